@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/**
+ * @file aggregate.hpp
+ * @brief Mergeable sum/count/min/max of a measure
+ *
+ * Kept apart from group_aggregate.hpp so headers that only return aggregates
+ * do not pull the OpenMP group-by templates into every translation unit.
+ */
+
+/**
+ * @struct GroupAggregate
+ * @brief Running sum, count, min and max of one group's measure
+ */
+struct GroupAggregate {
+    double sum{0.0};
+    std::size_t count{0};
+    double min{std::numeric_limits<double>::infinity()};
+    double max{-std::numeric_limits<double>::infinity()};
+
+    void add(double value) noexcept {
+        sum += value;
+        ++count;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(const GroupAggregate& other) noexcept {
+        sum += other.sum;
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    double mean() const noexcept { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+};
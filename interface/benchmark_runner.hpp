@@ -25,7 +25,7 @@ namespace BenchmarkRunner {
      * @brief Configuration for benchmark execution
      */
     struct BenchmarkConfig {
-        int parallelThreads = 4;      ///< Number of threads for parallel execution
+        int parallelThreads = 4;      ///< Team size of the parallel runs (always opened: grain 0)
         int repetitions = 5;          ///< Number of benchmark repetitions
         bool validateResults = true;  ///< Whether to validate serial vs parallel results
         bool showValues = true;       ///< Whether to display result values
@@ -53,6 +53,57 @@ namespace BenchmarkRunner {
         int year,
         const BenchmarkConfig& config = {});
 
+    /**
+     * @brief Run the fused yearSummary benchmark
+     * 
+     * Times the single-pass summary that replaces separate sum/average/min/max
+     * sweeps and checks that serial and parallel summaries agree.
+     * 
+     * @param services Vector of service implementations to benchmark
+     * @param year Target year for the summary
+     * @param config Benchmark configuration
+     */
+    void runYearSummaryBenchmark(
+        const std::vector<std::reference_wrapper<IPopulationService>>& services,
+        int year,
+        const BenchmarkConfig& config = {});
+
+    /**
+     * @brief Run the multi-year batch benchmark
+     * 
+     * Compares four single-year aggregate calls per year (one parallel region
+     * each) against one yearSummaries call over the same years.
+     * 
+     * @param services Vector of service implementations to benchmark
+     * @param years Years to aggregate
+     * @param config Benchmark configuration
+     */
+    void runYearBatchBenchmark(
+        const std::vector<std::reference_wrapper<IPopulationService>>& services,
+        const std::vector<int>& years,
+        const BenchmarkConfig& config = {});
+
+    /**
+     * @brief Run the concurrent small-query latency benchmark
+     * 
+     * Several caller threads issue sumPopulationForYear queries against the same
+     * service, once with a context that always opens a parallel region (grain 0)
+     * and once with the service's own context. Reports per-query p50/p99/max
+     * latency and throughput for both; the service's context is restored after.
+     * 
+     * @param services Vector of service implementations to benchmark
+     * @param year Target year for the queries
+     * @param callerThreads Number of concurrent caller threads
+     * @param queriesPerCaller Queries issued by each caller
+     * @param config Benchmark configuration (parallelThreads = team size per query)
+     */
+    void runConcurrentQueryBenchmark(
+        const std::vector<std::reference_wrapper<IPopulationService>>& services,
+        int year,
+        int callerThreads,
+        int queriesPerCaller,
+        const BenchmarkConfig& config = {});
+
     /**
      * @brief Run top-N benchmark for ranking operations
      * 
@@ -94,6 +94,9 @@ namespace BenchmarkUtils {
      * @param csvPath Path to CSV file to load
      * @param model Row-oriented model to populate
      * @param modelCol Column-oriented model to populate
+     * @param numThreads Threads used to parse the CSV (1 = serial reader)
+     * @param columnSnapshotPath Binary snapshot for the column model (empty = always parse CSV);
+     *        used when newer than csvPath, otherwise rewritten after parsing
      * @return ValidationResult indicating success or failure with error details
      * 
      * Handles all aspects of model initialization:
@@ -104,7 +107,9 @@ namespace BenchmarkUtils {
      */
     ValidationResult initializeModels(const std::string& csvPath,
                                      PopulationModel& model,
-                                     PopulationModelColumn& modelCol);
+                                     PopulationModelColumn& modelCol,
+                                     int numThreads = 1,
+                                     const std::string& columnSnapshotPath = "");
     
     // === Benchmark Execution ===
     
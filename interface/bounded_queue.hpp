@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @file bounded_queue.hpp
+ * @brief Fixed-capacity lock-free multi-producer/multi-consumer queue
+ *
+ * A ring of cells, each carrying a sequence number that says whether it is
+ * free for the producer of a given position or holds a value for the consumer of
+ * that position (Vyukov's bounded MPMC queue). Producers and consumers claim a
+ * position with one compare-exchange on their own cursor and then own the cell,
+ * so no operation ever takes a lock or waits for another thread to finish.
+ */
+
+/**
+ * @class BoundedQueue
+ * @brief Lock-free queue holding at most capacity() values
+ *
+ * tryPush() fails when the queue is full and tryPop() when it is empty; callers
+ * decide how to wait (see IngestPipeline). T must be default-constructible and
+ * move-assignable.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /// Create a queue for at least capacity values (rounded up to a power of two, minimum 2)
+    explicit BoundedQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size *= 2;
+        _mask = size - 1;
+        _cells = std::make_unique<Cell[]>(size);
+        for (std::size_t i = 0; i < size; ++i) _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    std::size_t capacity() const noexcept { return _mask + 1; }
+
+    /// Move value in unless the queue is full; value is left untouched on failure
+    bool tryPush(T& value) {
+        std::size_t position = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = _cells[position & _mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // the consumer of the previous lap has not freed this cell yet
+            } else {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Move the oldest value out unless the queue is empty
+    bool tryPop(T& out) {
+        std::size_t position = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = _cells[position & _mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(position + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // no producer has filled this position yet
+            } else {
+                position = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    // Producers and consumers hammer different cursors; keep them on separate cache lines
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> _cells;
+    std::size_t _mask{0};
+    alignas(CACHE_LINE) std::atomic<std::size_t> _tail{0};
+    alignas(CACHE_LINE) std::atomic<std::size_t> _head{0};
+};
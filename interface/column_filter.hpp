@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "aggregate.hpp"
+#include "column_view.hpp"
+#include "execution_context.hpp"
+
+/**
+ * @file column_filter.hpp
+ * @brief Block-at-a-time predicate filters and aggregates over numeric columns
+ *
+ * A Filter is a conjunction of range and comparison predicates on columns of
+ * the same table (e.g. FireColumnModel's aqis(), timestamps() and
+ * parameterCodes()). It is evaluated in blocks of BLOCK_ROWS rows:
+ *
+ * 1. Each predicate compares its block of values with its bounds. The result
+ *    is one bit per row (vector compares plus movemask, or AVX-512 compare
+ *    masks). The bits are ANDed into the block's mask, and the remaining
+ *    predicates are skipped once no row is left.
+ * 2. The mask is turned into a selection vector of row offsets. The
+ *    aggregate reads only those rows, while the block is still in cache.
+ *
+ * Blocks are independent, so a filter runs as one OpenMP loop over blocks
+ * driven by an ExecutionContext. Kernels are chosen at runtime like
+ * SimdReduce: AVX-512, AVX2, or a portable scalar fallback.
+ */
+
+namespace ColumnFilter {
+    /// Available predicate kernels
+    enum class Kernel { Scalar, AVX2, AVX512 };
+
+    /// Best kernel supported by the running CPU
+    Kernel detectKernel() noexcept;
+
+    /// Kernel currently used by the filters (defaults to detectKernel())
+    Kernel activeKernel() noexcept;
+
+    /// True if the running CPU can execute the given kernel
+    bool isSupported(Kernel kernel) noexcept;
+
+    /// Force a specific kernel (e.g. for benchmarking). Returns false if unsupported.
+    bool selectKernel(Kernel kernel) noexcept;
+
+    /// Human-readable kernel name
+    const char* kernelName(Kernel kernel) noexcept;
+
+    /// Rows per block: a block's mask is 64 words, its double values 32 KB
+    constexpr std::size_t BLOCK_ROWS = 4096;
+
+    /// Comparison of a column value with a constant
+    enum class Op { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+    /**
+     * @class Predicate
+     * @brief One column compared with constants
+     *
+     * Every comparison is stored as an inclusive range [low, high], negated
+     * for NotEqual. Strict bounds are turned into inclusive ones (v > 150 on
+     * an int column is [151, INT_MAX]). NaN never satisfies a comparison
+     * except NotEqual, as with IEEE operators. The predicate points into the
+     * column, which must outlive it and stay unmodified.
+     */
+    class Predicate {
+    public:
+        static Predicate compare(ColumnView<double> column, Op op, double value);
+        static Predicate compare(ColumnView<int> column, Op op, int value);
+        static Predicate compare(ColumnView<std::uint32_t> column, Op op, std::uint32_t value);
+        static Predicate compare(ColumnView<std::int64_t> column, Op op, std::int64_t value);
+
+        /// low <= value <= high (matches nothing if low > high)
+        static Predicate between(ColumnView<double> column, double low, double high);
+        static Predicate between(ColumnView<int> column, int low, int high);
+        static Predicate between(ColumnView<std::uint32_t> column, std::uint32_t low, std::uint32_t high);
+        static Predicate between(ColumnView<std::int64_t> column, std::int64_t low, std::int64_t high);
+
+        /// Rows in the column
+        std::size_t size() const noexcept { return _size; }
+
+        /// Bytes of one value of the column
+        std::size_t valueBytes() const noexcept;
+
+        /**
+         * @brief Set bit r of bits for every row begin + r in [begin, begin + n) that passes
+         * @param bits (n + 63) / 64 words, overwritten; bits past n are clear
+         *
+         * n must not exceed BLOCK_ROWS.
+         */
+        void evaluate(std::size_t begin, std::size_t n, std::uint64_t* bits) const noexcept;
+
+    private:
+        enum class Type : std::uint8_t { Double, Int32, UInt32, Int64 };
+
+        const void* _values{nullptr};
+        std::size_t _size{0};
+        Type _type{Type::Double};
+        bool _negated{false};          ///< Passes outside [low, high] (NotEqual)
+        double _real_low{0.0};         ///< Bounds of a Double column
+        double _real_high{0.0};
+        std::int64_t _int_low{0};      ///< Bounds of an integer column, within its value type
+        std::int64_t _int_high{0};
+
+        template <typename T>
+        static Predicate integer(ColumnView<T> column, Type type, std::int64_t low, std::int64_t high, bool negated);
+        static Predicate real(ColumnView<double> column, double low, double high, bool negated);
+    };
+
+    /**
+     * @class Selection
+     * @brief Rows that passed a filter, one bit per row
+     */
+    class Selection {
+    public:
+        Selection() = default;
+
+        /// Selection over rows [0, rows) with nothing selected
+        explicit Selection(std::size_t rows) : _rows(rows), _words((rows + 63) / 64, 0) {}
+
+        /// Rows covered (selected or not)
+        std::size_t size() const noexcept { return _rows; }
+
+        /// Rows selected
+        std::size_t count() const noexcept;
+
+        bool test(std::size_t row) const noexcept { return (_words[row / 64] >> (row % 64)) & 1; }
+
+        /// Bit r % 64 of word r / 64 is row r
+        const std::vector<std::uint64_t>& words() const noexcept { return _words; }
+        std::uint64_t* data() noexcept { return _words.data(); }
+
+        /// Selected rows in increasing order (a selection vector)
+        std::vector<std::size_t> toIndices() const;
+
+    private:
+        std::size_t _rows{0};
+        std::vector<std::uint64_t> _words;
+    };
+
+    /**
+     * @class Filter
+     * @brief Conjunction of predicates over the rows of one table
+     *
+     * Filters are cheap to copy (a few pointers per predicate) and read-only
+     * once built, so one filter can be run from several threads.
+     */
+    class Filter {
+    public:
+        /// Filter over rows [0, rows) that every row passes until predicates are added
+        explicit Filter(std::size_t rows) : _rows(rows) {}
+
+        /**
+         * @brief Add a predicate that every selected row must also pass
+         * @throws std::invalid_argument if its column does not have rowCount() rows
+         */
+        Filter& where(const Predicate& predicate);
+
+        std::size_t rowCount() const noexcept { return _rows; }
+        const std::vector<Predicate>& predicates() const noexcept { return _predicates; }
+
+        /// Bytes a full pass reads from the predicate columns (for throughput figures)
+        std::size_t scannedBytes() const noexcept;
+
+        /// Bitmask of the passing rows
+        Selection select(const ExecutionContext& context = {}) const;
+
+        /// Number of passing rows
+        std::size_t count(const ExecutionContext& context = {}) const;
+
+        /// Sum, count, min and max of values over the passing rows (values must have rowCount() rows)
+        GroupAggregate aggregate(ColumnView<double> values, const ExecutionContext& context = {}) const;
+        GroupAggregate aggregate(ColumnView<int> values, const ExecutionContext& context = {}) const;
+
+    private:
+        std::size_t _rows;
+        std::vector<Predicate> _predicates;
+
+        /// Write the mask of rows [begin, begin + n) to mask; returns false if no row passed
+        bool evaluateBlock(std::size_t begin, std::size_t n, std::uint64_t* mask) const noexcept;
+
+        template <typename T>
+        GroupAggregate aggregateValues(ColumnView<T> values, const ExecutionContext& context) const;
+    };
+}
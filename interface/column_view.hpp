@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file column_view.hpp
+ * @brief Read-only column views and storage that may borrow its values
+ *
+ * Model accessors hand out ColumnView<T> rather than const std::vector<T>& so the
+ * values can live either in the model's own vectors or in memory the model does
+ * not own, such as a memory-mapped snapshot file (see columnar_snapshot.hpp).
+ */
+
+/**
+ * @class ColumnView
+ * @brief Non-owning contiguous span of column values
+ *
+ * Offers the read-only subset of std::vector used by the services: size(),
+ * operator[], data() and iteration. Invalidated by any write to the column.
+ */
+template <typename T>
+class ColumnView {
+public:
+    using value_type = T;
+    using const_iterator = const T*;
+
+    ColumnView() = default;
+    ColumnView(const T* data, std::size_t size) noexcept : _data(data), _size(size) {}
+    ColumnView(const std::vector<T>& values) noexcept : _data(values.data()), _size(values.size()) {}
+
+    const T* data() const noexcept { return _data; }
+    std::size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+
+    const T& operator[](std::size_t i) const noexcept { return _data[i]; }
+    const T& front() const noexcept { return _data[0]; }
+    const T& back() const noexcept { return _data[_size - 1]; }
+
+    const T* begin() const noexcept { return _data; }
+    const T* end() const noexcept { return _data + _size; }
+
+    /// Copy the viewed values out
+    std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+    friend bool operator==(const ColumnView& a, const ColumnView& b) noexcept {
+        return a._size == b._size && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const ColumnView& a, const ColumnView& b) noexcept { return !(a == b); }
+
+private:
+    const T* _data{nullptr};
+    std::size_t _size{0};
+};
+
+/**
+ * @class ColumnStorage
+ * @brief A column that either owns a vector or borrows values from elsewhere
+ *
+ * borrow() points the column at external memory without copying; the owner of
+ * that memory must keep it alive until the column is destroyed, re-borrowed or
+ * written. owned() is the only write path: a borrowed column copies its values
+ * into its own vector first, so later writes never touch the borrowed memory.
+ */
+template <typename T>
+class ColumnStorage {
+public:
+    ColumnView<T> view() const noexcept { return _borrowed ? ColumnView<T>(_borrowed, _borrowedSize) : ColumnView<T>(_owned); }
+
+    const T* data() const noexcept { return _borrowed ? _borrowed : _owned.data(); }
+    std::size_t size() const noexcept { return _borrowed ? _borrowedSize : _owned.size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    const T& operator[](std::size_t i) const noexcept { return data()[i]; }
+    const T* begin() const noexcept { return data(); }
+    const T* end() const noexcept { return data() + size(); }
+
+    /// True while the values live in borrowed memory
+    bool isBorrowed() const noexcept { return _borrowed != nullptr; }
+
+    /// Point the column at external values, dropping any owned ones
+    void borrow(ColumnView<T> values) {
+        _owned = std::vector<T>();
+        _borrowed = values.empty() ? nullptr : values.data();
+        _borrowedSize = values.size();
+    }
+
+    /// Writable vector; a borrowed column is copied into it first
+    std::vector<T>& owned() {
+        if (_borrowed) {
+            _owned.assign(_borrowed, _borrowed + _borrowedSize);
+            _borrowed = nullptr;
+            _borrowedSize = 0;
+        }
+        return _owned;
+    }
+
+    /// Bytes of values: the owned vector's capacity, or the borrowed extent
+    std::size_t memoryBytes() const noexcept {
+        return (_borrowed ? _borrowedSize : _owned.capacity()) * sizeof(T);
+    }
+
+private:
+    std::vector<T> _owned;
+    const T* _borrowed{nullptr};
+    std::size_t _borrowedSize{0};
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "column_view.hpp"
+#include "mapped_file.hpp"
+
+/**
+ * @file columnar_snapshot.hpp
+ * @brief Versioned, checksummed binary snapshots of columnar models
+ *
+ * A snapshot is one file holding a model's columns as raw native-order arrays so
+ * that it can be memory-mapped and used in place instead of re-parsing CSV:
+ *
+ * ```
+ * [FileHeader 64 B][SectionEntry x sectionCount][pad][section 0][pad][section 1]...
+ * ```
+ *
+ * Every section starts on a 64-byte boundary and is described by its id, element
+ * size, offset, element count and checksum. The header carries a magic string,
+ * format version, model kind, byte-order mark, total file size and checksums of
+ * itself and of the section table. Sections are identified by model-specific ids,
+ * so a model can add sections without a format change; a layout change bumps
+ * VERSION and older files are rejected.
+ */
+
+namespace Snapshot {
+
+    /// Format version written by Writer; Reader accepts only this version
+    constexpr std::uint32_t VERSION = 1;
+
+    /// Alignment of every section within the file
+    constexpr std::size_t SECTION_ALIGNMENT = 64;
+
+    /// Which model a snapshot holds
+    enum class Kind : std::uint32_t {
+        FireColumns = 1,        ///< FireColumnModel
+        PopulationColumns = 2   ///< PopulationModelColumn
+    };
+
+    /**
+     * @brief 64-bit checksum of a byte range (XXH64-style, several GB/s)
+     * @param data Start of the bytes
+     * @param bytes Number of bytes
+     * @param seed Initial value, so independent ranges can be chained
+     */
+    std::uint64_t checksum(const void* data, std::size_t bytes, std::uint64_t seed = 0) noexcept;
+
+    /**
+     * @brief True if snapshotPath exists and is at least as new as its source
+     * @param snapshotPath Snapshot file
+     * @param sourcePath CSV file, or directory whose regular files are all compared
+     */
+    bool isFresh(const std::string& snapshotPath, const std::string& sourcePath);
+
+    /**
+     * @brief Atomically replace a file with new contents
+     * @param path File to replace (created if missing)
+     * @param what Noun used in error messages, e.g. "snapshot"
+     * @param mode Extra open mode for the stream, e.g. std::ios::binary
+     * @param fill Writes the contents
+     * @throws std::runtime_error if a step fails; exceptions from fill() propagate
+     *
+     * The contents go to path + ".tmp", which is flushed and fsynced before it
+     * is renamed over path. The directory is then synced so the rename
+     * survives a crash. The temporary file is removed on every failure.
+     */
+    void replaceFile(const std::string& path, const std::string& what, std::ios::openmode mode,
+                     const std::function<void(std::ostream&)>& fill);
+
+    /**
+     * @brief Load a model from its snapshot if fresh, otherwise build it and write one
+     * @param model Model with loadSnapshot()/saveSnapshot() members
+     * @param snapshotPath Snapshot file (empty disables snapshots: just build())
+     * @param sourcePath Data the snapshot was made from (see isFresh())
+     * @param build Fills the model from the source data
+     * @return True if the model was loaded from the snapshot
+     *
+     * A stale, unreadable or corrupt snapshot is reported on std::cerr and
+     * rebuilt; exceptions from build() propagate.
+     */
+    template <typename Model, typename Build>
+    bool loadOrBuild(Model& model, const std::string& snapshotPath, const std::string& sourcePath, Build build);
+
+    /// On-disk header (fixed 64 bytes)
+    struct FileHeader {
+        char magic[8];                 ///< "COLSNAP\0"
+        std::uint32_t version;         ///< VERSION at write time
+        std::uint32_t kind;            ///< Kind
+        std::uint32_t byteOrder;       ///< 0x01020304 as written by the producing machine
+        std::uint32_t sectionCount;    ///< Entries in the section table
+        std::uint64_t fileSize;        ///< Total bytes, to detect truncation
+        std::uint64_t tableChecksum;   ///< checksum() of the section table
+        std::uint64_t headerChecksum;  ///< checksum() of the bytes before this field
+        std::uint8_t reserved[16];
+    };
+    static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+
+    /// On-disk section table entry
+    struct SectionEntry {
+        std::uint32_t id;              ///< Model-specific section id
+        std::uint32_t elementSize;     ///< sizeof one element (1 for string sections)
+        std::uint64_t offset;          ///< Byte offset from the start of the file
+        std::uint64_t count;           ///< Number of elements
+        std::uint64_t checksum;        ///< checksum() of the section bytes
+    };
+    static_assert(sizeof(SectionEntry) == 32, "SectionEntry must stay 32 bytes");
+
+    /**
+     * @class Writer
+     * @brief Collects sections and writes them as one snapshot file
+     *
+     * column() keeps a pointer to the caller's values, which must stay valid until
+     * write() returns; strings() encodes its input into the writer.
+     */
+    class Writer {
+    public:
+        explicit Writer(Kind kind) : _kind(kind) {}
+
+        /// Add a section of trivially copyable values
+        template <typename T>
+        void column(std::uint32_t id, ColumnView<T> values) {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot columns must be trivially copyable");
+            add(id, sizeof(T), values.data(), values.size());
+        }
+
+        /// Add a section holding a list of strings (count, offsets, bytes)
+        void strings(std::uint32_t id, const std::vector<std::string>& values);
+
+        /**
+         * @brief Write the snapshot to path
+         * @throws std::runtime_error if the file cannot be written
+         *
+         * The file is written next to path and renamed over it, so readers never
+         * see a partial snapshot.
+         */
+        void write(const std::string& path) const;
+
+    private:
+        struct Pending {
+            std::uint32_t id;
+            std::uint32_t elementSize;
+            const void* data;
+            std::size_t count;
+        };
+
+        void add(std::uint32_t id, std::uint32_t elementSize, const void* data, std::size_t count);
+
+        Kind _kind;
+        std::vector<Pending> _sections;
+        std::deque<std::vector<char>> _encoded;   ///< Owned bytes of string sections
+    };
+
+    /**
+     * @class Reader
+     * @brief Maps a snapshot file and hands out views of its sections
+     *
+     * The constructor validates the header, section table and section bounds, and
+     * (when verifyChecksums is set) every section's checksum. Views returned by
+     * column() point into the mapping; keep file() alive for as long as they are used.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Open and validate a snapshot
+         * @param path Snapshot file
+         * @param kind Expected model kind
+         * @param verifyChecksums Also checksum every section (reads the whole file)
+         * @throws std::runtime_error if the file is missing, of another kind or
+         *         version, truncated or corrupt
+         */
+        Reader(const std::string& path, Kind kind, bool verifyChecksums = true);
+
+        /// True if the snapshot has a section with this id
+        bool has(std::uint32_t id) const noexcept { return find(id) != nullptr; }
+
+        /// Values of a section (throws std::runtime_error if missing or of another element type)
+        template <typename T>
+        ColumnView<T> column(std::uint32_t id) const {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot columns must be trivially copyable");
+            const SectionEntry& entry = section(id, sizeof(T));
+            const char* bytes = _file->data() + entry.offset;
+            if (reinterpret_cast<std::uintptr_t>(bytes) % alignof(T) != 0) {
+                throw std::runtime_error("Snapshot section " + std::to_string(id) + " is misaligned in " + _path);
+            }
+            return ColumnView<T>(reinterpret_cast<const T*>(bytes), static_cast<std::size_t>(entry.count));
+        }
+
+        /// Decode a strings() section
+        std::vector<std::string> strings(std::uint32_t id) const;
+
+        /// The mapping the views point into
+        const std::shared_ptr<const MappedFile>& file() const noexcept { return _file; }
+
+    private:
+        const SectionEntry* find(std::uint32_t id) const noexcept;
+        const SectionEntry& section(std::uint32_t id, std::size_t elementSize) const;
+
+        std::string _path;
+        std::shared_ptr<const MappedFile> _file;
+        std::vector<SectionEntry> _sections;
+    };
+
+    template <typename Model, typename Build>
+    bool loadOrBuild(Model& model, const std::string& snapshotPath, const std::string& sourcePath, Build build) {
+        if (!snapshotPath.empty() && isFresh(snapshotPath, sourcePath)) {
+            try {
+                model.loadSnapshot(snapshotPath);
+                return true;
+            } catch (const std::exception& e) {
+                std::cerr << "Rebuilding snapshot: " << e.what() << "\n";
+            }
+        }
+        build();
+        if (!snapshotPath.empty()) {
+            try {
+                model.saveSnapshot(snapshotPath);
+            } catch (const std::exception& e) {
+                std::cerr << "Could not write snapshot: " << e.what() << "\n";
+            }
+        }
+        return false;
+    }
+
+}
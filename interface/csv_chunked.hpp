@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "constants.hpp"
+
+/**
+ * @file csv_chunked.hpp
+ * @brief Intra-file parallel CSV parsing support
+ *
+ * Splits one large CSV buffer into byte ranges that each start and end on a
+ * record boundary, so every range can be parsed by its own OpenMP thread with
+ * CSVReader::openBuffer(). Boundaries are quote-aware: a newline inside a
+ * quoted field never starts a new range.
+ */
+
+namespace CSVChunked {
+    /// Half-open byte range [begin, end) covering whole records
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    /**
+     * @brief Split data into at most `parts` record-aligned ranges
+     * @param data Whole CSV contents (typically a MappedFile view)
+     * @param parts Desired number of ranges; quote parity is counted with this many threads
+     * @param quote Quote character
+     * @param comment Comment character
+     * @return Non-empty, ordered ranges that together cover data exactly
+     *
+     * Each nominal split point is moved forward to the first newline that lies
+     * outside quotes. Quote state at the split point is recovered exactly from a
+     * parallel per-range quote count and a prefix XOR of the parities. Comment
+     * lines ignore quotes, so files containing them fall back to a single range.
+     */
+    std::vector<Range> splitRecords(std::string_view data, int parts,
+                                    char quote = Config::DEFAULT_CSV_QUOTE,
+                                    char comment = Config::DEFAULT_CSV_COMMENT);
+}
+
+/**
+ * @struct PopulationCSVData
+ * @brief Parsed contents of a population CSV (header years plus one entry per country)
+ *
+ * Values are kept flat with per-row offsets so rows of any length survive
+ * exactly as the serial readers see them.
+ */
+struct PopulationCSVData {
+    std::vector<long long> years;               ///< Years parsed from the header
+    std::vector<std::string> countryNames;      ///< Column 0 of each data row
+    std::vector<std::string> countryCodes;      ///< Column 1 of each data row
+    std::vector<std::string> indicatorNames;    ///< Column 2 of each data row
+    std::vector<std::string> indicatorCodes;    ///< Column 3 of each data row
+    std::vector<long long> values;              ///< Year values of all rows, back to back
+    std::vector<std::size_t> rowOffsets{0};     ///< Row i spans values[rowOffsets[i], rowOffsets[i+1])
+
+    std::size_t rowCount() const noexcept { return countryNames.size(); }
+};
+
+namespace PopulationCSV {
+    /**
+     * @brief Parse a population CSV with one OpenMP thread per record-aligned chunk
+     * @param filename CSV path (Country Name, Country Code, Indicator Name, Indicator Code, <years...>)
+     * @param numThreads Number of chunks/threads
+     * @param out Parsed rows in file order
+     * @return False if the file cannot be opened
+     */
+    bool readParallel(const std::string& filename, int numThreads, PopulationCSVData& out);
+}
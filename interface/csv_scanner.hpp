@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file csv_scanner.hpp
+ * @brief Vectorized structural scanner for CSV parsing
+ *
+ * Classifies 64 bytes at a time into bitmasks of delimiter, quote and newline
+ * positions (bit i set means byte i of the block matches). CSVReader combines
+ * these masks with a prefix-XOR of the quote mask to find record and field
+ * boundaries outside quotes without a per-byte state machine.
+ *
+ * Kernels are chosen at runtime: AVX2 (32 bytes per compare), SSE4.2
+ * (16 bytes per compare) or a portable scalar fallback on other CPUs.
+ */
+
+namespace CSVScan {
+    /// Available block classification kernels
+    enum class Kernel { Scalar, SSE42, AVX2 };
+
+    /// Structural character bitmasks for one 64-byte block
+    struct BlockMasks {
+        std::uint64_t delim;    ///< Delimiter positions
+        std::uint64_t quote;    ///< Quote positions
+        std::uint64_t newline;  ///< '\n' positions
+    };
+
+    /// Number of bytes classified per scanBlock() call
+    constexpr std::size_t BLOCK_SIZE = 64;
+
+    /// Best kernel supported by the running CPU
+    Kernel detectKernel() noexcept;
+
+    /// Kernel currently used by scanBlock() (defaults to detectKernel())
+    Kernel activeKernel() noexcept;
+
+    /// True if the running CPU can execute the given kernel
+    bool isSupported(Kernel kernel) noexcept;
+
+    /// Force a specific kernel (e.g. for benchmarking). Returns false if unsupported.
+    bool selectKernel(Kernel kernel) noexcept;
+
+    /// Human-readable kernel name
+    const char* kernelName(Kernel kernel) noexcept;
+
+    /**
+     * @brief Classify up to BLOCK_SIZE bytes starting at data
+     * @param data First byte of the block
+     * @param len Number of valid bytes (bits at or above len are always clear)
+     * @param delim Field delimiter
+     * @param quote Quote character
+     */
+    BlockMasks scanBlock(const char* data, std::size_t len, char delim, char quote) noexcept;
+
+    /**
+     * @brief Inclusive prefix XOR: bit i of the result is the XOR of bits 0..i
+     *
+     * Applied to a quote mask this yields "inside quotes" for every non-quote byte.
+     */
+    inline std::uint64_t prefixXor(std::uint64_t x) noexcept {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @file execution_context.hpp
+ * @brief How a service runs its parallel work: team size, loop schedule and thread affinity
+ *
+ * Services hold one ExecutionContext and pass it to every parallel region they
+ * open, instead of calling omp_set_num_threads() and changing the process-wide
+ * OpenMP defaults. The team size, proc_bind policy and schedule are applied per
+ * region (see parallel_region.hpp), so several caller threads can query the same
+ * or different services concurrently without affecting each other.
+ *
+ * Small inputs do not pay for a fork/join: teamSize() gives every thread at
+ * least `grain` items and runs inputs below that inline on the calling thread.
+ */
+struct ExecutionContext {
+    /// Loop schedule for the work-sharing loops of a region
+    enum class Schedule { Static, Dynamic, Guided };
+
+    /// Thread affinity policy (OpenMP proc_bind) over the places from OMP_PLACES
+    enum class Affinity {
+        Default,   ///< Whatever OMP_PROC_BIND says (usually unbound)
+        Close,     ///< Pack the team onto places next to the caller
+        Spread     ///< Spread the team evenly over the available places
+    };
+
+    /// Pass as numThreads to use the service's context unchanged
+    static constexpr int USE_CONTEXT = 0;
+
+    /// Default minimum number of items per thread before a region is opened
+    static constexpr std::size_t DEFAULT_GRAIN = 2048;
+
+    int threads{1};                          ///< Maximum team size (<= 1 runs serially)
+    Schedule schedule{Schedule::Static};
+    int chunk{0};                            ///< Schedule chunk size (0 = OpenMP default)
+    Affinity affinity{Affinity::Default};
+    std::size_t grain{DEFAULT_GRAIN};        ///< Minimum items per thread (0 = always use all threads)
+
+    /// Context with the given thread count and defaults for everything else
+    static ExecutionContext withThreadCount(int threads) {
+        ExecutionContext context;
+        context.threads = threads;
+        return context;
+    }
+
+    /// Copy of this context with the thread count replaced (USE_CONTEXT keeps it)
+    ExecutionContext withThreads(int numThreads) const {
+        ExecutionContext context = *this;
+        if (numThreads != USE_CONTEXT) context.threads = numThreads;
+        return context;
+    }
+
+    /// Copy of this context for a loop of `items` iterations that together touch `work` values,
+    /// with the grain rescaled so the team is sized by the values rather than the iterations
+    ExecutionContext withWork(std::size_t items, std::size_t work) const {
+        ExecutionContext context = *this;
+        if (grain > 0 && items > 0 && work > items) {
+            const std::size_t scaled = grain * items / work;
+            context.grain = scaled > 0 ? scaled : 1;
+        }
+        return context;
+    }
+
+    /// Team size for a region over `items` work items (1 = run inline). The grain applies to
+    /// explicit thread counts too: inputs under two grains run inline unless grain is 0
+    int teamSize(std::size_t items) const noexcept {
+        if (threads <= 1) return 1;
+        if (grain == 0) return threads;
+        std::size_t byWork = items / grain;
+        if (byWork <= 1) return 1;
+        return byWork < static_cast<std::size_t>(threads) ? static_cast<int>(byWork) : threads;
+    }
+
+    /// One-line summary, e.g. "4 threads, dynamic(64), spread, grain 2048"
+    std::string describe() const;
+};
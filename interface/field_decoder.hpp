@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "timestamp.hpp"
+
+/**
+ * @file field_decoder.hpp
+ * @brief Typed, non-throwing decoders for CSV fields
+ *
+ * Replaces std::stod / std::stoi in the loaders. Decoders work directly on
+ * CSVReader field views, never allocate, never touch the locale and report
+ * failures through a Status value so callers can count rejected rows instead
+ * of unwinding an exception per bad field.
+ */
+
+namespace FieldDecoder {
+    /// Outcome of decoding one field
+    enum class Status {
+        Ok,         ///< Value decoded
+        Empty,      ///< Field was empty
+        Invalid,    ///< No number at the start of the field
+        OutOfRange  ///< Number does not fit the target type
+    };
+
+    /**
+     * @brief Decode a leading floating-point number
+     * @param s Field characters (need not be null-terminated)
+     * @param out Decoded value, only written on Status::Ok
+     *
+     * Follows std::stod: leading whitespace is skipped and trailing characters
+     * are ignored. Plain decimals take an exact fast path (at most 19 significant
+     * digits, |exponent| <= 22, mantissa <= 2^53); anything else, including
+     * inf/nan and hex floats, falls back to strtod on a stack copy.
+     */
+    Status toDouble(std::string_view s, double& out) noexcept;
+
+    /**
+     * @brief Decode a leading integer that must fit in int
+     *
+     * Follows std::stoi: leading whitespace and a sign are accepted, trailing
+     * characters are ignored.
+     */
+    Status toInt(std::string_view s, int& out) noexcept;
+
+    /// Decode a leading integer that must fit in long long (std::stoll semantics)
+    Status toLong(std::string_view s, long long& out) noexcept;
+
+    /// Number of columns in an AirNow fire data row
+    constexpr std::size_t FIRE_COLUMN_COUNT = 13;
+
+    /**
+     * @struct FireRecord
+     * @brief One decoded fire CSV row; string fields view the source row
+     */
+    struct FireRecord {
+        double latitude;
+        double longitude;
+        Timestamp::EpochMinutes timestamp;  ///< Parsed from the ISO datetime column
+        std::string_view parameter;
+        double concentration;
+        std::string_view unit;
+        double raw_concentration;
+        int aqi;
+        int category;
+        std::string_view site_name;
+        std::string_view agency_name;
+        std::string_view aqs_code;
+        std::string_view full_aqs_code;
+    };
+
+    /**
+     * @brief Decode a fire data row (lat, lon, datetime, parameter, concentration,
+     *        unit, raw concentration, AQI, category, site, agency, AQS, full AQS)
+     * @param fields Row fields; at least FIRE_COLUMN_COUNT are required
+     * @param out Decoded record, valid only on Status::Ok
+     * @return First failing field's status (Invalid if there are too few fields,
+     *         the latitude or longitude is not finite, or the datetime is not
+     *         "YYYY-MM-DDTHH:MM")
+     */
+    Status decodeFireRecord(const std::vector<std::string_view>& fields, FireRecord& out) noexcept;
+}
@@ -1,9 +1,19 @@
 #pragma once
 
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
-#include <unordered_set>
+#include "column_view.hpp"
+#include "ingest_manifest.hpp"
+#include "ingest_pipeline.hpp"
+#include "mapped_file.hpp"
+#include "roaring_bitmap.hpp"
+#include "spatial_index.hpp"
+#include "string_dictionary.hpp"
+#include "timestamp.hpp"
 
 /**
  * @file fireColumnModel.hpp
@@ -15,6 +25,22 @@
  * measurements for specific parameters, locations, or time ranges.
  */
 
+class CSVReader;
+
+/**
+ * @struct MeasurementFilter
+ * @brief Equality filter on the indexed string fields for FireColumnModel::select()
+ *
+ * A measurement passes if, for every non-empty list, its value is one of the
+ * listed values (OR within a field, AND across fields). Values the model has
+ * never seen match nothing; an all-empty filter matches every measurement.
+ */
+struct MeasurementFilter {
+    std::vector<std::string> parameters;
+    std::vector<std::string> siteNames;
+    std::vector<std::string> aqsCodes;
+};
+
 /**
  * @class FireColumnModel
  * @brief Column-oriented fire air quality data model for efficient analytics
@@ -42,47 +68,91 @@
  * + Efficient for statistical analysis and aggregations
  * - Requires coordination between parallel vectors for complete measurement access
  * - More complex insertion logic compared to row model
+ *
+ * A model loaded with loadSnapshot() borrows its columns from the mapped snapshot
+ * file; the accessors below then point straight into the mapping. The first write
+ * (insert or merge) copies the columns into owned vectors and releases the file.
+ *
+ * The site, parameter and AQS posting lists are RoaringBitmaps of measurement
+ * indices, so select() answers multi-field filters with bitmap AND/OR and the
+ * postingsByXxx() accessors hand out a list without copying it. Indices are 32-bit,
+ * which caps a model at 2^32 measurements.
+ *
+ * Box and radius queries go through a SpatialIndex of the distinct locations
+ * of each AQS code, then read only those codes' posting lists.
+ *
+ * Dictionaries and posting lists (thousands of small allocations per file) come
+ * from a std::pmr memory resource, the default heap unless one is given; the
+ * pipelined loader builds each per-file model in an arena (see ArenaBatch).
  */
 class FireColumnModel {
+public:
+    /// Dictionary code stored in the encoded string columns
+    using Code = StringDictionary::Code;
+
 private:
-    // Columnar storage - each vector contains all measurements' values for one field
-    std::vector<double> _latitudes;              ///< All measurement latitudes
-    std::vector<double> _longitudes;             ///< All measurement longitudes
-    std::vector<std::string> _datetimes;         ///< All measurement datetimes
-    std::vector<std::string> _parameters;        ///< All measurement parameters (PM2.5, PM10, etc.)
-    std::vector<double> _concentrations;         ///< All measured concentration values
-    std::vector<std::string> _units;             ///< All measurement units
-    std::vector<double> _raw_concentrations;     ///< All raw concentration values
-    std::vector<int> _aqis;                      ///< All Air Quality Index values
-    std::vector<int> _categories;                ///< All AQI categories
-    std::vector<std::string> _site_names;        ///< All monitoring site names
-    std::vector<std::string> _agency_names;      ///< All responsible agency names
-    std::vector<std::string> _aqs_codes;         ///< All AQS codes (short)
-    std::vector<std::string> _full_aqs_codes;    ///< All full AQS codes
+    // Columnar storage - each column contains all measurements' values for one field.
+    // Low-cardinality string fields are dictionary-encoded: one code per measurement
+    // plus a per-column StringDictionary holding each distinct value once.
+    ColumnStorage<double> _latitudes;              ///< All measurement latitudes
+    ColumnStorage<double> _longitudes;             ///< All measurement longitudes
+    ColumnStorage<Timestamp::EpochMinutes> _timestamps; ///< All measurement datetimes (epoch minutes)
+    ColumnStorage<Code> _parameter_codes;          ///< All measurement parameters (PM2.5, PM10, etc.)
+    ColumnStorage<double> _concentrations;         ///< All measured concentration values
+    ColumnStorage<Code> _unit_codes;               ///< All measurement units
+    ColumnStorage<double> _raw_concentrations;     ///< All raw concentration values
+    ColumnStorage<int> _aqis;                      ///< All Air Quality Index values
+    ColumnStorage<int> _categories;                ///< All AQI categories
+    ColumnStorage<Code> _site_name_codes;          ///< All monitoring site names
+    ColumnStorage<Code> _agency_name_codes;        ///< All responsible agency names
+    ColumnStorage<Code> _aqs_code_codes;           ///< All AQS codes (short)
+    ColumnStorage<Code> _full_aqs_code_codes;      ///< All full AQS codes
+
+    // String tables for the encoded columns (distinct values in first-seen order)
+    StringDictionary _parameter_dict;
+    StringDictionary _unit_dict;
+    StringDictionary _site_name_dict;
+    StringDictionary _agency_name_dict;
+    StringDictionary _aqs_code_dict;
+    StringDictionary _full_aqs_code_dict;
 
-    // Index structures for fast lookups
-    std::unordered_map<std::string, std::vector<std::size_t>> _site_indices;      ///< Site name -> measurement indices
-    std::unordered_map<std::string, std::vector<std::size_t>> _parameter_indices; ///< Parameter -> measurement indices
-    std::unordered_map<std::string, std::vector<std::size_t>> _aqs_indices;       ///< AQS code -> measurement indices
+    // Index structures for fast lookups, indexed by dictionary code
+    using PostingLists = std::pmr::vector<RoaringBitmap>;
+    PostingLists _site_indices;      ///< Site code -> measurement indices
+    PostingLists _parameter_indices; ///< Parameter code -> measurement indices
+    PostingLists _aqs_indices;       ///< AQS code -> measurement indices
+    SpatialIndex _spatial;           ///< AQS code -> distinct measurement locations
     
     // Metadata tracking
-    std::unordered_set<std::string> _unique_sites;      ///< All unique site names
-    std::unordered_set<std::string> _unique_parameters; ///< All unique parameters
-    std::unordered_set<std::string> _unique_agencies;   ///< All unique agencies
-    std::vector<std::string> _datetime_range;           ///< [min_datetime, max_datetime]
+    Timestamp::EpochMinutes _min_timestamp{0};          ///< Earliest measurement time
+    Timestamp::EpochMinutes _max_timestamp{0};          ///< Latest measurement time
     
     // Geographic bounds tracking
     double _min_latitude, _max_latitude;
     double _min_longitude, _max_longitude;
     bool _bounds_initialized;
+    
+    std::size_t _rejected_rows{0};               ///< Rows skipped because they failed to decode
+
+    std::shared_ptr<const MappedFile> _snapshot; ///< Mapping the columns borrow from (null if owned)
 
 public:
     /// Default constructor
     FireColumnModel();
     
+    /// Model whose dictionaries and posting lists allocate from resource, which must outlive it
+    explicit FireColumnModel(std::pmr::memory_resource* resource);
+    
     /// Destructor
     ~FireColumnModel();
 
+    // Copies use the default heap. Moving into a model on another resource copies
+    // the dictionaries and posting lists, so move assignment may throw
+    FireColumnModel(const FireColumnModel&) = default;
+    FireColumnModel& operator=(const FireColumnModel&) = default;
+    FireColumnModel(FireColumnModel&&) noexcept = default;
+    FireColumnModel& operator=(FireColumnModel&&) = default;
+
     // === Data Loading Methods ===
     
     /**
@@ -107,20 +177,60 @@ public:
      */
     void readFromDirectoryParallel(const std::string& directoryPath, int numThreads);
 
+    /**
+     * @brief Read all CSV files in a directory through the streaming pipeline
+     * @param directoryPath Path to directory containing CSV files
+     * @param parseWorkers Parse threads; one more thread reads files ahead and the caller appends
+     * @return Per-stage throughput (see IngestPipeline::Report::print)
+     *
+     * Reading, decoding and inserting overlap instead of running back to back in
+     * each thread. Files are appended in sorted order, so the model is identical
+     * to a serial readFromDirectory().
+     */
+    IngestPipeline::Report readFromDirectoryPipelined(const std::string& directoryPath, int parseWorkers);
+
     /**
      * @brief Read fire data from a single CSV file
      * @param filename Path to CSV file to read
      * 
      * Processes one CSV file and adds all measurements to the columnar storage.
-     * Used by both serial and parallel ingestion methods.
+     * Used by both serial and parallel ingestion methods. The file is memory-mapped
+     * and numeric fields are decoded straight from the mapped bytes; rows that fail
+     * to decode are counted in rejectedRowCount().
      */
     void readFromCSV(const std::string& filename);
 
+    /**
+     * @brief Read the rows in bytes [fromByte, toByte) of a CSV file
+     * @param filename Path to CSV file to read
+     * @param fromByte Start of a line; the header row is only skipped when this is 0
+     * @param toByte End of the range (the file may have grown past it)
+     * @throws std::runtime_error if the file cannot be opened or is shorter than toByte
+     */
+    void readFromCSV(const std::string& filename, std::size_t fromByte, std::size_t toByte);
+
+    /**
+     * @brief Append only the files (or file tails) added since the manifest was recorded
+     * @param directoryPath Directory previously ingested with this manifest
+     * @param manifest Files already in this model; updated with the ones parsed here
+     * @param numThreads Threads used to parse (if <= 1, parses straight into this model)
+     * @return What was found and appended
+     *
+     * New files and the appended tails of grown files are parsed and appended like
+     * a merge: columns grow at the end and the posting lists, bounds and time range
+     * are extended in place. If any ingested file was rewritten or removed, or the
+     * manifest does not describe this model, nothing is read and the report asks
+     * for a full reload (reset the model and manifest, then call this again).
+     * Starting from an empty model and manifest is a full load that records the
+     * manifest.
+     */
+    IngestReport readNewFiles(const std::string& directoryPath, IngestManifest& manifest, int numThreads = 1);
+
     /**
      * @brief Insert a single measurement into the columnar storage
      * @param latitude Measurement latitude
      * @param longitude Measurement longitude
-     * @param datetime Measurement datetime string
+     * @param timestamp Measurement time in epoch minutes (see Timestamp::parseIsoMinutes)
      * @param parameter Parameter type (PM2.5, PM10, etc.)
      * @param concentration Measured concentration value
      * @param unit Unit of measurement
@@ -132,11 +242,11 @@ public:
      * @param aqs_code AQS code (short)
      * @param full_aqs_code Full AQS code
      */
-    void insertMeasurement(double latitude, double longitude, const std::string& datetime,
-                          const std::string& parameter, double concentration, const std::string& unit,
+    void insertMeasurement(double latitude, double longitude, Timestamp::EpochMinutes timestamp,
+                          std::string_view parameter, double concentration, std::string_view unit,
                           double raw_concentration, int aqi, int category,
-                          const std::string& site_name, const std::string& agency_name,
-                          const std::string& aqs_code, const std::string& full_aqs_code);
+                          std::string_view site_name, std::string_view agency_name,
+                          std::string_view aqs_code, std::string_view full_aqs_code);
 
     /**
      * @brief Merge another FireColumnModel into this one
@@ -146,6 +256,42 @@ public:
      * Efficiently appends all data from the other model and updates indices.
      */
     void mergeFromModel(const FireColumnModel& other);
+    
+    /**
+     * @brief Append several models at once, copying column segments in parallel
+     * @param others Models to append, in order (left intact)
+     * @param numThreads Threads used for the copy phase (<= 1 copies serially)
+     * 
+     * Every column is resized once from the per-model counts, then each model's
+     * segments are copied (code columns remapped) into place concurrently. The
+     * site/parameter/AQS posting lists are extended with offset-shifted copies of
+     * each model's lists, one code per task, so no code column is rescanned.
+     */
+    void mergeFromModels(const std::vector<FireColumnModel>& others, int numThreads);
+
+    // === Binary Snapshots ===
+
+    /**
+     * @brief Write all columns, dictionaries and metadata to a snapshot file
+     * @param path Destination file (replaced atomically)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void saveSnapshot(const std::string& path) const;
+
+    /**
+     * @brief Replace this model's contents with a snapshot written by saveSnapshot()
+     * @param path Snapshot file
+     * @param verifyChecksums Checksum every column before use (reads the whole file)
+     * @param numThreads Threads rebuilding the indices (at most 4: three posting lists and the spatial index)
+     * @throws std::runtime_error if the snapshot is missing, corrupt or of another version
+     *
+     * Columns are not copied: the accessors point into the mapped file. Dictionaries
+     * and the site/parameter/AQS posting lists are rebuilt in memory.
+     */
+    void loadSnapshot(const std::string& path, bool verifyChecksums = true, int numThreads = 1);
+
+    /// True while the columns are borrowed from a loaded snapshot
+    bool isSnapshotBacked() const noexcept { return _snapshot != nullptr; }
 
     // === Query Methods ===
     
@@ -169,22 +315,98 @@ public:
      * @return Vector of measurement indices for the AQS code
      */
     std::vector<std::size_t> getIndicesByAqsCode(const std::string& aqsCode) const;
+    
+    // Posting lists without a copy (an empty bitmap for unknown values)
+    const RoaringBitmap& postingsBySite(const std::string& siteName) const noexcept;
+    const RoaringBitmap& postingsByParameter(const std::string& parameter) const noexcept;
+    const RoaringBitmap& postingsByAqsCode(const std::string& aqsCode) const noexcept;
+    
+    /**
+     * @brief Measurements passing a filter on parameter, site and AQS code
+     * @param filter Accepted values per field (see MeasurementFilter)
+     * @return Matching measurement indices
+     *
+     * Each field's lists are united in one pass, then the fields are intersected
+     * smallest first; no row is read.
+     */
+    RoaringBitmap select(const MeasurementFilter& filter) const;
+    
+    // === Time-Range Queries ===
+    
+    /**
+     * @brief Get indices of all measurements with begin <= timestamp < end
+     * @param begin First minute of the range (epoch minutes)
+     * @param end One past the last minute of the range
+     * @return Measurement indices in storage order
+     */
+    std::vector<std::size_t> getIndicesInTimeRange(Timestamp::EpochMinutes begin, Timestamp::EpochMinutes end) const;
+    
+    /**
+     * @brief Aggregate measurements with begin <= timestamp < end into hourly buckets
+     * @param begin First minute of the range (epoch minutes)
+     * @param end One past the last minute of the range
+     * @return One bucket per hour from floorToHour(begin) up to end, empty hours included
+     */
+    std::vector<HourlyBucket> hourlyBuckets(Timestamp::EpochMinutes begin, Timestamp::EpochMinutes end) const;
+
+    // === Spatial Queries ===
+    
+    /// Distinct measurement locations by AQS code (SpatialIndex::Match::group is an aqsCodeCodes() value)
+    const SpatialIndex& spatialIndex() const noexcept { return _spatial; }
+    
+    /// Measurement indices of an AQS code (empty for an unknown code)
+    const RoaringBitmap& aqsCodePostings(Code code) const noexcept;
+    
+    /**
+     * @brief Get indices of all measurements inside a box (bounds included)
+     * @param box Latitude/longitude rectangle (may cross the antimeridian, see GeoBox)
+     * @return Measurement indices in storage order
+     */
+    std::vector<std::size_t> getIndicesInBox(const GeoBox& box) const;
+    
+    /**
+     * @brief Get indices of all measurements within a great-circle distance of a point
+     * @param latitude Center latitude
+     * @param longitude Center longitude
+     * @param radiusKm Radius in kilometres
+     * @return Measurement indices in storage order
+     */
+    std::vector<std::size_t> getIndicesWithinRadius(double latitude, double longitude, double radiusKm) const;
 
     // === Accessors for Columnar Data ===
     
-    const std::vector<double>& latitudes() const noexcept { return _latitudes; }
-    const std::vector<double>& longitudes() const noexcept { return _longitudes; }
-    const std::vector<std::string>& datetimes() const noexcept { return _datetimes; }
-    const std::vector<std::string>& parameters() const noexcept { return _parameters; }
-    const std::vector<double>& concentrations() const noexcept { return _concentrations; }
-    const std::vector<std::string>& units() const noexcept { return _units; }
-    const std::vector<double>& rawConcentrations() const noexcept { return _raw_concentrations; }
-    const std::vector<int>& aqis() const noexcept { return _aqis; }
-    const std::vector<int>& categories() const noexcept { return _categories; }
-    const std::vector<std::string>& siteNames() const noexcept { return _site_names; }
-    const std::vector<std::string>& agencyNames() const noexcept { return _agency_names; }
-    const std::vector<std::string>& aqsCodes() const noexcept { return _aqs_codes; }
-    const std::vector<std::string>& fullAqsCodes() const noexcept { return _full_aqs_codes; }
+    ColumnView<double> latitudes() const noexcept { return _latitudes.view(); }
+    ColumnView<double> longitudes() const noexcept { return _longitudes.view(); }
+    ColumnView<Timestamp::EpochMinutes> timestamps() const noexcept { return _timestamps.view(); }
+    ColumnView<double> concentrations() const noexcept { return _concentrations.view(); }
+    ColumnView<double> rawConcentrations() const noexcept { return _raw_concentrations.view(); }
+    ColumnView<int> aqis() const noexcept { return _aqis.view(); }
+    ColumnView<int> categories() const noexcept { return _categories.view(); }
+
+    // === Dictionary-Encoded String Columns ===
+    // xxxCodes() gives the per-measurement codes, xxxDictionary() decodes them and
+    // xxx(i) returns the decoded value of measurement i directly.
+
+    ColumnView<Code> parameterCodes() const noexcept { return _parameter_codes.view(); }
+    ColumnView<Code> unitCodes() const noexcept { return _unit_codes.view(); }
+    ColumnView<Code> siteNameCodes() const noexcept { return _site_name_codes.view(); }
+    ColumnView<Code> agencyNameCodes() const noexcept { return _agency_name_codes.view(); }
+    ColumnView<Code> aqsCodeCodes() const noexcept { return _aqs_code_codes.view(); }
+    ColumnView<Code> fullAqsCodeCodes() const noexcept { return _full_aqs_code_codes.view(); }
+
+    const StringDictionary& parameterDictionary() const noexcept { return _parameter_dict; }
+    const StringDictionary& unitDictionary() const noexcept { return _unit_dict; }
+    const StringDictionary& siteNameDictionary() const noexcept { return _site_name_dict; }
+    const StringDictionary& agencyNameDictionary() const noexcept { return _agency_name_dict; }
+    const StringDictionary& aqsCodeDictionary() const noexcept { return _aqs_code_dict; }
+    const StringDictionary& fullAqsCodeDictionary() const noexcept { return _full_aqs_code_dict; }
+
+    const std::string& parameter(std::size_t i) const noexcept { return _parameter_dict.value(_parameter_codes[i]); }
+    const std::string& unit(std::size_t i) const noexcept { return _unit_dict.value(_unit_codes[i]); }
+    const std::string& siteName(std::size_t i) const noexcept { return _site_name_dict.value(_site_name_codes[i]); }
+    const std::string& agencyName(std::size_t i) const noexcept { return _agency_name_dict.value(_agency_name_codes[i]); }
+    const std::string& aqsCode(std::size_t i) const noexcept { return _aqs_code_dict.value(_aqs_code_codes[i]); }
+    const std::string& fullAqsCode(std::size_t i) const noexcept { return _full_aqs_code_dict.value(_full_aqs_code_codes[i]); }
 
     // === Metadata and Statistics ===
     
@@ -195,34 +417,37 @@ public:
     std::size_t measurementCount() const noexcept { return _latitudes.size(); }
     
     /**
-     * @brief Get number of unique monitoring sites
-     * @return Number of unique sites
+     * @brief Get number of CSV rows rejected during loading
+     * @return Rows with too few columns or undecodable numeric fields
      */
-    std::size_t siteCount() const noexcept { return _unique_sites.size(); }
+    std::size_t rejectedRowCount() const noexcept { return _rejected_rows; }
     
     /**
-     * @brief Get all unique monitoring sites
-     * @return Set of unique site names
+     * @brief Get number of unique monitoring sites
+     * @return Number of unique sites
      */
-    const std::unordered_set<std::string>& uniqueSites() const noexcept { return _unique_sites; }
+    std::size_t siteCount() const noexcept { return _site_name_dict.size(); }
     
     /**
-     * @brief Get all unique parameters measured
-     * @return Set of unique parameter types
+     * @brief Approximate bytes held by the dictionary-encoded columns and their tables
+     * @return Code vectors plus string tables, excluding the numeric columns
      */
-    const std::unordered_set<std::string>& uniqueParameters() const noexcept { return _unique_parameters; }
+    std::size_t encodedStringBytes() const noexcept;
     
-    /**
-     * @brief Get all unique agencies
-     * @return Set of unique agency names
-     */
-    const std::unordered_set<std::string>& uniqueAgencies() const noexcept { return _unique_agencies; }
+    /// Bytes held by the site, parameter and AQS posting lists
+    std::size_t postingBytes() const noexcept;
     
     /**
      * @brief Get datetime range of all measurements
-     * @return Vector with [min_datetime, max_datetime]
+     * @return Vector with [min_datetime, max_datetime] as ISO strings (empty strings if no data)
      */
-    const std::vector<std::string>& datetimeRange() const noexcept { return _datetime_range; }
+    std::vector<std::string> datetimeRange() const;
+    
+    /// Earliest measurement time in epoch minutes (0 if no data)
+    Timestamp::EpochMinutes minTimestamp() const noexcept { return _min_timestamp; }
+    
+    /// Latest measurement time in epoch minutes (0 if no data)
+    Timestamp::EpochMinutes maxTimestamp() const noexcept { return _max_timestamp; }
     
     /**
      * @brief Get geographic bounds of all measurements
@@ -235,6 +460,30 @@ public:
                             double& min_lon, double& max_lon) const;
 
 private:
+    /**
+     * @brief Copy borrowed columns into owned vectors and release the snapshot
+     *
+     * Called by every method that writes the columns; a no-op for owned models.
+     */
+    void detachSnapshot();
+    
+    /**
+     * @brief Decode and insert every row an opened reader yields
+     * @param skipHeader Drop the first row (whole files start with a header line)
+     */
+    void readRows(CSVReader& reader, bool skipHeader);
+    
+    /**
+     * @brief Measurement indices inside a region, in storage order
+     */
+    std::vector<std::size_t> getIndicesIn(const GeoRegion& region) const;
+    
+    /**
+     * @brief Rebuild the site/parameter/AQS posting lists and the spatial index from the columns
+     * @param numThreads Team size; serial unless the model allocates from the (thread-safe) heap
+     */
+    void rebuildIndices(int numThreads);
+    
     /**
      * @brief Update indices after inserting a new measurement
      * @param index Index of the newly inserted measurement
@@ -249,10 +498,10 @@ private:
     void updateGeographicBounds(double latitude, double longitude);
     
     /**
-     * @brief Update datetime range with new datetime
-     * @param datetime New datetime string
+     * @brief Update min/max timestamps with a new measurement time
+     * @param timestamp New timestamp in epoch minutes
      */
-    void updateDatetimeRange(const std::string& datetime);
+    void updateDatetimeRange(Timestamp::EpochMinutes timestamp);
     
     /**
      * @brief Get list of all CSV files in a directory
@@ -1,9 +1,20 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
+#include "field_decoder.hpp"
+#include "ingest_manifest.hpp"
+#include "ingest_pipeline.hpp"
+#include "spatial_index.hpp"
+#include "string_dictionary.hpp"
+#include "timestamp.hpp"
 
 /**
  * @file fireRowModel.hpp
@@ -16,55 +27,76 @@
 
 /**
  * @class FireMeasurement
- * @brief Represents a single air quality measurement at a specific time and location
+ * @brief One air quality reading, stored as a fixed-size record
  * 
- * Each FireMeasurement contains all the data from one CSV row:
- * - Location (latitude, longitude)
- * - Time information
- * - Measurement details (parameter, concentration, AQI, etc.)
- * - Site and agency information
+ * Only the values that change from row to row are kept here:
+ * - Location (latitude, longitude) and time
+ * - Concentrations, AQI and category
+ * - Parameter and unit as codes into the owning FireRowModel's dictionaries
+ *   (see FireRowModel::parameterName() and unitName())
+ * - The monitor that took it, as an index into FireSiteData::monitors()
+ * 
+ * Site name, agency and AQS codes are the same for every reading of a monitor and
+ * are stored once on FireSiteData. The record is trivially copyable, so a site's
+ * readings form one flat array with no per-row heap allocations.
  */
 class FireMeasurement {
+public:
+    /// Dictionary code or monitor index
+    using Code = std::uint16_t;
+
+    /// Largest number of distinct values a Code can address
+    static constexpr std::size_t MAX_CODES = std::numeric_limits<Code>::max() + std::size_t{1};
+
 private:
-    double _latitude;                ///< Latitude coordinate
-    double _longitude;               ///< Longitude coordinate
-    std::string _datetime;           ///< DateTime string (ISO format)
-    std::string _parameter;          ///< Parameter type (PM2.5, PM10, etc.)
-    double _concentration;           ///< Measured concentration value
-    std::string _unit;               ///< Unit of measurement (UG/M3, etc.)
-    double _raw_concentration;       ///< Raw concentration value
-    int _aqi;                        ///< Air Quality Index
-    int _category;                   ///< AQI category
-    std::string _site_name;          ///< Monitoring site name
-    std::string _agency_name;        ///< Responsible agency name
-    std::string _aqs_code;           ///< AQS code (short)
-    std::string _full_aqs_code;      ///< Full AQS code
+    double _latitude{0.0};                  ///< Latitude coordinate
+    double _longitude{0.0};                 ///< Longitude coordinate
+    double _concentration{0.0};             ///< Measured concentration value
+    double _raw_concentration{0.0};         ///< Raw concentration value
+    Timestamp::EpochMinutes _timestamp{0};  ///< Measurement time (minutes since the epoch)
+    std::int32_t _aqi{0};                   ///< Air Quality Index
+    Code _parameter{0};                     ///< Parameter code (PM2.5, PM10, etc.)
+    Code _unit{0};                          ///< Unit code (UG/M3, etc.)
+    Code _monitor{0};                       ///< Index into the site's monitors
+    std::int16_t _category{0};              ///< AQI category (-999 when not reported)
 
 public:
     /// Default constructor
-    FireMeasurement();
+    FireMeasurement() = default;
     
     /// Parameterized constructor
-    FireMeasurement(double latitude, double longitude, std::string datetime,
-                   std::string parameter, double concentration, std::string unit,
-                   double raw_concentration, int aqi, int category,
-                   std::string site_name, std::string agency_name,
-                   std::string aqs_code, std::string full_aqs_code);
+    FireMeasurement(double latitude, double longitude, Timestamp::EpochMinutes timestamp,
+                    Code parameter, double concentration, Code unit,
+                    double raw_concentration, int aqi, int category, Code monitor = 0) noexcept;
 
     // Getters
-    double latitude() const noexcept;
-    double longitude() const noexcept;
-    const std::string& datetime() const noexcept;
-    const std::string& parameter() const noexcept;
-    double concentration() const noexcept;
-    const std::string& unit() const noexcept;
-    double rawConcentration() const noexcept;
-    int aqi() const noexcept;
-    int category() const noexcept;
-    const std::string& siteName() const noexcept;
-    const std::string& agencyName() const noexcept;
-    const std::string& aqsCode() const noexcept;
-    const std::string& fullAqsCode() const noexcept;
+    double latitude() const noexcept { return _latitude; }
+    double longitude() const noexcept { return _longitude; }
+    Timestamp::EpochMinutes timestamp() const noexcept { return _timestamp; }
+    std::string datetime() const;    ///< Timestamp formatted as "YYYY-MM-DDTHH:MM"
+    Code parameterCode() const noexcept { return _parameter; }
+    double concentration() const noexcept { return _concentration; }
+    Code unitCode() const noexcept { return _unit; }
+    double rawConcentration() const noexcept { return _raw_concentration; }
+    int aqi() const noexcept { return _aqi; }
+    int category() const noexcept { return _category; }
+    Code monitorIndex() const noexcept { return _monitor; }
+
+    /// Copy with the parameter, unit and monitor codes replaced (used when merging models)
+    FireMeasurement recoded(Code parameter, Code unit, Code monitor) const noexcept;
+};
+
+static_assert(std::is_trivially_copyable<FireMeasurement>::value, "FireMeasurement must stay a flat record");
+static_assert(sizeof(FireMeasurement) == 56, "FireMeasurement grew; check the field order for padding");
+
+/**
+ * @struct FireMonitor
+ * @brief Per-monitor constants shared by all readings taken by one instrument
+ */
+struct FireMonitor {
+    std::string agency_name;     ///< Responsible agency name
+    std::string aqs_code;        ///< AQS code (short)
+    std::string full_aqs_code;   ///< Full AQS code
 };
 
 /**
@@ -72,26 +104,52 @@ public:
  * @brief Represents all measurements for a specific monitoring site
  * 
  * Each FireSiteData contains:
- * - Site identifier (name or code)
+ * - Site identifier (the site name)
+ * - The monitors reporting under that name (usually one; a few names such as
+ *   "N/A" are shared by several AQS codes)
  * - Vector of all measurements taken at this site
  * 
  * This design provides efficient access to all measurements for a specific site.
+ * The vectors allocate from the owning FireRowModel's memory resource; sites in
+ * a std::pmr container pick it up automatically (uses-allocator construction).
  */
 class FireSiteData {
+public:
+    /// Allocator of the monitor and measurement vectors
+    using allocator_type = std::pmr::polymorphic_allocator<FireMeasurement>;
+
 private:
-    std::string _site_identifier;                    ///< Site identifier (name or AQS code)
-    std::vector<FireMeasurement> _measurements;      ///< All measurements for this site
+    std::string _site_identifier;                    ///< Site identifier (site name)
+    std::pmr::vector<FireMonitor> _monitors;         ///< Monitors, in first-seen order
+    std::pmr::vector<FireMeasurement> _measurements; ///< All measurements for this site
 
 public:
     /// Default constructor
     FireSiteData();
     
-    /// Parameterized constructor
-    FireSiteData(std::string site_identifier, std::vector<FireMeasurement> measurements);
+    /// Create an empty site
+    explicit FireSiteData(std::string site_identifier, const allocator_type& allocator = {});
+    
+    // Copies use the given allocator (the default resource unless a container supplies one);
+    // moves keep the source's
+    FireSiteData(const FireSiteData& other, const allocator_type& allocator = {});
+    FireSiteData(FireSiteData&& other) noexcept = default;
+    FireSiteData(FireSiteData&& other, const allocator_type& allocator);
+    FireSiteData& operator=(const FireSiteData&) = default;
+    FireSiteData& operator=(FireSiteData&&) = default;
 
     // Getters
     const std::string& siteIdentifier() const noexcept;
-    const std::vector<FireMeasurement>& measurements() const noexcept;
+    const std::pmr::vector<FireMonitor>& monitors() const noexcept;
+    const std::pmr::vector<FireMeasurement>& measurements() const noexcept;
+    
+    /// Agency and AQS codes of the site's first monitor (empty if it has none)
+    const std::string& agencyName() const noexcept;
+    const std::string& aqsCode() const noexcept;
+    const std::string& fullAqsCode() const noexcept;
+    
+    /// Monitor that took a measurement of this site
+    const FireMonitor& monitorOf(const FireMeasurement& measurement) const;
     
     /// Get specific measurement by index
     const FireMeasurement& getMeasurement(std::size_t index) const;
@@ -99,10 +157,24 @@ public:
     /// Get number of measurements for this site
     std::size_t measurementCount() const noexcept;
     
-    /// Add a new measurement to this site
+    /// Index of the monitor with these codes, adding it if it is new
+    /// (throws std::length_error past FireMeasurement::MAX_CODES monitors)
+    FireMeasurement::Code findOrAddMonitor(std::string_view agency_name, std::string_view aqs_code,
+                                           std::string_view full_aqs_code);
+    
+    /// Add a new measurement to this site (its monitor index must refer to monitors())
     void addMeasurement(const FireMeasurement& measurement);
+    
+    /// Append all of other's measurements (steals its vector when this site is empty and
+    /// no code changes). parameter_map and unit_map translate other's dictionary codes;
+    /// an empty map keeps codes as they are. Other's monitors are matched or added here
+    void appendMeasurements(FireSiteData&& other,
+                            const std::vector<FireMeasurement::Code>& parameter_map = {},
+                            const std::vector<FireMeasurement::Code>& unit_map = {});
 };
 
+class CSVReader;
+
 /**
  * @class FireRowModel
  * @brief Row-oriented fire air quality data model for efficient site-based queries
@@ -113,56 +185,105 @@ public:
  * - Per-site operations (getting all measurements for one site)
  * - Time series analysis for specific monitoring locations
  * 
+ * Measurements are fixed-size records (see FireMeasurement): parameter and unit
+ * strings are interned once per model, and site, agency and AQS strings once
+ * per site, so a reading costs 56 bytes instead of a copy of every CSV string.
+ * 
+ * Sites, their vectors and the site indices allocate from a std::pmr memory
+ * resource. Long-lived models use the default heap; short-lived ingestion models
+ * (one per file in readFromDirectoryPipelined()) use a monotonic arena that is
+ * released in one step once they are merged. Copies always use the default heap.
+ * 
  * Trade-offs:
  * + Excellent for site-specific queries and operations
  * + Good cache locality for per-site time series analysis
  * + Efficient for filtering by site characteristics
  * - Less efficient for temporal aggregations across all sites
  * - Requires site lookup for random access by location
+ * 
+ * A SpatialIndex of each site's distinct measurement locations is kept up to
+ * date on every insert and merge, so box and radius queries scan only the sites
+ * near the region.
  */
 class FireRowModel {
 private:
     // Core data storage
-    std::vector<FireSiteData> _sites;                           ///< Main data storage: one entry per site
+    std::pmr::vector<FireSiteData> _sites;                      ///< Main data storage: one entry per site
     
     // Metadata for fast access
     std::vector<std::string> _site_names;                       ///< All unique site names
-    std::vector<std::string> _parameters;                       ///< All unique parameters (PM2.5, PM10, etc.)
+    StringDictionary _parameter_dict;                           ///< Parameter code <-> name (PM2.5, PM10, etc.)
+    StringDictionary _unit_dict;                                ///< Unit code <-> name (UG/M3, etc.)
     std::vector<std::string> _agencies;                         ///< All unique agency names
-    std::vector<std::string> _datetime_range;                   ///< Date/time range [start, end]
+    Timestamp::EpochMinutes _min_timestamp, _max_timestamp;     ///< Date/time range [start, end]
     
     // Fast lookup indices
-    std::unordered_map<std::string, int> _site_name_to_index;   ///< Site name -> index mapping
-    std::unordered_map<std::string, int> _aqs_code_to_index;    ///< AQS code -> index mapping
+    std::pmr::unordered_map<std::string, int> _site_name_to_index; ///< Site name -> index mapping
+    std::pmr::unordered_map<std::string, int> _aqs_code_to_index;  ///< AQS code -> index mapping
+    std::size_t _last_site;                                     ///< Site of the previous insert (rows come grouped by site)
+    SpatialIndex _spatial;                                      ///< Site index -> distinct measurement locations
     
     // Statistics for quick access
     std::size_t _total_measurements;                            ///< Total number of measurements
+    std::size_t _rejected_rows;                                 ///< CSV rows skipped because they failed to decode
     double _min_latitude, _max_latitude;                        ///< Latitude bounds
     double _min_longitude, _max_longitude;                      ///< Longitude bounds
 
 public:
-    /// Default constructor
+    /// Default constructor (allocates from the default heap)
     FireRowModel();
     
+    /// Model whose sites and indices allocate from resource, which must outlive it
+    explicit FireRowModel(std::pmr::memory_resource* resource);
+    
     /// Destructor
     ~FireRowModel();
 
+    // Copies use the default heap. Moving into a model on another resource copies
+    // the sites and indices, so move assignment may throw
+    FireRowModel(const FireRowModel&) = default;
+    FireRowModel& operator=(const FireRowModel&) = default;
+    FireRowModel(FireRowModel&&) noexcept = default;
+    FireRowModel& operator=(FireRowModel&&) = default;
+
     // === Metadata Access Methods ===
     
     /// Get all unique site names
     const std::vector<std::string>& siteNames() const noexcept;
     
-    /// Get all unique parameters
-    const std::vector<std::string>& parameters() const noexcept;
+    /// Get all unique parameters, in code order
+    std::vector<std::string> parameters() const;
     
     /// Get all unique agencies
     const std::vector<std::string>& agencies() const noexcept;
     
-    /// Get datetime range [start, end]
-    const std::vector<std::string>& datetimeRange() const noexcept;
+    /// Get datetime range [start, end] as ISO strings (empty if no data)
+    std::vector<std::string> datetimeRange() const;
+    
+    /// Earliest measurement time in epoch minutes (0 if no data)
+    Timestamp::EpochMinutes minTimestamp() const noexcept;
+    
+    /// Latest measurement time in epoch minutes (0 if no data)
+    Timestamp::EpochMinutes maxTimestamp() const noexcept;
     
     /// Get site name to index mapping
-    const std::unordered_map<std::string, int>& siteNameToIndex() const noexcept;
+    const std::pmr::unordered_map<std::string, int>& siteNameToIndex() const noexcept;
+    
+    /// Memory resource the model allocates from
+    std::pmr::memory_resource* resource() const noexcept;
+    
+    /// Parameter and unit dictionaries (FireMeasurement::parameterCode() / unitCode() index them)
+    const StringDictionary& parameterDictionary() const noexcept { return _parameter_dict; }
+    const StringDictionary& unitDictionary() const noexcept { return _unit_dict; }
+    
+    /// Parameter name of a measurement of this model
+    const std::string& parameterName(const FireMeasurement& measurement) const noexcept;
+    
+    /// Unit name of a measurement of this model
+    const std::string& unitName(const FireMeasurement& measurement) const noexcept;
+    
+    /// Approximate bytes held by the model: records, per-site strings, dictionaries and indices
+    std::size_t memoryBytes() const noexcept;
 
     // === Data Access Methods ===
     
@@ -172,6 +293,9 @@ public:
     /// Get total number of measurements across all sites
     std::size_t totalMeasurements() const noexcept;
     
+    /// Get number of CSV rows rejected (wrong column count or undecodable numbers)
+    std::size_t rejectedRowCount() const noexcept;
+    
     /// Get specific site's data by index
     const FireSiteData& siteAt(std::size_t idx) const;
     
@@ -184,12 +308,37 @@ public:
     /// Get geographic bounds
     void getGeographicBounds(double& min_lat, double& max_lat, 
                            double& min_lon, double& max_lon) const noexcept;
+    
+    // === Time-Range Queries ===
+    
+    /// Get all measurements with begin <= timestamp < end (epoch minutes), site by site
+    std::vector<const FireMeasurement*> measurementsInTimeRange(Timestamp::EpochMinutes begin,
+                                                                Timestamp::EpochMinutes end) const;
+    
+    /// Aggregate measurements with begin <= timestamp < end into one bucket per hour
+    /// from floorToHour(begin) up to end, empty hours included
+    std::vector<HourlyBucket> hourlyBuckets(Timestamp::EpochMinutes begin, Timestamp::EpochMinutes end) const;
+
+    // === Spatial Queries ===
+    
+    /// Distinct measurement locations by site index (SpatialIndex::Match::group is a siteAt() index)
+    const SpatialIndex& spatialIndex() const noexcept { return _spatial; }
+    
+    /// Get all measurements inside box (bounds included), site by site
+    std::vector<const FireMeasurement*> measurementsInBox(const GeoBox& box) const;
+    
+    /// Get all measurements within radius_km (great-circle distance) of a point, site by site
+    std::vector<const FireMeasurement*> measurementsWithinRadius(double latitude, double longitude, double radius_km) const;
 
     // === Data Modification Methods ===
     
     /// Load data from CSV file with comprehensive error handling
     void readFromCSV(const std::string& filename);
     
+    /// Load the rows in bytes [fromByte, toByte) of a CSV file (fromByte must start a line);
+    /// throws std::runtime_error if the file cannot be opened or is shorter than toByte
+    void readFromCSV(const std::string& filename, std::size_t fromByte, std::size_t toByte);
+    
     /// Load data from multiple CSV files (for processing multiple dates/times)
     void readFromMultipleCSV(const std::vector<std::string>& filenames);
     
@@ -206,8 +355,28 @@ public:
     /// @param num_threads Number of threads to use (if <= 1, uses single thread)
     void readFromDirectoryParallel(const std::string& directory_path, int num_threads = 3);
     
-    /// Insert a new measurement (creates new site if needed)
-    void insertMeasurement(const FireMeasurement& measurement);
+    /// Load all CSV files from a directory through the streaming pipeline: one thread reads
+    /// files ahead, parse_workers decode them and the caller appends them in sorted order,
+    /// so the model matches readFromDirectory()
+    /// @return Per-stage throughput (see IngestPipeline::Report::print)
+    IngestPipeline::Report readFromDirectoryPipelined(const std::string& directory_path, int parse_workers = 3);
+    
+    /// Append only the files (or grown file tails) not yet recorded in the manifest, then
+    /// record them. Sites, metadata and bounds are extended in place. Nothing is read if
+    /// an ingested file was rewritten or removed, or the manifest describes other model
+    /// contents; the report then asks for a full reload (see IngestManifest)
+    /// @param directory_path Directory previously ingested with this manifest
+    /// @param manifest Files already in this model
+    /// @param num_threads Number of threads to use (if <= 1, parses straight into this model)
+    IngestReport readNewFiles(const std::string& directory_path, IngestManifest& manifest, int num_threads = 1);
+    
+    /// Insert a new measurement (creates new site, monitor or dictionary codes if needed);
+    /// throws std::length_error past FireMeasurement::MAX_CODES parameters or units
+    void insertMeasurement(double latitude, double longitude, Timestamp::EpochMinutes timestamp,
+                           std::string_view parameter, double concentration, std::string_view unit,
+                           double raw_concentration, int aqi, int category,
+                           std::string_view site_name, std::string_view agency_name,
+                           std::string_view aqs_code, std::string_view full_aqs_code);
     
     /// Clear all data
     void clear();
@@ -216,12 +385,29 @@ private:
     /// Helper method to update metadata when adding measurements
     void updateMetadata(const FireMeasurement& measurement);
     
-    /// Helper method to parse a vector of CSV tokens into a FireMeasurement
-    FireMeasurement parseCSVRow(const std::vector<std::string>& tokens) const;
+    /// Helper method to decode and insert every row an opened reader yields
+    void readRows(CSVReader& reader);
+    
+    /// Helper method collecting the measurements inside a region, site by site
+    std::vector<const FireMeasurement*> measurementsIn(const GeoRegion& region) const;
+    
+    /// Helper method to decode CSV field views into a record. Returns false on a malformed row
+    bool parseCSVRow(const std::vector<std::string_view>& tokens, FieldDecoder::FireRecord& out) const;
+    
+    /// Helper method to insert a decoded record
+    void insertRecord(const FieldDecoder::FireRecord& record);
+    
+    /// Helper method to intern a parameter or unit as a FireMeasurement code
+    static FireMeasurement::Code encode(StringDictionary& dictionary, std::string_view value);
     
     /// Helper method to find or create site index
-    int findOrCreateSiteIndex(const std::string& site_name, const std::string& aqs_code);
+    std::size_t findOrCreateSiteIndex(std::string_view site_name, std::string_view aqs_code);
     
-    /// Helper method to merge data from another FireRowModel instance
+    /// Helper method to merge data from another FireRowModel instance (copies, then bulk-merges)
     void mergeFromModel(const FireRowModel& other);
+    
+    /// Bulk merge that moves other's per-site measurement vectors into this model.
+    /// Site identity is resolved once per site (by name, then AQS code), so the cost
+    /// scales with the number of sites rather than the number of measurements
+    void mergeFromModel(FireRowModel&& other);
 };
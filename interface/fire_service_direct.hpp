@@ -2,6 +2,10 @@
 
 #include "fireRowModel.hpp"
 #include "fireColumnModel.hpp"
+#include "execution_context.hpp"
+#include "aggregate.hpp"
+#include "spatial_index.hpp"
+#include "column_filter.hpp"
 #include <vector>
 #include <string>
 #include <utility>
@@ -13,6 +17,9 @@
  * Simple, direct implementations without inheritance or virtual interfaces.
  * Provides 4 core operations: maxAQI, minAQI, averageAQI, topNSitesByAverageConcentration
  * Following the same pattern as PopulationModelService but for fire data.
+ * 
+ * The geographic aggregates (concentrationInBox, concentrationWithinRadius) use
+ * the models' spatial indices and scan only the measurements of sites near the region.
  */
 
 /**
@@ -25,27 +32,51 @@
 class FireRowService {
 private:
     const FireRowModel* model_;  ///< Pointer to the underlying data model
+    ExecutionContext context_;   ///< Team size, schedule and affinity for parallel operations
+
+    /// Context for loops over sites, sized by the measurements they hold
+    ExecutionContext siteContext(int numThreads) const;
+
+    /// Concentration statistics of one parameter over the measurements inside region
+    GroupAggregate concentrationIn(const std::string& parameter, const GeoRegion& region, int numThreads) const;
 
 public:
     /// Constructor
-    explicit FireRowService(const FireRowModel* model);
+    explicit FireRowService(const FireRowModel* model, ExecutionContext context = {});
     
     /// Destructor
     ~FireRowService();
 
+    /// Context used by every parallel operation; an explicit numThreads only overrides its thread count
+    const ExecutionContext& executionContext() const { return context_; }
+    
+    /// Replace the context (not synchronized with queries running concurrently)
+    void setExecutionContext(const ExecutionContext& context) { context_ = context; }
+
     // === Core Analytics Operations ===
     
     /// Find maximum AQI across all measurements
-    int maxAQI(int numThreads = 1) const;
+    int maxAQI(int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     /// Find minimum AQI across all measurements
-    int minAQI(int numThreads = 1) const;
+    int minAQI(int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     /// Calculate average AQI across all measurements
-    double averageAQI(int numThreads = 1) const;
+    double averageAQI(int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     /// Find top N sites by average concentration
-    std::vector<std::pair<std::string, double>> topNSitesByAverageConcentration(std::size_t n, int numThreads = 1) const;
+    std::vector<std::pair<std::string, double>> topNSitesByAverageConcentration(std::size_t n, int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// Average concentration per parameter (PM2.5, OZONE, ...), sorted by parameter name
+    std::vector<std::pair<std::string, double>> averageConcentrationByParameter(int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// Concentration statistics of one parameter over the measurements inside box (count 0 if none)
+    GroupAggregate concentrationInBox(const std::string& parameter, const GeoBox& box,
+                                      int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// Concentration statistics of one parameter within radiusKm (great-circle) of a point (count 0 if none)
+    GroupAggregate concentrationWithinRadius(const std::string& parameter, double latitude, double longitude,
+                                             double radiusKm, int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     // === Metadata Operations ===
     
@@ -69,27 +100,60 @@ public:
 class FireColumnService {
 private:
     const FireColumnModel* model_;  ///< Pointer to the underlying data model
+    ExecutionContext context_;   ///< Team size, schedule and affinity for parallel operations
+
+    /// Concentration statistics of one parameter over the measurements inside region
+    GroupAggregate concentrationIn(const std::string& parameter, const GeoRegion& region, int numThreads) const;
 
 public:
     /// Constructor
-    explicit FireColumnService(const FireColumnModel* model);
+    explicit FireColumnService(const FireColumnModel* model, ExecutionContext context = {});
     
     /// Destructor
     ~FireColumnService();
 
+    /// Context used by every parallel operation; an explicit numThreads only overrides its thread count
+    const ExecutionContext& executionContext() const { return context_; }
+    
+    /// Replace the context (not synchronized with queries running concurrently)
+    void setExecutionContext(const ExecutionContext& context) { context_ = context; }
+
     // === Core Analytics Operations ===
     
     /// Find maximum AQI across all measurements
-    int maxAQI(int numThreads = 1) const;
+    int maxAQI(int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     /// Find minimum AQI across all measurements
-    int minAQI(int numThreads = 1) const;
+    int minAQI(int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     /// Calculate average AQI across all measurements
-    double averageAQI(int numThreads = 1) const;
+    double averageAQI(int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     /// Find top N sites by average concentration
-    std::vector<std::pair<std::string, double>> topNSitesByAverageConcentration(std::size_t n, int numThreads = 1) const;
+    std::vector<std::pair<std::string, double>> topNSitesByAverageConcentration(std::size_t n, int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// Average concentration per parameter (PM2.5, OZONE, ...), sorted by parameter name
+    std::vector<std::pair<std::string, double>> averageConcentrationByParameter(int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// Concentration statistics of one parameter over the measurements inside box (count 0 if none)
+    GroupAggregate concentrationInBox(const std::string& parameter, const GeoBox& box,
+                                      int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// Concentration statistics of one parameter within radiusKm (great-circle) of a point (count 0 if none)
+    GroupAggregate concentrationWithinRadius(const std::string& parameter, double latitude, double longitude,
+                                             double radiusKm, int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /**
+     * @brief Concentration statistics over the measurements passing filter
+     * @throws std::invalid_argument if filter is not over this model's measurementCount() rows
+     *
+     * Build the filter from the model's columns, e.g. AQI > 150 within a time
+     * range for PM2.5 only.
+     */
+    GroupAggregate concentrationWhere(const ColumnFilter::Filter& filter, int numThreads = ExecutionContext::USE_CONTEXT) const;
+    
+    /// AQI statistics over the measurements passing filter
+    GroupAggregate aqiWhere(const ColumnFilter::Filter& filter, int numThreads = ExecutionContext::USE_CONTEXT) const;
     
     // === Metadata Operations ===
     
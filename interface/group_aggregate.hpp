@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "aggregate.hpp"
+
+/**
+ * @file group_aggregate.hpp
+ * @brief Lock-free parallel group-by aggregation
+ *
+ * Aggregates a measure per group key with thread-local partial aggregates and a
+ * partitioned merge: every thread first accumulates its share of the input into
+ * private tables, then each thread merges one disjoint slice of the key space
+ * from all partials. No locks or critical sections are taken at any point.
+ *
+ * The input is described by a body callable `body(i, emit)` invoked once for
+ * every item i in [0, n); it calls `emit(key, value)` zero or more times. This
+ * lets row-oriented models emit every measurement of a site and column-oriented
+ * models emit one value per row through the same engine.
+ *
+ * The templates must be instantiated in a translation unit compiled with OpenMP
+ * (the core library); otherwise they run on a single thread.
+ */
+
+namespace GroupBy {
+    /**
+     * @brief Aggregate over dense integer keys in [0, keyCount)
+     * @param n Number of items passed to body
+     * @param keyCount Number of distinct keys (e.g. a StringDictionary size)
+     * @param numThreads Threads to use (<= 1 runs serially)
+     * @param body Callable body(i, emit) with emit(std::size_t key, double value)
+     * @return One aggregate per key; keys never emitted have count 0
+     *
+     * Each thread fills a private keyCount-sized array, then the key range is
+     * split across threads and every thread sums its slice from all arrays.
+     */
+    template <typename Body>
+    std::vector<GroupAggregate> dense(std::size_t n, std::size_t keyCount, int numThreads, Body body) {
+        std::vector<GroupAggregate> result(keyCount);
+        if (numThreads <= 1) {
+            auto emit = [&result](std::size_t key, double value) { result[key].add(value); };
+            for (std::size_t i = 0; i < n; ++i) body(i, emit);
+            return result;
+        }
+
+        std::vector<std::vector<GroupAggregate>> partials(static_cast<std::size_t>(numThreads));
+#pragma omp parallel num_threads(numThreads)
+        {
+            const std::size_t tid = static_cast<std::size_t>(omp_get_thread_num());
+            std::vector<GroupAggregate>& local = partials[tid];
+            local.resize(keyCount);
+            auto emit = [&local](std::size_t key, double value) { local[key].add(value); };
+
+#pragma omp for schedule(static)
+            for (std::size_t i = 0; i < n; ++i) body(i, emit);
+
+            // Implicit barrier above: every partial is complete. Each key is owned by one thread.
+            const std::size_t threads = static_cast<std::size_t>(omp_get_num_threads());
+#pragma omp for schedule(static)
+            for (std::size_t key = 0; key < keyCount; ++key) {
+                for (std::size_t t = 0; t < threads; ++t) result[key].merge(partials[t][key]);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Aggregate over arbitrary hashable keys
+     * @param n Number of items passed to body
+     * @param numThreads Threads to use (<= 1 runs serially)
+     * @param body Callable body(i, emit) with emit(const Key& key, double value)
+     * @return (key, aggregate) pairs in unspecified order
+     *
+     * Each thread keeps one hash map per partition, chosen by a mixed hash of the
+     * key. After the accumulation pass, thread p merges partition p from every
+     * thread, so no two threads ever write the same map. Keys are copied into the
+     * maps; use std::string_view keys to group by strings owned by a model.
+     */
+    template <typename Key, typename Body, typename Hash = std::hash<Key>>
+    std::vector<std::pair<Key, GroupAggregate>> hashed(std::size_t n, int numThreads, Body body) {
+        using Map = std::unordered_map<Key, GroupAggregate, Hash>;
+        std::vector<std::pair<Key, GroupAggregate>> result;
+
+        if (numThreads <= 1) {
+            Map map;
+            auto emit = [&map](const Key& key, double value) { map[key].add(value); };
+            for (std::size_t i = 0; i < n; ++i) body(i, emit);
+            result.assign(map.begin(), map.end());
+            return result;
+        }
+
+        const std::size_t parts = static_cast<std::size_t>(numThreads);
+        // partials[t * parts + p] holds thread t's keys that fall in partition p
+        std::vector<Map> partials(parts * parts);
+        std::vector<Map> merged(parts);
+
+#pragma omp parallel num_threads(numThreads)
+        {
+            const std::size_t tid = static_cast<std::size_t>(omp_get_thread_num());
+            Map* local = &partials[tid * parts];
+            Hash hash;
+            auto emit = [local, &hash, parts](const Key& key, double value) {
+                // Fibonacci mix so the partition choice is independent of the maps' bucket choice
+                std::uint64_t h = static_cast<std::uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ULL;
+                local[(h >> 32) % parts][key].add(value);
+            };
+
+#pragma omp for schedule(static)
+            for (std::size_t i = 0; i < n; ++i) body(i, emit);
+
+            const std::size_t threads = static_cast<std::size_t>(omp_get_num_threads());
+#pragma omp for schedule(static, 1)
+            for (std::size_t p = 0; p < parts; ++p) {
+                Map& out = merged[p];
+                for (std::size_t t = 0; t < threads; ++t) {
+                    for (const auto& entry : partials[t * parts + p]) out[entry.first].merge(entry.second);
+                }
+            }
+        }
+
+        std::size_t total = 0;
+        for (const auto& map : merged) total += map.size();
+        result.reserve(total);
+        for (const auto& map : merged) result.insert(result.end(), map.begin(), map.end());
+        return result;
+    }
+}
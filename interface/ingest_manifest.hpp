@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file ingest_manifest.hpp
+ * @brief Record of the CSV files already loaded into a model, for incremental ingestion
+ *
+ * The fire feed only ever adds files (one hourly CSV under a YYYYMMDD/ folder) or
+ * appends lines to the newest one. An IngestManifest remembers, per file, the
+ * size, modification time and content hash that were ingested, so a later
+ * plan() over the same directory finds just the new files and the appended tails
+ * of grown ones. The models' readNewFiles() parse only those and append them in
+ * place (see FireColumnModel and FireRowModel).
+ *
+ * A file whose old bytes changed, or that disappeared, cannot be applied as an
+ * append: its previously ingested rows would have to be removed first. plan()
+ * reports such files and leaves them alone; the caller reloads from scratch.
+ */
+
+/// State of one ingested file
+struct IngestedFile {
+    std::uint64_t size{0};    ///< Bytes ingested (always whole lines)
+    std::int64_t mtime{0};    ///< Modification time (file_time_type ticks) when ingested
+    std::uint64_t hash{0};    ///< Snapshot::checksum() of the first size bytes
+};
+
+/**
+ * @struct IngestPlan
+ * @brief What an incremental ingestion of a directory has to do
+ */
+struct IngestPlan {
+    /// One file (or file tail) to parse
+    struct Task {
+        std::string path;          ///< Path to open
+        std::string key;           ///< Manifest key (path relative to the directory)
+        std::uint64_t fromByte{0}; ///< 0 for a new file, else the previously ingested size
+        IngestedFile state;        ///< Manifest entry to record once parsed
+    };
+
+    std::vector<Task> tasks;                 ///< New and grown files, in path order
+    std::size_t unchangedFiles{0};           ///< Files skipped because no complete line was added
+    std::vector<std::string> rewrittenFiles; ///< Ingested files whose old bytes changed
+    std::vector<std::string> removedFiles;   ///< Ingested files no longer in the directory
+
+    std::size_t newFiles() const noexcept;
+    std::size_t grownFiles() const noexcept;
+
+    /// True if the model no longer matches the directory and must be reloaded
+    bool requiresFullReload() const noexcept { return !rewrittenFiles.empty() || !removedFiles.empty(); }
+};
+
+/**
+ * @struct IngestReport
+ * @brief Outcome of a model's readNewFiles()
+ */
+struct IngestReport {
+    IngestPlan plan;                    ///< What was found (tasks are the parsed files)
+    std::size_t measurementsAdded{0};   ///< Rows appended to the model
+    std::size_t failedFiles{0};         ///< Tasks that could not be read (retried next time)
+    bool modelMismatch{false};          ///< The manifest was recorded against other model contents
+
+    /// True if nothing was appended because the model must be reloaded from scratch
+    bool requiresFullReload() const noexcept { return modelMismatch || plan.requiresFullReload(); }
+};
+
+/**
+ * @class IngestManifest
+ * @brief Files already ingested from one directory into one model
+ *
+ * Keys are paths relative to the ingested directory, so a saved manifest stays
+ * valid when the directory is reached through another path.
+ */
+class IngestManifest {
+public:
+    /**
+     * @brief Compare a directory's .csv files with the manifest
+     * @param directoryPath Directory scanned recursively, as by readFromDirectory()
+     * @throws std::runtime_error if the directory cannot be read
+     *
+     * Files whose size and mtime match the manifest are skipped without reading
+     * them. Any other known file is hashed: the same bytes (a touch) are counted
+     * as unchanged, a larger file whose first size bytes hash as recorded and end
+     * in a newline becomes a tail task, and anything else is reported as
+     * rewritten. New files are hashed when planned.
+     *
+     * Tasks end after the file's last newline. A trailing line that is still
+     * being written is neither parsed nor hashed; it is picked up once a later
+     * plan() sees it completed. A file with no complete line is left out
+     * entirely (counted as unchanged).
+     */
+    IngestPlan plan(const std::string& directoryPath) const;
+
+    /// Record a parsed task (its state at plan time)
+    void record(const IngestPlan::Task& task);
+
+    /// Entry for a key, or nullptr if the file was never ingested
+    const IngestedFile* find(const std::string& key) const;
+
+    std::size_t size() const noexcept { return _files.size(); }
+    bool empty() const noexcept { return _files.empty(); }
+    void clear() noexcept { _files.clear(); _measurementCount = 0; }
+
+    /// Measurements the model held after the last readNewFiles(), to detect a mismatched pairing
+    std::size_t measurementCount() const noexcept { return _measurementCount; }
+    void setMeasurementCount(std::size_t count) noexcept { _measurementCount = count; }
+
+    /**
+     * @brief Write the manifest as text (written to path.tmp, then renamed)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Replace the manifest with one written by save()
+     * @throws std::runtime_error if the file is missing or malformed
+     */
+    void load(const std::string& path);
+
+private:
+    std::map<std::string, IngestedFile> _files;
+    std::size_t _measurementCount{0};
+};
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bounded_queue.hpp"
+
+/**
+ * @file ingest_pipeline.hpp
+ * @brief Streaming CSV loader: read, parse and append stages linked by bounded queues
+ *
+ * readFromDirectoryParallel() has each thread read a file, parse it and insert it
+ * in turn, so disk I/O and parsing never overlap. run() splits that work into
+ * stages on their own threads:
+ *
+ * ```
+ * read (1 thread) --BoundedQueue<FileBuffer>--> parse (N workers) --BoundedQueue<Parsed>--> append (caller)
+ * ```
+ *
+ * The read stage prefetches whole files into buffers, the parse workers turn a
+ * buffer into a typed batch (the fire models use a small model of their own
+ * type, so string interning and index building happen on the workers), and the
+ * append stage merges batches into the model in file order. Both queues are lock-free and bounded, and the read stage never
+ * runs more than Options::maxInFlight files ahead of the append stage, so memory
+ * stays bounded however fast the disk is. Every stage records its busy and wait
+ * time; Report::print() shows which one limits throughput.
+ *
+ * Batches are built on one thread and destroyed on another right after they
+ * are appended. ArenaBatch gives each one a private arena so that churn is a
+ * few block allocations instead of thousands of cross-thread malloc/free pairs.
+ */
+
+namespace IngestPipeline {
+
+    /// Stage sizing
+    struct Options {
+        int parseWorkers{2};            ///< Parse threads (at least 1)
+        std::size_t queueCapacity{8};   ///< Slots in each queue
+        std::size_t maxInFlight{32};    ///< Files read but not yet appended
+    };
+
+    /// Work and timing of one stage, summed over its threads
+    struct StageStats {
+        const char* name{""};
+        int threads{1};
+        std::size_t files{0};
+        std::size_t bytes{0};
+        std::size_t rows{0};
+        double busySeconds{0.0};   ///< Reading, parsing or appending
+        double waitSeconds{0.0};   ///< Blocked on an empty input or full output queue
+
+        /// Share of the stage's thread time spent working
+        double utilization(double wallSeconds) const;
+
+        /// Input MB per second the stage sustains while all its threads are busy
+        double megabytesPerSecond() const;
+
+        void add(const StageStats& other);
+    };
+
+    /// Outcome of run()
+    struct Report {
+        StageStats read{"read"};
+        StageStats parse{"parse"};
+        StageStats append{"append"};
+        double wallSeconds{0.0};
+        std::size_t files{0};
+        std::size_t failedFiles{0};   ///< Files that could not be read or parsed (skipped)
+
+        /// The stage with the highest utilization
+        const StageStats& bottleneck() const;
+
+        /// Print the per-stage throughput table
+        void print(std::ostream& out) const;
+    };
+
+    /// A file's bytes as handed from the read stage to a parse worker
+    struct FileBuffer {
+        std::size_t index{0};      ///< Position in the file list
+        std::string path;
+        std::vector<char> bytes;
+        std::string error;         ///< Set if the file could not be read
+    };
+
+    /// Read a whole file (throws std::runtime_error on failure)
+    std::vector<char> readFile(const std::string& path);
+
+    /**
+     * @struct ArenaBatch
+     * @brief A batch model that allocates from its own monotonic arena
+     *
+     * The model's small allocations (sites, index nodes, short vectors) are
+     * carved from a few large blocks and released together when the batch is
+     * destroyed; nothing is freed individually. Pass batches through run() as
+     * std::unique_ptr<ArenaBatch<Model>> so the queues move a pointer. Model needs
+     * a constructor taking a std::pmr::memory_resource*, and appending it to a
+     * heap-backed model must copy rather than adopt its containers.
+     */
+    template <typename Model>
+    struct ArenaBatch {
+        /// initialBytes sizes the first block (e.g. the file size); later blocks grow geometrically
+        explicit ArenaBatch(std::size_t initialBytes) : arena(std::max<std::size_t>(initialBytes, 1)), model(&arena) {}
+
+        std::pmr::monotonic_buffer_resource arena;
+        Model model;
+    };
+
+    /**
+     * @brief Stream files through the read, parse and append stages
+     * @param files Files to load; batches are appended in this order
+     * @param options Stage sizing
+     * @param parse std::size_t(FileBuffer&&, Batch&): decode a buffer, return its row count
+     * @param append void(Batch&&): write a batch into the model (runs on the calling thread)
+     * @return Per-stage statistics
+     *
+     * A file that cannot be read, or whose parse throws, is reported on std::cerr,
+     * counted in failedFiles and skipped. An exception from append() stops further
+     * appends and is rethrown once the stages have finished.
+     */
+    template <typename Batch, typename Parse, typename Append>
+    Report run(const std::vector<std::string>& files, const Options& options, Parse parse, Append append);
+
+    namespace detail {
+        using Clock = std::chrono::steady_clock;
+
+        inline double secondsSince(Clock::time_point start) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        /**
+         * @class Doorbell
+         * @brief Lets a stage sleep while its queue is empty or full
+         *
+         * The queues themselves never block; a stage that cannot make progress
+         * spins briefly, then parks on a condition variable until another stage
+         * rings after changing queue state. ring() costs one fence and one load
+         * when nobody is parked. Parking also times out, as a backstop.
+         */
+        class Doorbell {
+        public:
+            /// Retry ready() until it returns true, adding the time it took to waitSeconds
+            template <typename Ready>
+            void wait(Ready ready, double& waitSeconds) {
+                if (ready()) return;
+                const auto start = Clock::now();
+                for (int spins = 0; spins < 16; ++spins) {
+                    std::this_thread::yield();
+                    if (ready()) {
+                        waitSeconds += secondsSince(start);
+                        return;
+                    }
+                }
+                std::unique_lock<std::mutex> lock(_mutex);
+                _parked.fetch_add(1);
+                while (!ready()) _bell.wait_for(lock, std::chrono::milliseconds(1));
+                _parked.fetch_sub(1);
+                waitSeconds += secondsSince(start);
+            }
+
+            /// Wake parked stages after a push, pop or counter update
+            void ring() {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (_parked.load(std::memory_order_relaxed) == 0) return;
+                std::lock_guard<std::mutex> lock(_mutex);
+                _bell.notify_all();
+            }
+
+        private:
+            std::mutex _mutex;
+            std::condition_variable _bell;
+            std::atomic<int> _parked{0};
+        };
+    }
+
+    template <typename Batch, typename Parse, typename Append>
+    Report run(const std::vector<std::string>& files, const Options& options, Parse parse, Append append) {
+        using detail::Clock;
+        using detail::secondsSince;
+
+        struct Parsed {
+            std::size_t index{0};
+            std::string path;
+            std::size_t bytes{0};
+            std::size_t rows{0};
+            std::string error;
+            Batch batch{};
+        };
+
+        const int workers = std::max(1, options.parseWorkers);
+        const std::size_t maxInFlight = std::max<std::size_t>(1, options.maxInFlight);
+        BoundedQueue<FileBuffer> readQueue(options.queueCapacity);
+        BoundedQueue<Parsed> parsedQueue(options.queueCapacity);
+        std::atomic<std::size_t> appended{0};
+        std::atomic<bool> readDone{false};
+        detail::Doorbell doorbell;
+
+        Report report;
+        report.files = files.size();
+        report.parse.threads = workers;
+        std::vector<StageStats> parseStats(static_cast<std::size_t>(workers));
+        const auto started = Clock::now();
+
+        std::thread reader([&] {
+            StageStats& stats = report.read;
+            for (std::size_t i = 0; i < files.size(); ++i) {
+                doorbell.wait([&] { return i - appended.load(std::memory_order_acquire) < maxInFlight; }, stats.waitSeconds);
+                FileBuffer buffer;
+                buffer.index = i;
+                buffer.path = files[i];
+                const auto start = Clock::now();
+                try {
+                    buffer.bytes = readFile(files[i]);
+                } catch (const std::exception& e) {
+                    buffer.error = e.what();
+                }
+                stats.busySeconds += secondsSince(start);
+                stats.bytes += buffer.bytes.size();
+                ++stats.files;
+                doorbell.wait([&] { return readQueue.tryPush(buffer); }, stats.waitSeconds);
+                doorbell.ring();
+            }
+            readDone.store(true, std::memory_order_release);
+            doorbell.ring();
+        });
+
+        std::vector<std::thread> parsers;
+        for (int w = 0; w < workers; ++w) {
+            parsers.emplace_back([&, w] {
+                StageStats& stats = parseStats[static_cast<std::size_t>(w)];
+                FileBuffer buffer;
+                for (;;) {
+                    bool popped = false;
+                    doorbell.wait([&] {
+                        popped = readQueue.tryPop(buffer);
+                        return popped || readDone.load(std::memory_order_acquire);
+                    }, stats.waitSeconds);
+                    // Everything was pushed before readDone was set, so one more pop drains the queue
+                    if (!popped && !readQueue.tryPop(buffer)) break;
+                    doorbell.ring();
+
+                    Parsed parsed;
+                    parsed.index = buffer.index;
+                    parsed.path = buffer.path;
+                    parsed.bytes = buffer.bytes.size();
+                    parsed.error = std::move(buffer.error);
+                    if (parsed.error.empty()) {
+                        const auto start = Clock::now();
+                        try {
+                            parsed.rows = parse(std::move(buffer), parsed.batch);
+                        } catch (const std::exception& e) {
+                            parsed.error = e.what();
+                            parsed.batch = Batch{};
+                            parsed.rows = 0;
+                        }
+                        stats.busySeconds += secondsSince(start);
+                        stats.bytes += parsed.bytes;
+                        stats.rows += parsed.rows;
+                        ++stats.files;
+                    }
+                    buffer = FileBuffer{};
+                    doorbell.wait([&] { return parsedQueue.tryPush(parsed); }, stats.waitSeconds);
+                    doorbell.ring();
+                }
+            });
+        }
+
+        // Append stage: batches arrive in any order and are applied in file order
+        StageStats& stats = report.append;
+        std::map<std::size_t, Parsed> pending;
+        std::size_t next = 0;
+        std::exception_ptr failure;
+        Parsed parsed;
+        while (next < files.size()) {
+            doorbell.wait([&] { return parsedQueue.tryPop(parsed); }, stats.waitSeconds);
+            doorbell.ring();
+            const std::size_t index = parsed.index;
+            pending.emplace(index, std::move(parsed));
+            for (auto it = pending.find(next); it != pending.end(); it = pending.find(next)) {
+                Parsed& ready = it->second;
+                if (!ready.error.empty()) {
+                    std::cerr << "Error processing " << ready.path << ": " << ready.error << std::endl;
+                    ++report.failedFiles;
+                } else if (!failure) {
+                    const auto start = Clock::now();
+                    try {
+                        append(std::move(ready.batch));
+                    } catch (...) {
+                        failure = std::current_exception();   // keep draining so the stages can finish
+                    }
+                    stats.busySeconds += secondsSince(start);
+                    stats.bytes += ready.bytes;
+                    stats.rows += ready.rows;
+                    ++stats.files;
+                }
+                pending.erase(it);
+                appended.store(++next, std::memory_order_release);
+                doorbell.ring();
+            }
+        }
+
+        reader.join();
+        for (auto& parser : parsers) parser.join();
+        for (const auto& workerStats : parseStats) report.parse.add(workerStats);
+        report.wallSeconds = secondsSince(started);
+        if (failure) std::rethrow_exception(failure);
+        return report;
+    }
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @file json_line.hpp
+ * @brief Minimal reader and writer for line-delimited JSON messages
+ *
+ * The query protocol exchanges one object per line. Top-level values that are
+ * strings, numbers, booleans or null are decoded; nested objects and arrays are
+ * checked for well-formedness and kept as their raw JSON text, which can be
+ * parsed again if needed. Responses are built field by field. This is
+ * deliberately not a general JSON library.
+ */
+
+namespace JsonLine {
+
+    /**
+     * @class Object
+     * @brief A parsed JSON object (one level)
+     *
+     * Strings are stored unescaped; numbers, booleans, null and nested values keep
+     * their literal text and are converted on access.
+     */
+    class Object {
+    public:
+        /// True if the key is present (with any value, including null)
+        bool has(const std::string& key) const { return _fields.count(key) > 0; }
+
+        /// String value, or nullopt if absent or not a string
+        std::optional<std::string> getString(const std::string& key) const;
+
+        /// Integer value, or nullopt if absent or not an integral number
+        std::optional<long long> getInt(const std::string& key) const;
+
+        /// Numeric value, or nullopt if absent or not a number
+        std::optional<double> getDouble(const std::string& key) const;
+
+        /// Literal JSON text of the value (strings re-quoted), or nullopt if absent
+        std::optional<std::string> getRaw(const std::string& key) const;
+
+        /// Number of fields
+        std::size_t size() const noexcept { return _fields.size(); }
+
+    private:
+        friend std::optional<Object> parse(std::string_view line, std::string* error);
+
+        struct Value {
+            std::string text;
+            bool isString{false};
+        };
+        std::unordered_map<std::string, Value> _fields;
+    };
+
+    /**
+     * @brief Parse one JSON object
+     * @param line Text of the object (surrounding whitespace allowed)
+     * @param error Receives a short description on failure (may be null)
+     * @return The object, or nullopt if the text is not a single JSON object
+     */
+    std::optional<Object> parse(std::string_view line, std::string* error = nullptr);
+
+    /// Quote and escape a string as a JSON string literal
+    std::string quote(std::string_view text);
+
+    /**
+     * @class Writer
+     * @brief Appends fields to a single-line JSON object
+     *
+     * Values passed to raw() must already be valid JSON (e.g. an array built
+     * with another Writer or by hand).
+     */
+    class Writer {
+    public:
+        Writer& field(std::string_view key, std::string_view value);
+        Writer& field(std::string_view key, const char* value) { return field(key, std::string_view(value)); }
+        Writer& field(std::string_view key, long long value);
+        Writer& field(std::string_view key, int value) { return field(key, static_cast<long long>(value)); }
+        Writer& field(std::string_view key, std::size_t value);
+        Writer& field(std::string_view key, double value);
+        Writer& field(std::string_view key, bool value);
+        Writer& raw(std::string_view key, std::string_view json);
+
+        /// The finished object, without a trailing newline
+        std::string str() const { return _out + "}"; }
+
+    private:
+        void key(std::string_view name);
+        std::string _out{"{"};
+    };
+
+    /// Format a double as a JSON number (finite values only; NaN/inf become null)
+    std::string number(double value);
+
+}
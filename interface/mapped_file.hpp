@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory-mapped file wrapper
+ *
+ * Maps a whole file into the address space so that parsers can hand out
+ * std::string_view spans into the file contents instead of copying every
+ * byte through an std::ifstream buffer.
+ */
+
+/**
+ * @class MappedFile
+ * @brief RAII owner of a read-only file mapping
+ *
+ * The mapping stays valid for the lifetime of the object (or until close()).
+ * Empty files are "open" with a null data pointer and size 0.
+ */
+class MappedFile {
+public:
+    /// Expected access pattern, passed to the kernel as a paging hint
+    enum class Access {
+        Sequential,  ///< One front-to-back pass (CSV parsing): aggressive read-ahead
+        Normal       ///< Repeated or random reads (snapshot columns): default paging
+    };
+
+    /// Default constructor - creates an unopened mapping
+    MappedFile() = default;
+
+    /// Map the given file (throws std::runtime_error on failure)
+    explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Unmaps the file if still mapped
+    ~MappedFile();
+
+    /// Map the given file, releasing any previous mapping first
+    void open(const std::string& path, Access access = Access::Sequential);
+
+    /// Release the mapping (safe to call repeatedly)
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return _open; }
+    const char* data() const noexcept { return _data; }
+    std::size_t size() const noexcept { return _size; }
+    std::string_view view() const noexcept { return std::string_view(_data, _size); }
+
+private:
+    const char* _data{nullptr};  ///< Start of the mapped bytes (nullptr for empty files)
+    std::size_t _size{0};        ///< Number of mapped bytes
+    bool _open{false};           ///< True once open() succeeded
+    bool _heap{false};           ///< True when the fallback heap copy is used instead of mmap
+};
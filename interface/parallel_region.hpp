@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <omp.h>
+#include "execution_context.hpp"
+
+/**
+ * @file parallel_region.hpp
+ * @brief Parallel regions and loops driven by an ExecutionContext
+ *
+ * Every region gets its team size from a num_threads clause and its affinity
+ * from a proc_bind clause. Each implicit task then sets its own run-sched-var,
+ * so `schedule(runtime)` loops inside the region follow the context. None of
+ * this touches the process-wide OpenMP defaults, and nothing outlives the region.
+ *
+ * Like group_aggregate.hpp, these templates must be instantiated in a translation
+ * unit compiled with OpenMP (the core library); otherwise they run serially.
+ */
+
+namespace Parallel {
+    namespace detail {
+        inline void applySchedule(const ExecutionContext& context) {
+            omp_sched_t kind = omp_sched_static;
+            if (context.schedule == ExecutionContext::Schedule::Dynamic) kind = omp_sched_dynamic;
+            else if (context.schedule == ExecutionContext::Schedule::Guided) kind = omp_sched_guided;
+            omp_set_schedule(kind, context.chunk);
+        }
+    }
+
+    /**
+     * @brief Run body() once per thread of a team sized for `items` work items
+     * @return Team size used; 1 means body ran inline on the calling thread
+     *
+     * Work-sharing loops inside body should use `#pragma omp for schedule(runtime)`.
+     */
+    template <typename Body>
+    int region(const ExecutionContext& context, std::size_t items, Body body) {
+        const int team = context.teamSize(items);
+        if (team <= 1) {
+            body();
+            return 1;
+        }
+        switch (context.affinity) {
+            case ExecutionContext::Affinity::Close:
+#pragma omp parallel num_threads(team) proc_bind(close)
+                { detail::applySchedule(context); body(); }
+                break;
+            case ExecutionContext::Affinity::Spread:
+#pragma omp parallel num_threads(team) proc_bind(spread)
+                { detail::applySchedule(context); body(); }
+                break;
+            default:
+#pragma omp parallel num_threads(team)
+                { detail::applySchedule(context); body(); }
+                break;
+        }
+        return team;
+    }
+
+    /**
+     * @brief Call body(i) for every i in [0, n) using the context's schedule
+     */
+    template <typename Body>
+    void forEach(const ExecutionContext& context, std::size_t n, Body body) {
+        region(context, n, [&]() {
+#pragma omp for schedule(runtime)
+            for (std::size_t i = 0; i < n; ++i) body(i);
+        });
+    }
+
+    /**
+     * @brief Reduce items [0, n) into one Partial
+     * @param identity Starting value of every thread's partial
+     * @param body Callable body(i, Partial& local) folding item i into local
+     * @param combine Callable combine(Partial& into, const Partial& from)
+     *
+     * Thread partials are combined in thread order on the calling thread, so
+     * order-sensitive results (e.g. first index on ties) match a serial run.
+     */
+    template <typename Partial, typename Body, typename Combine>
+    Partial reduce(const ExecutionContext& context, std::size_t n, const Partial& identity, Body body, Combine combine) {
+        const int team = context.teamSize(n);
+        if (team <= 1) {
+            Partial result = identity;
+            for (std::size_t i = 0; i < n; ++i) body(i, result);
+            return result;
+        }
+        std::vector<Partial> partials(static_cast<std::size_t>(team), identity);
+        region(context, n, [&]() {
+            Partial& local = partials[static_cast<std::size_t>(omp_get_thread_num())];
+#pragma omp for schedule(runtime)
+            for (std::size_t i = 0; i < n; ++i) body(i, local);
+        });
+        Partial result = identity;
+        for (const Partial& partial : partials) combine(result, partial);
+        return result;
+    }
+}
@@ -1,48 +1,52 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "population_matrix.hpp"
+#include "population_range_index.hpp"
 
 /**
  * @file populationModel.hpp
  * @brief Row-oriented population data model for efficient per-country operations
  * 
  * This file defines the row-oriented data model where each country's data is stored
- * as a contiguous vector of population values across years. This layout is optimal
+ * as a contiguous run of population values across years. This layout is optimal
  * for operations that need to access all years for a specific country.
  */
 
 /**
  * @class PopulationRow
- * @brief Represents one country's population values across a sequence of years
+ * @brief Lightweight view of one country's population values across a sequence of years
  * 
  * Each PopulationRow contains:
- * - Country name (string identifier)
- * - Vector of population values indexed by year position
+ * - Country name (reference into the model)
+ * - Non-owning span over the country's values in the model's PopulationMatrix
  * 
+ * Rows are handed out by value and stay valid until the model is modified.
  * This design provides O(1) access to population data for a specific country-year
  * combination once the row is located.
  */
 class PopulationRow {
 private:
-    std::string _country;                    ///< Country name identifier
-    std::vector<long long> _year_population; ///< Population values by year index
+    const std::string* _country;             ///< Country name identifier (owned by the model)
+    PopulationSpan _year_population;         ///< Population values by year index
 
 public:
     /// Default constructor - creates empty row
     PopulationRow();
     
-    /// Parameterized constructor with move semantics for efficiency
-    PopulationRow(std::string country, std::vector<long long> year_population);
+    /// View constructor used by PopulationModel
+    PopulationRow(const std::string& country, PopulationSpan year_population);
 
     // Getters
     /// Get country name (const reference to avoid copying)
     const std::string& country() const noexcept;
     
-    /// Get all population data (const reference to avoid copying)
-    const std::vector<long long>& yearPopulation() const noexcept;
+    /// Get all population data (view into the model's matrix)
+    PopulationSpan yearPopulation() const noexcept;
     
     /// Get population for specific year index (bounds checking in implementation)
     long long getPopulationForYear(std::size_t yearIndex) const;
@@ -55,9 +59,9 @@ public:
  * @class PopulationModel
  * @brief Row-oriented population data model for efficient country-based queries
  * 
- * This model stores data as a vector of PopulationRow objects, where each row
- * contains all population data for one country across all years. This layout
- * provides excellent cache locality for:
+ * This model stores all values in one aligned countries x years PopulationMatrix
+ * (row-major by default), so each country's years are contiguous and there is
+ * no per-country allocation. This layout provides excellent cache locality for:
  * - Per-country operations (getting all years for one country)
  * - Sequential access patterns within a country's data
  * 
@@ -70,7 +74,7 @@ public:
 class PopulationModel {
 private:
     // Core data storage
-    std::vector<PopulationRow> _rows;               ///< Main data storage: one row per country
+    PopulationMatrix _matrix;                       ///< Main data storage: one matrix row per country
     
     // Metadata vectors (parallel arrays for fast indexed access)
     std::vector<std::string> _countryNames;         ///< Country names in row order
@@ -83,10 +87,15 @@ private:
     std::unordered_map<std::string, int> _countryCodeToRowIndex;    ///< Country code -> row index
     std::unordered_map<long long, int> _yearToIndex;                ///< Year -> column index
     std::unordered_map<std::string,std::string> _countryNameToCountryCode; ///< Name -> code mapping
+    std::unordered_map<std::string, int> _countryNameToRowIndex;    ///< Country name -> row index
+
+    // Optional year-range index, kept in sync by insertNewEntry once built
+    PopulationRangeIndex _rangeIndex;               ///< Per-country prefix sums and min/max sparse tables
+    bool _rangeIndexEnabled{false};                 ///< True after buildRangeIndex()
 
 public:
-    /// Default constructor - initializes empty model
-    PopulationModel();
+    /// Default constructor - initializes empty model with the given storage order
+    explicit PopulationModel(PopulationMatrix::Layout layout = PopulationMatrix::Layout::RowMajor);
     
     /// Destructor - default cleanup is sufficient
     ~PopulationModel();
@@ -120,10 +129,31 @@ public:
     std::size_t rowCount() const noexcept;
     
     /// Get specific country's data by row index (bounds checking in implementation)
-    const PopulationRow& rowAt(std::size_t idx) const;
+    PopulationRow rowAt(std::size_t idx) const;
+
+    /// Find a country's row by name. Returns an empty optional if not found
+    std::optional<PopulationRow> getByCountry(const std::string& country) const noexcept;
+    
+    /// Non-owning countries x years view of all values (invalidated by insertNewEntry)
+    PopulationMatrixView matrix() const noexcept;
+
+    // === Year-Range Index ===
+
+    /// Build the per-country range index; later inserts extend it incrementally
+    void buildRangeIndex();
+
+    /// Discard the range index and stop maintaining it
+    void dropRangeIndex() noexcept;
+
+    /// True if buildRangeIndex() has been called
+    bool hasRangeIndex() const noexcept;
+
+    /// The range index (empty unless hasRangeIndex())
+    const PopulationRangeIndex& rangeIndex() const noexcept;
 
-    /// Find a country's row by name. Returns nullptr if not found
-    const PopulationRow* getByCountry(const std::string& country) const noexcept;
+    /// Sum/min/max of a country between two years (inclusive); O(1) with the index,
+    /// otherwise a scan of the country's row. count == 0 if country or years are unknown
+    PopulationRange rangeForCountry(const std::string& country, long long startYear, long long endYear) const;
 
     // === Data Modification Methods ===
     
@@ -131,7 +161,8 @@ public:
     bool setYears(std::vector<long long> years);
     
     /// Load data from CSV file with comprehensive error handling
-    void readFromCSV(const std::string& filename);
+    /// numThreads > 1 splits the file into record-aligned chunks parsed in parallel
+    void readFromCSV(const std::string& filename, int numThreads = 1);
     
     /// Insert a new country's data (appends to existing data)
     void insertNewEntry(std::string country, std::string contry_code, std::string indicator_name, std::string indicator_code, std::vector<long long> year_population);
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "mapped_file.hpp"
+#include "population_matrix.hpp"
+#include "population_range_index.hpp"
 
 /**
  * @file populationModelColumn.hpp
@@ -40,6 +44,9 @@
  * + Direct indexing for country-year lookups (O(1) access)
  * - Less efficient for per-country time series operations
  * - Requires year-country coordinate calculations
+ *
+ * After loadSnapshot() the values are read straight from the mapped snapshot file
+ * (matrix() views the mapping); the first insert copies them into an owned matrix.
  */
 class PopulationModelColumn {
 private:
@@ -52,21 +59,29 @@ private:
 
     /**
      * Core data storage: columnar layout
-     * _columns[year_index][country_index] = population_value
-     * 
-     * Each inner vector contains all countries' populations for one year,
-     * providing excellent cache locality for per-year operations.
+     * One aligned countries x years PopulationMatrix, column-major by default, so
+     * each year's populations for all countries are contiguous and every year
+     * column starts on a cache line.
      */
-    std::vector<std::vector<long long>> _columns;
+    PopulationMatrix _matrix;
+
+    // Snapshot-backed values: while _snapshot is set, _mappedMatrix views the mapping
+    // and _matrix is empty
+    std::shared_ptr<const MappedFile> _snapshot;    ///< Mapping of a loaded snapshot (null if owned)
+    PopulationMatrixView _mappedMatrix;             ///< Values inside _snapshot
 
     // Fast lookup indices for O(1) access
     std::unordered_map<std::string, int> _countryNameToIndex;           ///< Country name -> index
     std::unordered_map<std::string, std::string> _countryNameToCountryCode; ///< Name -> code mapping
     std::unordered_map<long long, int> _yearToIndex;                    ///< Year -> column index
 
+    // Optional year-range index, kept in sync by insertNewEntry once built
+    PopulationRangeIndex _rangeIndex;               ///< Per-country prefix sums and min/max sparse tables
+    bool _rangeIndexEnabled{false};                 ///< True after buildRangeIndex()
+
 public:
-    /// Default constructor - initializes empty model
-    PopulationModelColumn();
+    /// Default constructor - initializes empty model with the given storage order
+    explicit PopulationModelColumn(PopulationMatrix::Layout layout = PopulationMatrix::Layout::ColumnMajor);
     
     /// Destructor - default cleanup is sufficient
     ~PopulationModelColumn();
@@ -113,7 +128,22 @@ public:
 
     /// Load data from CSV file with comprehensive error handling
     /// Expects same CSV format as row model: Country Name, Country Code, Indicator Name, Indicator Code, <year columns...>
-    void readFromCSV(const std::string& filename);
+    /// numThreads > 1 splits the file into record-aligned chunks parsed in parallel
+    void readFromCSV(const std::string& filename, int numThreads = 1);
+
+    // === Binary Snapshots ===
+
+    /// Write metadata and the value matrix (with its padded layout) to a snapshot file.
+    /// Throws std::runtime_error if the file cannot be written
+    void saveSnapshot(const std::string& path) const;
+
+    /// Replace the contents with a snapshot written by saveSnapshot(); values stay in the
+    /// mapped file. verifyChecksums reads the whole file once to check it. The range index
+    /// is dropped. Throws std::runtime_error if the snapshot is missing, corrupt or of another version
+    void loadSnapshot(const std::string& path, bool verifyChecksums = true);
+
+    /// True while values are read from a loaded snapshot
+    bool isSnapshotBacked() const noexcept;
 
     // === Data Access Methods ===
     
@@ -121,6 +151,31 @@ public:
     /// This is the fastest way to access data in the columnar model
     long long getPopulationForCountryYear(std::size_t countryIndex, std::size_t yearIndex) const;
 
+    /// Non-owning countries x years view of all values (invalidated by insertNewEntry)
+    PopulationMatrixView matrix() const noexcept;
+
     /// Find country index by name. Returns -1 if not found
     int countryNameIndex(const std::string& country) const noexcept;
+
+    // === Year-Range Index ===
+
+    /// Build the per-country range index; later inserts extend it incrementally
+    void buildRangeIndex();
+
+    /// Discard the range index and stop maintaining it
+    void dropRangeIndex() noexcept;
+
+    /// True if buildRangeIndex() has been called
+    bool hasRangeIndex() const noexcept;
+
+    /// The range index (empty unless hasRangeIndex())
+    const PopulationRangeIndex& rangeIndex() const noexcept;
+
+    /// Sum/min/max of a country between two years (inclusive); O(1) with the index,
+    /// otherwise a scan of the country's values. count == 0 if country or years are unknown
+    PopulationRange rangeForCountry(const std::string& country, long long startYear, long long endYear) const;
+
+private:
+    /// Copy snapshot values into _matrix and release the mapping (no-op if owned)
+    void detachSnapshot();
 };
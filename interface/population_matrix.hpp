@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+/**
+ * @file population_matrix.hpp
+ * @brief Contiguous, cache-aligned countries x years storage for the population models
+ *
+ * Both population models keep all of their values in one 64-byte-aligned buffer
+ * instead of one heap vector per country (or per year). The buffer can be laid out
+ * row-major (a country's years are contiguous) or column-major (a year's countries
+ * are contiguous); the leading dimension is padded to a whole number of cache lines
+ * so every row (or column) starts on a 64-byte boundary.
+ */
+
+/**
+ * @struct AlignedAllocator
+ * @brief Minimal allocator returning PopulationMatrix::ALIGNMENT-aligned storage
+ */
+template <typename T, std::size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        // aligned_alloc requires the size to be a multiple of the alignment
+        std::size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* p = std::aligned_alloc(Alignment, bytes == 0 ? Alignment : bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, std::size_t) noexcept { std::free(p); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * @struct PopulationSpan
+ * @brief Non-owning, possibly strided view of one row or column of a PopulationMatrix
+ */
+struct PopulationSpan {
+    const long long* data{nullptr};  ///< First element
+    std::size_t size{0};             ///< Number of elements
+    std::size_t stride{1};           ///< Distance between consecutive elements (1 = contiguous)
+
+    long long operator[](std::size_t i) const noexcept { return data[i * stride]; }
+    bool empty() const noexcept { return size == 0; }
+    bool contiguous() const noexcept { return stride == 1; }
+
+    /// Copy the viewed elements out
+    std::vector<long long> toVector() const;
+
+    friend bool operator==(const PopulationSpan& a, const PopulationSpan& b) noexcept;
+    friend bool operator!=(const PopulationSpan& a, const PopulationSpan& b) noexcept { return !(a == b); }
+};
+
+/**
+ * @class PopulationMatrixView
+ * @brief Non-owning 2D view (countries x years) over a PopulationMatrix
+ *
+ * Element (r, c) lives at data()[r * rowStride() + c * colStride()]. Exactly one
+ * of the strides is 1, depending on the matrix layout. Rows may be shorter than
+ * cols() (ragged CSV rows); cells past rowLength(r) read as 0.
+ */
+class PopulationMatrixView {
+public:
+    PopulationMatrixView() = default;
+    PopulationMatrixView(const long long* data, std::size_t rows, std::size_t cols,
+                         std::size_t rowStride, std::size_t colStride, const std::size_t* rowLengths) noexcept
+        : _data(data), _rows(rows), _cols(cols), _rowStride(rowStride), _colStride(colStride),
+          _rowLengths(rowLengths) {}
+
+    const long long* data() const noexcept { return _data; }
+    std::size_t rows() const noexcept { return _rows; }
+    std::size_t cols() const noexcept { return _cols; }
+    std::size_t rowStride() const noexcept { return _rowStride; }
+    std::size_t colStride() const noexcept { return _colStride; }
+
+    /// Number of values row r was inserted with
+    std::size_t rowLength(std::size_t r) const noexcept { return _rowLengths[r]; }
+
+    long long at(std::size_t r, std::size_t c) const noexcept { return _data[r * _rowStride + c * _colStride]; }
+
+    /// Values of row r (length rowLength(r))
+    PopulationSpan row(std::size_t r) const noexcept { return {_data + r * _rowStride, _rowLengths[r], _colStride}; }
+
+    /// Values of column c over all rows (short rows contribute 0)
+    PopulationSpan column(std::size_t c) const noexcept { return {_data + c * _colStride, _rows, _rowStride}; }
+
+private:
+    const long long* _data{nullptr};
+    std::size_t _rows{0};
+    std::size_t _cols{0};
+    std::size_t _rowStride{0};
+    std::size_t _colStride{1};
+    const std::size_t* _rowLengths{nullptr};
+};
+
+/**
+ * @class PopulationMatrix
+ * @brief Owning, growable countries x years matrix in one aligned buffer
+ *
+ * Capacity grows geometrically in both dimensions; growing re-lays the buffer
+ * out once, so appending a row is amortized O(cols) in either layout.
+ */
+class PopulationMatrix {
+public:
+    /// Memory order of the buffer
+    enum class Layout {
+        RowMajor,    ///< Each country's years are contiguous (per-country scans)
+        ColumnMajor  ///< Each year's countries are contiguous (per-year scans)
+    };
+
+    /// Alignment of the buffer and of every row/column start
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    /// Values per cache line; the padded leading dimension is a multiple of this
+    static constexpr std::size_t LANE = ALIGNMENT / sizeof(long long);
+
+    explicit PopulationMatrix(Layout layout = Layout::RowMajor) noexcept : _layout(layout) {}
+
+    Layout layout() const noexcept { return _layout; }
+    std::size_t rows() const noexcept { return _rows; }
+    std::size_t cols() const noexcept { return _cols; }
+    std::size_t rowLength(std::size_t r) const noexcept { return _rowLengths[r]; }
+
+    /// Reserve capacity for at least rows x cols values
+    void reserve(std::size_t rows, std::size_t cols);
+
+    /// Resize to rows x cols; new cells are zero and new rows have length cols
+    void resize(std::size_t rows, std::size_t cols);
+
+    /// Append one row of `count` values, widening the matrix if count > cols()
+    void appendRow(const long long* values, std::size_t count);
+
+    /// Replace the contents with a copy of view (row lengths included), keeping this layout
+    void assign(const PopulationMatrixView& view);
+
+    long long at(std::size_t r, std::size_t c) const noexcept { return _data[offset(r, c)]; }
+    long long& at(std::size_t r, std::size_t c) noexcept { return _data[offset(r, c)]; }
+
+    /// Mutable pointer to the start of column c (contiguous in ColumnMajor layout)
+    long long* columnData(std::size_t c) noexcept { return _data.data() + offset(0, c); }
+
+    /// Mutable pointer to the start of row r (contiguous in RowMajor layout)
+    long long* rowData(std::size_t r) noexcept { return _data.data() + offset(r, 0); }
+
+    /// Non-owning view; invalidated by any call that grows the matrix
+    PopulationMatrixView view() const noexcept;
+
+    /// Remove all rows and columns (keeps the layout)
+    void clear() noexcept;
+
+    /// Bytes held by the value buffer and row lengths
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    Layout _layout;
+    std::size_t _rows{0};
+    std::size_t _cols{0};
+    std::size_t _rowCapacity{0};   ///< Allocated rows (padded to LANE in ColumnMajor layout)
+    std::size_t _colCapacity{0};   ///< Allocated columns (padded to LANE in RowMajor layout)
+    std::vector<std::size_t> _rowLengths;
+    std::vector<long long, AlignedAllocator<long long, ALIGNMENT>> _data;
+
+    std::size_t offset(std::size_t r, std::size_t c) const noexcept {
+        return _layout == Layout::RowMajor ? r * _colCapacity + c : c * _rowCapacity + r;
+    }
+
+    /// Reallocate to at least the given capacities, keeping existing values
+    void grow(std::size_t rowCapacity, std::size_t colCapacity);
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "population_matrix.hpp"
+
+/**
+ * @file population_range_index.hpp
+ * @brief Per-country prefix sums and min/max sparse tables for O(1) year-range queries
+ *
+ * For every country row of length L the index keeps L+1 prefix sums and a
+ * sparse table of floor(log2 L)+1 levels for min and for max, where level k
+ * holds the extreme of each window of 2^k consecutive years. A range
+ * [first, last] is answered with one subtraction and two overlapping window
+ * lookups. Rows are stored back to back with their own offsets, so appending
+ * a country never touches the tables of existing countries.
+ */
+
+/**
+ * @struct PopulationRange
+ * @brief Aggregates of one country over an inclusive range of year indices
+ */
+struct PopulationRange {
+    long long sum{0};
+    long long min{0};
+    long long max{0};
+    std::size_t count{0};   ///< Number of years in the range (0 = invalid range or country)
+};
+
+/**
+ * @class PopulationRangeIndex
+ * @brief Range-sum and range-min/max index over the rows of a PopulationMatrix
+ *
+ * Only the first rowLength(r) values of each row are indexed; ranges reaching
+ * past a country's inserted values are rejected by query() like they are by
+ * the row service's per-country lookups.
+ */
+class PopulationRangeIndex {
+public:
+    /// Rebuild the index from every row of the matrix
+    void build(const PopulationMatrixView& matrix);
+
+    /// Index one more row (O(L log L), existing rows are untouched)
+    void appendRow(const PopulationSpan& values);
+
+    /// Drop all rows
+    void clear() noexcept;
+
+    std::size_t rows() const noexcept { return _lengths.size(); }
+    std::size_t rowLength(std::size_t r) const noexcept { return _lengths[r]; }
+
+    // === O(1) queries; require first <= last < rowLength(r) ===
+
+    long long sum(std::size_t r, std::size_t first, std::size_t last) const noexcept {
+        const long long* prefix = _prefix.data() + _prefixOffsets[r];
+        return prefix[last + 1] - prefix[first];
+    }
+    long long min(std::size_t r, std::size_t first, std::size_t last) const noexcept;
+    long long max(std::size_t r, std::size_t first, std::size_t last) const noexcept;
+
+    /// Sum, min and max of row r over [first, last]; count == 0 if the range is invalid
+    PopulationRange query(std::size_t r, std::size_t first, std::size_t last) const noexcept;
+
+    /// Bytes held by the prefix sums, sparse tables and offsets
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    std::vector<std::size_t> _lengths;          ///< Indexed values per row
+    std::vector<std::size_t> _prefixOffsets;    ///< Start of each row's prefix sums in _prefix
+    std::vector<std::size_t> _tableOffsets;     ///< Start of each row's sparse table in _min/_max
+    std::vector<long long> _prefix;             ///< prefix[i] = sum of the row's first i values
+    std::vector<long long> _min;                ///< Sparse table levels, level k = min of 2^k-wide windows
+    std::vector<long long> _max;                ///< Same layout as _min
+
+    /// Position of level k inside a row table of length L
+    static std::size_t levelOffset(std::size_t length, unsigned level) noexcept {
+        return level * (length + 1) - ((std::size_t{1} << level) - 1);
+    }
+
+    static unsigned floorLog2(std::size_t n) noexcept {
+        return static_cast<unsigned>(8 * sizeof(unsigned long long) - 1) - static_cast<unsigned>(__builtin_clzll(n));
+    }
+};
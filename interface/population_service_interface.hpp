@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include <string>
 #include <utility>
+#include "population_range_index.hpp"
+#include "execution_context.hpp"
 
 /**
  * @file population_service_interface.hpp
@@ -13,6 +16,46 @@
  * Both row-oriented and column-oriented services implement this interface.
  */
 
+/**
+ * @struct YearSummary
+ * @brief All per-year aggregates of one year column, computed in a single pass
+ *
+ * argmin/argmax are model row (country) indices; ties resolve to the lowest
+ * index so serial and parallel passes agree. A year that is unknown or has no
+ * values yields count == 0 and zeroes everywhere else.
+ */
+struct YearSummary {
+    long long sum{0};
+    std::size_t count{0};
+    double mean{0.0};
+    long long min{0};
+    long long max{0};
+    std::size_t argmin{0};      ///< Row index of the smallest value
+    std::size_t argmax{0};      ///< Row index of the largest value
+    std::string minCountry;     ///< Country name at argmin
+    std::string maxCountry;     ///< Country name at argmax
+
+    /// Fold in the value of row `index`
+    void add(long long value, std::size_t index) noexcept {
+        if (count == 0 || value < min) { min = value; argmin = index; }
+        if (count == 0 || value > max) { max = value; argmax = index; }
+        sum += value;
+        ++count;
+    }
+
+    /// Combine with a partial summary of other rows (country names are not merged)
+    void merge(const YearSummary& other) noexcept {
+        if (other.count == 0) return;
+        if (count == 0 || other.min < min || (other.min == min && other.argmin < argmin)) { min = other.min; argmin = other.argmin; }
+        if (count == 0 || other.max > max || (other.max == max && other.argmax < argmax)) { max = other.max; argmax = other.argmax; }
+        sum += other.sum;
+        count += other.count;
+    }
+
+    /// Derive the mean once all values have been added
+    void finalize() noexcept { mean = count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+};
+
 /**
  * @interface IPopulationService
  * @brief Abstract interface for population analytics operations
@@ -31,31 +74,58 @@ class IPopulationService {
 public:
     virtual ~IPopulationService() = default;
 
+    // === Execution ===
+
+    /// Context used by every parallel operation; an explicit numThreads only overrides its thread count
+    virtual const ExecutionContext& executionContext() const = 0;
+
+    /// Replace the context (not synchronized with queries running concurrently)
+    virtual void setExecutionContext(const ExecutionContext& context) = 0;
+
     // === Aggregation Operations ===
     
     /// Calculate total population across all countries for a specific year
     /// @param year The target year for calculation
-    /// @param numThreads Number of threads for parallel execution (1 = serial)
+    /// @param numThreads Number of threads for parallel execution (1 = serial, USE_CONTEXT = service context)
     /// @return Total population or 0 if year not found
-    virtual long long sumPopulationForYear(int year, int numThreads = 1) const = 0;
+    virtual long long sumPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
     
     /// Calculate average population across all countries for a specific year
     /// @param year The target year for calculation  
-    /// @param numThreads Number of threads for parallel execution (1 = serial)
+    /// @param numThreads Number of threads for parallel execution (1 = serial, USE_CONTEXT = service context)
     /// @return Average population or 0.0 if year not found
-    virtual double averagePopulationForYear(int year, int numThreads = 1) const = 0;
+    virtual double averagePopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
     
     /// Find maximum population among all countries for a specific year
     /// @param year The target year for calculation
-    /// @param numThreads Number of threads for parallel execution (1 = serial)
+    /// @param numThreads Number of threads for parallel execution (1 = serial, USE_CONTEXT = service context)
     /// @return Maximum population or 0 if year not found
-    virtual long long maxPopulationForYear(int year, int numThreads = 1) const = 0;
+    virtual long long maxPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
     
     /// Find minimum population among all countries for a specific year
     /// @param year The target year for calculation
-    /// @param numThreads Number of threads for parallel execution (1 = serial)
+    /// @param numThreads Number of threads for parallel execution (1 = serial, USE_CONTEXT = service context)
     /// @return Minimum population or 0 if year not found
-    virtual long long minPopulationForYear(int year, int numThreads = 1) const = 0;
+    virtual long long minPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
+
+    /// Sum, count, mean, min, max, argmin and argmax of a year in one sweep
+    /// @param year The target year for calculation
+    /// @param numThreads Number of threads for parallel execution (1 = serial, USE_CONTEXT = service context)
+    /// @return Summary with count == 0 if year not found
+    virtual YearSummary yearSummary(int year, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
+
+    /// Summaries of many years from one parallel region
+    /// @param years Target years; unknown years yield a summary with count == 0
+    /// @param numThreads Number of threads for parallel execution (1 = serial, USE_CONTEXT = service context)
+    /// @return One summary per entry of years, in the same order
+    virtual std::vector<YearSummary> yearSummaries(const std::vector<int>& years, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
+
+    /// Summaries of every year in [startYear, endYear]
+    std::vector<YearSummary> yearSummaries(int startYear, int endYear, int numThreads = ExecutionContext::USE_CONTEXT) const {
+        std::vector<int> years;
+        for (int year = startYear; year <= endYear; ++year) years.push_back(year);
+        return yearSummaries(years, numThreads);
+    }
 
     // === Country-Specific Operations ===
     
@@ -64,7 +134,7 @@ public:
     /// @param year Target year
     /// @param numThreads Number of threads (typically unused for single lookups)
     /// @return Population value or 0 if country/year not found
-    virtual long long populationForCountryInYear(const std::string& country, int year, int numThreads = 1) const = 0;
+    virtual long long populationForCountryInYear(const std::string& country, int year, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
     
     /// Get population data for a specific country across a range of years
     /// @param country Country name to look up
@@ -72,7 +142,14 @@ public:
     /// @param endYear End of year range (inclusive)
     /// @param numThreads Number of threads for parallel execution
     /// @return Vector of population values indexed by (year - startYear)
-    virtual std::vector<long long> populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads = 1) const = 0;
+    virtual std::vector<long long> populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
+
+    /// Total, minimum and maximum population of a country over a range of years
+    /// @param country Country name to look up
+    /// @param startYear Start of year range (inclusive)
+    /// @param endYear End of year range (inclusive)
+    /// @return Range aggregates (O(1) once the model's range index is built); count == 0 if not found
+    virtual PopulationRange populationRangeForCountry(const std::string& country, int startYear, int endYear) const = 0;
 
     // === Top-N Operations ===
     
@@ -81,7 +158,7 @@ public:
     /// @param n Number of top countries to return
     /// @param numThreads Number of threads for parallel execution
     /// @return Vector of (country_name, population) pairs sorted by population (descending)
-    virtual std::vector<std::pair<std::string, long long>> topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads = 1) const = 0;
+    virtual std::vector<std::pair<std::string, long long>> topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads = ExecutionContext::USE_CONTEXT) const = 0;
     
     // === Metadata Operations ===
     
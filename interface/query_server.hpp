@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "execution_context.hpp"
+#include "json_line.hpp"
+#include "service.hpp"
+#include "fire_service_direct.hpp"
+
+/**
+ * @file query_server.hpp
+ * @brief Long-running query mode over models loaded once
+ *
+ * Requests are JSON objects, one per line, answered with one JSON object
+ * per line carrying the same "id":
+ *
+ *   {"id":1,"op":"sum","year":2000,"model":"row"}
+ *   {"id":1,"ok":true,"result":57094730240,"latency_us":0.4,"queue_us":2.1}
+ *
+ * Operations: info, ping, stats, shutdown; population sum, average, max, min,
+ * summary, top_n (year, n), country_year (country, year), country_years and
+ * country_range (country, start, end); fire fire_max_aqi, fire_min_aqi,
+ * fire_average_aqi, fire_top_sites (n), fire_by_parameter. Population and fire
+ * operations take "model": "row" or "column" (default column) and an optional
+ * "threads" that overrides the server's ExecutionContext thread count.
+ *
+ * Queries run on a fixed worker pool against read-only models, so responses on
+ * one connection may arrive out of request order. latency_us is the time spent
+ * executing the query, queue_us the time it waited for a worker.
+ */
+
+namespace QueryServer {
+
+    /**
+     * @class LatencyHistogram
+     * @brief Lock-free log-scale histogram of latencies in microseconds
+     *
+     * Each power of two is split into 8 buckets, so percentiles are within
+     * about 9% of the true value. Safe to record from any number of threads.
+     */
+    class LatencyHistogram {
+    public:
+        /// Record one latency
+        void record(double micros) noexcept;
+
+        /// Upper bound of the bucket holding the given quantile (0..1), 0 if empty
+        double percentile(double quantile) const noexcept;
+
+        /// Number of recorded values
+        std::uint64_t count() const noexcept { return _count.load(std::memory_order_relaxed); }
+
+        /// Largest recorded value
+        double max() const noexcept;
+
+        /// Mean of recorded values
+        double mean() const noexcept;
+
+    private:
+        static constexpr int SUB_BUCKETS = 8;
+        static constexpr int BUCKETS = 40 * SUB_BUCKETS;   // up to 2^42 ns (about 73 minutes)
+
+        static int bucketOf(std::uint64_t nanos) noexcept;
+        static std::uint64_t upperBound(int bucket) noexcept;
+
+        std::array<std::atomic<std::uint64_t>, BUCKETS> _buckets{};
+        std::atomic<std::uint64_t> _count{0};
+        std::atomic<std::uint64_t> _totalNanos{0};
+        std::atomic<std::uint64_t> _maxNanos{0};
+    };
+
+    /**
+     * @class WorkerPool
+     * @brief Fixed set of threads draining a bounded FIFO of jobs
+     *
+     * submit() blocks while the queue is full, which pushes back on the
+     * connection that is sending faster than the workers can answer.
+     */
+    class WorkerPool {
+    public:
+        WorkerPool(int workers, std::size_t capacity);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /// Queue a job; returns false once the pool is stopping
+        bool submit(std::function<void()> job);
+
+        /// Block until every submitted job has finished
+        void drain();
+
+        /// Finish queued jobs and join the workers (idempotent)
+        void stop();
+
+        int size() const noexcept { return static_cast<int>(_threads.size()); }
+
+    private:
+        void run();
+
+        std::vector<std::thread> _threads;
+        std::deque<std::function<void()>> _jobs;
+        std::size_t _capacity;
+        std::size_t _active{0};
+        bool _stopping{false};
+        std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+        std::condition_variable _idle;
+    };
+
+    /// Models served by a Server; any may be null if it was not loaded
+    struct Models {
+        PopulationModel* populationRow{nullptr};
+        PopulationModelColumn* populationColumn{nullptr};
+        const FireRowModel* fireRow{nullptr};
+        const FireColumnModel* fireColumn{nullptr};
+    };
+
+    /// Server configuration
+    struct Options {
+        int workers{4};                       ///< Worker threads answering queries
+        std::size_t queueCapacity{4096};      ///< Queued requests before readers block
+        std::size_t maxInFlightPerConnection{64};   ///< Queued or running requests per socket client before its reader waits
+        int sendTimeoutMs{5000};              ///< A socket client that accepts no reply bytes for this long is dropped (0 = never)
+        ExecutionContext context{};           ///< Per-query parallelism for every service
+    };
+
+    /**
+     * @class Server
+     * @brief Answers line-delimited JSON queries from stdin or a Unix socket
+     *
+     * The models must outlive the server and must not be modified while it runs.
+     */
+    class Server {
+    public:
+        Server(const Models& models, const Options& options);
+        ~Server();
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        /// Answer one request line synchronously on the calling thread
+        std::string handle(const std::string& line);
+
+        /**
+         * @brief Read requests from `in` until EOF or a shutdown request
+         *
+         * Requests are answered on the worker pool; every response is written
+         * to `out` as one line. Returns after all responses have been written.
+         */
+        void serveStream(std::istream& in, std::ostream& out);
+
+        /**
+         * @brief Accept connections on a Unix domain socket until a shutdown request
+         * @throws std::runtime_error if the socket cannot be created or bound
+         *
+         * An existing socket file at `path` is replaced and removed on return.
+         * A client has at most Options::maxInFlightPerConnection requests queued
+         * or running, so a fast sender only ever waits on itself. A client that
+         * stops reading its answers is dropped after Options::sendTimeoutMs,
+         * which frees its workers.
+         */
+        void serveUnixSocket(const std::string& path);
+
+        /// Ask serveStream()/serveUnixSocket() to return (thread-safe)
+        void requestShutdown() noexcept { _shutdown.store(true); }
+
+        /// One line per operation with count and p50/p99/max latency
+        void printStats(std::ostream& out) const;
+
+    private:
+        struct OpStats {
+            LatencyHistogram latency;
+            std::atomic<std::uint64_t> errors{0};
+        };
+
+        /// Parse, execute and time a request received at `receivedAt` (steady clock, ns)
+        std::string answer(const std::string& line, std::int64_t receivedAt);
+
+        /// Execute a parsed request; throws std::invalid_argument on bad parameters
+        std::string execute(const JsonLine::Object& request, const std::string& op);
+
+        std::string statsJson() const;
+        OpStats& statsFor(const std::string& op);
+
+        const IPopulationService& population(const JsonLine::Object& request) const;
+
+        Models _models;
+        Options _options;
+        std::unique_ptr<PopulationModelService> _rowService;
+        std::unique_ptr<PopulationModelColumnService> _columnService;
+        std::unique_ptr<FireRowService> _fireRowService;
+        std::unique_ptr<FireColumnService> _fireColumnService;
+        std::map<std::string, std::unique_ptr<OpStats>> _stats;   ///< Fixed set of ops, filled in the constructor
+        std::atomic<bool> _shutdown{false};
+        WorkerPool _pool;
+    };
+
+}
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 // CSVReader: declaration-only header. Implementation lives in src/readcsv.cpp
 class CSVReader {
 public:
-	explicit CSVReader(const std::string& path, char delimiter = ',', char quote = '"', char comment = '#');
+	// Stream reads through std::ifstream; Mapped memory-maps the whole file and
+	// lets readRowViews() return spans into the mapping without copying.
+	enum class Mode { Stream, Mapped };
+
+	explicit CSVReader(const std::string& path, char delimiter = ',', char quote = '"', char comment = '#',
+	                   Mode mode = Mode::Stream);
 
 	CSVReader(const CSVReader&) = delete;
 	CSVReader& operator=(const CSVReader&) = delete;
@@ -14,9 +20,19 @@ public:
 	void open();
 	void close();
 
+	// Parse records from an external buffer (e.g. one chunk of a MappedFile) instead of
+	// opening the path. The buffer must outlive the reader; rows are read as in Mapped mode.
+	void openBuffer(std::string_view buffer);
+
 	// Read next CSV row. Returns true if a row was read, false on EOF.
 	bool readRow(std::vector<std::string>& out);
 
+	// Read next CSV row as views. Fields point into the mapped file (Mapped mode) or
+	// the reader's record buffer (Stream mode); only fields containing an escaped
+	// quote are materialized into a scratch buffer. Views stay valid until the next
+	// read call or close().
+	bool readRowViews(std::vector<std::string_view>& out);
+
 	~CSVReader();
 
 private:
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @file roaring_bitmap.hpp
+ * @brief Compressed bitmap of row ids for posting lists and multi-predicate filters
+ *
+ * A posting list stored as a vector of std::size_t costs 8 bytes per row, and
+ * combining two of them (parameter AND site) means a merge of two sorted
+ * vectors. RoaringBitmap splits the 32-bit id space into 2^16-value chunks and
+ * stores each non-empty chunk in whichever container is smaller:
+ *
+ * - array container: the sorted low 16 bits of its values (2 bytes per row, at most 4096 values)
+ * - bitmap container: 1024 64-bit words, one bit per possible value (8 KB, over 4096 values)
+ *
+ * A site's rows scattered over the whole table cost 2 bytes each; a parameter
+ * covering half the table costs about a bit each. AND and OR work one chunk at a
+ * time, with word-wide operations when both sides are bitmaps.
+ */
+
+/**
+ * @class RoaringBitmap
+ * @brief Append-only set of 32-bit ids in array or bitmap containers
+ *
+ * Ids are appended in increasing order, which is how posting lists grow (a
+ * model only ever appends rows). The last container is the only one that
+ * changes, so all containers share two flat pools (array values and bitmap
+ * words) instead of allocating one buffer each. Storage comes from a std::pmr
+ * memory resource; the class is allocator-aware, so a std::pmr::vector of
+ * bitmaps hands its resource to every element. Copies use the default resource.
+ */
+class RoaringBitmap {
+public:
+    using Value = std::uint32_t;
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    /// Largest id a bitmap can hold
+    static constexpr Value MAX_VALUE = static_cast<Value>(-1);
+
+    /// Containers holding more values than this are bitmaps
+    static constexpr std::uint32_t ARRAY_LIMIT = 4096;
+
+    RoaringBitmap() = default;
+
+    /// Bitmap whose pools allocate from alloc's resource, which must outlive it
+    explicit RoaringBitmap(const allocator_type& alloc);
+
+    RoaringBitmap(const RoaringBitmap&) = default;
+    RoaringBitmap(RoaringBitmap&&) noexcept = default;
+    RoaringBitmap& operator=(const RoaringBitmap&) = default;
+    RoaringBitmap& operator=(RoaringBitmap&&) = default;
+    RoaringBitmap(const RoaringBitmap& other, const allocator_type& alloc);
+    RoaringBitmap(RoaringBitmap&& other, const allocator_type& alloc);
+
+    /// Every id in [begin, end)
+    static RoaringBitmap range(Value begin, Value end);
+
+    /// Ids in any of bitmaps, each chunk combined in one pass however many bitmaps cover it
+    static RoaringBitmap unionOf(const std::vector<const RoaringBitmap*>& bitmaps);
+
+    /**
+     * @brief Add an id larger than every id already present
+     * @throws std::invalid_argument if value is not larger than the last id
+     */
+    void append(Value value);
+
+    bool contains(Value value) const noexcept;
+
+    /// Number of ids
+    std::size_t cardinality() const noexcept { return _cardinality; }
+
+    bool empty() const noexcept { return _cardinality == 0; }
+
+    /// Call f(Value) for every id in increasing order
+    template <typename F>
+    void forEach(F&& f) const;
+
+    /// The ids in increasing order, widened to indices
+    std::vector<std::size_t> toIndices() const;
+
+    /// Ids in both bitmaps
+    friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    /// Ids in either bitmap
+    friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other) { return *this = *this & other; }
+    RoaringBitmap& operator|=(const RoaringBitmap& other) { return *this = *this | other; }
+
+    friend bool operator==(const RoaringBitmap& a, const RoaringBitmap& b) noexcept;
+    friend bool operator!=(const RoaringBitmap& a, const RoaringBitmap& b) noexcept { return !(a == b); }
+
+    void clear() noexcept;
+
+    /// Array and bitmap containers in use (for memory reports)
+    std::size_t arrayContainerCount() const noexcept;
+    std::size_t bitmapContainerCount() const noexcept { return _containers.size() - arrayContainerCount(); }
+
+    /// Bytes held by the container headers and both pools
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    static constexpr std::uint32_t WORDS = 1024;   ///< Words in a bitmap container
+
+    struct Container {
+        std::uint16_t key;           ///< High 16 bits shared by its values
+        std::uint32_t cardinality;   ///< 1..65536; above ARRAY_LIMIT the container is a bitmap
+        std::uint32_t offset;        ///< First value in _arrays, or first word in _words
+    };
+
+    std::pmr::vector<Container> _containers;   ///< In increasing key order
+    std::pmr::vector<std::uint16_t> _arrays;   ///< Array containers' values, container after container
+    std::pmr::vector<std::uint64_t> _words;    ///< Bitmap containers' words, container after container
+    std::size_t _cardinality{0};
+    Value _last{0};                            ///< Largest id (meaningless while empty)
+
+    static bool isBitmap(const Container& c) noexcept { return c.cardinality > ARRAY_LIMIT; }
+    const std::uint16_t* values(const Container& c) const noexcept { return _arrays.data() + c.offset; }
+    const std::uint64_t* words(const Container& c) const noexcept { return _words.data() + c.offset; }
+
+    /// Store a chunk given as WORDS words holding cardinality bits (nothing if it is 0)
+    void appendWords(std::uint16_t key, const std::uint64_t* words, std::uint32_t cardinality);
+
+    /// Store a copy of container c of from
+    void appendCopy(const RoaringBitmap& from, const Container& c);
+
+    /// Register the values pushed onto _arrays since offset as a container (nothing if there are none)
+    void closeArray(std::uint16_t key, std::size_t offset);
+
+    /// Turn the last container, an array, into a bitmap
+    void convertLastToBitmap();
+
+    /// Recompute _last after a bulk build
+    void updateLast() noexcept;
+};
+
+template <typename F>
+void RoaringBitmap::forEach(F&& f) const {
+    for (const Container& c : _containers) {
+        const Value high = static_cast<Value>(c.key) << 16;
+        if (!isBitmap(c)) {
+            const std::uint16_t* low = values(c);
+            for (std::uint32_t i = 0; i < c.cardinality; ++i) f(high | low[i]);
+            continue;
+        }
+        const std::uint64_t* bits = words(c);
+        for (std::uint32_t w = 0; w < WORDS; ++w) {
+            for (std::uint64_t word = bits[w]; word != 0; word &= word - 1) {
+                f(high | (w << 6) | static_cast<Value>(__builtin_ctzll(word)));
+            }
+        }
+    }
+}
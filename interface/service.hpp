@@ -23,36 +23,43 @@
  * 
  * Concrete implementation of IPopulationService for row-oriented population data.
  * All operations support both serial and parallel execution modes through the
- * numThreads parameter. The service acts as a facade over the PopulationModel,
+ * numThreads parameter or the service's ExecutionContext. The service acts as a facade over the PopulationModel,
  * implementing complex queries and aggregations with OpenMP parallelization.
  * 
  * Key Features:
  * - Implements IPopulationService interface
  * - OpenMP-optimized algorithms for parallel operations
- * - Per-thread min-heap optimization for top-N queries
+ * - Bounded per-thread top-N selection over (value, row) pairs
  * - Efficient reduction patterns for aggregations
  */
 class PopulationModelService : public IPopulationService {
 public:
     /// Constructor takes ownership of model pointer (non-owning)
-    explicit PopulationModelService(PopulationModel* m);
+    explicit PopulationModelService(PopulationModel* m, ExecutionContext context = {});
     
     /// Destructor - model cleanup is handled externally
     ~PopulationModelService() override;
 
     // === IPopulationService Implementation ===
     
-    long long sumPopulationForYear(int year, int numThreads = 1) const override;
-    double averagePopulationForYear(int year, int numThreads = 1) const override;
-    long long maxPopulationForYear(int year, int numThreads = 1) const override;
-    long long minPopulationForYear(int year, int numThreads = 1) const override;
-    long long populationForCountryInYear(const std::string& country, int year, int numThreads = 1) const override;
-    std::vector<long long> populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads = 1) const override;
-    std::vector<std::pair<std::string, long long>> topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads = 1) const override;
+    const ExecutionContext& executionContext() const override { return context_; }
+    void setExecutionContext(const ExecutionContext& context) override { context_ = context; }
+    long long sumPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    double averagePopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    long long maxPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    long long minPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    YearSummary yearSummary(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    std::vector<YearSummary> yearSummaries(const std::vector<int>& years, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    using IPopulationService::yearSummaries;
+    long long populationForCountryInYear(const std::string& country, int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    std::vector<long long> populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    PopulationRange populationRangeForCountry(const std::string& country, int startYear, int endYear) const override;
+    std::vector<std::pair<std::string, long long>> topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads = ExecutionContext::USE_CONTEXT) const override;
     std::string getImplementationName() const override;
 
 private:
     PopulationModel* model_;  ///< Non-owning pointer to underlying data model
+    ExecutionContext context_;  ///< Team size, schedule and affinity for parallel operations
 };
 
 /**
@@ -78,23 +85,30 @@ private:
 class PopulationModelColumnService : public IPopulationService {
 public:
     /// Constructor takes ownership of model pointer (non-owning)
-    explicit PopulationModelColumnService(PopulationModelColumn* m);
+    explicit PopulationModelColumnService(PopulationModelColumn* m, ExecutionContext context = {});
     
     /// Destructor - model cleanup is handled externally
     ~PopulationModelColumnService() override;
 
     // === IPopulationService Implementation ===
     
-    long long sumPopulationForYear(int year, int numThreads = 1) const override;
-    double averagePopulationForYear(int year, int numThreads = 1) const override;
-    long long maxPopulationForYear(int year, int numThreads = 1) const override;
-    long long minPopulationForYear(int year, int numThreads = 1) const override;
-    long long populationForCountryInYear(const std::string& country, int year, int numThreads = 1) const override;
-    std::vector<long long> populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads = 1) const override;
-    std::vector<std::pair<std::string, long long>> topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads = 1) const override;
+    const ExecutionContext& executionContext() const override { return context_; }
+    void setExecutionContext(const ExecutionContext& context) override { context_ = context; }
+    long long sumPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    double averagePopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    long long maxPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    long long minPopulationForYear(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    YearSummary yearSummary(int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    std::vector<YearSummary> yearSummaries(const std::vector<int>& years, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    using IPopulationService::yearSummaries;
+    long long populationForCountryInYear(const std::string& country, int year, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    std::vector<long long> populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads = ExecutionContext::USE_CONTEXT) const override;
+    PopulationRange populationRangeForCountry(const std::string& country, int startYear, int endYear) const override;
+    std::vector<std::pair<std::string, long long>> topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads = ExecutionContext::USE_CONTEXT) const override;
     std::string getImplementationName() const override;
 
 private:
     PopulationModelColumn* model_;  ///< Non-owning pointer to underlying columnar data model
+    ExecutionContext context_;  ///< Team size, schedule and affinity for parallel operations
 };
 
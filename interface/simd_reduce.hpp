@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+/**
+ * @file simd_reduce.hpp
+ * @brief Vectorized reductions over contiguous long long columns
+ *
+ * Sum, min, max, threshold count and a fused sum+min+max pass over one
+ * contiguous run of values, e.g. a year column of PopulationModelColumn.
+ * Kernels are chosen at runtime: AVX-512 (8 lanes), AVX2 (4 lanes) or a
+ * portable scalar fallback on other CPUs. The parallel variants split the
+ * input into one contiguous chunk per OpenMP thread and reduce every chunk
+ * with the active kernel.
+ *
+ * Sums wrap on overflow (two's complement) instead of invoking undefined
+ * behaviour; min/max of an empty range return the identity values below.
+ */
+
+namespace SimdReduce {
+    /// Available reduction kernels
+    enum class Kernel { Scalar, AVX2, AVX512 };
+
+    /// Identity returned by min() on an empty range
+    constexpr long long MIN_IDENTITY = std::numeric_limits<long long>::max();
+
+    /// Identity returned by max() on an empty range
+    constexpr long long MAX_IDENTITY = std::numeric_limits<long long>::min();
+
+    /// Result of the fused summarize() pass
+    struct Summary {
+        long long sum{0};
+        long long min{MIN_IDENTITY};
+        long long max{MAX_IDENTITY};
+        std::size_t count{0};   ///< Number of values reduced
+    };
+
+    /// Best kernel supported by the running CPU
+    Kernel detectKernel() noexcept;
+
+    /// Kernel currently used by the reductions (defaults to detectKernel())
+    Kernel activeKernel() noexcept;
+
+    /// True if the running CPU can execute the given kernel
+    bool isSupported(Kernel kernel) noexcept;
+
+    /// Force a specific kernel (e.g. for benchmarking). Returns false if unsupported.
+    bool selectKernel(Kernel kernel) noexcept;
+
+    /// Human-readable kernel name
+    const char* kernelName(Kernel kernel) noexcept;
+
+    // === Single-threaded reductions over data[0, n) ===
+
+    long long sum(const long long* data, std::size_t n) noexcept;
+    long long min(const long long* data, std::size_t n) noexcept;
+    long long max(const long long* data, std::size_t n) noexcept;
+
+    /// Number of values strictly greater than threshold
+    std::size_t countGreater(const long long* data, std::size_t n, long long threshold) noexcept;
+
+    /// Sum, min and max in one pass
+    Summary summarize(const long long* data, std::size_t n) noexcept;
+
+    // === OpenMP-parallel reductions (numThreads <= 1 runs the single-threaded kernel) ===
+
+    long long parallelSum(const long long* data, std::size_t n, int numThreads);
+    long long parallelMin(const long long* data, std::size_t n, int numThreads);
+    long long parallelMax(const long long* data, std::size_t n, int numThreads);
+    std::size_t parallelCountGreater(const long long* data, std::size_t n, long long threshold, int numThreads);
+    Summary parallelSummarize(const long long* data, std::size_t n, int numThreads);
+}
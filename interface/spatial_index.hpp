@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file spatial_index.hpp
+ * @brief Uniform-grid index over monitoring locations for box and radius queries
+ *
+ * Fire data has about a million measurements but only a few thousand distinct
+ * monitor locations. The index stores each (group, latitude, longitude) point
+ * once, where a group is whatever the model scans its measurements by (a site
+ * in FireRowModel, an AQS code in FireColumnModel). A query finds the points
+ * inside a region from the grid cells it overlaps and returns their groups, so
+ * the model touches only the measurements of those groups instead of all rows.
+ */
+
+/**
+ * @struct GeoBox
+ * @brief Latitude/longitude rectangle in degrees, bounds included
+ *
+ * A box with minLongitude > maxLongitude crosses the antimeridian (e.g. 170 to
+ * -170). A box with minLatitude > maxLatitude is empty.
+ */
+struct GeoBox {
+    double minLatitude{0.0};
+    double maxLatitude{0.0};
+    double minLongitude{0.0};
+    double maxLongitude{0.0};
+
+    bool empty() const noexcept { return !(minLatitude <= maxLatitude); }
+    bool wrapsAntimeridian() const noexcept { return minLongitude > maxLongitude; }
+    bool contains(double latitude, double longitude) const noexcept;
+};
+
+namespace Geo {
+    /// Mean Earth radius used for great-circle distances
+    constexpr double EARTH_RADIUS_KM = 6371.0088;
+
+    /// Great-circle (haversine) distance between two points in degrees
+    double distanceKm(double latitude1, double longitude1, double latitude2, double longitude2) noexcept;
+}
+
+/**
+ * @class GeoRegion
+ * @brief Query shape: a GeoBox or a circle of a given great-circle radius
+ *
+ * bounds() is the smallest box containing the region (the box itself for box
+ * regions); contains() is the exact test.
+ */
+class GeoRegion {
+public:
+    static GeoRegion box(const GeoBox& box) noexcept;
+
+    /// Points within radiusKm of (latitude, longitude); a negative radius matches nothing
+    static GeoRegion circle(double latitude, double longitude, double radiusKm) noexcept;
+
+    const GeoBox& bounds() const noexcept { return _bounds; }
+    bool contains(double latitude, double longitude) const noexcept;
+
+private:
+    GeoBox _bounds;
+    bool _circle{false};
+    double _latitude{0.0};
+    double _longitude{0.0};
+    double _radius_km{0.0};
+};
+
+/**
+ * @class SpatialIndex
+ * @brief Distinct points per group, bucketed into fixed-size latitude/longitude cells
+ *
+ * Points are kept in one array and chained per group and per cell, so adding a
+ * measurement whose location is already known is a walk over its group's
+ * points (usually one) with no allocation. Occupied cells live in a hash map;
+ * a query visits the cells under its bounding box, or every point when that box
+ * spans more cells than are occupied. Storage comes from a std::pmr memory
+ * resource, like the owning model's; copies use the default resource.
+ */
+class SpatialIndex {
+public:
+    /// A group with at least one point inside the queried region
+    struct Match {
+        std::size_t group{0};
+        bool whole{false};   ///< Every point of the group is inside, so none of its rows needs a check
+    };
+
+    /// Cell edge in degrees (about 55 km of latitude)
+    static constexpr double DEFAULT_CELL_DEGREES = 0.5;
+
+    SpatialIndex() : SpatialIndex(std::pmr::get_default_resource()) {}
+
+    /// Index whose storage allocates from resource, which must outlive it
+    explicit SpatialIndex(std::pmr::memory_resource* resource, double cellDegrees = DEFAULT_CELL_DEGREES);
+
+    /// Record that group has a measurement at (latitude, longitude); non-finite coordinates
+    /// add no point but keep the group from ever matching whole
+    void add(std::size_t group, double latitude, double longitude);
+
+    /// Add every point of other, with its group g stored as groupMap[g] (as is if groupMap is empty)
+    void merge(const SpatialIndex& other, const std::vector<std::size_t>& groupMap = {});
+
+    /// Groups with a point inside region, in increasing group order
+    std::vector<Match> query(const GeoRegion& region) const;
+
+    /// Number of distinct (group, location) points
+    std::size_t pointCount() const noexcept { return _points.size(); }
+
+    void clear() noexcept;
+
+    /// Approximate bytes held by the points, group heads and cell map
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    static constexpr std::uint32_t NONE = static_cast<std::uint32_t>(-1);
+
+    struct Point {
+        double latitude;
+        double longitude;
+        std::uint32_t group;
+        std::uint32_t nextInGroup;   ///< Next point of the same group (NONE at the end)
+        std::uint32_t nextInCell;    ///< Next point in the same cell (NONE at the end)
+    };
+
+    std::pmr::vector<Point> _points;
+    std::pmr::vector<std::uint32_t> _group_heads;                ///< Group -> its most recent point
+    std::pmr::vector<bool> _unlocated;                           ///< Groups with a measurement at no finite location
+    std::pmr::unordered_map<std::int64_t, std::uint32_t> _cells; ///< Occupied cell -> its most recent point
+    double _cell_degrees;
+    std::int64_t _rows;      ///< Cells from latitude -90 to 90
+    std::int64_t _columns;   ///< Cells from longitude -180 to 180
+
+    std::int64_t rowOf(double latitude) const noexcept;
+    std::int64_t columnOf(double longitude) const noexcept;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @file string_dictionary.hpp
+ * @brief String table for dictionary-encoded columns
+ *
+ * Maps each distinct string to a dense integer code (0, 1, 2, ... in first-seen
+ * order) so a column of repeated strings can be stored as a vector of codes.
+ * Lookups take string_views, so interning a field straight from a CSVReader
+ * view allocates only when the value is new.
+ */
+
+/**
+ * @class StringDictionary
+ * @brief Append-only bidirectional string <-> code table
+ *
+ * Values live in a deque so their addresses stay stable as the table grows;
+ * the hash index keys are views into those values. The deque blocks and index
+ * nodes come from a std::pmr memory resource (the value strings themselves use
+ * the heap); copies use the default resource.
+ */
+class StringDictionary {
+public:
+    /// Code type stored in encoded columns
+    using Code = std::uint32_t;
+
+    /// Returned by find() when the value has never been interned
+    static constexpr Code NOT_FOUND = static_cast<Code>(-1);
+
+    StringDictionary() = default;
+
+    /// Table whose deque blocks and index nodes allocate from resource, which must outlive it
+    explicit StringDictionary(std::pmr::memory_resource* resource);
+
+    StringDictionary(const StringDictionary& other);
+    StringDictionary& operator=(const StringDictionary& other);
+    StringDictionary(StringDictionary&&) = default;
+
+    /// Moves the values; the index is rebuilt if the two tables use different resources
+    StringDictionary& operator=(StringDictionary&& other);
+
+    /// Return the code for value, adding it to the table if it is new
+    Code intern(std::string_view value);
+
+    /// Return the code for value, or NOT_FOUND
+    Code find(std::string_view value) const noexcept;
+
+    /// Decode a code (code must be < size())
+    const std::string& value(Code code) const noexcept { return _values[code]; }
+
+    /// Number of distinct values
+    std::size_t size() const noexcept { return _values.size(); }
+
+    bool empty() const noexcept { return _values.empty(); }
+
+    /// Remove all values
+    void clear() noexcept;
+
+    /// Approximate heap bytes held by the table (values plus index)
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    std::pmr::deque<std::string> _values;                    ///< Code -> value
+    std::pmr::unordered_map<std::string_view, Code> _index;  ///< Value -> code (views into _values)
+
+    void rebuildIndex();
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @file timestamp.hpp
+ * @brief Integer timestamps for measurement datetimes
+ *
+ * Fire measurements carry ISO datetimes such as "2020-08-10T01:00". They are
+ * parsed once at ingest into minutes since 1970-01-01T00:00 (UTC, no time zone
+ * handling) so range checks, min/max tracking and hourly bucketing are plain
+ * integer operations.
+ */
+
+namespace Timestamp {
+    /// Minutes since the Unix epoch
+    using EpochMinutes = std::int64_t;
+
+    constexpr EpochMinutes MINUTES_PER_HOUR = 60;
+    constexpr EpochMinutes MINUTES_PER_DAY = 24 * MINUTES_PER_HOUR;
+
+    /**
+     * @brief Parse "YYYY-MM-DDTHH:MM" (a space may replace 'T'; trailing ":SS" etc. is ignored)
+     * @param s Datetime characters
+     * @param out Minutes since the epoch on success
+     * @return False if the text is not a valid calendar datetime
+     */
+    bool parseIsoMinutes(std::string_view s, EpochMinutes& out) noexcept;
+
+    /// Format minutes since the epoch as "YYYY-MM-DDTHH:MM"
+    std::string formatIsoMinutes(EpochMinutes minutes);
+
+    /// Start of the hour containing t
+    inline EpochMinutes floorToHour(EpochMinutes t) noexcept {
+        EpochMinutes r = t % MINUTES_PER_HOUR;
+        return r < 0 ? t - r - MINUTES_PER_HOUR : t - r;
+    }
+}
+
+/**
+ * @struct HourlyBucket
+ * @brief Aggregate of all measurements whose timestamp falls in one hour
+ */
+struct HourlyBucket {
+    Timestamp::EpochMinutes hourStart{0};  ///< First minute of the hour
+    std::size_t count{0};                  ///< Measurements in the hour
+    double concentrationSum{0.0};          ///< Sum of concentrations
+    long long aqiSum{0};                   ///< Sum of AQI values
+
+    double averageConcentration() const noexcept { return count ? concentrationSum / count : 0.0; }
+    double averageAQI() const noexcept { return count ? static_cast<double>(aqiSum) / count : 0.0; }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file top_n.hpp
+ * @brief Top-N selection over (value, row index) pairs
+ *
+ * Candidates are ranked by value (largest first) with ties going to the lower
+ * row index, so serial and parallel selections return the same rows. Callers
+ * resolve names or other payload only for the N rows that are returned.
+ *
+ * The generic engine lives in top_n_engine.hpp (OpenMP, core library only);
+ * this header exposes the plain-array entry points that any target can call.
+ */
+
+/**
+ * @struct TopNEntry
+ * @brief One selected candidate: its value and the row it came from
+ */
+template <typename Value>
+struct TopNEntry {
+    Value value{};
+    std::size_t index{0};
+};
+
+namespace TopN {
+    /// True if a ranks ahead of b (larger value, then lower index)
+    template <typename Value>
+    bool ranksBefore(const TopNEntry<Value>& a, const TopNEntry<Value>& b) noexcept {
+        return a.value > b.value || (a.value == b.value && a.index < b.index);
+    }
+
+    /**
+     * @brief Largest n values of values[0, count), best first
+     * @param numThreads Threads to use (<= 1 runs serially)
+     */
+    std::vector<TopNEntry<long long>> largest(const long long* values, std::size_t count, std::size_t n, int numThreads = 1);
+    std::vector<TopNEntry<double>> largest(const double* values, std::size_t count, std::size_t n, int numThreads = 1);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <omp.h>
+#include "top_n.hpp"
+
+/**
+ * @file top_n_engine.hpp
+ * @brief Parallel top-N engine with bounded per-thread candidate buffers
+ *
+ * Every thread offers its candidates to a private TopNCollector. The collector
+ * keeps up to 2N entries; when the buffer fills, std::nth_element cuts it back
+ * to the best N and the N-th entry becomes a cutoff that rejects most later
+ * candidates with a single comparison. Compaction costs O(N) per N accepted
+ * candidates, so selection stays O(count) for any N. The per-thread survivors
+ * (at most N each) are cut once more and only the final N are sorted.
+ *
+ * Like group_aggregate.hpp, the templates must be instantiated in a translation
+ * unit compiled with OpenMP (the core library); otherwise they run serially.
+ */
+
+/**
+ * @class TopNCollector
+ * @brief Single-threaded bounded buffer of the best N candidates seen so far
+ */
+template <typename Value>
+class TopNCollector {
+public:
+    using Entry = TopNEntry<Value>;
+
+    explicit TopNCollector(std::size_t n) : _n(n) {}
+
+    /// Offer the value of row `index`
+    void offer(Value value, std::size_t index) {
+        const Entry entry{value, index};
+        if (_bounded && !TopN::ranksBefore(entry, _cutoff)) return;
+        _buffer.push_back(entry);
+        if (_buffer.size() >= 2 * _n) {
+            compact();
+            _cutoff = _buffer.back();
+            _bounded = true;
+        }
+    }
+
+    /// Best min(n, offered) entries in unspecified order
+    std::vector<Entry>& finish() {
+        compact();
+        return _buffer;
+    }
+
+    void reserve(std::size_t n) { _buffer.reserve(n); }
+
+private:
+    std::size_t _n;
+    std::vector<Entry> _buffer;
+    Entry _cutoff{};          ///< Worst kept entry after the last compaction
+    bool _bounded{false};     ///< True once _cutoff is valid
+
+    void compact() {
+        if (_buffer.size() <= _n) return;
+        // After nth_element, [0, n) holds the best n and _buffer[n - 1] is the worst of them
+        std::nth_element(_buffer.begin(), _buffer.begin() + static_cast<std::ptrdiff_t>(_n - 1), _buffer.end(),
+                         TopN::ranksBefore<Value>);
+        _buffer.resize(_n);
+    }
+};
+
+namespace TopN {
+    /**
+     * @brief Select the n best candidates among items [0, count)
+     * @param count Number of items passed to candidate
+     * @param n Number of entries to return (fewer if fewer items qualify)
+     * @param numThreads Threads to use (<= 1 runs serially)
+     * @param candidate Callable bool candidate(i, Value& value); return false to skip item i
+     * @return Selected entries, best first
+     */
+    template <typename Value, typename Candidate>
+    std::vector<TopNEntry<Value>> select(std::size_t count, std::size_t n, int numThreads, Candidate candidate) {
+        std::vector<TopNEntry<Value>> result;
+        n = std::min(n, count);
+        if (n == 0) return result;
+
+        if (numThreads <= 1) {
+            TopNCollector<Value> collector(n);
+            collector.reserve(std::min(2 * n, count));
+            Value value{};
+            for (std::size_t i = 0; i < count; ++i) {
+                if (candidate(i, value)) collector.offer(value, i);
+            }
+            result.swap(collector.finish());
+        } else {
+            std::vector<std::vector<TopNEntry<Value>>> partials(static_cast<std::size_t>(numThreads));
+#pragma omp parallel num_threads(numThreads)
+            {
+                TopNCollector<Value> collector(n);
+                Value value{};
+#pragma omp for schedule(static)
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (candidate(i, value)) collector.offer(value, i);
+                }
+                partials[static_cast<std::size_t>(omp_get_thread_num())].swap(collector.finish());
+            }
+
+            // Every partial holds at most n entries: concatenate and cut to n once more
+            std::size_t total = 0;
+            for (const auto& partial : partials) total += partial.size();
+            result.reserve(total);
+            for (const auto& partial : partials) result.insert(result.end(), partial.begin(), partial.end());
+            if (result.size() > n) {
+                std::nth_element(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(n - 1), result.end(),
+                                 ranksBefore<Value>);
+                result.resize(n);
+            }
+        }
+
+        std::sort(result.begin(), result.end(), ranksBefore<Value>);
+        return result;
+    }
+}
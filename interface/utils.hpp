@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <chrono>
@@ -23,7 +24,28 @@ namespace Utils {
      * Handles leading/trailing whitespace gracefully and provides
      * safe parsing with consistent error handling across the project.
      */
-    long long parseLongOrZero(const std::string& s);
+    long long parseLongOrZero(std::string_view s) noexcept;
+
+    /**
+     * @brief Parse a leading integer from a view without allocating or throwing
+     * @param s Input characters (e.g. a CSVReader field view)
+     * @param out Parsed value on success
+     * @return True if at least one digit was consumed and the value fits
+     *
+     * Mirrors std::stoll: leading whitespace and '+' are skipped and trailing
+     * characters are ignored.
+     */
+    bool parseLong(std::string_view s, long long& out) noexcept;
+
+    /**
+     * @brief Parse a leading floating-point value from a view without throwing
+     * @param s Input characters (e.g. a CSVReader field view)
+     * @param out Parsed value on success
+     * @return True if a number was recognised, false otherwise
+     *
+     * Mirrors std::stod semantics, but works on non-null-terminated views.
+     */
+    bool parseDouble(std::string_view s, double& out) noexcept;
 
     // === Timing Utilities ===
     
@@ -2,8 +2,35 @@
 #include "../interface/constants.hpp"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 namespace BenchmarkRunner {
+    namespace {
+        /**
+         * Sets a service's grain to 0 for one serial-vs-parallel comparison, so the
+         * parallel run opens its full team even when the data is below the default
+         * grain (the population tables have a few hundred countries). The service's
+         * own context is restored on destruction.
+         */
+        class ForcedTeam {
+        public:
+            explicit ForcedTeam(IPopulationService& service)
+                : _service(service), _original(service.executionContext()) {
+                ExecutionContext context = _original;
+                context.grain = 0;
+                _service.setExecutionContext(context);
+            }
+            ~ForcedTeam() { _service.setExecutionContext(_original); }
+            ForcedTeam(const ForcedTeam&) = delete;
+            ForcedTeam& operator=(const ForcedTeam&) = delete;
+
+        private:
+            IPopulationService& _service;
+            ExecutionContext _original;
+        };
+    }
+
     template<typename T>
     void runAggregationBenchmark(
         const std::vector<std::reference_wrapper<IPopulationService>>& services,
@@ -12,6 +39,7 @@ namespace BenchmarkRunner {
         int /* year */,
         const BenchmarkConfig& config) {
         for (const auto& serviceRef : services) {
+            const ForcedTeam team(serviceRef.get());
             const IPopulationService& service = serviceRef.get();
             const std::string& implName = service.getImplementationName();
             T serialResult{}, parallelResult{};
@@ -40,6 +68,7 @@ namespace BenchmarkRunner {
         const std::string& country,
         const BenchmarkConfig& config) {
         for (const auto& serviceRef : services) {
+            const ForcedTeam team(serviceRef.get());
             const IPopulationService& service = serviceRef.get();
             const std::string& implName = service.getImplementationName();
             T serialResult{}, parallelResult{};
@@ -74,6 +103,142 @@ namespace BenchmarkRunner {
         std::function<std::vector<long long>(const IPopulationService&, const std::string&, int)>,
         const std::string&, const BenchmarkConfig&);
 
+    void runYearSummaryBenchmark(
+        const std::vector<std::reference_wrapper<IPopulationService>>& services,
+        int year,
+        const BenchmarkConfig& config) {
+        
+        for (const auto& serviceRef : services) {
+            const ForcedTeam team(serviceRef.get());
+            const IPopulationService& service = serviceRef.get();
+            const std::string& implName = service.getImplementationName();
+            
+            YearSummary serialResult, parallelResult;
+            
+            BenchmarkUtils::runAndReport(
+                "yearSummary (" + implName + ")",
+                [&]{ serialResult = service.yearSummary(year, 1); },
+                [&]{ parallelResult = service.yearSummary(year, config.parallelThreads); },
+                config.repetitions
+            );
+            
+            if (config.showValues) {
+                std::cout << "  -> sum=" << serialResult.sum << " mean=" << serialResult.mean
+                          << " min=" << serialResult.min << " (" << serialResult.minCountry << ")"
+                          << " max=" << serialResult.max << " (" << serialResult.maxCountry << ")\n";
+            }
+            
+            if (config.validateResults &&
+                (serialResult.sum != parallelResult.sum || serialResult.count != parallelResult.count ||
+                 serialResult.argmin != parallelResult.argmin || serialResult.argmax != parallelResult.argmax)) {
+                std::cout << "  ⚠️  WARNING: Serial/parallel result mismatch!\n";
+            }
+        }
+        std::cout << "\n";
+    }
+
+    void runYearBatchBenchmark(
+        const std::vector<std::reference_wrapper<IPopulationService>>& services,
+        const std::vector<int>& years,
+        const BenchmarkConfig& config) {
+        
+        for (const auto& serviceRef : services) {
+            const ForcedTeam team(serviceRef.get());
+            const IPopulationService& service = serviceRef.get();
+            const std::string& implName = service.getImplementationName();
+            
+            long long perYearTotal = 0;
+            auto perYear = [&](int numThreads) {
+                perYearTotal = 0;
+                for (int year : years) {
+                    perYearTotal += service.sumPopulationForYear(year, numThreads);
+                    perYearTotal += static_cast<long long>(service.averagePopulationForYear(year, numThreads));
+                    perYearTotal += service.maxPopulationForYear(year, numThreads);
+                    perYearTotal += service.minPopulationForYear(year, numThreads);
+                }
+            };
+            BenchmarkUtils::runAndReport(
+                "4 aggregates x " + std::to_string(years.size()) + " years (" + implName + ")",
+                [&]{ perYear(1); },
+                [&]{ perYear(config.parallelThreads); },
+                config.repetitions
+            );
+            
+            std::vector<YearSummary> serialResult, parallelResult;
+            BenchmarkUtils::runAndReport(
+                "yearSummaries x " + std::to_string(years.size()) + " years (" + implName + ")",
+                [&]{ serialResult = service.yearSummaries(years, 1); },
+                [&]{ parallelResult = service.yearSummaries(years, config.parallelThreads); },
+                config.repetitions
+            );
+            
+            if (config.validateResults) {
+                bool mismatch = serialResult.size() != parallelResult.size();
+                for (std::size_t j = 0; !mismatch && j < serialResult.size(); ++j) {
+                    mismatch = serialResult[j].sum != parallelResult[j].sum || serialResult[j].argmax != parallelResult[j].argmax;
+                }
+                if (mismatch) std::cout << "  ⚠️  WARNING: Serial/parallel result mismatch!\n";
+            }
+        }
+        std::cout << "\n";
+    }
+
+    void runConcurrentQueryBenchmark(
+        const std::vector<std::reference_wrapper<IPopulationService>>& services,
+        int year,
+        int callerThreads,
+        int queriesPerCaller,
+        const BenchmarkConfig& config) {
+        using Clock = std::chrono::steady_clock;
+        const std::size_t callers = static_cast<std::size_t>(std::max(1, callerThreads));
+        const std::size_t perCaller = static_cast<std::size_t>(std::max(1, queriesPerCaller));
+        
+        for (const auto& serviceRef : services) {
+            IPopulationService& service = serviceRef.get();
+            const ExecutionContext original = service.executionContext();
+            
+            ExecutionContext alwaysFork = original.withThreads(config.parallelThreads);
+            alwaysFork.grain = 0;
+            const ExecutionContext grained = original.withThreads(config.parallelThreads);
+            
+            std::cout << "sumPopulationForYear x " << callers * perCaller << " from " << callers
+                      << " callers (" << service.getImplementationName() << ")\n";
+            for (const auto& [label, context] : {std::make_pair("grain 0", alwaysFork),
+                                                 std::make_pair("context", grained)}) {
+                service.setExecutionContext(context);
+                std::vector<double> latencies(callers * perCaller);
+                auto start = Clock::now();
+                std::vector<std::thread> workers;
+                workers.reserve(callers);
+                for (std::size_t c = 0; c < callers; ++c) {
+                    workers.emplace_back([&, c] {
+                        for (std::size_t q = 0; q < perCaller; ++q) {
+                            auto t0 = Clock::now();
+                            volatile long long sink = service.sumPopulationForYear(year);
+                            (void)sink;
+                            latencies[c * perCaller + q] = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+                        }
+                    });
+                }
+                for (auto& worker : workers) worker.join();
+                double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                
+                std::sort(latencies.begin(), latencies.end());
+                const std::ios_base::fmtflags flags = std::cout.flags();
+                const std::streamsize precision = std::cout.precision();
+                auto percentile = [&](double p) { return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))]; };
+                std::cout << "  " << std::left << std::setw(9) << label << std::right << std::fixed << std::setprecision(1)
+                          << " p50=" << percentile(0.50) << "us p99=" << percentile(0.99) << "us max=" << latencies.back()
+                          << "us  " << std::setprecision(0) << static_cast<double>(latencies.size()) / seconds << " queries/s"
+                          << "  [" << context.describe() << "]\n";
+                std::cout.flags(flags);
+                std::cout.precision(precision);
+            }
+            service.setExecutionContext(original);
+        }
+        std::cout << "\n";
+    }
+
     void runTopNBenchmark(
         const std::vector<std::reference_wrapper<IPopulationService>>& services,
         const std::string& operationName,
@@ -82,6 +247,7 @@ namespace BenchmarkRunner {
         const BenchmarkConfig& config) {
         
         for (const auto& serviceRef : services) {
+            const ForcedTeam team(serviceRef.get());
             const IPopulationService& service = serviceRef.get();
             const std::string& implName = service.getImplementationName();
             
@@ -114,6 +280,7 @@ namespace BenchmarkRunner {
         const BenchmarkConfig& config) {
         
         for (const auto& serviceRef : services) {
+            const ForcedTeam team(serviceRef.get());
             const IPopulationService& service = serviceRef.get();
             const std::string& implName = service.getImplementationName();
             
@@ -146,7 +313,9 @@ namespace BenchmarkRunner {
         
         std::cout << "========================================\n";
         std::cout << "   COMPREHENSIVE BENCHMARK SUITE\n";
-        std::cout << "========================================\n\n";
+        std::cout << "========================================\n";
+        std::cout << "Parallel runs use " << config.parallelThreads
+                  << " threads with grain 0 (no inline fallback for small inputs)\n\n";
         
         // === Aggregation Benchmarks ===
         std::cout << "=== Aggregation Operations ===\n\n";
@@ -183,6 +352,16 @@ namespace BenchmarkRunner {
             midYear, config
         );
         
+        runYearSummaryBenchmark(services, midYear, config);
+        
+        if (!years.empty()) {
+            std::vector<int> allYears(years.begin(), years.end());
+            runYearBatchBenchmark(services, allYears, config);
+        }
+        
+        std::cout << "=== Concurrent Small Queries ===\n\n";
+        runConcurrentQueryBenchmark(services, midYear, config.parallelThreads, 2000, config);
+        
         // === Top-N Benchmarks ===
         std::cout << "=== Top-N Operations ===\n\n";
         
@@ -205,6 +384,15 @@ namespace BenchmarkRunner {
             int endYear = static_cast<int>(years[std::min(years.size() - 1, static_cast<std::size_t>(10))]);
             
             runYearRangeBenchmark(services, sampleCountry, startYear, endYear, config);
+            
+            int lastYear = static_cast<int>(*std::max_element(years.begin(), years.end()));
+            runCountryBenchmark<long long>(
+                services, "populationRangeForCountry sum " + std::to_string(startYear) + "-" + std::to_string(lastYear),
+                [startYear, lastYear](const IPopulationService& svc, const std::string& country, int) {
+                    return svc.populationRangeForCountry(country, startYear, lastYear).sum;
+                },
+                sampleCountry, config
+            );
         }
         
         std::cout << "========================================\n";
@@ -11,6 +11,7 @@
 #include "../interface/benchmark_utils.hpp"
 #include "../interface/constants.hpp"
 #include "../interface/utils.hpp"
+#include "../interface/columnar_snapshot.hpp"
 #include <iostream>
 #include <thread>
 #include <iomanip>
@@ -160,9 +161,11 @@ namespace BenchmarkUtils {
     
     ValidationResult initializeModels(const std::string& csvPath,
                                      PopulationModel& model,
-                                     PopulationModelColumn& modelCol) {
+                                     PopulationModelColumn& modelCol,
+                                     int numThreads,
+                                     const std::string& columnSnapshotPath) {
         try {
-            model.readFromCSV(csvPath);
+            model.readFromCSV(csvPath, numThreads);
         } catch (const std::exception& e) {
             return ValidationResult(false, "Failed to read CSV into row model: " + std::string(e.what()));
         } catch (...) {
@@ -170,7 +173,8 @@ namespace BenchmarkUtils {
         }
         
         try {
-            modelCol.readFromCSV(csvPath);
+            Snapshot::loadOrBuild(modelCol, columnSnapshotPath, csvPath,
+                                  [&] { modelCol.readFromCSV(csvPath, numThreads); });
         } catch (const std::exception& e) {
             return ValidationResult(false, "Failed to read CSV into column model: " + std::string(e.what()));
         } catch (...) {
@@ -0,0 +1,499 @@
+/**
+ * @file column_filter.cpp
+ * @brief Runtime-dispatched predicate kernels and the block-at-a-time filter driver
+ *
+ * Each kernel compares n values with an inclusive range and packs the results
+ * into 64-bit words, one bit per row. AVX2 compares 4 doubles or int64s, or 8
+ * int32s, per instruction and packs them with movemask. Unsigned codes are
+ * biased into signed order first, because AVX2 has no unsigned compare.
+ * AVX-512 compares produce the bit masks directly. A final partial word is
+ * always done by the scalar loop.
+ */
+
+#include "../interface/column_filter.hpp"
+#include "../interface/parallel_region.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define COLUMN_FILTER_X86 1
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(int) == 4, "Int32 predicates assume a 32-bit int");
+
+namespace ColumnFilter {
+    namespace {
+        constexpr std::size_t BLOCK_WORDS = BLOCK_ROWS / 64;
+
+        struct KernelTable {
+            void (*real)(const double*, std::size_t, double, double, std::uint64_t*);
+            void (*int32)(const int*, std::size_t, int, int, std::uint64_t*);
+            void (*uint32)(const std::uint32_t*, std::size_t, std::uint32_t, std::uint32_t, std::uint64_t*);
+            void (*int64)(const std::int64_t*, std::size_t, std::int64_t, std::int64_t, std::uint64_t*);
+        };
+
+        // === Portable fallback ===
+
+        template <typename T>
+        void rangeScalar(const T* values, std::size_t n, T low, T high, std::uint64_t* bits) {
+            for (std::size_t i = 0; i < n; i += 64) {
+                const std::size_t m = std::min<std::size_t>(64, n - i);
+                std::uint64_t word = 0;
+                for (std::size_t b = 0; b < m; ++b) {
+                    const T v = values[i + b];
+                    word |= static_cast<std::uint64_t>((v >= low) & (v <= high)) << b;
+                }
+                bits[i / 64] = word;
+            }
+        }
+
+        const KernelTable scalarKernels{rangeScalar<double>, rangeScalar<int>, rangeScalar<std::uint32_t>,
+                                        rangeScalar<std::int64_t>};
+
+#if defined(COLUMN_FILTER_X86)
+        // === AVX2: 4 x double / int64, 8 x int32 lanes ===
+
+        __attribute__((target("avx2")))
+        void realAVX2(const double* values, std::size_t n, double low, double high, std::uint64_t* bits) {
+            const __m256d lo = _mm256_set1_pd(low);
+            const __m256d hi = _mm256_set1_pd(high);
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t word = 0;
+                for (unsigned k = 0; k < 64; k += 4) {
+                    const __m256d v = _mm256_loadu_pd(values + i + k);
+                    const __m256d in = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ), _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+                    word |= static_cast<std::uint64_t>(_mm256_movemask_pd(in)) << k;
+                }
+                bits[i / 64] = word;
+            }
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        // Shared by the signed and (biased) unsigned int32 kernels
+        __attribute__((target("avx2")))
+        std::uint64_t int32WordAVX2(const void* values, __m256i lo, __m256i hi, __m256i bias) {
+            std::uint64_t word = 0;
+            for (unsigned k = 0; k < 64; k += 8) {
+                const __m256i v = _mm256_xor_si256(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(static_cast<const std::uint32_t*>(values) + k)), bias);
+                const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+                const auto in = static_cast<unsigned>(~_mm256_movemask_ps(_mm256_castsi256_ps(outside))) & 0xFFu;
+                word |= static_cast<std::uint64_t>(in) << k;
+            }
+            return word;
+        }
+
+        __attribute__((target("avx2")))
+        void int32AVX2(const int* values, std::size_t n, int low, int high, std::uint64_t* bits) {
+            const __m256i lo = _mm256_set1_epi32(low);
+            const __m256i hi = _mm256_set1_epi32(high);
+            const __m256i bias = _mm256_setzero_si256();
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) bits[i / 64] = int32WordAVX2(values + i, lo, hi, bias);
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        __attribute__((target("avx2")))
+        void uint32AVX2(const std::uint32_t* values, std::size_t n, std::uint32_t low, std::uint32_t high, std::uint64_t* bits) {
+            // Flipping the sign bit maps unsigned order onto signed order
+            constexpr std::uint32_t SIGN = 0x80000000u;
+            const __m256i lo = _mm256_set1_epi32(static_cast<int>(low ^ SIGN));
+            const __m256i hi = _mm256_set1_epi32(static_cast<int>(high ^ SIGN));
+            const __m256i bias = _mm256_set1_epi32(static_cast<int>(SIGN));
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) bits[i / 64] = int32WordAVX2(values + i, lo, hi, bias);
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        __attribute__((target("avx2")))
+        void int64AVX2(const std::int64_t* values, std::size_t n, std::int64_t low, std::int64_t high, std::uint64_t* bits) {
+            const __m256i lo = _mm256_set1_epi64x(low);
+            const __m256i hi = _mm256_set1_epi64x(high);
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t word = 0;
+                for (unsigned k = 0; k < 64; k += 4) {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + k));
+                    const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(lo, v), _mm256_cmpgt_epi64(v, hi));
+                    const auto in = static_cast<unsigned>(~_mm256_movemask_pd(_mm256_castsi256_pd(outside))) & 0xFu;
+                    word |= static_cast<std::uint64_t>(in) << k;
+                }
+                bits[i / 64] = word;
+            }
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        const KernelTable avx2Kernels{realAVX2, int32AVX2, uint32AVX2, int64AVX2};
+
+        // === AVX-512: compares write the mask registers directly ===
+
+        __attribute__((target("avx512f")))
+        void realAVX512(const double* values, std::size_t n, double low, double high, std::uint64_t* bits) {
+            const __m512d lo = _mm512_set1_pd(low);
+            const __m512d hi = _mm512_set1_pd(high);
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t word = 0;
+                for (unsigned k = 0; k < 64; k += 8) {
+                    const __m512d v = _mm512_loadu_pd(values + i + k);
+                    const __mmask8 in = _mm512_mask_cmp_pd_mask(_mm512_cmp_pd_mask(v, lo, _CMP_GE_OQ), v, hi, _CMP_LE_OQ);
+                    word |= static_cast<std::uint64_t>(in) << k;
+                }
+                bits[i / 64] = word;
+            }
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        __attribute__((target("avx512f")))
+        void int32AVX512(const int* values, std::size_t n, int low, int high, std::uint64_t* bits) {
+            const __m512i lo = _mm512_set1_epi32(low);
+            const __m512i hi = _mm512_set1_epi32(high);
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t word = 0;
+                for (unsigned k = 0; k < 64; k += 16) {
+                    const __m512i v = _mm512_loadu_si512(values + i + k);
+                    const __mmask16 in = _mm512_mask_cmple_epi32_mask(_mm512_cmpge_epi32_mask(v, lo), v, hi);
+                    word |= static_cast<std::uint64_t>(in) << k;
+                }
+                bits[i / 64] = word;
+            }
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        __attribute__((target("avx512f")))
+        void uint32AVX512(const std::uint32_t* values, std::size_t n, std::uint32_t low, std::uint32_t high, std::uint64_t* bits) {
+            const __m512i lo = _mm512_set1_epi32(static_cast<int>(low));
+            const __m512i hi = _mm512_set1_epi32(static_cast<int>(high));
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t word = 0;
+                for (unsigned k = 0; k < 64; k += 16) {
+                    const __m512i v = _mm512_loadu_si512(values + i + k);
+                    const __mmask16 in = _mm512_mask_cmple_epu32_mask(_mm512_cmpge_epu32_mask(v, lo), v, hi);
+                    word |= static_cast<std::uint64_t>(in) << k;
+                }
+                bits[i / 64] = word;
+            }
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        __attribute__((target("avx512f")))
+        void int64AVX512(const std::int64_t* values, std::size_t n, std::int64_t low, std::int64_t high, std::uint64_t* bits) {
+            const __m512i lo = _mm512_set1_epi64(low);
+            const __m512i hi = _mm512_set1_epi64(high);
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t word = 0;
+                for (unsigned k = 0; k < 64; k += 8) {
+                    const __m512i v = _mm512_loadu_si512(values + i + k);
+                    const __mmask8 in = _mm512_mask_cmple_epi64_mask(_mm512_cmpge_epi64_mask(v, lo), v, hi);
+                    word |= static_cast<std::uint64_t>(in) << k;
+                }
+                bits[i / 64] = word;
+            }
+            if (i < n) rangeScalar(values + i, n - i, low, high, bits + i / 64);
+        }
+
+        const KernelTable avx512Kernels{realAVX512, int32AVX512, uint32AVX512, int64AVX512};
+#endif
+
+        const KernelTable& kernelTable(Kernel kernel) {
+            switch (kernel) {
+#if defined(COLUMN_FILTER_X86)
+                case Kernel::AVX512: return avx512Kernels;
+                case Kernel::AVX2: return avx2Kernels;
+#endif
+                default: return scalarKernels;
+            }
+        }
+
+        std::atomic<Kernel>& currentKernel() {
+            static std::atomic<Kernel> kernel{detectKernel()};
+            return kernel;
+        }
+
+        /// Inclusive integer bounds of a comparison; low > high matches nothing
+        struct Bounds {
+            std::int64_t low;
+            std::int64_t high;
+            bool negated;
+        };
+
+        template <typename T>
+        Bounds integerBounds(Op op, T value) {
+            constexpr auto MIN = static_cast<std::int64_t>(std::numeric_limits<T>::min());
+            constexpr auto MAX = static_cast<std::int64_t>(std::numeric_limits<T>::max());
+            const auto v = static_cast<std::int64_t>(value);
+            switch (op) {
+                case Op::Less: return v == MIN ? Bounds{1, 0, false} : Bounds{MIN, v - 1, false};
+                case Op::LessEqual: return Bounds{MIN, v, false};
+                case Op::Greater: return v == MAX ? Bounds{1, 0, false} : Bounds{v + 1, MAX, false};
+                case Op::GreaterEqual: return Bounds{v, MAX, false};
+                case Op::Equal: return Bounds{v, v, false};
+                default: return Bounds{v, v, true};
+            }
+        }
+
+        std::size_t blockCount(std::size_t rows) { return (rows + BLOCK_ROWS - 1) / BLOCK_ROWS; }
+    }
+
+    bool isSupported(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::Scalar: return true;
+#if defined(COLUMN_FILTER_X86)
+            case Kernel::AVX2: return __builtin_cpu_supports("avx2");
+            case Kernel::AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+            default: return false;
+        }
+    }
+
+    Kernel detectKernel() noexcept {
+        if (isSupported(Kernel::AVX512)) return Kernel::AVX512;
+        if (isSupported(Kernel::AVX2)) return Kernel::AVX2;
+        return Kernel::Scalar;
+    }
+
+    Kernel activeKernel() noexcept { return currentKernel().load(std::memory_order_relaxed); }
+
+    bool selectKernel(Kernel kernel) noexcept {
+        if (!isSupported(kernel)) return false;
+        currentKernel().store(kernel, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* kernelName(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::AVX512: return "AVX-512";
+            case Kernel::AVX2: return "AVX2";
+            default: return "Scalar";
+        }
+    }
+
+    // === Predicate ===
+
+    template <typename T>
+    Predicate Predicate::integer(ColumnView<T> column, Type type, std::int64_t low, std::int64_t high, bool negated) {
+        constexpr auto MIN = static_cast<std::int64_t>(std::numeric_limits<T>::min());
+        constexpr auto MAX = static_cast<std::int64_t>(std::numeric_limits<T>::max());
+        Predicate predicate;
+        predicate._values = column.data();
+        predicate._size = column.size();
+        predicate._type = type;
+        predicate._negated = negated;
+        low = std::max(low, MIN);
+        high = std::min(high, MAX);
+        if (low > high) {
+            // Empty, and still empty once narrowed to T
+            low = MAX;
+            high = MIN;
+        }
+        predicate._int_low = low;
+        predicate._int_high = high;
+        return predicate;
+    }
+
+    Predicate Predicate::real(ColumnView<double> column, double low, double high, bool negated) {
+        Predicate predicate;
+        predicate._values = column.data();
+        predicate._size = column.size();
+        predicate._type = Type::Double;
+        predicate._negated = negated;
+        predicate._real_low = low;
+        predicate._real_high = high;
+        return predicate;
+    }
+
+    Predicate Predicate::compare(ColumnView<double> column, Op op, double value) {
+        constexpr double INF = std::numeric_limits<double>::infinity();
+        switch (op) {
+            // Strict bounds move to the next representable double; nothing is below -inf or above +inf
+            case Op::Less: return value > -INF ? real(column, -INF, std::nextafter(value, -INF), false) : real(column, 1.0, 0.0, false);
+            case Op::LessEqual: return real(column, -INF, value, false);
+            case Op::Greater: return value < INF ? real(column, std::nextafter(value, INF), INF, false) : real(column, 1.0, 0.0, false);
+            case Op::GreaterEqual: return real(column, value, INF, false);
+            case Op::Equal: return real(column, value, value, false);
+            default: return real(column, value, value, true);
+        }
+    }
+
+    Predicate Predicate::compare(ColumnView<int> column, Op op, int value) {
+        const Bounds b = integerBounds(op, value);
+        return integer(column, Type::Int32, b.low, b.high, b.negated);
+    }
+
+    Predicate Predicate::compare(ColumnView<std::uint32_t> column, Op op, std::uint32_t value) {
+        const Bounds b = integerBounds(op, value);
+        return integer(column, Type::UInt32, b.low, b.high, b.negated);
+    }
+
+    Predicate Predicate::compare(ColumnView<std::int64_t> column, Op op, std::int64_t value) {
+        const Bounds b = integerBounds(op, value);
+        return integer(column, Type::Int64, b.low, b.high, b.negated);
+    }
+
+    Predicate Predicate::between(ColumnView<double> column, double low, double high) {
+        return real(column, low, high, false);
+    }
+
+    Predicate Predicate::between(ColumnView<int> column, int low, int high) {
+        return integer(column, Type::Int32, low, high, false);
+    }
+
+    Predicate Predicate::between(ColumnView<std::uint32_t> column, std::uint32_t low, std::uint32_t high) {
+        return integer(column, Type::UInt32, low, high, false);
+    }
+
+    Predicate Predicate::between(ColumnView<std::int64_t> column, std::int64_t low, std::int64_t high) {
+        return integer(column, Type::Int64, low, high, false);
+    }
+
+    std::size_t Predicate::valueBytes() const noexcept {
+        return _type == Type::Double || _type == Type::Int64 ? 8 : 4;
+    }
+
+    void Predicate::evaluate(std::size_t begin, std::size_t n, std::uint64_t* bits) const noexcept {
+        const KernelTable& kernels = kernelTable(activeKernel());
+        switch (_type) {
+            case Type::Double:
+                kernels.real(static_cast<const double*>(_values) + begin, n, _real_low, _real_high, bits);
+                break;
+            case Type::Int32:
+                kernels.int32(static_cast<const int*>(_values) + begin, n, static_cast<int>(_int_low),
+                              static_cast<int>(_int_high), bits);
+                break;
+            case Type::UInt32:
+                kernels.uint32(static_cast<const std::uint32_t*>(_values) + begin, n, static_cast<std::uint32_t>(_int_low),
+                               static_cast<std::uint32_t>(_int_high), bits);
+                break;
+            case Type::Int64:
+                kernels.int64(static_cast<const std::int64_t*>(_values) + begin, n, _int_low, _int_high, bits);
+                break;
+        }
+        if (!_negated) return;
+        const std::size_t words = (n + 63) / 64;
+        for (std::size_t w = 0; w < words; ++w) bits[w] = ~bits[w];
+        if (n % 64 != 0) bits[words - 1] &= (std::uint64_t{1} << (n % 64)) - 1;
+    }
+
+    // === Selection ===
+
+    std::size_t Selection::count() const noexcept {
+        std::size_t selected = 0;
+        for (std::uint64_t word : _words) selected += static_cast<std::size_t>(__builtin_popcountll(word));
+        return selected;
+    }
+
+    std::vector<std::size_t> Selection::toIndices() const {
+        std::vector<std::size_t> indices;
+        indices.reserve(count());
+        for (std::size_t w = 0; w < _words.size(); ++w) {
+            for (std::uint64_t word = _words[w]; word != 0; word &= word - 1) {
+                indices.push_back(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word)));
+            }
+        }
+        return indices;
+    }
+
+    // === Filter ===
+
+    Filter& Filter::where(const Predicate& predicate) {
+        if (predicate.size() != _rows) {
+            throw std::invalid_argument("ColumnFilter: predicate column has " + std::to_string(predicate.size()) +
+                                        " rows, filter has " + std::to_string(_rows));
+        }
+        _predicates.push_back(predicate);
+        return *this;
+    }
+
+    std::size_t Filter::scannedBytes() const noexcept {
+        std::size_t bytes = 0;
+        for (const Predicate& predicate : _predicates) bytes += predicate.valueBytes() * _rows;
+        return bytes;
+    }
+
+    bool Filter::evaluateBlock(std::size_t begin, std::size_t n, std::uint64_t* mask) const noexcept {
+        const std::size_t words = (n + 63) / 64;
+        std::fill(mask, mask + words, ~std::uint64_t{0});
+        if (n % 64 != 0) mask[words - 1] = (std::uint64_t{1} << (n % 64)) - 1;
+        std::uint64_t bits[BLOCK_WORDS];
+        for (const Predicate& predicate : _predicates) {
+            predicate.evaluate(begin, n, bits);
+            std::uint64_t any = 0;
+            for (std::size_t w = 0; w < words; ++w) any |= (mask[w] &= bits[w]);
+            if (any == 0) return false;
+        }
+        return true;
+    }
+
+    Selection Filter::select(const ExecutionContext& context) const {
+        Selection selection(_rows);
+        std::uint64_t* words = selection.data();
+        const std::size_t blocks = blockCount(_rows);
+        // Blocks are whole words apart, so threads never write the same word
+        Parallel::forEach(context.withWork(blocks, _rows), blocks, [&](std::size_t b) {
+            const std::size_t begin = b * BLOCK_ROWS;
+            evaluateBlock(begin, std::min(BLOCK_ROWS, _rows - begin), words + begin / 64);
+        });
+        return selection;
+    }
+
+    std::size_t Filter::count(const ExecutionContext& context) const {
+        const std::size_t blocks = blockCount(_rows);
+        return Parallel::reduce(context.withWork(blocks, _rows), blocks, std::size_t{0},
+            [&](std::size_t b, std::size_t& local) {
+                std::uint64_t mask[BLOCK_WORDS];
+                const std::size_t begin = b * BLOCK_ROWS;
+                const std::size_t n = std::min(BLOCK_ROWS, _rows - begin);
+                if (!evaluateBlock(begin, n, mask)) return;
+                for (std::size_t w = 0; w < (n + 63) / 64; ++w) local += static_cast<std::size_t>(__builtin_popcountll(mask[w]));
+            },
+            [](std::size_t& into, std::size_t from) { into += from; });
+    }
+
+    template <typename T>
+    GroupAggregate Filter::aggregateValues(ColumnView<T> values, const ExecutionContext& context) const {
+        if (values.size() != _rows) {
+            throw std::invalid_argument("ColumnFilter: aggregated column has " + std::to_string(values.size()) +
+                                        " rows, filter has " + std::to_string(_rows));
+        }
+        const std::size_t blocks = blockCount(_rows);
+        return Parallel::reduce(context.withWork(blocks, _rows), blocks, GroupAggregate{},
+            [&](std::size_t b, GroupAggregate& local) {
+                std::uint64_t mask[BLOCK_WORDS];
+                const std::size_t begin = b * BLOCK_ROWS;
+                const std::size_t n = std::min(BLOCK_ROWS, _rows - begin);
+                if (!evaluateBlock(begin, n, mask)) return;
+
+                // Selection vector of the block's passing rows, then one tight loop over them
+                std::uint16_t selected[BLOCK_ROWS];
+                std::size_t count = 0;
+                for (std::size_t w = 0; w < (n + 63) / 64; ++w) {
+                    for (std::uint64_t word = mask[w]; word != 0; word &= word - 1) {
+                        selected[count++] = static_cast<std::uint16_t>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word)));
+                    }
+                }
+                const T* block = values.data() + begin;
+                GroupAggregate part;
+                for (std::size_t k = 0; k < count; ++k) part.add(static_cast<double>(block[selected[k]]));
+                local.merge(part);
+            },
+            [](GroupAggregate& into, const GroupAggregate& from) { into.merge(from); });
+    }
+
+    GroupAggregate Filter::aggregate(ColumnView<double> values, const ExecutionContext& context) const {
+        return aggregateValues(values, context);
+    }
+
+    GroupAggregate Filter::aggregate(ColumnView<int> values, const ExecutionContext& context) const {
+        return aggregateValues(values, context);
+    }
+}
@@ -0,0 +1,284 @@
+#include "../interface/columnar_snapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char MAGIC[8] = {'C', 'O', 'L', 'S', 'N', 'A', 'P', '\0'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+    constexpr std::uint64_t P1 = 11400714785074694791ULL;
+    constexpr std::uint64_t P2 = 14029467366897019727ULL;
+    constexpr std::uint64_t P3 = 1609587929392839161ULL;
+    constexpr std::uint64_t P4 = 9650029242287828579ULL;
+    constexpr std::uint64_t P5 = 2870177450012600261ULL;
+
+    /// Flush a file or directory to stable storage; false if it cannot be opened or synced
+    bool syncPath(const std::string& path, bool directory) {
+#if defined(_WIN32)
+        (void)path;
+        (void)directory;
+        return true;
+#else
+        const int fd = ::open(path.c_str(), directory ? (O_RDONLY | O_DIRECTORY) : O_RDONLY);
+        if (fd < 0) return false;
+        const bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+#endif
+    }
+
+    inline std::uint64_t rotl(std::uint64_t x, int r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+    inline std::uint64_t read64(const unsigned char* p) noexcept {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline std::uint32_t read32(const unsigned char* p) noexcept {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline std::uint64_t round(std::uint64_t acc, std::uint64_t input) noexcept {
+        return rotl(acc + input * P2, 31) * P1;
+    }
+
+    inline std::uint64_t mergeRound(std::uint64_t acc, std::uint64_t lane) noexcept {
+        return (acc ^ round(0, lane)) * P1 + P4;
+    }
+
+    std::size_t alignUp(std::size_t n) {
+        return (n + Snapshot::SECTION_ALIGNMENT - 1) / Snapshot::SECTION_ALIGNMENT * Snapshot::SECTION_ALIGNMENT;
+    }
+
+    std::uint64_t headerChecksum(const Snapshot::FileHeader& header) noexcept {
+        return Snapshot::checksum(&header, offsetof(Snapshot::FileHeader, headerChecksum));
+    }
+}
+
+namespace Snapshot {
+
+    std::uint64_t checksum(const void* data, std::size_t bytes, std::uint64_t seed) noexcept {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const unsigned char* const end = p + bytes;
+        std::uint64_t h;
+        if (bytes >= 32) {
+            // Four independent lanes keep several multiplies in flight per cycle
+            std::uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+            const unsigned char* const limit = end - 32;
+            do {
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h = mergeRound(h, v1);
+            h = mergeRound(h, v2);
+            h = mergeRound(h, v3);
+            h = mergeRound(h, v4);
+        } else {
+            h = seed + P5;
+        }
+        h += static_cast<std::uint64_t>(bytes);
+        for (; p + 8 <= end; p += 8) h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+        if (p + 4 <= end) {
+            h = rotl(h ^ (static_cast<std::uint64_t>(read32(p)) * P1), 23) * P2 + P3;
+            p += 4;
+        }
+        for (; p < end; ++p) h = rotl(h ^ (*p * P5), 11) * P1;
+        h ^= h >> 33;
+        h *= P2;
+        h ^= h >> 29;
+        h *= P3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    bool isFresh(const std::string& snapshotPath, const std::string& sourcePath) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        const auto snapshotTime = fs::last_write_time(snapshotPath, ec);
+        if (ec) return false;
+        if (!fs::is_directory(sourcePath, ec)) {
+            const auto sourceTime = fs::last_write_time(sourcePath, ec);
+            return !ec && sourceTime <= snapshotTime;
+        }
+        for (fs::recursive_directory_iterator it(sourcePath, ec), last; !ec && it != last; it.increment(ec)) {
+            if (!it->is_regular_file(ec)) continue;
+            if (it->last_write_time(ec) > snapshotTime) return false;
+        }
+        return !ec;
+    }
+
+    void replaceFile(const std::string& path, const std::string& what, std::ios::openmode mode,
+                     const std::function<void(std::ostream&)>& fill) {
+        const std::string tempPath = path + ".tmp";
+        std::error_code ec;
+        try {
+            {
+                std::ofstream out(tempPath, mode | std::ios::out | std::ios::trunc);
+                if (!out) throw std::runtime_error("Failed to create " + what + " " + tempPath);
+                fill(out);
+                if (!out.flush()) throw std::runtime_error("Failed to write " + what + " " + tempPath);
+            }
+            if (!syncPath(tempPath, false)) throw std::runtime_error("Failed to sync " + what + " " + tempPath);
+            std::filesystem::rename(tempPath, path, ec);
+            if (ec) throw std::runtime_error("Failed to replace " + what + " " + path);
+        } catch (...) {
+            std::filesystem::remove(tempPath, ec);
+            throw;
+        }
+        // The new contents are already in place; syncing the directory only makes the rename durable
+        const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        syncPath(parent.empty() ? std::string(".") : parent.string(), true);
+    }
+
+    void Writer::add(std::uint32_t id, std::uint32_t elementSize, const void* data, std::size_t count) {
+        for (const auto& pending : _sections) {
+            if (pending.id == id) throw std::logic_error("Duplicate snapshot section " + std::to_string(id));
+        }
+        _sections.push_back({id, elementSize, data, count});
+    }
+
+    void Writer::strings(std::uint32_t id, const std::vector<std::string>& values) {
+        // [count][offsets x (count + 1)][bytes], offsets relative to the start of the bytes
+        const std::uint64_t count = values.size();
+        std::vector<std::uint64_t> offsets(values.size() + 1, 0);
+        for (std::size_t i = 0; i < values.size(); ++i) offsets[i + 1] = offsets[i] + values[i].size();
+        std::vector<char>& encoded = _encoded.emplace_back(sizeof(count) + offsets.size() * sizeof(std::uint64_t) + offsets.back());
+        char* out = encoded.data();
+        std::memcpy(out, &count, sizeof(count));
+        out += sizeof(count);
+        std::memcpy(out, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+        out += offsets.size() * sizeof(std::uint64_t);
+        for (const auto& value : values) {
+            std::memcpy(out, value.data(), value.size());
+            out += value.size();
+        }
+        add(id, 1, encoded.data(), encoded.size());
+    }
+
+    void Writer::write(const std::string& path) const {
+        std::vector<SectionEntry> table(_sections.size());
+        std::size_t offset = alignUp(sizeof(FileHeader) + table.size() * sizeof(SectionEntry));
+        for (std::size_t s = 0; s < _sections.size(); ++s) {
+            const Pending& pending = _sections[s];
+            const std::size_t bytes = pending.count * pending.elementSize;
+            table[s] = {pending.id, pending.elementSize, offset, pending.count, checksum(pending.data, bytes)};
+            offset = alignUp(offset + bytes);
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.kind = static_cast<std::uint32_t>(_kind);
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.sectionCount = static_cast<std::uint32_t>(table.size());
+        header.fileSize = offset;
+        header.tableChecksum = checksum(table.data(), table.size() * sizeof(SectionEntry));
+        header.headerChecksum = headerChecksum(header);
+
+        replaceFile(path, "snapshot", std::ios::binary, [&](std::ostream& out) {
+            static const char zeros[SECTION_ALIGNMENT] = {};
+            std::size_t written = 0;
+            auto put = [&](const void* data, std::size_t bytes) {
+                out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+                written += bytes;
+            };
+            auto pad = [&] { put(zeros, alignUp(written) - written); };
+            put(&header, sizeof(header));
+            put(table.data(), table.size() * sizeof(SectionEntry));
+            for (const Pending& pending : _sections) {
+                pad();
+                put(pending.data, pending.count * pending.elementSize);
+            }
+            pad();
+        });
+    }
+
+    Reader::Reader(const std::string& path, Kind kind, bool verifyChecksums) : _path(path) {
+        auto file = std::make_shared<MappedFile>(path, MappedFile::Access::Normal);
+        auto fail = [&](const std::string& why) { return std::runtime_error("Invalid snapshot " + path + ": " + why); };
+
+        FileHeader header;
+        if (file->size() < sizeof(header)) throw fail("file too small");
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) throw fail("not a snapshot");
+        if (header.byteOrder != BYTE_ORDER_MARK) throw fail("written on a machine with another byte order");
+        if (header.headerChecksum != headerChecksum(header)) throw fail("header checksum mismatch");
+        if (header.version != VERSION) {
+            throw fail("format version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION));
+        }
+        if (header.kind != static_cast<std::uint32_t>(kind)) throw fail("holds another model kind");
+        if (header.fileSize != file->size()) throw fail("truncated or extended");
+
+        const std::size_t tableBytes = static_cast<std::size_t>(header.sectionCount) * sizeof(SectionEntry);
+        if (tableBytes > file->size() - sizeof(header)) throw fail("section table out of bounds");
+        _sections.resize(header.sectionCount);
+        std::memcpy(_sections.data(), file->data() + sizeof(header), tableBytes);
+        if (checksum(_sections.data(), tableBytes) != header.tableChecksum) throw fail("section table checksum mismatch");
+
+        for (const SectionEntry& entry : _sections) {
+            const std::uint64_t size = file->size();
+            if (entry.elementSize == 0 || entry.offset > size ||
+                entry.count > (size - entry.offset) / entry.elementSize) {
+                throw fail("section " + std::to_string(entry.id) + " out of bounds");
+            }
+            if (verifyChecksums && checksum(file->data() + entry.offset, entry.count * entry.elementSize) != entry.checksum) {
+                throw fail("section " + std::to_string(entry.id) + " checksum mismatch");
+            }
+        }
+        _file = std::move(file);
+    }
+
+    const SectionEntry* Reader::find(std::uint32_t id) const noexcept {
+        auto it = std::find_if(_sections.begin(), _sections.end(), [id](const SectionEntry& e) { return e.id == id; });
+        return it == _sections.end() ? nullptr : &*it;
+    }
+
+    const SectionEntry& Reader::section(std::uint32_t id, std::size_t elementSize) const {
+        const SectionEntry* entry = find(id);
+        if (!entry) throw std::runtime_error("Snapshot " + _path + " has no section " + std::to_string(id));
+        if (entry->elementSize != elementSize) {
+            throw std::runtime_error("Snapshot section " + std::to_string(id) + " in " + _path + " has element size " +
+                                     std::to_string(entry->elementSize) + ", expected " + std::to_string(elementSize));
+        }
+        return *entry;
+    }
+
+    std::vector<std::string> Reader::strings(std::uint32_t id) const {
+        const ColumnView<char> bytes = column<char>(id);
+        auto corrupt = [&] { return std::runtime_error("Snapshot string section " + std::to_string(id) + " is corrupt in " + _path); };
+        std::uint64_t count;
+        if (bytes.size() < sizeof(count)) throw corrupt();
+        std::memcpy(&count, bytes.data(), sizeof(count));
+        const std::size_t available = (bytes.size() - sizeof(count)) / sizeof(std::uint64_t);
+        if (count >= available) throw corrupt();
+        std::vector<std::uint64_t> offsets(static_cast<std::size_t>(count) + 1);
+        std::memcpy(offsets.data(), bytes.data() + sizeof(count), offsets.size() * sizeof(std::uint64_t));
+        const char* text = bytes.data() + sizeof(count) + offsets.size() * sizeof(std::uint64_t);
+        const std::size_t textBytes = static_cast<std::size_t>(bytes.end() - text);
+
+        std::vector<std::string> values;
+        values.reserve(static_cast<std::size_t>(count));
+        for (std::size_t i = 0; i < count; ++i) {
+            if (offsets[i] > offsets[i + 1] || offsets[i + 1] > textBytes) throw corrupt();
+            values.emplace_back(text + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i]));
+        }
+        return values;
+    }
+
+}
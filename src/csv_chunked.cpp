@@ -0,0 +1,149 @@
+/**
+ * @file csv_chunked.cpp
+ * @brief Record-aligned chunking and parallel population CSV parsing
+ */
+
+#include "../interface/csv_chunked.hpp"
+#include "../interface/mapped_file.hpp"
+#include "../interface/readcsv.hpp"
+#include "../interface/utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <omp.h>
+
+namespace CSVChunked {
+    std::vector<Range> splitRecords(std::string_view data, int parts, char quote, char comment) {
+        const std::size_t n = data.size();
+        if (parts <= 1 || n == 0) return {Range{0, n}};
+
+        std::size_t count = static_cast<std::size_t>(parts);
+        std::vector<std::size_t> nominal(count + 1);
+        for (std::size_t p = 0; p <= count; ++p) nominal[p] = n * p / count;
+
+        // Pass 1 (parallel): quote parity of each nominal range, and whether any
+        // line in it starts with the comment character
+        std::vector<unsigned char> parity(count, 0);
+        std::vector<unsigned char> hasComment(count, 0);
+#pragma omp parallel for num_threads(parts) schedule(static, 1)
+        for (std::size_t p = 0; p < count; ++p) {
+            std::size_t quotes = 0;
+            bool comment_seen = false;
+            bool lineStart = (nominal[p] == 0) || data[nominal[p] - 1] == '\n';
+            for (std::size_t i = nominal[p]; i < nominal[p + 1]; ++i) {
+                char c = data[i];
+                if (c == quote) ++quotes;
+                if (lineStart && c != ' ' && c != '\t') {
+                    if (c == comment) comment_seen = true;
+                    lineStart = false;
+                }
+                if (c == '\n') lineStart = true;
+            }
+            parity[p] = static_cast<unsigned char>(quotes & 1);
+            hasComment[p] = comment_seen ? 1 : 0;
+        }
+        if (std::find(hasComment.begin(), hasComment.end(), 1) != hasComment.end()) {
+            return {Range{0, n}};
+        }
+
+        // Pass 2: quote state at each nominal split is the XOR of all earlier parities;
+        // walk forward to the first newline outside quotes
+        std::vector<Range> ranges;
+        std::size_t begin = 0;
+        bool inside = false;
+        for (std::size_t p = 1; p < count; ++p) {
+            inside ^= (parity[p - 1] != 0);
+            std::size_t split = nominal[p];
+            if (split <= begin) continue;
+            bool state = inside;
+            std::size_t i = split;
+            for (; i < n; ++i) {
+                char c = data[i];
+                if (c == quote) state = !state;
+                else if (c == '\n' && !state) break;
+            }
+            if (i >= n) break;
+            ranges.push_back(Range{begin, i + 1});
+            begin = i + 1;
+        }
+        if (begin < n) ranges.push_back(Range{begin, n});
+        return ranges;
+    }
+}
+
+namespace PopulationCSV {
+    namespace {
+        // Parse one record-aligned slice; the first row of the file is the header
+        void parseChunk(std::string_view slice, bool hasHeader, PopulationCSVData& out) {
+            CSVReader reader(std::string(), Config::DEFAULT_CSV_DELIMITER, Config::DEFAULT_CSV_QUOTE,
+                             Config::DEFAULT_CSV_COMMENT, CSVReader::Mode::Mapped);
+            reader.openBuffer(slice);
+            std::vector<std::string_view> row;
+            bool headerRead = !hasHeader;
+            while (reader.readRowViews(row)) {
+                if (!headerRead) {
+                    for (std::size_t i = 4; i < row.size(); ++i) {
+                        if (row[i].empty()) continue;
+                        out.years.push_back(Utils::parseLongOrZero(row[i]));
+                    }
+                    headerRead = true;
+                    continue;
+                }
+                if (row.size() < 5) continue;
+                out.countryNames.emplace_back(row[0]);
+                out.countryCodes.emplace_back(row[1]);
+                out.indicatorNames.emplace_back(row[2]);
+                out.indicatorCodes.emplace_back(row[3]);
+                for (std::size_t i = 4; i < row.size(); ++i) {
+                    out.values.push_back(row[i].empty() ? 0 : Utils::parseLongOrZero(row[i]));
+                }
+                out.rowOffsets.push_back(out.values.size());
+            }
+        }
+
+        template <typename T>
+        void appendMoved(std::vector<T>& dst, std::vector<T>& src) {
+            dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+        }
+    }
+
+    bool readParallel(const std::string& filename, int numThreads, PopulationCSVData& out) {
+        MappedFile file;
+        try { file.open(filename); } catch (const std::exception& e) {
+            std::cerr << "Failed to open CSV: " << e.what() << "\n";
+            return false;
+        }
+        std::string_view data = file.view();
+        std::vector<CSVChunked::Range> ranges = CSVChunked::splitRecords(data, std::max(1, numThreads));
+
+        std::vector<PopulationCSVData> parts(ranges.size());
+        const int nChunks = static_cast<int>(ranges.size());
+#pragma omp parallel for num_threads(std::max(1, numThreads)) schedule(static, 1)
+        for (int c = 0; c < nChunks; ++c) {
+            const auto& r = ranges[static_cast<std::size_t>(c)];
+            parseChunk(data.substr(r.begin, r.end - r.begin), c == 0, parts[static_cast<std::size_t>(c)]);
+        }
+
+        // Concatenate chunk results in file order, rebasing value offsets
+        out = PopulationCSVData();
+        out.years = std::move(parts.front().years);
+        std::size_t rows = 0, values = 0;
+        for (const auto& p : parts) { rows += p.rowCount(); values += p.values.size(); }
+        out.countryNames.reserve(rows);
+        out.countryCodes.reserve(rows);
+        out.indicatorNames.reserve(rows);
+        out.indicatorCodes.reserve(rows);
+        out.rowOffsets.reserve(rows + 1);
+        out.values.reserve(values);
+        for (auto& p : parts) {
+            std::size_t base = out.values.size();
+            appendMoved(out.countryNames, p.countryNames);
+            appendMoved(out.countryCodes, p.countryCodes);
+            appendMoved(out.indicatorNames, p.indicatorNames);
+            appendMoved(out.indicatorCodes, p.indicatorCodes);
+            out.values.insert(out.values.end(), p.values.begin(), p.values.end());
+            for (std::size_t i = 1; i < p.rowOffsets.size(); ++i) out.rowOffsets.push_back(base + p.rowOffsets[i]);
+        }
+        return true;
+    }
+}
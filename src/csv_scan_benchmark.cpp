@@ -0,0 +1,132 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+#include "../interface/readcsv.hpp"
+#include "../interface/csv_scanner.hpp"
+#include "../interface/constants.hpp"
+
+/**
+ * @file csv_scan_benchmark.cpp
+ * @brief Micro-benchmark: scalar CSV splitter vs. vectorized structural scanner
+ *
+ * Parses every CSV file under the fire data directory (FIRE_DATA_PATH or
+ * data/FireData) with the original getline + splitRecord path and with the
+ * mapped structural-index path for each kernel the CPU supports.
+ *
+ * Usage: ./OpenMP_Mini1_Project_csv_benchmark [repetitions]
+ */
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+    struct PassResult {
+        std::size_t rows = 0;
+        std::size_t fields = 0;
+        double seconds = 0.0;
+    };
+
+    PassResult streamPass(const std::vector<std::string>& files) {
+        PassResult r;
+        std::vector<std::string> row;
+        auto t0 = Clock::now();
+        for (const auto& file : files) {
+            CSVReader reader(file);
+            reader.open();
+            while (reader.readRow(row)) { ++r.rows; r.fields += row.size(); }
+        }
+        r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        return r;
+    }
+
+    PassResult mappedPass(const std::vector<std::string>& files) {
+        PassResult r;
+        std::vector<std::string_view> row;
+        auto t0 = Clock::now();
+        for (const auto& file : files) {
+            CSVReader reader(file, ',', '"', '#', CSVReader::Mode::Mapped);
+            reader.open();
+            while (reader.readRowViews(row)) { ++r.rows; r.fields += row.size(); }
+        }
+        r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        return r;
+    }
+
+    void report(const std::string& label, const PassResult& best, double megabytes, double baseline) {
+        std::cout << std::setw(28) << label
+                  << std::setw(12) << best.rows
+                  << std::setw(14) << best.fields
+                  << std::setw(12) << std::fixed << std::setprecision(3) << best.seconds
+                  << std::setw(12) << std::setprecision(1) << megabytes / best.seconds
+                  << std::setw(10) << std::setprecision(2) << baseline / best.seconds << "x\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int repetitions = Config::DEFAULT_REPETITIONS;
+    if (argc > 1) repetitions = std::max(1, std::atoi(argv[1]));
+
+    const char* env = std::getenv("FIRE_DATA_PATH");
+    std::string dataPath = env ? env : "data/FireData";
+
+    std::vector<std::string> files;
+    std::uintmax_t totalBytes = 0;
+    try {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dataPath)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+                files.push_back(entry.path().string());
+                totalBytes += entry.file_size();
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error scanning " << dataPath << ": " << e.what() << "\n";
+        return 1;
+    }
+    if (files.empty()) {
+        std::cerr << "No CSV files found in " << dataPath << "\n";
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+    double megabytes = static_cast<double>(totalBytes) / (1024.0 * 1024.0);
+
+    std::cout << "CSV splitter micro-benchmark: " << files.size() << " files, "
+              << std::fixed << std::setprecision(1) << megabytes << " MB, best of "
+              << repetitions << " runs\n";
+    std::cout << "Detected kernel: " << CSVScan::kernelName(CSVScan::detectKernel()) << "\n\n";
+
+    // Warm the page cache so every variant measures parsing, not disk
+    mappedPass(files);
+
+    auto bestOf = [repetitions](auto&& pass) {
+        PassResult best;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            PassResult r = pass();
+            if (rep == 0 || r.seconds < best.seconds) best = r;
+        }
+        return best;
+    };
+
+    std::cout << std::setw(28) << "Variant" << std::setw(12) << "Rows" << std::setw(14) << "Fields"
+              << std::setw(12) << "Time (s)" << std::setw(12) << "MB/s" << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(89, '-') << "\n";
+
+    PassResult scalar = bestOf([&] { return streamPass(files); });
+    report("Scalar splitRecord (stream)", scalar, megabytes, scalar.seconds);
+
+    CSVScan::Kernel original = CSVScan::activeKernel();
+    for (CSVScan::Kernel kernel : {CSVScan::Kernel::Scalar, CSVScan::Kernel::SSE42, CSVScan::Kernel::AVX2}) {
+        if (!CSVScan::selectKernel(kernel)) continue;
+        PassResult r = bestOf([&] { return mappedPass(files); });
+        report(std::string("Structural ") + CSVScan::kernelName(kernel) + " (mapped)", r, megabytes, scalar.seconds);
+        if (r.rows != scalar.rows || r.fields != scalar.fields) {
+            std::cout << "  WARNING: row/field count mismatch against scalar splitter!\n";
+        }
+    }
+    CSVScan::selectKernel(original);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file csv_scanner.cpp
+ * @brief Runtime-dispatched structural scanner kernels for CSV parsing
+ *
+ * Each kernel turns a 64-byte block into delimiter/quote/newline bitmasks.
+ * The x86 kernels are compiled with function-level target attributes so the
+ * rest of the project keeps its baseline compiler flags; the dispatcher only
+ * installs them after checking the CPU at runtime.
+ */
+
+#include "../interface/csv_scanner.hpp"
+
+#include <atomic>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CSV_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace CSVScan {
+    namespace {
+        using ScanFn = BlockMasks (*)(const char*, char, char);
+
+        // Portable fallback: one pass over the block building all three masks
+        BlockMasks scanScalar(const char* data, char delim, char quote) {
+            BlockMasks m{0, 0, 0};
+            for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+                std::uint64_t bit = std::uint64_t{1} << i;
+                char c = data[i];
+                if (c == delim) m.delim |= bit;
+                else if (c == quote) m.quote |= bit;
+                else if (c == '\n') m.newline |= bit;
+            }
+            return m;
+        }
+
+#if defined(CSV_SCANNER_X86)
+        __attribute__((target("sse4.2")))
+        BlockMasks scanSSE42(const char* data, char delim, char quote) {
+            const __m128i vd = _mm_set1_epi8(delim);
+            const __m128i vq = _mm_set1_epi8(quote);
+            const __m128i vn = _mm_set1_epi8('\n');
+            BlockMasks m{0, 0, 0};
+            for (int k = 0; k < 4; ++k) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * k));
+                int shift = 16 * k;
+                m.delim |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vd)))) << shift;
+                m.quote |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vq)))) << shift;
+                m.newline |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vn)))) << shift;
+            }
+            return m;
+        }
+
+        __attribute__((target("avx2")))
+        inline std::uint64_t matchMask(__m256i lo, __m256i hi, __m256i v) {
+            std::uint64_t l = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v)));
+            std::uint64_t h = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v)));
+            return l | (h << 32);
+        }
+
+        __attribute__((target("avx2")))
+        BlockMasks scanAVX2(const char* data, char delim, char quote) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+            return BlockMasks{matchMask(lo, hi, _mm256_set1_epi8(delim)),
+                              matchMask(lo, hi, _mm256_set1_epi8(quote)),
+                              matchMask(lo, hi, _mm256_set1_epi8('\n'))};
+        }
+#endif
+
+        ScanFn kernelFunction(Kernel kernel) {
+            switch (kernel) {
+#if defined(CSV_SCANNER_X86)
+                case Kernel::AVX2: return scanAVX2;
+                case Kernel::SSE42: return scanSSE42;
+#endif
+                default: return scanScalar;
+            }
+        }
+
+        std::atomic<Kernel>& currentKernel() {
+            static std::atomic<Kernel> kernel{detectKernel()};
+            return kernel;
+        }
+    }
+
+    bool isSupported(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::Scalar: return true;
+#if defined(CSV_SCANNER_X86)
+            case Kernel::SSE42: return __builtin_cpu_supports("sse4.2");
+            case Kernel::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+            default: return false;
+        }
+    }
+
+    Kernel detectKernel() noexcept {
+        if (isSupported(Kernel::AVX2)) return Kernel::AVX2;
+        if (isSupported(Kernel::SSE42)) return Kernel::SSE42;
+        return Kernel::Scalar;
+    }
+
+    Kernel activeKernel() noexcept { return currentKernel().load(std::memory_order_relaxed); }
+
+    bool selectKernel(Kernel kernel) noexcept {
+        if (!isSupported(kernel)) return false;
+        currentKernel().store(kernel, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* kernelName(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::AVX2: return "AVX2";
+            case Kernel::SSE42: return "SSE4.2";
+            default: return "Scalar";
+        }
+    }
+
+    BlockMasks scanBlock(const char* data, std::size_t len, char delim, char quote) noexcept {
+        ScanFn fn = kernelFunction(activeKernel());
+        if (len >= BLOCK_SIZE) return fn(data, delim, quote);
+
+        // Tail block: pad with a byte that matches nothing so masks stop at len
+        char padded[BLOCK_SIZE];
+        char filler = 0;
+        while (filler == delim || filler == quote || filler == '\n') ++filler;
+        std::memset(padded, filler, BLOCK_SIZE);
+        if (len > 0) std::memcpy(padded, data, len);
+        return fn(padded, delim, quote);
+    }
+}
@@ -0,0 +1,18 @@
+#include "../interface/execution_context.hpp"
+
+std::string ExecutionContext::describe() const {
+    std::string text = std::to_string(threads) + (threads == 1 ? " thread, " : " threads, ");
+    switch (schedule) {
+        case Schedule::Static:  text += "static"; break;
+        case Schedule::Dynamic: text += "dynamic"; break;
+        case Schedule::Guided:  text += "guided"; break;
+    }
+    if (chunk > 0) text += "(" + std::to_string(chunk) + ")";
+    switch (affinity) {
+        case Affinity::Default: break;
+        case Affinity::Close:   text += ", close"; break;
+        case Affinity::Spread:  text += ", spread"; break;
+    }
+    text += ", grain " + std::to_string(grain);
+    return text;
+}
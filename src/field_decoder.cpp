@@ -0,0 +1,160 @@
+/**
+ * @file field_decoder.cpp
+ * @brief Allocation-free numeric field decoding for the CSV loaders
+ */
+
+#include "../interface/field_decoder.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace FieldDecoder {
+    namespace {
+        inline bool isSpace(char c) noexcept {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+        }
+
+        inline bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+        // Powers of ten that are exactly representable as doubles
+        constexpr double EXACT_POW10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        // Correctly rounded slow path for everything the fast path declines
+        Status strtodFallback(const char* first, const char* last, double& out) noexcept {
+            char buffer[64];
+            std::size_t len = static_cast<std::size_t>(last - first);
+            if (len >= sizeof(buffer)) return Status::Invalid;
+            std::copy(first, last, buffer);
+            buffer[len] = '\0';
+            char* end = nullptr;
+            errno = 0;
+            double v = std::strtod(buffer, &end);
+            if (end == buffer) return Status::Invalid;
+            if (errno == ERANGE) return Status::OutOfRange;
+            out = v;
+            return Status::Ok;
+        }
+
+        Status parseInteger(std::string_view s, long long& out) noexcept {
+            if (s.empty()) return Status::Empty;
+            const char* first = s.data();
+            const char* last = first + s.size();
+            while (first != last && isSpace(*first)) ++first;
+            if (first != last && *first == '+' && last - first > 1 && *(first + 1) != '-') ++first;
+            auto res = std::from_chars(first, last, out);
+            if (res.ec == std::errc::result_out_of_range) return Status::OutOfRange;
+            return res.ec == std::errc() ? Status::Ok : Status::Invalid;
+        }
+    }
+
+    Status toDouble(std::string_view s, double& out) noexcept {
+        if (s.empty()) return Status::Empty;
+        const char* p = s.data();
+        const char* last = p + s.size();
+        while (p != last && isSpace(*p)) ++p;
+        const char* start = p;
+
+        bool negative = false;
+        if (p != last && (*p == '+' || *p == '-')) negative = (*p++ == '-');
+
+        std::uint64_t mantissa = 0;
+        int digits = 0;      // significant digits accumulated into mantissa
+        int exponent = 0;    // decimal exponent applied to mantissa
+        bool sawDigit = false;
+        bool overflow = false;
+
+        while (p != last && isDigit(*p)) {
+            sawDigit = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                if (mantissa != 0) ++digits;
+            } else {
+                overflow = true;
+            }
+            ++p;
+        }
+        if (p != last && *p == '.') {
+            ++p;
+            while (p != last && isDigit(*p)) {
+                sawDigit = true;
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                    if (mantissa != 0) ++digits;
+                    --exponent;
+                } else {
+                    overflow = true;
+                }
+                ++p;
+            }
+        }
+        // inf, nan and hex floats ("0x...") are left to strtod
+        if (!sawDigit || (p != last && (*p == 'x' || *p == 'X'))) return strtodFallback(start, last, out);
+
+        if (p != last && (*p == 'e' || *p == 'E')) {
+            const char* q = p + 1;
+            bool expNegative = false;
+            if (q != last && (*q == '+' || *q == '-')) expNegative = (*q++ == '-');
+            if (q != last && isDigit(*q)) {
+                int e = 0;
+                while (q != last && isDigit(*q)) {
+                    if (e < 10000) e = e * 10 + (*q - '0');
+                    ++q;
+                }
+                exponent += expNegative ? -e : e;
+                p = q;
+            }
+        }
+
+        if (overflow || mantissa > (std::uint64_t{1} << 53) || exponent < -22 || exponent > 22) {
+            return strtodFallback(start, p, out);
+        }
+        double v = static_cast<double>(mantissa);
+        v = exponent < 0 ? v / EXACT_POW10[-exponent] : v * EXACT_POW10[exponent];
+        out = negative ? -v : v;
+        return Status::Ok;
+    }
+
+    Status toLong(std::string_view s, long long& out) noexcept {
+        long long v = 0;
+        Status st = parseInteger(s, v);
+        if (st == Status::Ok) out = v;
+        return st;
+    }
+
+    Status toInt(std::string_view s, int& out) noexcept {
+        long long v = 0;
+        Status st = parseInteger(s, v);
+        if (st != Status::Ok) return st;
+        if (v < INT_MIN || v > INT_MAX) return Status::OutOfRange;
+        out = static_cast<int>(v);
+        return Status::Ok;
+    }
+
+    Status decodeFireRecord(const std::vector<std::string_view>& fields, FireRecord& out) noexcept {
+        if (fields.size() < FIRE_COLUMN_COUNT) return Status::Invalid;
+        Status st;
+        if ((st = toDouble(fields[0], out.latitude)) != Status::Ok) return st;
+        if ((st = toDouble(fields[1], out.longitude)) != Status::Ok) return st;
+        // inf/nan parse as numbers but are no location; such a row would slip past region queries
+        if (!std::isfinite(out.latitude) || !std::isfinite(out.longitude)) return Status::Invalid;
+        if ((st = toDouble(fields[4], out.concentration)) != Status::Ok) return st;
+        if ((st = toDouble(fields[6], out.raw_concentration)) != Status::Ok) return st;
+        if ((st = toInt(fields[7], out.aqi)) != Status::Ok) return st;
+        if ((st = toInt(fields[8], out.category)) != Status::Ok) return st;
+        if (!Timestamp::parseIsoMinutes(fields[2], out.timestamp)) return Status::Invalid;
+        out.parameter = fields[3];
+        out.unit = fields[5];
+        out.site_name = fields[9];
+        out.agency_name = fields[10];
+        out.aqs_code = fields[11];
+        out.full_aqs_code = fields[12];
+        return Status::Ok;
+    }
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include "../interface/column_filter.hpp"
+#include "../interface/constants.hpp"
+
+/**
+ * @file filter_benchmark.cpp
+ * @brief Micro-benchmark: row-at-a-time filter loop vs. block predicate kernels
+ *
+ * Builds synthetic fire-measurement columns (AQI, timestamp, parameter code,
+ * concentration) and times "mean concentration where AQI > 150 AND timestamp
+ * in the middle half AND parameter = PM2.5" for every kernel the CPU supports,
+ * at 1..maxThreads OpenMP threads. The row loop is the short-circuiting
+ * if-chain a service method would otherwise contain. GB/s is the predicate
+ * columns' bytes over the time taken.
+ *
+ * Usage: ./OpenMP_Mini1_Project_filter_benchmark [rows] [repetitions] [maxThreads]
+ */
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+    template <typename Fn>
+    double bestOf(int repetitions, Fn&& fn) {
+        double best = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            auto t0 = Clock::now();
+            fn();
+            double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (rep == 0 || seconds < best) best = seconds;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t rows = std::size_t{1} << 24;
+    int repetitions = Config::DEFAULT_REPETITIONS;
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (argc > 1) rows = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[1])));
+    if (argc > 2) repetitions = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) maxThreads = std::max(1, std::atoi(argv[3]));
+
+    // AQI 0..300, one reading per site per hour, six parameters, PM2.5 is code 0
+    std::vector<int> aqis(rows);
+    std::vector<std::int64_t> timestamps(rows);
+    std::vector<std::uint32_t> parameters(rows);
+    std::vector<double> concentrations(rows);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> aqiDist(0, 300);
+    std::uniform_int_distribution<std::uint32_t> parameterDist(0, 5);
+    std::uniform_real_distribution<double> concentrationDist(0.0, 250.0);
+    const std::int64_t start = 28000000;   // epoch minutes, mid-2023
+    for (std::size_t i = 0; i < rows; ++i) {
+        aqis[i] = aqiDist(rng);
+        timestamps[i] = start + static_cast<std::int64_t>(i / 1000) * 60;
+        parameters[i] = parameterDist(rng);
+        concentrations[i] = concentrationDist(rng);
+    }
+    const std::int64_t from = timestamps[rows / 4];
+    const std::int64_t to = timestamps[rows * 3 / 4];
+
+    ColumnFilter::Filter filter(rows);
+    filter.where(ColumnFilter::Predicate::compare(ColumnView<int>(aqis), ColumnFilter::Op::Greater, 150))
+          .where(ColumnFilter::Predicate::between(ColumnView<std::int64_t>(timestamps), from, to))
+          .where(ColumnFilter::Predicate::compare(ColumnView<std::uint32_t>(parameters), ColumnFilter::Op::Equal, 0u));
+    const double gigabytes = static_cast<double>(filter.scannedBytes()) / (1024.0 * 1024.0 * 1024.0);
+
+    std::cout << "Predicate filter micro-benchmark: " << rows << " rows, "
+              << std::fixed << std::setprecision(1) << gigabytes * 1024.0 << " MB of predicate columns, best of "
+              << repetitions << " runs\n";
+    std::cout << "Detected kernel: " << ColumnFilter::kernelName(ColumnFilter::detectKernel()) << "\n\n";
+
+    GroupAggregate reference;
+    const double loopSeconds = bestOf(repetitions, [&] {
+        reference = GroupAggregate{};
+        for (std::size_t i = 0; i < rows; ++i) {
+            if (aqis[i] > 150 && timestamps[i] >= from && timestamps[i] <= to && parameters[i] == 0) {
+                reference.add(concentrations[i]);
+            }
+        }
+    });
+    std::cout << "Selected " << reference.count << " rows ("
+              << std::setprecision(2) << 100.0 * static_cast<double>(reference.count) / static_cast<double>(rows) << "%)\n\n";
+
+    std::cout << std::setw(10) << "Kernel" << std::setw(9) << "Threads"
+              << std::setw(16) << "Aggregate (ms)" << std::setw(10) << "GB/s"
+              << std::setw(13) << "Count (ms)" << std::setw(10) << "GB/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(79, '-') << "\n";
+    std::cout << std::setw(10) << "Row loop" << std::setw(9) << 1
+              << std::setw(16) << std::setprecision(3) << loopSeconds * 1000.0
+              << std::setw(10) << std::setprecision(2) << gigabytes / loopSeconds
+              << std::setw(13) << "-" << std::setw(10) << "-"
+              << std::setw(10) << 1.0 << "x\n";
+
+    ColumnFilter::Kernel original = ColumnFilter::activeKernel();
+    for (ColumnFilter::Kernel kernel : {ColumnFilter::Kernel::Scalar, ColumnFilter::Kernel::AVX2, ColumnFilter::Kernel::AVX512}) {
+        if (!ColumnFilter::selectKernel(kernel)) continue;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            const ExecutionContext context = ExecutionContext::withThreadCount(threads);
+            GroupAggregate result;
+            std::size_t count = 0;
+            double aggregateSeconds = bestOf(repetitions, [&] { result = filter.aggregate(ColumnView<double>(concentrations), context); });
+            double countSeconds = bestOf(repetitions, [&] { count = filter.count(context); });
+
+            std::cout << std::setw(10) << ColumnFilter::kernelName(kernel) << std::setw(9) << threads
+                      << std::setw(16) << std::setprecision(3) << aggregateSeconds * 1000.0
+                      << std::setw(10) << std::setprecision(2) << gigabytes / aggregateSeconds
+                      << std::setw(13) << std::setprecision(3) << countSeconds * 1000.0
+                      << std::setw(10) << std::setprecision(2) << gigabytes / countSeconds
+                      << std::setw(10) << loopSeconds / aggregateSeconds << "x\n";
+            if (result.count != reference.count || count != reference.count ||
+                result.min != reference.min || result.max != reference.max) {
+                std::cout << "  WARNING: result mismatch against row loop!\n";
+            }
+        }
+    }
+    ColumnFilter::selectKernel(original);
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "../interface/fireColumnModel.hpp"
 #include "../interface/utils.hpp"
+#include "../interface/field_decoder.hpp"
 #include "../interface/readcsv.hpp"
+#include "../interface/columnar_snapshot.hpp"
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -15,12 +17,84 @@
 // FireColumnModel Implementation
 // ============================================================================
 
-FireColumnModel::FireColumnModel() 
-    : _min_latitude(0.0), _max_latitude(0.0), _min_longitude(0.0), _max_longitude(0.0),
-      _bounds_initialized(false) {
-    _datetime_range.resize(2);
+namespace {
+    using Code = FireColumnModel::Code;
+    
+    // Snapshot section ids (stable across versions: add new ids, never renumber)
+    enum Section : std::uint32_t {
+        LATITUDES = 1, LONGITUDES, TIMESTAMPS, CONCENTRATIONS, RAW_CONCENTRATIONS, AQIS, CATEGORIES,
+        PARAMETER_CODES, UNIT_CODES, SITE_NAME_CODES, AGENCY_NAME_CODES, AQS_CODE_CODES, FULL_AQS_CODE_CODES,
+        PARAMETER_DICT, UNIT_DICT, SITE_NAME_DICT, AGENCY_NAME_DICT, AQS_CODE_DICT, FULL_AQS_CODE_DICT,
+        BOUNDS,      ///< min/max latitude, min/max longitude
+        METADATA     ///< min/max timestamp, rejected rows, bounds initialized
+    };
+    
+    std::vector<std::string> dictionaryValues(const StringDictionary& dict) {
+        std::vector<std::string> values(dict.size());
+        for (std::size_t c = 0; c < values.size(); ++c) values[c] = dict.value(static_cast<Code>(c));
+        return values;
+    }
+    
+    StringDictionary dictionaryFrom(const std::vector<std::string>& values) {
+        StringDictionary dict;
+        for (const auto& value : values) dict.intern(value);
+        if (dict.size() != values.size()) throw std::runtime_error("Snapshot dictionary has duplicate values");
+        return dict;
+    }
+    
+    using Postings = std::pmr::vector<RoaringBitmap>;
+    
+    // Posting lists hold 32-bit row ids
+    void checkMeasurementCount(std::size_t count) {
+        if (count > static_cast<std::size_t>(RoaringBitmap::MAX_VALUE) + 1) {
+            throw std::length_error("FireColumnModel: more than 2^32 measurements");
+        }
+    }
+    
+    // Posting lists for one code column, appended in row order.
+    // Returns false if a code is outside the dictionary.
+    bool buildPostings(Postings& index, ColumnView<Code> codes, std::size_t nCodes) {
+        for (Code c : codes) {
+            if (c >= nCodes) return false;
+        }
+        index.clear();
+        index.resize(nCodes);
+        for (std::size_t i = 0; i < codes.size(); ++i) index[codes[i]].append(static_cast<RoaringBitmap::Value>(i));
+        return true;
+    }
+    
+    // Append other's codes, translated into dst's dictionary (one intern per distinct value)
+    void appendRemapped(std::vector<Code>& dst, StringDictionary& dstDict,
+                        ColumnView<Code> src, const StringDictionary& srcDict) {
+        std::vector<Code> remap(srcDict.size());
+        for (std::size_t c = 0; c < remap.size(); ++c) {
+            remap[c] = dstDict.intern(srcDict.value(static_cast<Code>(c)));
+        }
+        // Grow geometrically: an exact reserve would reallocate on every one of many small merges
+        if (dst.capacity() < dst.size() + src.size()) dst.reserve(std::max(dst.size() + src.size(), 2 * dst.capacity()));
+        for (Code c : src) dst.push_back(remap[c]);
+    }
+    
+    void appendIndex(Postings& indices, Code code, std::size_t index) {
+        if (code >= indices.size()) indices.resize(static_cast<std::size_t>(code) + 1);
+        indices[code].append(static_cast<RoaringBitmap::Value>(index));
+    }
+    
+    const RoaringBitmap& postingsFor(const Postings& indices, Code code) noexcept {
+        static const RoaringBitmap none;
+        return code < indices.size() ? indices[code] : none;
+    }
 }
 
+FireColumnModel::FireColumnModel() : FireColumnModel(std::pmr::get_default_resource()) {}
+
+FireColumnModel::FireColumnModel(std::pmr::memory_resource* resource)
+    : _parameter_dict(resource), _unit_dict(resource), _site_name_dict(resource), _agency_name_dict(resource),
+      _aqs_code_dict(resource), _full_aqs_code_dict(resource),
+      _site_indices(resource), _parameter_indices(resource), _aqs_indices(resource), _spatial(resource),
+      _min_latitude(0.0), _max_latitude(0.0), _min_longitude(0.0), _max_longitude(0.0),
+      _bounds_initialized(false) {}
+
 FireColumnModel::~FireColumnModel() = default;
 
 void FireColumnModel::readFromDirectory(const std::string& directoryPath, int numThreads) {
@@ -30,6 +104,9 @@ void FireColumnModel::readFromDirectory(const std::string& directoryPath, int nu
         for (const auto& file : csvFiles) {
             readFromCSV(file);
         }
+        if (_rejected_rows > 0) {
+            std::cout << "Rejected rows: " << _rejected_rows << std::endl;
+        }
     } else {
         // Parallel processing
         readFromDirectoryParallel(directoryPath, numThreads);
@@ -85,11 +162,7 @@ void FireColumnModel::readFromDirectoryParallel(const std::string& directoryPath
     
     // Merge phase
     auto start_merge = std::chrono::high_resolution_clock::now();
-    for (int t = 0; t < numThreads; ++t) {
-        if (threadModels[t].measurementCount() > 0) {
-            mergeFromModel(threadModels[t]);
-        }
-    }
+    mergeFromModels(threadModels, numThreads);
     auto end_merge = std::chrono::high_resolution_clock::now();
     auto merge_time = std::chrono::duration<double>(end_merge - start_merge).count();
     
@@ -97,6 +170,9 @@ void FireColumnModel::readFromDirectoryParallel(const std::string& directoryPath
               << merge_time << " seconds." << std::endl;
     std::cout << "Total processing time: " << std::fixed << std::setprecision(1) 
               << (parallel_time + merge_time) << " seconds." << std::endl;
+    if (_rejected_rows > 0) {
+        std::cout << "Rejected rows: " << _rejected_rows << std::endl;
+    }
     
     // Calculate and display parallel efficiency
     double theoretical_min_time = parallel_time / numThreads;
@@ -105,117 +181,184 @@ void FireColumnModel::readFromDirectoryParallel(const std::string& directoryPath
               << efficiency << "%" << std::endl;
 }
 
+IngestPipeline::Report FireColumnModel::readFromDirectoryPipelined(const std::string& directoryPath, int parseWorkers) {
+    IngestPipeline::Options options;
+    options.parseWorkers = parseWorkers;
+    // Each file is decoded into its own small arena-backed model (dictionaries and
+    // posting lists included), so the single append stage only remaps codes and copies columns
+    using Batch = std::unique_ptr<IngestPipeline::ArenaBatch<FireColumnModel>>;
+    return IngestPipeline::run<Batch>(getCSVFiles(directoryPath), options,
+        [](IngestPipeline::FileBuffer&& file, Batch& batch) {
+            batch = std::make_unique<IngestPipeline::ArenaBatch<FireColumnModel>>(file.bytes.size());
+            CSVReader reader(file.path, ',', '"', '#', CSVReader::Mode::Mapped);
+            reader.openBuffer(std::string_view(file.bytes.data(), file.bytes.size()));
+            batch->model.readRows(reader, true);
+            return batch->model.measurementCount();
+        },
+        [this](Batch&& batch) { mergeFromModel(batch->model); });
+}
+
 void FireColumnModel::readFromCSV(const std::string& filename) {
-    CSVReader reader(filename);
+    CSVReader reader(filename, ',', '"', '#', CSVReader::Mode::Mapped);
     
     try {
         reader.open();
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to open CSV file " + filename + ": " + e.what());
     }
+    readRows(reader, true);
+    reader.close();
+}
+
+void FireColumnModel::readFromCSV(const std::string& filename, std::size_t fromByte, std::size_t toByte) {
+    MappedFile file;
+    try {
+        file.open(filename);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to open CSV file " + filename + ": " + e.what());
+    }
+    if (fromByte > toByte || toByte > file.size()) {
+        throw std::runtime_error("CSV file " + filename + " is shorter than expected (" +
+                                 std::to_string(file.size()) + " < " + std::to_string(toByte) + " bytes)");
+    }
     
-    std::vector<std::string> row;
-    bool headerSkipped = false;
+    CSVReader reader(filename, ',', '"', '#', CSVReader::Mode::Mapped);
+    reader.openBuffer(file.view().substr(fromByte, toByte - fromByte));
+    readRows(reader, fromByte == 0);
+    reader.close();
+}
+
+void FireColumnModel::readRows(CSVReader& reader, bool skipHeader) {
+    // Fields are views into the mapped file; numbers are parsed in place and
+    // strings are only copied once, into the columns themselves
+    std::vector<std::string_view> row;
+    bool headerSkipped = !skipHeader;
     
-    while (reader.readRow(row)) {
+    while (reader.readRowViews(row)) {
         // Skip header row
         if (!headerSkipped) {
             headerSkipped = true;
             continue;
         }
         
-        // Expect at least 13 columns for complete fire measurement data
-        if (row.size() < 13) {
-            continue; // Skip incomplete rows
+        // Rows with too few columns or undecodable numbers are counted, not thrown
+        FieldDecoder::FireRecord rec;
+        if (FieldDecoder::decodeFireRecord(row, rec) != FieldDecoder::Status::Ok) {
+            ++_rejected_rows;
+            continue;
         }
         
+        insertMeasurement(rec.latitude, rec.longitude, rec.timestamp, rec.parameter, rec.concentration,
+                        rec.unit, rec.raw_concentration, rec.aqi, rec.category,
+                        rec.site_name, rec.agency_name, rec.aqs_code, rec.full_aqs_code);
+    }
+}
+
+IngestReport FireColumnModel::readNewFiles(const std::string& directoryPath, IngestManifest& manifest, int numThreads) {
+    IngestReport report;
+    report.modelMismatch = manifest.measurementCount() != measurementCount();
+    if (report.modelMismatch) return report;
+    report.plan = manifest.plan(directoryPath);
+    if (report.plan.requiresFullReload()) return report;
+    
+    const auto& tasks = report.plan.tasks;
+    const std::size_t before = measurementCount();
+    std::vector<char> parsed(tasks.size(), 0);
+    auto parse = [&](FireColumnModel& into, std::size_t i) {
         try {
-            // Parse row data (assuming standard fire data CSV format)
-            double latitude = std::stod(row[0]);
-            double longitude = std::stod(row[1]);
-            std::string datetime = row[2];
-            std::string parameter = row[3];
-            double concentration = std::stod(row[4]);
-            std::string unit = row[5];
-            double raw_concentration = std::stod(row[6]);
-            int aqi = std::stoi(row[7]);
-            int category = std::stoi(row[8]);
-            std::string site_name = row[9];
-            std::string agency_name = row[10];
-            std::string aqs_code = row[11];
-            std::string full_aqs_code = row[12];
-            
-            insertMeasurement(latitude, longitude, datetime, parameter, concentration,
-                            unit, raw_concentration, aqi, category, site_name,
-                            agency_name, aqs_code, full_aqs_code);
-            
+            into.readFromCSV(tasks[i].path, tasks[i].fromByte, tasks[i].state.size);
+            parsed[i] = 1;
         } catch (const std::exception& e) {
-            // Skip rows with parsing errors
-            continue;
+            #pragma omp critical
+            {
+                std::cerr << "Error processing " << tasks[i].path << ": " << e.what() << std::endl;
+            }
         }
+    };
+    
+    if (numThreads <= 1 || tasks.size() <= 1) {
+        // Parse straight into this model: columns and indices grow row by row
+        for (std::size_t i = 0; i < tasks.size(); ++i) parse(*this, i);
+    } else {
+        // Thread-local models, appended (posting lists offset-shifted) in one merge
+        const int threads = static_cast<int>(std::min<std::size_t>(static_cast<std::size_t>(numThreads), tasks.size()));
+        std::vector<FireColumnModel> threadModels(static_cast<std::size_t>(threads));
+        #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            parse(threadModels[static_cast<std::size_t>(omp_get_thread_num())], i);
+        }
+        mergeFromModels(threadModels, threads);
     }
     
-    reader.close();
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        if (parsed[i]) {
+            manifest.record(tasks[i]);
+        } else {
+            ++report.failedFiles;
+        }
+    }
+    report.measurementsAdded = measurementCount() - before;
+    manifest.setMeasurementCount(measurementCount());
+    return report;
 }
 
-void FireColumnModel::insertMeasurement(double latitude, double longitude, const std::string& datetime,
-                                       const std::string& parameter, double concentration, const std::string& unit,
+void FireColumnModel::insertMeasurement(double latitude, double longitude, Timestamp::EpochMinutes timestamp,
+                                       std::string_view parameter, double concentration, std::string_view unit,
                                        double raw_concentration, int aqi, int category,
-                                       const std::string& site_name, const std::string& agency_name,
-                                       const std::string& aqs_code, const std::string& full_aqs_code) {
-    // Insert into columnar storage
-    _latitudes.push_back(latitude);
-    _longitudes.push_back(longitude);
-    _datetimes.push_back(datetime);
-    _parameters.push_back(parameter);
-    _concentrations.push_back(concentration);
-    _units.push_back(unit);
-    _raw_concentrations.push_back(raw_concentration);
-    _aqis.push_back(aqi);
-    _categories.push_back(category);
-    _site_names.push_back(site_name);
-    _agency_names.push_back(agency_name);
-    _aqs_codes.push_back(aqs_code);
-    _full_aqs_codes.push_back(full_aqs_code);
+                                       std::string_view site_name, std::string_view agency_name,
+                                       std::string_view aqs_code, std::string_view full_aqs_code) {
+    checkMeasurementCount(measurementCount() + 1);
+    detachSnapshot();
+    
+    // Insert into columnar storage; string fields are interned and stored as codes
+    _latitudes.owned().push_back(latitude);
+    _longitudes.owned().push_back(longitude);
+    _timestamps.owned().push_back(timestamp);
+    _parameter_codes.owned().push_back(_parameter_dict.intern(parameter));
+    _concentrations.owned().push_back(concentration);
+    _unit_codes.owned().push_back(_unit_dict.intern(unit));
+    _raw_concentrations.owned().push_back(raw_concentration);
+    _aqis.owned().push_back(aqi);
+    _categories.owned().push_back(category);
+    _site_name_codes.owned().push_back(_site_name_dict.intern(site_name));
+    _agency_name_codes.owned().push_back(_agency_name_dict.intern(agency_name));
+    _aqs_code_codes.owned().push_back(_aqs_code_dict.intern(aqs_code));
+    _full_aqs_code_codes.owned().push_back(_full_aqs_code_dict.intern(full_aqs_code));
     
     // Update indices and metadata
-    std::size_t newIndex = _latitudes.size() - 1;
+    std::size_t newIndex = measurementCount() - 1;
     updateIndices(newIndex);
     updateGeographicBounds(latitude, longitude);
-    updateDatetimeRange(datetime);
-    
-    // Update unique sets
-    _unique_sites.insert(site_name);
-    _unique_parameters.insert(parameter);
-    _unique_agencies.insert(agency_name);
+    updateDatetimeRange(timestamp);
 }
 
 void FireColumnModel::mergeFromModel(const FireColumnModel& other) {
+    _rejected_rows += other._rejected_rows;
     if (other.measurementCount() == 0) {
         return;
     }
+    checkMeasurementCount(measurementCount() + other.measurementCount());
+    detachSnapshot();
     
     std::size_t currentSize = measurementCount();
     
     // Merge columnar data
-    _latitudes.insert(_latitudes.end(), other._latitudes.begin(), other._latitudes.end());
-    _longitudes.insert(_longitudes.end(), other._longitudes.begin(), other._longitudes.end());
-    _datetimes.insert(_datetimes.end(), other._datetimes.begin(), other._datetimes.end());
-    _parameters.insert(_parameters.end(), other._parameters.begin(), other._parameters.end());
-    _concentrations.insert(_concentrations.end(), other._concentrations.begin(), other._concentrations.end());
-    _units.insert(_units.end(), other._units.begin(), other._units.end());
-    _raw_concentrations.insert(_raw_concentrations.end(), other._raw_concentrations.begin(), other._raw_concentrations.end());
-    _aqis.insert(_aqis.end(), other._aqis.begin(), other._aqis.end());
-    _categories.insert(_categories.end(), other._categories.begin(), other._categories.end());
-    _site_names.insert(_site_names.end(), other._site_names.begin(), other._site_names.end());
-    _agency_names.insert(_agency_names.end(), other._agency_names.begin(), other._agency_names.end());
-    _aqs_codes.insert(_aqs_codes.end(), other._aqs_codes.begin(), other._aqs_codes.end());
-    _full_aqs_codes.insert(_full_aqs_codes.end(), other._full_aqs_codes.begin(), other._full_aqs_codes.end());
-    
-    // Merge unique sets
-    _unique_sites.insert(other._unique_sites.begin(), other._unique_sites.end());
-    _unique_parameters.insert(other._unique_parameters.begin(), other._unique_parameters.end());
-    _unique_agencies.insert(other._unique_agencies.begin(), other._unique_agencies.end());
+    auto append = [](auto& dst, const auto& src) { dst.owned().insert(dst.owned().end(), src.begin(), src.end()); };
+    append(_latitudes, other._latitudes);
+    append(_longitudes, other._longitudes);
+    append(_timestamps, other._timestamps);
+    append(_concentrations, other._concentrations);
+    append(_raw_concentrations, other._raw_concentrations);
+    append(_aqis, other._aqis);
+    append(_categories, other._categories);
+    
+    // Encoded columns: translate the other model's codes into this model's dictionaries
+    appendRemapped(_parameter_codes.owned(), _parameter_dict, other.parameterCodes(), other._parameter_dict);
+    appendRemapped(_unit_codes.owned(), _unit_dict, other.unitCodes(), other._unit_dict);
+    appendRemapped(_site_name_codes.owned(), _site_name_dict, other.siteNameCodes(), other._site_name_dict);
+    appendRemapped(_agency_name_codes.owned(), _agency_name_dict, other.agencyNameCodes(), other._agency_name_dict);
+    appendRemapped(_aqs_code_codes.owned(), _aqs_code_dict, other.aqsCodeCodes(), other._aqs_code_dict);
+    appendRemapped(_full_aqs_code_codes.owned(), _full_aqs_code_dict, other.fullAqsCodeCodes(), other._full_aqs_code_dict);
     
     // Update indices for newly added measurements
     for (std::size_t i = currentSize; i < measurementCount(); ++i) {
@@ -228,28 +371,448 @@ void FireColumnModel::mergeFromModel(const FireColumnModel& other) {
         updateGeographicBounds(other._max_latitude, other._max_longitude);
     }
     
-    // Merge datetime range
-    if (!other._datetime_range[0].empty()) {
-        updateDatetimeRange(other._datetime_range[0]);
+    // Merge datetime range (other is non-empty, so its min/max are valid)
+    if (currentSize == 0) {
+        _min_timestamp = other._min_timestamp;
+        _max_timestamp = other._max_timestamp;
+    } else {
+        _min_timestamp = std::min(_min_timestamp, other._min_timestamp);
+        _max_timestamp = std::max(_max_timestamp, other._max_timestamp);
     }
-    if (!other._datetime_range[1].empty()) {
-        updateDatetimeRange(other._datetime_range[1]);
+}
+
+void FireColumnModel::mergeFromModels(const std::vector<FireColumnModel>& others, int numThreads) {
+    using CodeColumn = ColumnStorage<Code> FireColumnModel::*;
+    using Dictionary = StringDictionary FireColumnModel::*;
+    using Index = PostingLists FireColumnModel::*;
+    struct EncodedColumn { CodeColumn codes; Dictionary dict; Index index; };
+    static const EncodedColumn encoded[] = {
+        {&FireColumnModel::_parameter_codes, &FireColumnModel::_parameter_dict, &FireColumnModel::_parameter_indices},
+        {&FireColumnModel::_unit_codes, &FireColumnModel::_unit_dict, nullptr},
+        {&FireColumnModel::_site_name_codes, &FireColumnModel::_site_name_dict, &FireColumnModel::_site_indices},
+        {&FireColumnModel::_agency_name_codes, &FireColumnModel::_agency_name_dict, nullptr},
+        {&FireColumnModel::_aqs_code_codes, &FireColumnModel::_aqs_code_dict, &FireColumnModel::_aqs_indices},
+        {&FireColumnModel::_full_aqs_code_codes, &FireColumnModel::_full_aqs_code_dict, nullptr},
+    };
+    constexpr std::size_t nEncoded = sizeof(encoded) / sizeof(encoded[0]);
+    const std::size_t nParts = others.size();
+    std::size_t incoming = 0;
+    for (const FireColumnModel& other : others) incoming += other.measurementCount();
+    checkMeasurementCount(measurementCount() + incoming);
+    detachSnapshot();
+    
+    // Destination offset of each model's rows; metadata is folded in serially (O(models))
+    std::vector<std::size_t> offsets(nParts + 1);
+    offsets[0] = measurementCount();
+    for (std::size_t p = 0; p < nParts; ++p) {
+        const FireColumnModel& other = others[p];
+        offsets[p + 1] = offsets[p] + other.measurementCount();
+        _rejected_rows += other._rejected_rows;
+        if (other.measurementCount() == 0) continue;
+        if (other._bounds_initialized) {
+            updateGeographicBounds(other._min_latitude, other._min_longitude);
+            updateGeographicBounds(other._max_latitude, other._max_longitude);
+        }
+        if (offsets[p] == 0) {
+            _min_timestamp = other._min_timestamp;
+            _max_timestamp = other._max_timestamp;
+        } else {
+            _min_timestamp = std::min(_min_timestamp, other._min_timestamp);
+            _max_timestamp = std::max(_max_timestamp, other._max_timestamp);
+        }
     }
+    const std::size_t total = offsets[nParts];
+    if (total == offsets[0]) return;
+    
+    // Code remaps: one intern per distinct value per model, serial because dictionaries grow
+    std::vector<std::vector<Code>> remaps(nEncoded * nParts);
+    for (std::size_t e = 0; e < nEncoded; ++e) {
+        StringDictionary& dstDict = this->*encoded[e].dict;
+        for (std::size_t p = 0; p < nParts; ++p) {
+            const StringDictionary& srcDict = others[p].*encoded[e].dict;
+            std::vector<Code>& remap = remaps[e * nParts + p];
+            remap.resize(srcDict.size());
+            for (std::size_t c = 0; c < remap.size(); ++c) {
+                remap[c] = dstDict.intern(srcDict.value(static_cast<Code>(c)));
+            }
+        }
+    }
+    
+    // Posting-list tasks: one per global code, which collects that code's list from every
+    // model (localCodes inverts the remaps). Bitmaps only grow at the end, so a list
+    // cannot be filled from several models at once the way the columns are.
+    std::vector<std::pair<std::size_t, Code>> listTasks;
+    std::vector<std::vector<Code>> localCodes(nEncoded * nParts);
+    for (std::size_t e = 0; e < nEncoded; ++e) {
+        if (!encoded[e].index) continue;
+        const std::size_t nCodes = (this->*encoded[e].dict).size();
+        (this->*encoded[e].index).resize(nCodes);
+        for (std::size_t p = 0; p < nParts; ++p) {
+            const std::vector<Code>& remap = remaps[e * nParts + p];
+            std::vector<Code>& local = localCodes[e * nParts + p];
+            local.assign(nCodes, StringDictionary::NOT_FOUND);
+            for (std::size_t c = 0; c < remap.size(); ++c) local[remap[c]] = static_cast<Code>(c);
+        }
+        for (std::size_t g = 0; g < nCodes; ++g) listTasks.emplace_back(e, static_cast<Code>(g));
+    }
+    
+    // Locations (about one per AQS code) are merged serially through the AQS remaps
+    constexpr std::size_t aqsColumn = 4;
+    for (std::size_t p = 0; p < nParts; ++p) {
+        const std::vector<Code>& remap = remaps[aqsColumn * nParts + p];
+        _spatial.merge(others[p]._spatial, std::vector<std::size_t>(remap.begin(), remap.end()));
+    }
+    
+    // Pre-size every column once
+    _latitudes.owned().resize(total);
+    _longitudes.owned().resize(total);
+    _timestamps.owned().resize(total);
+    _concentrations.owned().resize(total);
+    _raw_concentrations.owned().resize(total);
+    _aqis.owned().resize(total);
+    _categories.owned().resize(total);
+    for (const auto& column : encoded) (this->*column.codes).owned().resize(total);
+    
+    // Copy every model's segments into place concurrently
+    // (every column is owned now, so owned() below only returns the vector)
+    auto copyInto = [](const auto& src, auto& dst, std::size_t offset) {
+        std::copy(src.begin(), src.end(), dst.owned().begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+    const int threads = std::max(1, numThreads);
+    const long long tasks = static_cast<long long>(nParts * (7 + nEncoded));
+#pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+    for (long long task = 0; task < tasks; ++task) {
+        const std::size_t p = static_cast<std::size_t>(task) % nParts;
+        const std::size_t column = static_cast<std::size_t>(task) / nParts;
+        const FireColumnModel& other = others[p];
+        const std::size_t offset = offsets[p];
+        switch (column) {
+            case 0: copyInto(other._latitudes, _latitudes, offset); break;
+            case 1: copyInto(other._longitudes, _longitudes, offset); break;
+            case 2: copyInto(other._timestamps, _timestamps, offset); break;
+            case 3: copyInto(other._concentrations, _concentrations, offset); break;
+            case 4: copyInto(other._raw_concentrations, _raw_concentrations, offset); break;
+            case 5: copyInto(other._aqis, _aqis, offset); break;
+            case 6: copyInto(other._categories, _categories, offset); break;
+            default: {
+                const std::size_t e = column - 7;
+                const std::vector<Code>& remap = remaps[e * nParts + p];
+                const ColumnStorage<Code>& src = other.*encoded[e].codes;
+                std::vector<Code>& dst = (this->*encoded[e].codes).owned();
+                for (std::size_t i = 0; i < src.size(); ++i) dst[offset + i] = remap[src[i]];
+                break;
+            }
+        }
+    }
+    
+    // Then append each model's lists, shifted by its offset, in model order. Bitmaps
+    // allocate as they grow, so only the (thread-safe) heap is used from several threads.
+    const bool heap = _site_indices.get_allocator().resource()->is_equal(*std::pmr::new_delete_resource());
+#pragma omp parallel for schedule(dynamic, 16) num_threads(heap ? threads : 1)
+    for (long long task = 0; task < static_cast<long long>(listTasks.size()); ++task) {
+        const std::size_t e = listTasks[static_cast<std::size_t>(task)].first;
+        const Code g = listTasks[static_cast<std::size_t>(task)].second;
+        RoaringBitmap& list = (this->*encoded[e].index)[g];
+        for (std::size_t p = 0; p < nParts; ++p) {
+            const Code c = localCodes[e * nParts + p][g];
+            const auto offset = static_cast<RoaringBitmap::Value>(offsets[p]);
+            postingsFor(others[p].*encoded[e].index, c).forEach([&](RoaringBitmap::Value row) { list.append(offset + row); });
+        }
+    }
+}
+
+void FireColumnModel::saveSnapshot(const std::string& path) const {
+    Snapshot::Writer writer(Snapshot::Kind::FireColumns);
+    writer.column(LATITUDES, latitudes());
+    writer.column(LONGITUDES, longitudes());
+    writer.column(TIMESTAMPS, timestamps());
+    writer.column(CONCENTRATIONS, concentrations());
+    writer.column(RAW_CONCENTRATIONS, rawConcentrations());
+    writer.column(AQIS, aqis());
+    writer.column(CATEGORIES, categories());
+    writer.column(PARAMETER_CODES, parameterCodes());
+    writer.column(UNIT_CODES, unitCodes());
+    writer.column(SITE_NAME_CODES, siteNameCodes());
+    writer.column(AGENCY_NAME_CODES, agencyNameCodes());
+    writer.column(AQS_CODE_CODES, aqsCodeCodes());
+    writer.column(FULL_AQS_CODE_CODES, fullAqsCodeCodes());
+    writer.strings(PARAMETER_DICT, dictionaryValues(_parameter_dict));
+    writer.strings(UNIT_DICT, dictionaryValues(_unit_dict));
+    writer.strings(SITE_NAME_DICT, dictionaryValues(_site_name_dict));
+    writer.strings(AGENCY_NAME_DICT, dictionaryValues(_agency_name_dict));
+    writer.strings(AQS_CODE_DICT, dictionaryValues(_aqs_code_dict));
+    writer.strings(FULL_AQS_CODE_DICT, dictionaryValues(_full_aqs_code_dict));
+    
+    const double bounds[] = {_min_latitude, _max_latitude, _min_longitude, _max_longitude};
+    const std::int64_t metadata[] = {_min_timestamp, _max_timestamp, static_cast<std::int64_t>(_rejected_rows),
+                                     _bounds_initialized ? 1 : 0};
+    writer.column(BOUNDS, ColumnView<double>(bounds, 4));
+    writer.column(METADATA, ColumnView<std::int64_t>(metadata, 4));
+    writer.write(path);
+}
+
+void FireColumnModel::loadSnapshot(const std::string& path, bool verifyChecksums, int numThreads) {
+    const Snapshot::Reader reader(path, Snapshot::Kind::FireColumns, verifyChecksums);
+    
+    // Decode everything into a fresh model first so a bad file leaves *this untouched
+    FireColumnModel loaded;
+    loaded._latitudes.borrow(reader.column<double>(LATITUDES));
+    loaded._longitudes.borrow(reader.column<double>(LONGITUDES));
+    loaded._timestamps.borrow(reader.column<Timestamp::EpochMinutes>(TIMESTAMPS));
+    loaded._concentrations.borrow(reader.column<double>(CONCENTRATIONS));
+    loaded._raw_concentrations.borrow(reader.column<double>(RAW_CONCENTRATIONS));
+    loaded._aqis.borrow(reader.column<int>(AQIS));
+    loaded._categories.borrow(reader.column<int>(CATEGORIES));
+    loaded._parameter_codes.borrow(reader.column<Code>(PARAMETER_CODES));
+    loaded._unit_codes.borrow(reader.column<Code>(UNIT_CODES));
+    loaded._site_name_codes.borrow(reader.column<Code>(SITE_NAME_CODES));
+    loaded._agency_name_codes.borrow(reader.column<Code>(AGENCY_NAME_CODES));
+    loaded._aqs_code_codes.borrow(reader.column<Code>(AQS_CODE_CODES));
+    loaded._full_aqs_code_codes.borrow(reader.column<Code>(FULL_AQS_CODE_CODES));
+    loaded._parameter_dict = dictionaryFrom(reader.strings(PARAMETER_DICT));
+    loaded._unit_dict = dictionaryFrom(reader.strings(UNIT_DICT));
+    loaded._site_name_dict = dictionaryFrom(reader.strings(SITE_NAME_DICT));
+    loaded._agency_name_dict = dictionaryFrom(reader.strings(AGENCY_NAME_DICT));
+    loaded._aqs_code_dict = dictionaryFrom(reader.strings(AQS_CODE_DICT));
+    loaded._full_aqs_code_dict = dictionaryFrom(reader.strings(FULL_AQS_CODE_DICT));
+    
+    const std::size_t n = loaded._latitudes.size();
+    for (std::size_t size : {loaded._longitudes.size(), loaded._timestamps.size(), loaded._concentrations.size(),
+                             loaded._raw_concentrations.size(), loaded._aqis.size(), loaded._categories.size(),
+                             loaded._parameter_codes.size(), loaded._unit_codes.size(), loaded._site_name_codes.size(),
+                             loaded._agency_name_codes.size(), loaded._aqs_code_codes.size(),
+                             loaded._full_aqs_code_codes.size()}) {
+        if (size != n) throw std::runtime_error("Snapshot columns differ in length: " + path);
+    }
+    
+    const ColumnView<double> bounds = reader.column<double>(BOUNDS);
+    const ColumnView<std::int64_t> metadata = reader.column<std::int64_t>(METADATA);
+    if (bounds.size() != 4 || metadata.size() != 4) throw std::runtime_error("Snapshot metadata is malformed: " + path);
+    loaded._min_latitude = bounds[0];
+    loaded._max_latitude = bounds[1];
+    loaded._min_longitude = bounds[2];
+    loaded._max_longitude = bounds[3];
+    loaded._min_timestamp = metadata[0];
+    loaded._max_timestamp = metadata[1];
+    loaded._rejected_rows = static_cast<std::size_t>(metadata[2]);
+    loaded._bounds_initialized = metadata[3] != 0;
+    
+    loaded._snapshot = reader.file();
+    loaded.rebuildIndices(numThreads);
+    *this = std::move(loaded);
+}
+
+void FireColumnModel::detachSnapshot() {
+    if (!_snapshot) return;
+    _latitudes.owned();
+    _longitudes.owned();
+    _timestamps.owned();
+    _concentrations.owned();
+    _raw_concentrations.owned();
+    _aqis.owned();
+    _categories.owned();
+    _parameter_codes.owned();
+    _unit_codes.owned();
+    _site_name_codes.owned();
+    _agency_name_codes.owned();
+    _aqs_code_codes.owned();
+    _full_aqs_code_codes.owned();
+    _snapshot.reset();
+}
+
+void FireColumnModel::rebuildIndices(int numThreads) {
+    // The three lists and the spatial index are independent; each list is one pass that
+    // checks the codes and one that appends the rows, the spatial index one pass over the coordinates
+    checkMeasurementCount(measurementCount());
+    // All four allocate from the model's resource as they grow, so only the heap is shared between threads
+    const bool heap = _site_indices.get_allocator().resource()->is_equal(*std::pmr::new_delete_resource());
+    const int threads = heap ? std::clamp(numThreads, 1, 4) : 1;
+    struct Target { PostingLists* index; ColumnView<Code> codes; std::size_t nCodes; };
+    const Target targets[] = {
+        {&_site_indices, siteNameCodes(), _site_name_dict.size()},
+        {&_parameter_indices, parameterCodes(), _parameter_dict.size()},
+        {&_aqs_indices, aqsCodeCodes(), _aqs_code_dict.size()},
+    };
+    bool outOfRange = false;
+#pragma omp parallel for num_threads(threads) schedule(static, 1) reduction(||:outOfRange)
+    for (int t = 0; t < 4; ++t) {
+        if (t == 3) {
+            // Out-of-range codes are reported by the AQS list; skip them here
+            const ColumnView<Code> codes = aqsCodeCodes();
+            _spatial.clear();
+            for (std::size_t i = 0; i < codes.size(); ++i) {
+                if (codes[i] < _aqs_code_dict.size()) _spatial.add(codes[i], _latitudes[i], _longitudes[i]);
+            }
+            continue;
+        }
+        outOfRange = !buildPostings(*targets[t].index, targets[t].codes, targets[t].nCodes) || outOfRange;
+    }
+    if (outOfRange) throw std::runtime_error("Snapshot code column references a value outside its dictionary");
 }
 
 std::vector<std::size_t> FireColumnModel::getIndicesBySite(const std::string& siteName) const {
-    auto it = _site_indices.find(siteName);
-    return (it != _site_indices.end()) ? it->second : std::vector<std::size_t>{};
+    return postingsBySite(siteName).toIndices();
 }
 
 std::vector<std::size_t> FireColumnModel::getIndicesByParameter(const std::string& parameter) const {
-    auto it = _parameter_indices.find(parameter);
-    return (it != _parameter_indices.end()) ? it->second : std::vector<std::size_t>{};
+    return postingsByParameter(parameter).toIndices();
 }
 
 std::vector<std::size_t> FireColumnModel::getIndicesByAqsCode(const std::string& aqsCode) const {
-    auto it = _aqs_indices.find(aqsCode);
-    return (it != _aqs_indices.end()) ? it->second : std::vector<std::size_t>{};
+    return postingsByAqsCode(aqsCode).toIndices();
+}
+
+const RoaringBitmap& FireColumnModel::postingsBySite(const std::string& siteName) const noexcept {
+    return postingsFor(_site_indices, _site_name_dict.find(siteName));
+}
+
+const RoaringBitmap& FireColumnModel::postingsByParameter(const std::string& parameter) const noexcept {
+    return postingsFor(_parameter_indices, _parameter_dict.find(parameter));
+}
+
+const RoaringBitmap& FireColumnModel::postingsByAqsCode(const std::string& aqsCode) const noexcept {
+    return postingsFor(_aqs_indices, _aqs_code_dict.find(aqsCode));
+}
+
+const RoaringBitmap& FireColumnModel::aqsCodePostings(Code code) const noexcept {
+    return postingsFor(_aqs_indices, code);
+}
+
+RoaringBitmap FireColumnModel::select(const MeasurementFilter& filter) const {
+    struct Field { const std::vector<std::string>* values; const StringDictionary* dict; const PostingLists* index; };
+    const Field fields[] = {
+        {&filter.parameters, &_parameter_dict, &_parameter_indices},
+        {&filter.siteNames, &_site_name_dict, &_site_indices},
+        {&filter.aqsCodes, &_aqs_code_dict, &_aqs_indices},
+    };
+    
+    // One term per constrained field: its only list, or the union of its lists
+    std::vector<RoaringBitmap> unions;
+    unions.reserve(3);
+    std::vector<const RoaringBitmap*> terms;
+    for (const Field& field : fields) {
+        if (field.values->empty()) continue;
+        std::vector<const RoaringBitmap*> lists;
+        for (const auto& value : *field.values) lists.push_back(&postingsFor(*field.index, field.dict->find(value)));
+        if (lists.size() == 1) {
+            terms.push_back(lists.front());
+        } else {
+            unions.push_back(RoaringBitmap::unionOf(lists));
+            terms.push_back(&unions.back());
+        }
+    }
+    if (terms.empty()) return RoaringBitmap::range(0, static_cast<RoaringBitmap::Value>(measurementCount()));
+    if (terms.size() == 1) return *terms.front();
+    
+    // Smallest first, so every intersection is bounded by the most selective field
+    std::sort(terms.begin(), terms.end(),
+              [](const RoaringBitmap* a, const RoaringBitmap* b) { return a->cardinality() < b->cardinality(); });
+    RoaringBitmap result = *terms[0] & *terms[1];
+    for (std::size_t t = 2; t < terms.size() && !result.empty(); ++t) result &= *terms[t];
+    return result;
+}
+
+std::vector<std::size_t> FireColumnModel::getIndicesInTimeRange(Timestamp::EpochMinutes begin,
+                                                                Timestamp::EpochMinutes end) const {
+    std::vector<std::size_t> indices;
+    for (std::size_t i = 0; i < _timestamps.size(); ++i) {
+        if (_timestamps[i] >= begin && _timestamps[i] < end) indices.push_back(i);
+    }
+    return indices;
+}
+
+std::vector<std::size_t> FireColumnModel::getIndicesInBox(const GeoBox& box) const {
+    return getIndicesIn(GeoRegion::box(box));
+}
+
+std::vector<std::size_t> FireColumnModel::getIndicesWithinRadius(double latitude, double longitude, double radiusKm) const {
+    return getIndicesIn(GeoRegion::circle(latitude, longitude, radiusKm));
+}
+
+std::vector<std::size_t> FireColumnModel::getIndicesIn(const GeoRegion& region) const {
+    const std::vector<SpatialIndex::Match> matches = _spatial.query(region);
+    std::size_t candidates = 0;
+    for (const auto& match : matches) candidates += aqsCodePostings(static_cast<Code>(match.group)).cardinality();
+    
+    // A code whose every location is inside needs no per-row test
+    std::vector<std::size_t> indices;
+    if (candidates * 16 < measurementCount()) {
+        // Few rows: read the matching codes' posting lists, then restore storage order
+        for (const auto& match : matches) {
+            const RoaringBitmap& list = aqsCodePostings(static_cast<Code>(match.group));
+            if (match.whole) {
+                list.forEach([&](RoaringBitmap::Value i) { indices.push_back(i); });
+                continue;
+            }
+            list.forEach([&](RoaringBitmap::Value i) {
+                if (region.contains(_latitudes[i], _longitudes[i])) indices.push_back(i);
+            });
+        }
+        std::sort(indices.begin(), indices.end());
+        return indices;
+    }
+    
+    // Many rows: one pass over the AQS code column with a per-code verdict is cheaper than sorting
+    enum Verdict : std::uint8_t { OUTSIDE, INSIDE, TEST };
+    std::vector<std::uint8_t> verdicts(_aqs_code_dict.size(), OUTSIDE);
+    for (const auto& match : matches) verdicts[match.group] = match.whole ? INSIDE : TEST;
+    indices.reserve(candidates);
+    for (std::size_t i = 0; i < _aqs_code_codes.size(); ++i) {
+        const std::uint8_t verdict = verdicts[_aqs_code_codes[i]];
+        if (verdict == INSIDE || (verdict == TEST && region.contains(_latitudes[i], _longitudes[i]))) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
+
+std::vector<HourlyBucket> FireColumnModel::hourlyBuckets(Timestamp::EpochMinutes begin,
+                                                         Timestamp::EpochMinutes end) const {
+    if (end <= begin) return {};
+    const Timestamp::EpochMinutes firstHour = Timestamp::floorToHour(begin);
+    const std::size_t nBuckets = static_cast<std::size_t>((end - firstHour + Timestamp::MINUTES_PER_HOUR - 1) /
+                                                          Timestamp::MINUTES_PER_HOUR);
+    std::vector<HourlyBucket> buckets(nBuckets);
+    for (std::size_t b = 0; b < nBuckets; ++b) {
+        buckets[b].hourStart = firstHour + static_cast<Timestamp::EpochMinutes>(b) * Timestamp::MINUTES_PER_HOUR;
+    }
+    // Single pass over the integer column: bucket index is a division, no string parsing
+    for (std::size_t i = 0; i < _timestamps.size(); ++i) {
+        Timestamp::EpochMinutes t = _timestamps[i];
+        if (t < begin || t >= end) continue;
+        HourlyBucket& bucket = buckets[static_cast<std::size_t>((t - firstHour) / Timestamp::MINUTES_PER_HOUR)];
+        bucket.count += 1;
+        bucket.concentrationSum += _concentrations[i];
+        bucket.aqiSum += _aqis[i];
+    }
+    return buckets;
+}
+
+std::vector<std::string> FireColumnModel::datetimeRange() const {
+    if (_timestamps.empty()) return {std::string(), std::string()};
+    return {Timestamp::formatIsoMinutes(_min_timestamp), Timestamp::formatIsoMinutes(_max_timestamp)};
+}
+
+std::size_t FireColumnModel::encodedStringBytes() const noexcept {
+    std::size_t bytes = 0;
+    for (const auto* codes : {&_parameter_codes, &_unit_codes, &_site_name_codes,
+                              &_agency_name_codes, &_aqs_code_codes, &_full_aqs_code_codes}) {
+        bytes += codes->memoryBytes();
+    }
+    for (const auto* dict : {&_parameter_dict, &_unit_dict, &_site_name_dict,
+                             &_agency_name_dict, &_aqs_code_dict, &_full_aqs_code_dict}) {
+        bytes += dict->memoryBytes();
+    }
+    return bytes;
+}
+
+std::size_t FireColumnModel::postingBytes() const noexcept {
+    std::size_t bytes = 0;
+    for (const auto* index : {&_site_indices, &_parameter_indices, &_aqs_indices}) {
+        bytes += index->capacity() * sizeof(RoaringBitmap);
+        for (const RoaringBitmap& list : *index) bytes += list.memoryBytes();
+    }
+    return bytes;
 }
 
 void FireColumnModel::getGeographicBounds(double& min_lat, double& max_lat, 
@@ -265,16 +828,13 @@ void FireColumnModel::getGeographicBounds(double& min_lat, double& max_lat,
 }
 
 void FireColumnModel::updateIndices(std::size_t index) {
-    if (index >= _site_names.size()) return;
-    
-    // Update site indices
-    _site_indices[_site_names[index]].push_back(index);
-    
-    // Update parameter indices
-    _parameter_indices[_parameters[index]].push_back(index);
+    if (index >= _site_name_codes.size()) return;
     
-    // Update AQS code indices
-    _aqs_indices[_aqs_codes[index]].push_back(index);
+    // Update site, parameter and AQS code indices
+    appendIndex(_site_indices, _site_name_codes[index], index);
+    appendIndex(_parameter_indices, _parameter_codes[index], index);
+    appendIndex(_aqs_indices, _aqs_code_codes[index], index);
+    _spatial.add(_aqs_code_codes[index], _latitudes[index], _longitudes[index]);
 }
 
 void FireColumnModel::updateGeographicBounds(double latitude, double longitude) {
@@ -290,12 +850,13 @@ void FireColumnModel::updateGeographicBounds(double latitude, double longitude)
     }
 }
 
-void FireColumnModel::updateDatetimeRange(const std::string& datetime) {
-    if (_datetime_range[0].empty() || datetime < _datetime_range[0]) {
-        _datetime_range[0] = datetime;
+void FireColumnModel::updateDatetimeRange(Timestamp::EpochMinutes timestamp) {
+    // Called after the measurement is appended, so size 1 means this is the first one
+    if (measurementCount() <= 1 || timestamp < _min_timestamp) {
+        _min_timestamp = timestamp;
     }
-    if (_datetime_range[1].empty() || datetime > _datetime_range[1]) {
-        _datetime_range[1] = datetime;
+    if (measurementCount() <= 1 || timestamp > _max_timestamp) {
+        _max_timestamp = timestamp;
     }
 }
 
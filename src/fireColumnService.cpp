@@ -1,14 +1,15 @@
 #include "../interface/fire_service_direct.hpp"
 #include "../interface/fireColumnModel.hpp"
+#include "../interface/group_aggregate.hpp"
+#include "../interface/top_n_engine.hpp"
+#include "../interface/parallel_region.hpp"
 #include <algorithm>
 #include <numeric>
-#include <queue>
 #include <functional>
-#include <omp.h>
 #include <limits>
-#include <unordered_map>
 
-FireColumnService::FireColumnService(const FireColumnModel* model) : model_(model) {}
+FireColumnService::FireColumnService(const FireColumnModel* model, ExecutionContext context)
+    : model_(model), context_(context) {}
 FireColumnService::~FireColumnService() = default;
 
 std::string FireColumnService::getImplementationName() const {
@@ -27,51 +28,24 @@ int FireColumnService::maxAQI(int numThreads) const {
     const auto& aqis = model_->aqis();
     if (aqis.empty()) return 0;
     
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        int global_max = std::numeric_limits<int>::min();
-        
-#pragma omp parallel for reduction(max:global_max)
-        for (std::size_t i = 0; i < aqis.size(); ++i) {
-            global_max = std::max(global_max, aqis[i]);
-        }
-        return global_max == std::numeric_limits<int>::min() ? 0 : global_max;
-    }
-    
-    // Serial version
-    int maxAQIValue = 0;
-    for (std::size_t i = 0; i < aqis.size(); ++i) {
-        maxAQIValue = std::max(maxAQIValue, aqis[i]);
-    }
-    return maxAQIValue;
+    return Parallel::reduce(context_.withThreads(numThreads), aqis.size(), 0,
+        [&aqis](std::size_t i, int& local) { local = std::max(local, aqis[i]); },
+        [](int& into, int from) { into = std::max(into, from); });
 }
 
 int FireColumnService::minAQI(int numThreads) const {
     const auto& aqis = model_->aqis();
     if (aqis.empty()) return 0;
     
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        int global_min = std::numeric_limits<int>::max();
-        
-#pragma omp parallel for reduction(min:global_min)
-        for (std::size_t i = 0; i < aqis.size(); ++i) {
+    const int minAQIValue = Parallel::reduce(context_.withThreads(numThreads), aqis.size(),
+        std::numeric_limits<int>::max(),
+        [&aqis](std::size_t i, int& local) {
             int aqi = aqis[i];
             if (aqi > 0) { // Only consider valid AQI values
-                global_min = std::min(global_min, aqi);
+                local = std::min(local, aqi);
             }
-        }
-        return global_min == std::numeric_limits<int>::max() ? 0 : global_min;
-    }
-    
-    // Serial version
-    int minAQIValue = std::numeric_limits<int>::max();
-    for (std::size_t i = 0; i < aqis.size(); ++i) {
-        int aqi = aqis[i];
-        if (aqi > 0) { // Only consider valid AQI values
-            minAQIValue = std::min(minAQIValue, aqi);
-        }
-    }
+        },
+        [](int& into, int from) { into = std::min(into, from); });
     return minAQIValue == std::numeric_limits<int>::max() ? 0 : minAQIValue;
 }
 
@@ -79,109 +53,101 @@ double FireColumnService::averageAQI(int numThreads) const {
     const auto& aqis = model_->aqis();
     if (aqis.empty()) return 0.0;
     
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        long long total = 0;
-        
-#pragma omp parallel for reduction(+:total)
-        for (std::size_t i = 0; i < aqis.size(); ++i) {
-            total += aqis[i];
-        }
-        return static_cast<double>(total) / static_cast<double>(aqis.size());
-    }
-    
-    // Serial version
-    long long total = 0;
-    for (std::size_t i = 0; i < aqis.size(); ++i) {
-        total += aqis[i];
-    }
+    const long long total = Parallel::reduce(context_.withThreads(numThreads), aqis.size(), 0LL,
+        [&aqis](std::size_t i, long long& local) { local += aqis[i]; },
+        [](long long& into, long long from) { into += from; });
     return static_cast<double>(total) / static_cast<double>(aqis.size());
 }
 
 std::vector<std::pair<std::string, double>> FireColumnService::topNSitesByAverageConcentration(std::size_t n, int numThreads) const {
     if (n == 0) return {};
     
-    const auto& siteNames = model_->siteNames();
+    const auto& siteCodes = model_->siteNameCodes();
     const auto& concentrations = model_->concentrations();
+    const auto& siteDictionary = model_->siteNameDictionary();
     
-    if (siteNames.empty() || concentrations.empty()) return {};
-    
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        
-        // First, collect all site concentrations in parallel
-        std::unordered_map<std::string, std::pair<double, std::size_t>> siteData; // site_name -> (total_concentration, count)
-        
-        // Use a mutex for thread-safe map access
-        omp_lock_t mapLock;
-        omp_init_lock(&mapLock);
-        
-#pragma omp parallel for
-        for (std::size_t i = 0; i < siteNames.size(); ++i) {
-            const std::string& siteName = siteNames[i];
-            double concentration = concentrations[i];
-            
-            omp_set_lock(&mapLock);
-            auto& data = siteData[siteName];
-            data.first += concentration;
-            data.second += 1;
-            omp_unset_lock(&mapLock);
-        }
-        
-        omp_destroy_lock(&mapLock);
-        
-        // Calculate averages and sort
-        std::vector<std::pair<std::string, double>> siteAvgConcentrations;
-        siteAvgConcentrations.reserve(siteData.size());
-        
-        for (const auto& entry : siteData) {
-            if (entry.second.second > 0) {
-                double avgConcentration = entry.second.first / entry.second.second;
-                siteAvgConcentrations.emplace_back(entry.first, avgConcentration);
-            }
-        }
-        
-        // Sort descending by average concentration and take top-N
-        std::sort(siteAvgConcentrations.begin(), siteAvgConcentrations.end(),
-                  [](const auto& a, const auto& b) { return a.second > b.second; });
-        
-        if (siteAvgConcentrations.size() > n) {
-            siteAvgConcentrations.resize(n);
-        }
-        
-        return siteAvgConcentrations;
-    }
+    if (siteCodes.empty() || concentrations.empty()) return {};
     
-    // Serial version: collect all site concentrations
-    std::unordered_map<std::string, std::pair<double, std::size_t>> siteData; // site_name -> (total_concentration, count)
+    // Site names are dictionary codes 0..nSites-1, so group by code with the dense engine:
+    // thread-private partial arrays, then a partitioned merge over the code range
+    const std::size_t nSites = siteDictionary.size();
+    const ExecutionContext context = context_.withThreads(numThreads);
+    std::vector<GroupAggregate> perSite = GroupBy::dense(
+        siteCodes.size(), nSites, context.teamSize(siteCodes.size()),
+        [&](std::size_t i, auto& emit) { emit(siteCodes[i], concentrations[i]); });
     
-    for (std::size_t i = 0; i < siteNames.size(); ++i) {
-        const std::string& siteName = siteNames[i];
-        double concentration = concentrations[i];
-        
-        auto& data = siteData[siteName];
-        data.first += concentration;
-        data.second += 1;
-    }
+    // Rank site codes by average concentration and decode only the top-N names
+    auto top = TopN::select<double>(nSites, n, context.teamSize(nSites), [&perSite](std::size_t c, double& average) {
+        if (perSite[c].count == 0) return false;
+        average = perSite[c].mean();
+        return true;
+    });
     
-    // Calculate averages and sort
     std::vector<std::pair<std::string, double>> siteAvgConcentrations;
-    siteAvgConcentrations.reserve(siteData.size());
-    
-    for (const auto& entry : siteData) {
-        if (entry.second.second > 0) {
-            double avgConcentration = entry.second.first / entry.second.second;
-            siteAvgConcentrations.emplace_back(entry.first, avgConcentration);
-        }
+    siteAvgConcentrations.reserve(top.size());
+    for (const auto& entry : top) {
+        siteAvgConcentrations.emplace_back(siteDictionary.value(static_cast<StringDictionary::Code>(entry.index)), entry.value);
     }
     
-    // Sort descending by average concentration and take top-N
-    std::sort(siteAvgConcentrations.begin(), siteAvgConcentrations.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    return siteAvgConcentrations;
+}
+
+std::vector<std::pair<std::string, double>> FireColumnService::averageConcentrationByParameter(int numThreads) const {
+    const auto& parameterCodes = model_->parameterCodes();
+    const auto& concentrations = model_->concentrations();
+    const auto& parameterDictionary = model_->parameterDictionary();
+    
+    std::vector<GroupAggregate> perParameter = GroupBy::dense(
+        parameterCodes.size(), parameterDictionary.size(), context_.withThreads(numThreads).teamSize(parameterCodes.size()),
+        [&](std::size_t i, auto& emit) { emit(parameterCodes[i], concentrations[i]); });
     
-    if (siteAvgConcentrations.size() > n) {
-        siteAvgConcentrations.resize(n);
+    std::vector<std::pair<std::string, double>> result;
+    for (std::size_t c = 0; c < perParameter.size(); ++c) {
+        if (perParameter[c].count > 0) {
+            result.emplace_back(parameterDictionary.value(static_cast<StringDictionary::Code>(c)), perParameter[c].mean());
+        }
     }
-    
-    return siteAvgConcentrations;
-}
\ No newline at end of file
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+GroupAggregate FireColumnService::concentrationInBox(const std::string& parameter, const GeoBox& box, int numThreads) const {
+    return concentrationIn(parameter, GeoRegion::box(box), numThreads);
+}
+
+GroupAggregate FireColumnService::concentrationWithinRadius(const std::string& parameter, double latitude, double longitude,
+                                                            double radiusKm, int numThreads) const {
+    return concentrationIn(parameter, GeoRegion::circle(latitude, longitude, radiusKm), numThreads);
+}
+
+GroupAggregate FireColumnService::concentrationWhere(const ColumnFilter::Filter& filter, int numThreads) const {
+    return filter.aggregate(model_->concentrations(), context_.withThreads(numThreads));
+}
+
+GroupAggregate FireColumnService::aqiWhere(const ColumnFilter::Filter& filter, int numThreads) const {
+    return filter.aggregate(model_->aqis(), context_.withThreads(numThreads));
+}
+
+GroupAggregate FireColumnService::concentrationIn(const std::string& parameter, const GeoRegion& region, int numThreads) const {
+    const StringDictionary::Code code = model_->parameterDictionary().find(parameter);
+    if (code == StringDictionary::NOT_FOUND) return {};
+    
+    // Work items are the AQS codes located in the region, each read through its posting list
+    const std::vector<SpatialIndex::Match> groups = model_->spatialIndex().query(region);
+    std::size_t rows = 0;
+    for (const auto& match : groups) rows += model_->aqsCodePostings(static_cast<FireColumnModel::Code>(match.group)).cardinality();
+    const auto parameterCodes = model_->parameterCodes();
+    const auto concentrations = model_->concentrations();
+    const auto latitudes = model_->latitudes();
+    const auto longitudes = model_->longitudes();
+    return Parallel::reduce(context_.withThreads(numThreads).withWork(groups.size(), rows),
+        groups.size(), GroupAggregate{},
+        [&](std::size_t g, GroupAggregate& local) {
+            model_->aqsCodePostings(static_cast<FireColumnModel::Code>(groups[g].group)).forEach([&](RoaringBitmap::Value i) {
+                if (parameterCodes[i] == code && (groups[g].whole || region.contains(latitudes[i], longitudes[i]))) {
+                    local.add(concentrations[i]);
+                }
+            });
+        },
+        [](GroupAggregate& into, const GroupAggregate& from) { into.merge(from); });
+}
@@ -1,6 +1,8 @@
 #include "../interface/fireRowModel.hpp"
 #include "../interface/utils.hpp"
 #include "../interface/readcsv.hpp"
+#include "../interface/field_decoder.hpp"
+#include "../interface/mapped_file.hpp"
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -10,39 +12,28 @@
 #include <omp.h>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 
 // ============================================================================
 // FireMeasurement Implementation
 // ============================================================================
 
-FireMeasurement::FireMeasurement() 
-    : _latitude(0.0), _longitude(0.0), _concentration(0.0), 
-      _raw_concentration(0.0), _aqi(0), _category(0) {}
-
-FireMeasurement::FireMeasurement(double latitude, double longitude, std::string datetime,
-                               std::string parameter, double concentration, std::string unit,
-                               double raw_concentration, int aqi, int category,
-                               std::string site_name, std::string agency_name,
-                               std::string aqs_code, std::string full_aqs_code)
-    : _latitude(latitude), _longitude(longitude), _datetime(std::move(datetime)),
-      _parameter(std::move(parameter)), _concentration(concentration), _unit(std::move(unit)),
-      _raw_concentration(raw_concentration), _aqi(aqi), _category(category),
-      _site_name(std::move(site_name)), _agency_name(std::move(agency_name)),
-      _aqs_code(std::move(aqs_code)), _full_aqs_code(std::move(full_aqs_code)) {}
-
-double FireMeasurement::latitude() const noexcept { return _latitude; }
-double FireMeasurement::longitude() const noexcept { return _longitude; }
-const std::string& FireMeasurement::datetime() const noexcept { return _datetime; }
-const std::string& FireMeasurement::parameter() const noexcept { return _parameter; }
-double FireMeasurement::concentration() const noexcept { return _concentration; }
-const std::string& FireMeasurement::unit() const noexcept { return _unit; }
-double FireMeasurement::rawConcentration() const noexcept { return _raw_concentration; }
-int FireMeasurement::aqi() const noexcept { return _aqi; }
-int FireMeasurement::category() const noexcept { return _category; }
-const std::string& FireMeasurement::siteName() const noexcept { return _site_name; }
-const std::string& FireMeasurement::agencyName() const noexcept { return _agency_name; }
-const std::string& FireMeasurement::aqsCode() const noexcept { return _aqs_code; }
-const std::string& FireMeasurement::fullAqsCode() const noexcept { return _full_aqs_code; }
+FireMeasurement::FireMeasurement(double latitude, double longitude, Timestamp::EpochMinutes timestamp,
+                                 Code parameter, double concentration, Code unit,
+                                 double raw_concentration, int aqi, int category, Code monitor) noexcept
+    : _latitude(latitude), _longitude(longitude), _concentration(concentration),
+      _raw_concentration(raw_concentration), _timestamp(timestamp), _aqi(aqi),
+      _parameter(parameter), _unit(unit), _monitor(monitor), _category(static_cast<std::int16_t>(category)) {}
+
+std::string FireMeasurement::datetime() const { return Timestamp::formatIsoMinutes(_timestamp); }
+
+FireMeasurement FireMeasurement::recoded(Code parameter, Code unit, Code monitor) const noexcept {
+    FireMeasurement copy = *this;
+    copy._parameter = parameter;
+    copy._unit = unit;
+    copy._monitor = monitor;
+    return copy;
+}
 
 // ============================================================================
 // FireSiteData Implementation
@@ -50,11 +41,43 @@ const std::string& FireMeasurement::fullAqsCode() const noexcept { return _full_
 
 FireSiteData::FireSiteData() = default;
 
-FireSiteData::FireSiteData(std::string site_identifier, std::vector<FireMeasurement> measurements)
-    : _site_identifier(std::move(site_identifier)), _measurements(std::move(measurements)) {}
+FireSiteData::FireSiteData(std::string site_identifier, const allocator_type& allocator)
+    : _site_identifier(std::move(site_identifier)), _monitors(allocator), _measurements(allocator) {}
+
+FireSiteData::FireSiteData(const FireSiteData& other, const allocator_type& allocator)
+    : _site_identifier(other._site_identifier), _monitors(other._monitors, allocator),
+      _measurements(other._measurements, allocator) {}
+
+FireSiteData::FireSiteData(FireSiteData&& other, const allocator_type& allocator)
+    : _site_identifier(std::move(other._site_identifier)), _monitors(std::move(other._monitors), allocator),
+      _measurements(std::move(other._measurements), allocator) {}
 
 const std::string& FireSiteData::siteIdentifier() const noexcept { return _site_identifier; }
-const std::vector<FireMeasurement>& FireSiteData::measurements() const noexcept { return _measurements; }
+const std::pmr::vector<FireMonitor>& FireSiteData::monitors() const noexcept { return _monitors; }
+const std::pmr::vector<FireMeasurement>& FireSiteData::measurements() const noexcept { return _measurements; }
+
+namespace {
+    const std::string& emptyString() {
+        static const std::string empty;
+        return empty;
+    }
+}
+
+const std::string& FireSiteData::agencyName() const noexcept {
+    return _monitors.empty() ? emptyString() : _monitors.front().agency_name;
+}
+
+const std::string& FireSiteData::aqsCode() const noexcept {
+    return _monitors.empty() ? emptyString() : _monitors.front().aqs_code;
+}
+
+const std::string& FireSiteData::fullAqsCode() const noexcept {
+    return _monitors.empty() ? emptyString() : _monitors.front().full_aqs_code;
+}
+
+const FireMonitor& FireSiteData::monitorOf(const FireMeasurement& measurement) const {
+    return _monitors.at(measurement.monitorIndex());
+}
 
 const FireMeasurement& FireSiteData::getMeasurement(std::size_t index) const {
     if (index >= _measurements.size()) {
@@ -66,16 +89,89 @@ const FireMeasurement& FireSiteData::getMeasurement(std::size_t index) const {
 
 std::size_t FireSiteData::measurementCount() const noexcept { return _measurements.size(); }
 
+FireMeasurement::Code FireSiteData::findOrAddMonitor(std::string_view agency_name, std::string_view aqs_code,
+                                                     std::string_view full_aqs_code) {
+    // A site has one monitor almost always, so a linear scan beats any index
+    for (std::size_t i = 0; i < _monitors.size(); ++i) {
+        const FireMonitor& monitor = _monitors[i];
+        if (monitor.aqs_code == aqs_code && monitor.full_aqs_code == full_aqs_code && monitor.agency_name == agency_name) {
+            return static_cast<FireMeasurement::Code>(i);
+        }
+    }
+    if (_monitors.size() >= FireMeasurement::MAX_CODES) {
+        throw std::length_error("Site " + _site_identifier + " has too many monitors");
+    }
+    _monitors.push_back(FireMonitor{std::string(agency_name), std::string(aqs_code), std::string(full_aqs_code)});
+    return static_cast<FireMeasurement::Code>(_monitors.size() - 1);
+}
+
 void FireSiteData::addMeasurement(const FireMeasurement& measurement) {
     _measurements.push_back(measurement);
 }
 
+void FireSiteData::appendMeasurements(FireSiteData&& other,
+                                      const std::vector<FireMeasurement::Code>& parameter_map,
+                                      const std::vector<FireMeasurement::Code>& unit_map) {
+    std::vector<FireMeasurement::Code> monitor_map(other._monitors.size());
+    bool identity = parameter_map.empty() && unit_map.empty();
+    for (std::size_t i = 0; i < other._monitors.size(); ++i) {
+        const FireMonitor& monitor = other._monitors[i];
+        monitor_map[i] = findOrAddMonitor(monitor.agency_name, monitor.aqs_code, monitor.full_aqs_code);
+        identity = identity && monitor_map[i] == i;
+    }
+    
+    const std::size_t offset = _measurements.size();
+    if (offset == 0) {
+        _measurements = std::move(other._measurements);
+    } else {
+        _measurements.insert(_measurements.end(), other._measurements.begin(), other._measurements.end());
+    }
+    if (!identity) {
+        for (std::size_t i = offset; i < _measurements.size(); ++i) {
+            FireMeasurement& m = _measurements[i];
+            m = m.recoded(parameter_map.empty() ? m.parameterCode() : parameter_map[m.parameterCode()],
+                          unit_map.empty() ? m.unitCode() : unit_map[m.unitCode()],
+                          monitor_map[m.monitorIndex()]);
+        }
+    }
+    other._measurements.clear();
+    other._monitors.clear();
+}
+
 // ============================================================================
 // FireRowModel Implementation
 // ============================================================================
 
-FireRowModel::FireRowModel() 
-    : _total_measurements(0), _min_latitude(90.0), _max_latitude(-90.0),
+namespace {
+    /// All .csv files under a directory, sorted for consistent ordering
+    std::vector<std::string> listCSVFiles(const std::string& directory_path) {
+        std::vector<std::string> csv_files;
+        
+        try {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(directory_path)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+                    csv_files.push_back(entry.path().string());
+                }
+            }
+        } catch (const std::filesystem::filesystem_error& e) {
+            throw std::runtime_error("Error reading directory " + directory_path + ": " + e.what());
+        }
+        
+        if (csv_files.empty()) {
+            throw std::runtime_error("No CSV files found in directory: " + directory_path);
+        }
+        
+        // Sort filenames for consistent ordering
+        std::sort(csv_files.begin(), csv_files.end());
+        return csv_files;
+    }
+}
+
+FireRowModel::FireRowModel() : FireRowModel(std::pmr::get_default_resource()) {}
+
+FireRowModel::FireRowModel(std::pmr::memory_resource* resource)
+    : _sites(resource), _min_timestamp(0), _max_timestamp(0), _site_name_to_index(resource), _aqs_code_to_index(resource),
+      _last_site(0), _spatial(resource), _total_measurements(0), _rejected_rows(0), _min_latitude(90.0), _max_latitude(-90.0),
       _min_longitude(180.0), _max_longitude(-180.0) {}
 
 FireRowModel::~FireRowModel() = default;
@@ -83,15 +179,75 @@ FireRowModel::~FireRowModel() = default;
 // === Metadata Access Methods ===
 
 const std::vector<std::string>& FireRowModel::siteNames() const noexcept { return _site_names; }
-const std::vector<std::string>& FireRowModel::parameters() const noexcept { return _parameters; }
+std::vector<std::string> FireRowModel::parameters() const {
+    std::vector<std::string> names;
+    names.reserve(_parameter_dict.size());
+    for (std::size_t c = 0; c < _parameter_dict.size(); ++c) {
+        names.push_back(_parameter_dict.value(static_cast<StringDictionary::Code>(c)));
+    }
+    return names;
+}
 const std::vector<std::string>& FireRowModel::agencies() const noexcept { return _agencies; }
-const std::vector<std::string>& FireRowModel::datetimeRange() const noexcept { return _datetime_range; }
-const std::unordered_map<std::string, int>& FireRowModel::siteNameToIndex() const noexcept { return _site_name_to_index; }
+std::vector<std::string> FireRowModel::datetimeRange() const {
+    if (_total_measurements == 0) return {};
+    return {Timestamp::formatIsoMinutes(_min_timestamp), Timestamp::formatIsoMinutes(_max_timestamp)};
+}
+Timestamp::EpochMinutes FireRowModel::minTimestamp() const noexcept { return _min_timestamp; }
+Timestamp::EpochMinutes FireRowModel::maxTimestamp() const noexcept { return _max_timestamp; }
+const std::pmr::unordered_map<std::string, int>& FireRowModel::siteNameToIndex() const noexcept { return _site_name_to_index; }
+std::pmr::memory_resource* FireRowModel::resource() const noexcept { return _sites.get_allocator().resource(); }
+
+const std::string& FireRowModel::parameterName(const FireMeasurement& measurement) const noexcept {
+    return _parameter_dict.value(measurement.parameterCode());
+}
+
+const std::string& FireRowModel::unitName(const FireMeasurement& measurement) const noexcept {
+    return _unit_dict.value(measurement.unitCode());
+}
+
+namespace {
+    /// Heap bytes behind a string (0 when it fits the small-string buffer)
+    std::size_t stringHeapBytes(const std::string& value) noexcept {
+        const char* inline_begin = reinterpret_cast<const char*>(&value);
+        const bool inline_storage = value.data() >= inline_begin && value.data() < inline_begin + sizeof(value);
+        return inline_storage ? 0 : value.capacity() + 1;
+    }
+    
+    template <typename Map>
+    std::size_t indexBytes(const Map& index) noexcept {
+        std::size_t bytes = index.bucket_count() * sizeof(void*);
+        for (const auto& entry : index) {
+            bytes += sizeof(entry) + sizeof(void*) + stringHeapBytes(entry.first);
+        }
+        return bytes;
+    }
+}
+
+std::size_t FireRowModel::memoryBytes() const noexcept {
+    std::size_t bytes = sizeof(*this) + _sites.capacity() * sizeof(FireSiteData);
+    for (const auto& site : _sites) {
+        bytes += stringHeapBytes(site.siteIdentifier());
+        bytes += site.monitors().capacity() * sizeof(FireMonitor);
+        for (const auto& monitor : site.monitors()) {
+            bytes += stringHeapBytes(monitor.agency_name) + stringHeapBytes(monitor.aqs_code) +
+                     stringHeapBytes(monitor.full_aqs_code);
+        }
+        bytes += site.measurements().capacity() * sizeof(FireMeasurement);
+    }
+    for (const auto* names : {&_site_names, &_agencies}) {
+        bytes += names->capacity() * sizeof(std::string);
+        for (const auto& name : *names) bytes += stringHeapBytes(name);
+    }
+    bytes += _parameter_dict.memoryBytes() + _unit_dict.memoryBytes();
+    bytes += indexBytes(_site_name_to_index) + indexBytes(_aqs_code_to_index) + _spatial.memoryBytes();
+    return bytes;
+}
 
 // === Data Access Methods ===
 
 std::size_t FireRowModel::siteCount() const noexcept { return _sites.size(); }
 std::size_t FireRowModel::totalMeasurements() const noexcept { return _total_measurements; }
+std::size_t FireRowModel::rejectedRowCount() const noexcept { return _rejected_rows; }
 
 const FireSiteData& FireRowModel::siteAt(std::size_t idx) const {
     if (idx >= _sites.size()) {
@@ -128,37 +284,52 @@ void FireRowModel::getGeographicBounds(double& min_lat, double& max_lat,
 // === Data Modification Methods ===
 
 void FireRowModel::readFromCSV(const std::string& filename) {
-    CSVReader reader(filename);
+    CSVReader reader(filename, ',', '"', '#', CSVReader::Mode::Mapped);
     try {
         reader.open();
     } catch (const std::exception& e) {
         throw std::runtime_error("Unable to open file: " + filename + " - " + e.what());
     }
+    readRows(reader);
+    reader.close();
+    // Remove verbose per-file output - will be summarized later
+}
+
+void FireRowModel::readFromCSV(const std::string& filename, std::size_t fromByte, std::size_t toByte) {
+    MappedFile file;
+    try {
+        file.open(filename);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Unable to open file: " + filename + " - " + e.what());
+    }
+    if (fromByte > toByte || toByte > file.size()) {
+        throw std::runtime_error("File " + filename + " is shorter than expected (" +
+                                 std::to_string(file.size()) + " < " + std::to_string(toByte) + " bytes)");
+    }
+    CSVReader reader(filename, ',', '"', '#', CSVReader::Mode::Mapped);
+    reader.openBuffer(file.view().substr(fromByte, toByte - fromByte));
+    readRows(reader);
+    reader.close();
+}
 
-    std::vector<std::string> row;
-    std::size_t line_number = 0;
+void FireRowModel::readRows(CSVReader& reader) {
+    std::vector<std::string_view> row;
+    FieldDecoder::FireRecord record;
     
-    while (reader.readRow(row)) {
-        line_number++;
-        
+    while (reader.readRowViews(row)) {
         // Skip empty rows
         if (row.empty()) {
             continue;
         }
         
-        // Fire data CSV has no header, so process every row
-        try {
-            FireMeasurement measurement = parseCSVRow(row);
-            insertMeasurement(measurement);
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Error parsing line " << line_number 
-                      << " in file " << filename << ": " << e.what() << std::endl;
-            continue; // Skip malformed lines
+        // Fire data CSV has no header, so process every row; malformed rows are
+        // counted instead of throwing per line
+        if (!parseCSVRow(row, record)) {
+            ++_rejected_rows;
+            continue;
         }
+        insertRecord(record);
     }
-    
-    reader.close();
-    // Remove verbose per-file output - will be summarized later
 }
 
 void FireRowModel::readFromMultipleCSV(const std::vector<std::string>& filenames) {
@@ -228,9 +399,7 @@ void FireRowModel::readFromMultipleCSVParallel(const std::vector<std::string>& f
     auto merge_start = std::chrono::high_resolution_clock::now();
     
     for (int t = 0; t < num_threads; ++t) {
-        if (thread_models[t].totalMeasurements() > 0) {
-            mergeFromModel(thread_models[t]);
-        }
+        mergeFromModel(std::move(thread_models[t]));
     }
     
     auto merge_end = std::chrono::high_resolution_clock::now();
@@ -247,65 +416,123 @@ void FireRowModel::readFromMultipleCSVParallel(const std::vector<std::string>& f
     }
     std::cout << "Parallel Processing: " << parallel_duration.count() << " ms" << std::endl;
     std::cout << "Data Merging: " << merge_duration.count() << " ms" << std::endl;
+    if (_rejected_rows > 0) {
+        std::cout << "Rejected rows: " << _rejected_rows << std::endl;
+    }
     std::cout << "Total Time: " << total_duration.count() << " ms" << std::endl;
     std::cout << "Processing Efficiency: " << std::fixed << std::setprecision(1) 
               << (double)parallel_duration.count() / total_duration.count() * 100 << "%" << std::endl;
 }
 
 void FireRowModel::readFromDirectory(const std::string& directory_path) {
-    std::vector<std::string> csv_files;
-    
-    try {
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
-                csv_files.push_back(entry.path().string());
-            }
-        }
-    } catch (const std::filesystem::filesystem_error& e) {
-        throw std::runtime_error("Error reading directory " + directory_path + ": " + e.what());
-    }
-    
-    if (csv_files.empty()) {
-        throw std::runtime_error("No CSV files found in directory: " + directory_path);
-    }
-    
-    // Sort filenames for consistent ordering
-    std::sort(csv_files.begin(), csv_files.end());
-    
+    std::vector<std::string> csv_files = listCSVFiles(directory_path);
     std::cout << "Found " << csv_files.size() << " CSV files in " << directory_path << std::endl;
     readFromMultipleCSV(csv_files);
 }
 
 void FireRowModel::readFromDirectoryParallel(const std::string& directory_path, int num_threads) {
-    std::vector<std::string> csv_files;
-    
-    try {
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
-                csv_files.push_back(entry.path().string());
+    std::vector<std::string> csv_files = listCSVFiles(directory_path);
+    std::cout << "Found " << csv_files.size() << " CSV files in " << directory_path << std::endl;
+    readFromMultipleCSVParallel(csv_files, num_threads);
+}
+
+IngestReport FireRowModel::readNewFiles(const std::string& directory_path, IngestManifest& manifest, int num_threads) {
+    IngestReport report;
+    report.modelMismatch = manifest.measurementCount() != _total_measurements;
+    if (report.modelMismatch) return report;
+    report.plan = manifest.plan(directory_path);
+    if (report.plan.requiresFullReload()) return report;
+    
+    const auto& tasks = report.plan.tasks;
+    const std::size_t before = _total_measurements;
+    std::vector<char> parsed(tasks.size(), 0);
+    auto parse = [&](FireRowModel& into, std::size_t i) {
+        try {
+            into.readFromCSV(tasks[i].path, tasks[i].fromByte, tasks[i].state.size);
+            parsed[i] = 1;
+        } catch (const std::exception& e) {
+            #pragma omp critical(error_output)
+            {
+                std::cerr << "Error processing " << tasks[i].path << ": " << e.what() << std::endl;
             }
         }
-    } catch (const std::filesystem::filesystem_error& e) {
-        throw std::runtime_error("Error reading directory " + directory_path + ": " + e.what());
-    }
+    };
     
-    if (csv_files.empty()) {
-        throw std::runtime_error("No CSV files found in directory: " + directory_path);
+    if (num_threads <= 1 || tasks.size() <= 1) {
+        for (std::size_t i = 0; i < tasks.size(); ++i) parse(*this, i);
+    } else {
+        // Thread-local models, then the site-by-site bulk merge
+        const int threads = static_cast<int>(std::min<std::size_t>(static_cast<std::size_t>(num_threads), tasks.size()));
+        std::vector<FireRowModel> thread_models(static_cast<std::size_t>(threads));
+        #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            parse(thread_models[static_cast<std::size_t>(omp_get_thread_num())], i);
+        }
+        for (auto& thread_model : thread_models) {
+            mergeFromModel(std::move(thread_model));
+        }
     }
     
-    // Sort filenames for consistent ordering
-    std::sort(csv_files.begin(), csv_files.end());
-    
-    std::cout << "Found " << csv_files.size() << " CSV files in " << directory_path << std::endl;
-    readFromMultipleCSVParallel(csv_files, num_threads);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        if (parsed[i]) {
+            manifest.record(tasks[i]);
+        } else {
+            ++report.failedFiles;
+        }
+    }
+    report.measurementsAdded = _total_measurements - before;
+    manifest.setMeasurementCount(_total_measurements);
+    return report;
+}
+
+IngestPipeline::Report FireRowModel::readFromDirectoryPipelined(const std::string& directory_path, int parse_workers) {
+    std::vector<std::string> csv_files = listCSVFiles(directory_path);
+    IngestPipeline::Options options;
+    options.parseWorkers = parse_workers;
+    // Parse workers build one small arena-backed model per file; the append stage
+    // copies its per-site records in with the bulk merge and drops the arena
+    using Batch = std::unique_ptr<IngestPipeline::ArenaBatch<FireRowModel>>;
+    return IngestPipeline::run<Batch>(csv_files, options,
+        [](IngestPipeline::FileBuffer&& file, Batch& batch) {
+            batch = std::make_unique<IngestPipeline::ArenaBatch<FireRowModel>>(file.bytes.size());
+            CSVReader reader(file.path, ',', '"', '#', CSVReader::Mode::Mapped);
+            reader.openBuffer(std::string_view(file.bytes.data(), file.bytes.size()));
+            batch->model.readRows(reader);
+            return batch->model.totalMeasurements();
+        },
+        [this](Batch&& batch) { mergeFromModel(std::move(batch->model)); });
+}
+
+void FireRowModel::insertMeasurement(double latitude, double longitude, Timestamp::EpochMinutes timestamp,
+                                     std::string_view parameter, double concentration, std::string_view unit,
+                                     double raw_concentration, int aqi, int category,
+                                     std::string_view site_name, std::string_view agency_name,
+                                     std::string_view aqs_code, std::string_view full_aqs_code) {
+    insertRecord(FieldDecoder::FireRecord{latitude, longitude, timestamp, parameter, concentration, unit,
+                                          raw_concentration, aqi, category, site_name, agency_name,
+                                          aqs_code, full_aqs_code});
 }
 
-void FireRowModel::insertMeasurement(const FireMeasurement& measurement) {
-    // Find or create site index
-    int site_index = findOrCreateSiteIndex(measurement.siteName(), measurement.aqsCode());
+void FireRowModel::insertRecord(const FieldDecoder::FireRecord& record) {
+    // Intern the per-model strings first so a failure adds no measurement
+    const FireMeasurement::Code parameter = encode(_parameter_dict, record.parameter);
+    const FireMeasurement::Code unit = encode(_unit_dict, record.unit);
+    
+    // Find or create site index, then the monitor within the site
+    const std::size_t site_index = findOrCreateSiteIndex(record.site_name, record.aqs_code);
+    FireSiteData& site = _sites[site_index];
+    const std::size_t monitors = site.monitors().size();
+    const FireMeasurement::Code monitor = site.findOrAddMonitor(record.agency_name, record.aqs_code, record.full_aqs_code);
+    if (site.monitors().size() != monitors &&
+        std::find(_agencies.begin(), _agencies.end(), record.agency_name) == _agencies.end()) {
+        _agencies.emplace_back(record.agency_name);
+    }
     
-    // Add measurement to the site
-    _sites[site_index].addMeasurement(measurement);
+    FireMeasurement measurement(record.latitude, record.longitude, record.timestamp, parameter,
+                                record.concentration, unit, record.raw_concentration, record.aqi,
+                                record.category, monitor);
+    site.addMeasurement(measurement);
+    _spatial.add(site_index, record.latitude, record.longitude);
     
     // Update metadata
     updateMetadata(measurement);
@@ -314,15 +541,87 @@ void FireRowModel::insertMeasurement(const FireMeasurement& measurement) {
     _total_measurements++;
 }
 
+FireMeasurement::Code FireRowModel::encode(StringDictionary& dictionary, std::string_view value) {
+    const StringDictionary::Code code = dictionary.find(value);
+    if (code != StringDictionary::NOT_FOUND) return static_cast<FireMeasurement::Code>(code);
+    if (dictionary.size() >= FireMeasurement::MAX_CODES) {
+        throw std::length_error("Too many distinct values for a fire measurement code: " + std::string(value));
+    }
+    return static_cast<FireMeasurement::Code>(dictionary.intern(value));
+}
+
+std::vector<const FireMeasurement*> FireRowModel::measurementsInTimeRange(Timestamp::EpochMinutes begin,
+                                                                        Timestamp::EpochMinutes end) const {
+    std::vector<const FireMeasurement*> result;
+    for (const auto& site : _sites) {
+        for (const auto& measurement : site.measurements()) {
+            if (measurement.timestamp() >= begin && measurement.timestamp() < end) {
+                result.push_back(&measurement);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<HourlyBucket> FireRowModel::hourlyBuckets(Timestamp::EpochMinutes begin, Timestamp::EpochMinutes end) const {
+    if (end <= begin) return {};
+    const Timestamp::EpochMinutes firstHour = Timestamp::floorToHour(begin);
+    const std::size_t nBuckets = static_cast<std::size_t>((end - firstHour + Timestamp::MINUTES_PER_HOUR - 1) /
+                                                          Timestamp::MINUTES_PER_HOUR);
+    std::vector<HourlyBucket> buckets(nBuckets);
+    for (std::size_t b = 0; b < nBuckets; ++b) {
+        buckets[b].hourStart = firstHour + static_cast<Timestamp::EpochMinutes>(b) * Timestamp::MINUTES_PER_HOUR;
+    }
+    for (const auto& site : _sites) {
+        for (const auto& measurement : site.measurements()) {
+            Timestamp::EpochMinutes t = measurement.timestamp();
+            if (t < begin || t >= end) continue;
+            HourlyBucket& bucket = buckets[static_cast<std::size_t>((t - firstHour) / Timestamp::MINUTES_PER_HOUR)];
+            bucket.count += 1;
+            bucket.concentrationSum += measurement.concentration();
+            bucket.aqiSum += measurement.aqi();
+        }
+    }
+    return buckets;
+}
+
+std::vector<const FireMeasurement*> FireRowModel::measurementsInBox(const GeoBox& box) const {
+    return measurementsIn(GeoRegion::box(box));
+}
+
+std::vector<const FireMeasurement*> FireRowModel::measurementsWithinRadius(double latitude, double longitude,
+                                                                         double radius_km) const {
+    return measurementsIn(GeoRegion::circle(latitude, longitude, radius_km));
+}
+
+std::vector<const FireMeasurement*> FireRowModel::measurementsIn(const GeoRegion& region) const {
+    // Only sites with a location in the region are scanned; a site whose every
+    // location is inside needs no per-measurement test
+    std::vector<const FireMeasurement*> result;
+    for (const SpatialIndex::Match& match : _spatial.query(region)) {
+        for (const auto& measurement : _sites[match.group].measurements()) {
+            if (match.whole || region.contains(measurement.latitude(), measurement.longitude())) {
+                result.push_back(&measurement);
+            }
+        }
+    }
+    return result;
+}
+
 void FireRowModel::clear() {
     _sites.clear();
     _site_names.clear();
-    _parameters.clear();
+    _parameter_dict.clear();
+    _unit_dict.clear();
     _agencies.clear();
-    _datetime_range.clear();
+    _min_timestamp = 0;
+    _max_timestamp = 0;
     _site_name_to_index.clear();
     _aqs_code_to_index.clear();
+    _last_site = 0;
+    _spatial.clear();
     _total_measurements = 0;
+    _rejected_rows = 0;
     _min_latitude = 90.0;
     _max_latitude = -90.0;
     _min_longitude = 180.0;
@@ -332,27 +631,14 @@ void FireRowModel::clear() {
 // === Private Helper Methods ===
 
 void FireRowModel::updateMetadata(const FireMeasurement& measurement) {
-    // Update parameters
-    if (std::find(_parameters.begin(), _parameters.end(), measurement.parameter()) == _parameters.end()) {
-        _parameters.push_back(measurement.parameter());
-    }
+    // Parameters and agencies are recorded when their code or monitor is created
     
-    // Update agencies
-    if (std::find(_agencies.begin(), _agencies.end(), measurement.agencyName()) == _agencies.end()) {
-        _agencies.push_back(measurement.agencyName());
-    }
-    
-    // Update datetime range
-    if (_datetime_range.empty()) {
-        _datetime_range.push_back(measurement.datetime()); // min
-        _datetime_range.push_back(measurement.datetime()); // max
+    // Update datetime range (called before _total_measurements is incremented)
+    if (_total_measurements == 0) {
+        _min_timestamp = _max_timestamp = measurement.timestamp();
     } else {
-        if (measurement.datetime() < _datetime_range[0]) {
-            _datetime_range[0] = measurement.datetime();
-        }
-        if (measurement.datetime() > _datetime_range[1]) {
-            _datetime_range[1] = measurement.datetime();
-        }
+        _min_timestamp = std::min(_min_timestamp, measurement.timestamp());
+        _max_timestamp = std::max(_max_timestamp, measurement.timestamp());
     }
     
     // Update geographic bounds
@@ -362,64 +648,117 @@ void FireRowModel::updateMetadata(const FireMeasurement& measurement) {
     _max_longitude = std::max(_max_longitude, measurement.longitude());
 }
 
-FireMeasurement FireRowModel::parseCSVRow(const std::vector<std::string>& tokens) const {
-    if (tokens.size() != 13) {
-        throw std::runtime_error("Expected 13 columns, got " + std::to_string(tokens.size()));
-    }
-    
-    try {
-        double latitude = std::stod(tokens[0]);
-        double longitude = std::stod(tokens[1]);
-        std::string datetime = tokens[2];
-        std::string parameter = tokens[3];
-        double concentration = std::stod(tokens[4]);
-        std::string unit = tokens[5];
-        double raw_concentration = std::stod(tokens[6]);
-        int aqi = std::stoi(tokens[7]);
-        int category = std::stoi(tokens[8]);
-        std::string site_name = tokens[9];
-        std::string agency_name = tokens[10];
-        std::string aqs_code = tokens[11];
-        std::string full_aqs_code = tokens[12];
-        
-        return FireMeasurement(latitude, longitude, datetime, parameter, concentration,
-                             unit, raw_concentration, aqi, category, site_name,
-                             agency_name, aqs_code, full_aqs_code);
-    } catch (const std::invalid_argument& e) {
-        throw std::runtime_error("Invalid numeric value in CSV row");
-    } catch (const std::out_of_range& e) {
-        throw std::runtime_error("Numeric value out of range in CSV row");
+bool FireRowModel::parseCSVRow(const std::vector<std::string_view>& tokens, FieldDecoder::FireRecord& out) const {
+    if (tokens.size() != FieldDecoder::FIRE_COLUMN_COUNT) {
+        return false;
     }
+    return FieldDecoder::decodeFireRecord(tokens, out) == FieldDecoder::Status::Ok;
 }
 
-int FireRowModel::findOrCreateSiteIndex(const std::string& site_name, const std::string& aqs_code) {
+std::size_t FireRowModel::findOrCreateSiteIndex(std::string_view site_name, std::string_view aqs_code) {
+    // Consecutive rows usually belong to the same site; skip the hash lookup then
+    if (_last_site < _sites.size() && _sites[_last_site].siteIdentifier() == site_name) {
+        return _last_site;
+    }
+    
     // Try to find by site name first
-    auto name_it = _site_name_to_index.find(site_name);
+    const std::string name(site_name);
+    auto name_it = _site_name_to_index.find(name);
     if (name_it != _site_name_to_index.end()) {
-        return name_it->second;
+        return _last_site = static_cast<std::size_t>(name_it->second);
     }
     
     // Try to find by AQS code
-    auto aqs_it = _aqs_code_to_index.find(aqs_code);
+    const std::string code(aqs_code);
+    auto aqs_it = _aqs_code_to_index.find(code);
     if (aqs_it != _aqs_code_to_index.end()) {
-        return aqs_it->second;
+        return _last_site = static_cast<std::size_t>(aqs_it->second);
     }
     
     // Create new site
     int new_index = static_cast<int>(_sites.size());
-    _sites.emplace_back(site_name, std::vector<FireMeasurement>());
-    _site_names.push_back(site_name);
-    _site_name_to_index[site_name] = new_index;
-    _aqs_code_to_index[aqs_code] = new_index;
+    _sites.emplace_back(name);
+    _site_names.push_back(name);
+    _site_name_to_index[name] = new_index;
+    _aqs_code_to_index[code] = new_index;
     
-    return new_index;
+    return _last_site = static_cast<std::size_t>(new_index);
 }
 
 void FireRowModel::mergeFromModel(const FireRowModel& other) {
-    // Merge all measurements from the other model
-    for (const auto& site : other._sites) {
-        for (const auto& measurement : site.measurements()) {
-            insertMeasurement(measurement);  // Reuses existing deduplication and indexing logic
+    FireRowModel copy(other);
+    mergeFromModel(std::move(copy));
+}
+
+void FireRowModel::mergeFromModel(FireRowModel&& other) {
+    _rejected_rows += other._rejected_rows;
+    if (other._total_measurements == 0) {
+        return;
+    }
+    
+    // Translate other's parameter and unit codes; models that saw values in the
+    // same order (the usual case) need no translation and keep an empty map
+    auto codeMap = [](StringDictionary& into, const StringDictionary& from) {
+        std::vector<FireMeasurement::Code> map(from.size());
+        bool identity = true;
+        for (std::size_t c = 0; c < from.size(); ++c) {
+            map[c] = encode(into, from.value(static_cast<StringDictionary::Code>(c)));
+            identity = identity && map[c] == c;
+        }
+        if (identity) map.clear();
+        return map;
+    };
+    const std::vector<FireMeasurement::Code> parameter_map = codeMap(_parameter_dict, other._parameter_dict);
+    const std::vector<FireMeasurement::Code> unit_map = codeMap(_unit_dict, other._unit_dict);
+    
+    // Resolve each site once (a site was registered under its first monitor's AQS code)
+    // and move its whole measurement run across
+    std::vector<std::size_t> site_map(other._sites.size());
+    for (std::size_t i = 0; i < other._sites.size(); ++i) {
+        FireSiteData& site = other._sites[i];
+        const std::string& site_name = site.siteIdentifier();
+        const std::string& aqs_code = site.aqsCode();
+        
+        int target = -1;
+        auto name_it = _site_name_to_index.find(site_name);
+        if (name_it != _site_name_to_index.end()) {
+            target = name_it->second;
+        } else {
+            auto aqs_it = _aqs_code_to_index.find(aqs_code);
+            if (aqs_it != _aqs_code_to_index.end()) target = aqs_it->second;
+        }
+        
+        if (target < 0) {
+            target = static_cast<int>(_sites.size());
+            _site_names.push_back(site_name);
+            _site_name_to_index[site_name] = target;
+            _aqs_code_to_index[aqs_code] = target;
+            _sites.emplace_back(site_name);
+        }
+        _sites[static_cast<std::size_t>(target)].appendMeasurements(std::move(site), parameter_map, unit_map);
+        site_map[i] = static_cast<std::size_t>(target);
+    }
+    _spatial.merge(other._spatial, site_map);
+    
+    // Metadata sets hold one entry per distinct value, so merging them is independent of row count
+    for (auto& agency : other._agencies) {
+        if (std::find(_agencies.begin(), _agencies.end(), agency) == _agencies.end()) {
+            _agencies.push_back(std::move(agency));
         }
     }
-}
\ No newline at end of file
+    
+    if (_total_measurements == 0) {
+        _min_timestamp = other._min_timestamp;
+        _max_timestamp = other._max_timestamp;
+    } else {
+        _min_timestamp = std::min(_min_timestamp, other._min_timestamp);
+        _max_timestamp = std::max(_max_timestamp, other._max_timestamp);
+    }
+    _min_latitude = std::min(_min_latitude, other._min_latitude);
+    _max_latitude = std::max(_max_latitude, other._max_latitude);
+    _min_longitude = std::min(_min_longitude, other._min_longitude);
+    _max_longitude = std::max(_max_longitude, other._max_longitude);
+    _total_measurements += other._total_measurements;
+    
+    other.clear();
+}
@@ -1,13 +1,15 @@
 #include "../interface/fire_service_direct.hpp"
 #include "../interface/fireRowModel.hpp"
+#include "../interface/group_aggregate.hpp"
+#include "../interface/top_n_engine.hpp"
+#include "../interface/parallel_region.hpp"
 #include <algorithm>
 #include <numeric>
-#include <queue>
 #include <functional>
-#include <omp.h>
 #include <limits>
 
-FireRowService::FireRowService(const FireRowModel* model) : model_(model) {}
+FireRowService::FireRowService(const FireRowModel* model, ExecutionContext context)
+    : model_(model), context_(context) {}
 FireRowService::~FireRowService() = default;
 
 std::string FireRowService::getImplementationName() const {
@@ -22,205 +24,123 @@ std::size_t FireRowService::uniqueSiteCount() const {
     return model_->siteCount();
 }
 
+ExecutionContext FireRowService::siteContext(int numThreads) const {
+    // Loops run over sites, but their cost is the measurements inside them
+    return context_.withThreads(numThreads).withWork(model_->siteCount(), model_->totalMeasurements());
+}
+
 int FireRowService::maxAQI(int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        int global_max = std::numeric_limits<int>::min();
-        
-#pragma omp parallel
-        {
-            int local_max = std::numeric_limits<int>::min();
-#pragma omp for nowait
-            for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-                const FireSiteData& site = model_->siteAt(i);
-                for (const auto& measurement : site.measurements()) {
-                    local_max = std::max(local_max, measurement.aqi());
-                }
+    // Sites are the work items; 0 is both the identity and the empty-model result
+    return Parallel::reduce(siteContext(numThreads), model_->siteCount(), 0,
+        [this](std::size_t i, int& local) {
+            for (const auto& measurement : model_->siteAt(i).measurements()) {
+                local = std::max(local, measurement.aqi());
             }
-#pragma omp critical
-            {
-                global_max = std::max(global_max, local_max);
-            }
-        }
-        return global_max == std::numeric_limits<int>::min() ? 0 : global_max;
-    }
-    
-    // Serial version
-    int maxAQIValue = 0;
-    for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-        const FireSiteData& site = model_->siteAt(i);
-        for (const auto& measurement : site.measurements()) {
-            maxAQIValue = std::max(maxAQIValue, measurement.aqi());
-        }
-    }
-    return maxAQIValue;
+        },
+        [](int& into, int from) { into = std::max(into, from); });
 }
 
 int FireRowService::minAQI(int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        int global_min = std::numeric_limits<int>::max();
-        
-#pragma omp parallel
-        {
-            int local_min = std::numeric_limits<int>::max();
-#pragma omp for nowait
-            for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-                const FireSiteData& site = model_->siteAt(i);
-                for (const auto& measurement : site.measurements()) {
-                    if (measurement.aqi() > 0) { // Only consider valid AQI values
-                        local_min = std::min(local_min, measurement.aqi());
-                    }
+    const int minAQIValue = Parallel::reduce(siteContext(numThreads), model_->siteCount(),
+        std::numeric_limits<int>::max(),
+        [this](std::size_t i, int& local) {
+            for (const auto& measurement : model_->siteAt(i).measurements()) {
+                if (measurement.aqi() > 0) { // Only consider valid AQI values
+                    local = std::min(local, measurement.aqi());
                 }
             }
-#pragma omp critical
-            {
-                global_min = std::min(global_min, local_min);
-            }
-        }
-        return global_min == std::numeric_limits<int>::max() ? 0 : global_min;
-    }
-    
-    // Serial version
-    int minAQIValue = std::numeric_limits<int>::max();
-    for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-        const FireSiteData& site = model_->siteAt(i);
-        for (const auto& measurement : site.measurements()) {
-            if (measurement.aqi() > 0) { // Only consider valid AQI values
-                minAQIValue = std::min(minAQIValue, measurement.aqi());
-            }
-        }
-    }
+        },
+        [](int& into, int from) { into = std::min(into, from); });
     return minAQIValue == std::numeric_limits<int>::max() ? 0 : minAQIValue;
 }
 
 double FireRowService::averageAQI(int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        long long total = 0;
-        long long count = 0;
-        
-#pragma omp parallel for reduction(+:total, count)
-        for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-            const FireSiteData& site = model_->siteAt(i);
-            for (const auto& measurement : site.measurements()) {
-                total += measurement.aqi();
-                ++count;
+    struct SumCount {
+        long long total{0};
+        long long count{0};
+    };
+    const SumCount totals = Parallel::reduce(siteContext(numThreads), model_->siteCount(), SumCount{},
+        [this](std::size_t i, SumCount& local) {
+            for (const auto& measurement : model_->siteAt(i).measurements()) {
+                local.total += measurement.aqi();
+                ++local.count;
             }
-        }
-        return count > 0 ? static_cast<double>(total) / static_cast<double>(count) : 0.0;
-    }
-    
-    // Serial version
-    long long total = 0;
-    std::size_t count = 0;
-    for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-        const FireSiteData& site = model_->siteAt(i);
-        for (const auto& measurement : site.measurements()) {
-            total += measurement.aqi();
-            ++count;
-        }
-    }
-    return count > 0 ? static_cast<double>(total) / count : 0.0;
+        },
+        [](SumCount& into, const SumCount& from) { into.total += from.total; into.count += from.count; });
+    return totals.count > 0 ? static_cast<double>(totals.total) / static_cast<double>(totals.count) : 0.0;
 }
 
 std::vector<std::pair<std::string, double>> FireRowService::topNSitesByAverageConcentration(std::size_t n, int numThreads) const {
     if (n == 0) return {};
     
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        
-        // Define heap element and min-heap type for top-N selection
-        using HeapElem = std::pair<double, std::string>; // (avg_concentration, site_name)
-        using MinHeap = std::priority_queue<HeapElem, std::vector<HeapElem>, std::greater<HeapElem>>;
-        
-        int threads = omp_get_max_threads();
-        std::vector<MinHeap> localHeaps(static_cast<std::size_t>(threads)); // one heap per thread
-        
-#pragma omp parallel
-        {
-            int tid = omp_get_thread_num();
-            MinHeap &heap = localHeaps[static_cast<std::size_t>(tid)];
-#pragma omp for nowait
-            for (std::size_t i = 0; i < model_->siteCount(); ++i) {
-                const FireSiteData& site = model_->siteAt(i);
-                if (site.measurementCount() == 0) continue;
-                
-                // Calculate average concentration for this site
-                double totalConcentration = 0.0;
-                std::size_t measurementCount = 0;
-                for (const auto& measurement : site.measurements()) {
-                    totalConcentration += measurement.concentration();
-                    ++measurementCount;
-                }
-                
-                if (measurementCount > 0) {
-                    double avgConcentration = totalConcentration / measurementCount;
-                    HeapElem e{avgConcentration, site.siteIdentifier()};
-                    
-                    // Maintain top-N in each thread's heap
-                    if (heap.size() < n) {
-                        heap.push(e);
-                    } else if (e > heap.top()) {
-                        heap.pop();
-                        heap.push(e);
-                    }
-                }
-            }
-        }
-        
-        // Merge all thread-local heaps into a single final heap of size up to n
-        MinHeap finalHeap;
-        for (auto &h : localHeaps) {
-            while (!h.empty()) {
-                HeapElem e = h.top(); h.pop();
-                if (finalHeap.size() < n) {
-                    finalHeap.push(e);
-                } else if (e > finalHeap.top()) {
-                    finalHeap.pop();
-                    finalHeap.push(e);
-                }
-            }
-        }
-        
-        // Extract results from finalHeap into vector sorted descending by concentration
-        std::vector<std::pair<std::string, double>> out;
-        out.reserve(finalHeap.size());
-        while (!finalHeap.empty()) {
-            auto p = finalHeap.top(); finalHeap.pop(); // smallest-first
-            out.emplace_back(p.second, p.first); // (site_name, avg_concentration)
-        }
-        std::reverse(out.begin(), out.end()); // now descending
-        return out;
-    }
-    
-    // Serial version: collect all site average concentrations
-    std::vector<std::pair<std::string, double>> siteAvgConcentrations;
-    for (std::size_t i = 0; i < model_->siteCount(); ++i) {
+    // Rank sites by (average concentration, site index); only the top-N names are copied
+    const std::size_t sites = model_->siteCount();
+    const int team = siteContext(numThreads).teamSize(sites);
+    auto top = TopN::select<double>(sites, n, team, [this](std::size_t i, double& average) {
         const FireSiteData& site = model_->siteAt(i);
-        if (site.measurementCount() == 0) continue;
+        if (site.measurementCount() == 0) return false;
         
-        // Calculate average concentration for this site
         double totalConcentration = 0.0;
-        std::size_t measurementCount = 0;
-        for (const auto& measurement : site.measurements()) {
-            totalConcentration += measurement.concentration();
-            ++measurementCount;
-        }
-        
-        if (measurementCount > 0) {
-            double avgConcentration = totalConcentration / measurementCount;
-            siteAvgConcentrations.emplace_back(site.siteIdentifier(), avgConcentration);
-        }
-    }
+        for (const auto& measurement : site.measurements()) totalConcentration += measurement.concentration();
+        average = totalConcentration / static_cast<double>(site.measurementCount());
+        return true;
+    });
     
-    // Sort descending by average concentration and take top-N
-    std::sort(siteAvgConcentrations.begin(), siteAvgConcentrations.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::vector<std::pair<std::string, double>> siteAvgConcentrations;
+    siteAvgConcentrations.reserve(top.size());
+    for (const auto& entry : top) {
+        siteAvgConcentrations.emplace_back(model_->siteAt(entry.index).siteIdentifier(), entry.value);
+    }
+    return siteAvgConcentrations;
+}
+
+std::vector<std::pair<std::string, double>> FireRowService::averageConcentrationByParameter(int numThreads) const {
+    // Measurements carry dictionary codes, so group over the dense code range
+    const StringDictionary& parameterDictionary = model_->parameterDictionary();
+    std::vector<GroupAggregate> perParameter = GroupBy::dense(
+        model_->siteCount(), parameterDictionary.size(), siteContext(numThreads).teamSize(model_->siteCount()),
+        [this](std::size_t i, auto& emit) {
+            for (const auto& measurement : model_->siteAt(i).measurements()) {
+                emit(measurement.parameterCode(), measurement.concentration());
+            }
+        });
     
-    if (siteAvgConcentrations.size() > n) {
-        siteAvgConcentrations.resize(n);
+    std::vector<std::pair<std::string, double>> result;
+    for (std::size_t c = 0; c < perParameter.size(); ++c) {
+        if (perParameter[c].count > 0) {
+            result.emplace_back(parameterDictionary.value(static_cast<StringDictionary::Code>(c)), perParameter[c].mean());
+        }
     }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+GroupAggregate FireRowService::concentrationInBox(const std::string& parameter, const GeoBox& box, int numThreads) const {
+    return concentrationIn(parameter, GeoRegion::box(box), numThreads);
+}
+
+GroupAggregate FireRowService::concentrationWithinRadius(const std::string& parameter, double latitude, double longitude,
+                                                         double radiusKm, int numThreads) const {
+    return concentrationIn(parameter, GeoRegion::circle(latitude, longitude, radiusKm), numThreads);
+}
+
+GroupAggregate FireRowService::concentrationIn(const std::string& parameter, const GeoRegion& region, int numThreads) const {
+    const StringDictionary::Code code = model_->parameterDictionary().find(parameter);
+    if (code == StringDictionary::NOT_FOUND) return {};
     
-    return siteAvgConcentrations;
-}
\ No newline at end of file
+    // Work items are the sites located in the region; sites entirely inside skip the location test
+    const std::vector<SpatialIndex::Match> sites = model_->spatialIndex().query(region);
+    std::size_t measurements = 0;
+    for (const auto& match : sites) measurements += model_->siteAt(match.group).measurementCount();
+    return Parallel::reduce(context_.withThreads(numThreads).withWork(sites.size(), measurements),
+        sites.size(), GroupAggregate{},
+        [&](std::size_t i, GroupAggregate& local) {
+            for (const auto& measurement : model_->siteAt(sites[i].group).measurements()) {
+                if (measurement.parameterCode() == code &&
+                    (sites[i].whole || region.contains(measurement.latitude(), measurement.longitude()))) {
+                    local.add(measurement.concentration());
+                }
+            }
+        },
+        [](GroupAggregate& into, const GroupAggregate& from) { into.merge(from); });
+}
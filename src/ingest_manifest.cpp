@@ -0,0 +1,147 @@
+#include "../interface/ingest_manifest.hpp"
+#include "../interface/columnar_snapshot.hpp"
+#include "../interface/mapped_file.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+
+namespace {
+    constexpr const char* MANIFEST_HEADER = "# ingest manifest v1";
+
+    std::uint64_t hashPrefix(const MappedFile& file, std::uint64_t bytes) {
+        return Snapshot::checksum(file.data(), static_cast<std::size_t>(bytes));
+    }
+}
+
+std::size_t IngestPlan::newFiles() const noexcept {
+    return static_cast<std::size_t>(std::count_if(tasks.begin(), tasks.end(), [](const Task& t) { return t.fromByte == 0; }));
+}
+
+std::size_t IngestPlan::grownFiles() const noexcept {
+    return tasks.size() - newFiles();
+}
+
+IngestPlan IngestManifest::plan(const std::string& directoryPath) const {
+    namespace fs = std::filesystem;
+    std::vector<fs::path> csvFiles;
+    try {
+        for (const auto& entry : fs::recursive_directory_iterator(directoryPath)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+                csvFiles.push_back(entry.path());
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        throw std::runtime_error("Error accessing directory " + directoryPath + ": " + e.what());
+    }
+    std::sort(csvFiles.begin(), csvFiles.end());
+
+    IngestPlan plan;
+    std::unordered_set<std::string> seen;
+    for (const auto& path : csvFiles) {
+        IngestPlan::Task task;
+        task.path = path.string();
+        task.key = path.lexically_relative(directoryPath).generic_string();
+        seen.insert(task.key);
+
+        std::error_code ec;
+        task.state.size = fs::file_size(path, ec);
+        if (ec) continue;   // vanished since the scan; picked up (or reported) next time
+        task.state.mtime = static_cast<std::int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+
+        const IngestedFile* previous = find(task.key);
+        if (previous && previous->size == task.state.size && previous->mtime == task.state.mtime) {
+            ++plan.unchangedFiles;
+            continue;
+        }
+
+        MappedFile file(task.path);
+        // Parse up to the last complete line; a line still being written waits for the next plan
+        const std::size_t lastNewline = file.view().rfind('\n');
+        task.state.size = lastNewline == std::string_view::npos ? 0 : lastNewline + 1;
+        if (previous) {
+            if (file.size() < previous->size || hashPrefix(file, previous->size) != previous->hash) {
+                plan.rewrittenFiles.push_back(task.path);
+                continue;
+            }
+            if (task.state.size <= previous->size) {   // touched, or only part of a line added
+                ++plan.unchangedFiles;
+                continue;
+            }
+            if (previous->size > 0 && file.data()[previous->size - 1] != '\n') {
+                // The last ingested line was incomplete, so its rows would be split
+                plan.rewrittenFiles.push_back(task.path);
+                continue;
+            }
+            task.fromByte = previous->size;
+        } else if (task.state.size == 0) {   // no complete line yet
+            ++plan.unchangedFiles;
+            continue;
+        }
+        task.state.hash = hashPrefix(file, task.state.size);
+        plan.tasks.push_back(std::move(task));
+    }
+
+    for (const auto& [key, state] : _files) {
+        (void)state;
+        if (!seen.count(key)) plan.removedFiles.push_back(key);
+    }
+    return plan;
+}
+
+void IngestManifest::record(const IngestPlan::Task& task) {
+    _files[task.key] = task.state;
+}
+
+const IngestedFile* IngestManifest::find(const std::string& key) const {
+    auto it = _files.find(key);
+    return it == _files.end() ? nullptr : &it->second;
+}
+
+void IngestManifest::save(const std::string& path) const {
+    Snapshot::replaceFile(path, "manifest", std::ios::out, [&](std::ostream& out) {
+        out << MANIFEST_HEADER << "\n";
+        out << "measurements " << _measurementCount << "\n";
+        for (const auto& [key, state] : _files) {
+            // The key goes last so it may contain spaces
+            out << state.size << ' ' << state.mtime << ' ' << std::hex << state.hash << std::dec << ' ' << key << "\n";
+        }
+    });
+}
+
+void IngestManifest::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Failed to open manifest " + path);
+    auto malformed = [&](std::size_t line) {
+        return std::runtime_error("Malformed manifest " + path + " at line " + std::to_string(line));
+    };
+
+    std::string line;
+    if (!std::getline(in, line) || line != MANIFEST_HEADER) throw malformed(1);
+    std::size_t measurementCount = 0;
+    {
+        std::string label;
+        if (!std::getline(in, line) || !(std::istringstream(line) >> label >> measurementCount) || label != "measurements") {
+            throw malformed(2);
+        }
+    }
+
+    std::map<std::string, IngestedFile> files;
+    for (std::size_t lineNumber = 3; std::getline(in, line); ++lineNumber) {
+        std::istringstream fields(line);
+        IngestedFile state;
+        std::string key;
+        if (!(fields >> state.size >> state.mtime >> std::hex >> state.hash >> std::dec) || fields.get() != ' ' ||
+            !std::getline(fields, key) || key.empty()) {
+            throw malformed(lineNumber);
+        }
+        files[key] = state;
+    }
+    _files = std::move(files);
+    _measurementCount = measurementCount;
+}
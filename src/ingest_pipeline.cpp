@@ -0,0 +1,64 @@
+#include "../interface/ingest_pipeline.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace IngestPipeline {
+
+    double StageStats::utilization(double wallSeconds) const {
+        return wallSeconds > 0.0 && threads > 0 ? busySeconds / (threads * wallSeconds) : 0.0;
+    }
+
+    double StageStats::megabytesPerSecond() const {
+        return busySeconds > 0.0 ? static_cast<double>(bytes) * threads / busySeconds / (1024.0 * 1024.0) : 0.0;
+    }
+
+    void StageStats::add(const StageStats& other) {
+        files += other.files;
+        bytes += other.bytes;
+        rows += other.rows;
+        busySeconds += other.busySeconds;
+        waitSeconds += other.waitSeconds;
+    }
+
+    const StageStats& Report::bottleneck() const {
+        const StageStats* worst = &read;
+        for (const StageStats* stage : {&parse, &append}) {
+            if (stage->utilization(wallSeconds) > worst->utilization(wallSeconds)) worst = stage;
+        }
+        return *worst;
+    }
+
+    void Report::print(std::ostream& out) const {
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << "Pipeline: " << files << " files";
+        if (failedFiles > 0) out << " (" << failedFiles << " failed)";
+        out << ", " << std::fixed << std::setprecision(1) << static_cast<double>(read.bytes) / (1024.0 * 1024.0)
+            << " MB, " << append.rows << " rows in " << std::setprecision(3) << wallSeconds << " s\n";
+        out << std::setw(8) << "Stage" << std::setw(9) << "Threads" << std::setw(11) << "MB/s"
+            << std::setw(11) << "Busy (s)" << std::setw(11) << "Wait (s)" << std::setw(13) << "Utilization" << "\n";
+        for (const StageStats* stage : {&read, &parse, &append}) {
+            out << std::setw(8) << stage->name << std::setw(9) << stage->threads
+                << std::setw(11) << std::setprecision(1) << stage->megabytesPerSecond()
+                << std::setw(11) << std::setprecision(3) << stage->busySeconds
+                << std::setw(11) << stage->waitSeconds
+                << std::setw(12) << std::setprecision(0) << 100.0 * stage->utilization(wallSeconds) << "%\n";
+        }
+        out << "Bottleneck: " << bottleneck().name << " stage\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    std::vector<char> readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Failed to open " + path);
+        const std::streamsize size = in.tellg();
+        std::vector<char> bytes(static_cast<std::size_t>(size));
+        in.seekg(0);
+        if (size > 0 && !in.read(bytes.data(), size)) throw std::runtime_error("Failed to read " + path);
+        return bytes;
+    }
+
+}
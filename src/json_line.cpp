@@ -0,0 +1,335 @@
+#include "../interface/json_line.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace JsonLine {
+    namespace {
+        class Parser {
+        public:
+            explicit Parser(std::string_view text) : _text(text) {}
+
+            bool fail(const char* message) {
+                if (_error.empty()) _error = std::string(message) + " at offset " + std::to_string(_pos);
+                return false;
+            }
+
+            void skipSpace() {
+                while (_pos < _text.size() && (_text[_pos] == ' ' || _text[_pos] == '\t' ||
+                                               _text[_pos] == '\r' || _text[_pos] == '\n')) {
+                    ++_pos;
+                }
+            }
+
+            bool consume(char c) {
+                skipSpace();
+                if (_pos < _text.size() && _text[_pos] == c) { ++_pos; return true; }
+                return false;
+            }
+
+            static void appendUtf8(std::string& out, unsigned code) {
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xF0 | (code >> 18));
+                    out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+            }
+
+            bool hex4(unsigned& code) {
+                if (_pos + 4 > _text.size()) return fail("truncated \\u escape");
+                code = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const char c = _text[_pos++];
+                    code <<= 4;
+                    if (c >= '0' && c <= '9') code |= static_cast<unsigned>(c - '0');
+                    else if (c >= 'a' && c <= 'f') code |= static_cast<unsigned>(c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F') code |= static_cast<unsigned>(c - 'A' + 10);
+                    else return fail("bad \\u escape");
+                }
+                return true;
+            }
+
+            bool string(std::string& out) {
+                if (!consume('"')) return fail("expected string");
+                out.clear();
+                while (_pos < _text.size()) {
+                    const char c = _text[_pos++];
+                    if (c == '"') return true;
+                    if (static_cast<unsigned char>(c) < 0x20) return fail("control character in string");
+                    if (c != '\\') { out += c; continue; }
+                    if (_pos >= _text.size()) break;
+                    const char e = _text[_pos++];
+                    switch (e) {
+                        case '"': out += '"'; break;
+                        case '\\': out += '\\'; break;
+                        case '/': out += '/'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'n': out += '\n'; break;
+                        case 'r': out += '\r'; break;
+                        case 't': out += '\t'; break;
+                        case 'u': {
+                            unsigned code = 0;
+                            if (!hex4(code)) return false;
+                            // Combine a UTF-16 surrogate pair into one code point
+                            if (code >= 0xD800 && code < 0xDC00 && _pos + 1 < _text.size() &&
+                                _text[_pos] == '\\' && _text[_pos + 1] == 'u') {
+                                _pos += 2;
+                                unsigned low = 0;
+                                if (!hex4(low)) return false;
+                                if (low < 0xDC00 || low > 0xDFFF) return fail("bad surrogate pair");
+                                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            appendUtf8(out, code);
+                            break;
+                        }
+                        default: return fail("bad escape");
+                    }
+                }
+                return fail("unterminated string");
+            }
+
+            /// True if the text matches the JSON number grammar: -?(0|[1-9]d*)(.d+)?([eE][+-]?d+)?
+            static bool isNumber(std::string_view text) {
+                std::size_t i = 0;
+                auto digits = [&] {
+                    const std::size_t first = i;
+                    while (i < text.size() && text[i] >= '0' && text[i] <= '9') ++i;
+                    return i > first;
+                };
+                if (i < text.size() && text[i] == '-') ++i;
+                if (i < text.size() && text[i] == '0') ++i;
+                else if (!digits()) return false;
+                if (i < text.size() && text[i] == '.') {
+                    ++i;
+                    if (!digits()) return false;
+                }
+                if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+                    ++i;
+                    if (i < text.size() && (text[i] == '+' || text[i] == '-')) ++i;
+                    if (!digits()) return false;
+                }
+                return i == text.size();
+            }
+
+            /// Read a number, true, false or null up to the next delimiter
+            bool scalar(std::string& out) {
+                const std::size_t start = _pos;
+                while (_pos < _text.size()) {
+                    const char c = _text[_pos];
+                    if (c == ',' || c == '}' || c == ']' || c == ':' ||
+                        c == ' ' || c == '\t' || c == '\r' || c == '\n') break;
+                    if (c == '{' || c == '[' || c == '"') return fail("unexpected character in value");
+                    ++_pos;
+                }
+                out.assign(_text.substr(start, _pos - start));
+                if (out == "true" || out == "false" || out == "null") return true;
+                if (out.empty()) return fail("expected value");
+                return isNumber(out) ? true : fail("bad number");
+            }
+
+            /// Validate one value of any type, descending into objects and arrays
+            bool value(std::size_t depth) {
+                skipSpace();
+                if (_pos >= _text.size()) return fail("expected value");
+                const char open = _text[_pos];
+                std::string ignored;
+                if (open == '"') return string(ignored);
+                if (open != '{' && open != '[') return scalar(ignored);
+                if (depth >= MAX_DEPTH) return fail("nesting too deep");
+                const char close = open == '{' ? '}' : ']';
+                ++_pos;
+                if (consume(close)) return true;
+                for (;;) {
+                    if (open == '{') {
+                        if (!string(ignored)) return false;
+                        if (!consume(':')) return fail("expected ':'");
+                    }
+                    if (!value(depth + 1)) return false;
+                    if (consume(',')) continue;
+                    if (consume(close)) return true;
+                    return fail(open == '{' ? "expected ',' or '}'" : "expected ',' or ']'");
+                }
+            }
+
+            /// Read a non-string value; nested objects and arrays are validated and kept verbatim
+            bool literal(std::string& out) {
+                skipSpace();
+                if (_pos < _text.size() && (_text[_pos] == '{' || _text[_pos] == '[')) {
+                    const std::size_t start = _pos;
+                    if (!value(1)) return false;
+                    out.assign(_text.substr(start, _pos - start));
+                    return true;
+                }
+                return scalar(out);
+            }
+
+            bool object(std::unordered_map<std::string, std::pair<std::string, bool>>& fields) {
+                if (!consume('{')) return fail("expected '{'");
+                if (consume('}')) return atEnd();
+                for (;;) {
+                    std::string key;
+                    if (!string(key)) return false;
+                    if (!consume(':')) return fail("expected ':'");
+                    skipSpace();
+                    std::string value;
+                    bool isString = _pos < _text.size() && _text[_pos] == '"';
+                    if (isString ? !string(value) : !literal(value)) return false;
+                    fields[key] = {std::move(value), isString};
+                    if (consume(',')) continue;
+                    if (consume('}')) return atEnd();
+                    return fail("expected ',' or '}'");
+                }
+            }
+
+            bool atEnd() {
+                skipSpace();
+                return _pos == _text.size() ? true : fail("trailing characters");
+            }
+
+            const std::string& error() const { return _error; }
+
+        private:
+            static constexpr std::size_t MAX_DEPTH = 64;
+
+            std::string_view _text;
+            std::size_t _pos{0};
+            std::string _error;
+        };
+    }
+
+    std::optional<std::string> Object::getString(const std::string& key) const {
+        auto it = _fields.find(key);
+        if (it == _fields.end() || !it->second.isString) return std::nullopt;
+        return it->second.text;
+    }
+
+    std::optional<long long> Object::getInt(const std::string& key) const {
+        auto it = _fields.find(key);
+        if (it == _fields.end() || it->second.isString) return std::nullopt;
+        const std::string& text = it->second.text;
+        errno = 0;
+        char* end = nullptr;
+        long long value = std::strtoll(text.c_str(), &end, 10);
+        if (errno != 0 || end == text.c_str() || *end != '\0') return std::nullopt;
+        return value;
+    }
+
+    std::optional<double> Object::getDouble(const std::string& key) const {
+        auto it = _fields.find(key);
+        if (it == _fields.end() || it->second.isString) return std::nullopt;
+        const std::string& text = it->second.text;
+        char* end = nullptr;
+        const double value = std::strtod(text.c_str(), &end);
+        if (end == text.c_str() || *end != '\0') return std::nullopt;
+        return value;
+    }
+
+    std::optional<std::string> Object::getRaw(const std::string& key) const {
+        auto it = _fields.find(key);
+        if (it == _fields.end()) return std::nullopt;
+        return it->second.isString ? quote(it->second.text) : it->second.text;
+    }
+
+    std::optional<Object> parse(std::string_view line, std::string* error) {
+        Parser parser(line);
+        std::unordered_map<std::string, std::pair<std::string, bool>> fields;
+        if (!parser.object(fields)) {
+            if (error) *error = parser.error();
+            return std::nullopt;
+        }
+        Object object;
+        for (auto& [key, value] : fields) {
+            object._fields[key] = Object::Value{std::move(value.first), value.second};
+        }
+        return object;
+    }
+
+    std::string quote(std::string_view text) {
+        std::string out;
+        out.reserve(text.size() + 2);
+        out += '"';
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                        out += buffer;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+        return out;
+    }
+
+    std::string number(double value) {
+        if (!std::isfinite(value)) return "null";
+        // Shortest of 15 or 17 significant digits that reads back as the same double
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+        if (std::strtod(buffer, nullptr) != value) std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        return buffer;
+    }
+
+    void Writer::key(std::string_view name) {
+        if (_out.size() > 1) _out += ',';
+        _out += quote(name);
+        _out += ':';
+    }
+
+    Writer& Writer::field(std::string_view name, std::string_view value) {
+        key(name);
+        _out += quote(value);
+        return *this;
+    }
+
+    Writer& Writer::field(std::string_view name, long long value) {
+        key(name);
+        _out += std::to_string(value);
+        return *this;
+    }
+
+    Writer& Writer::field(std::string_view name, std::size_t value) {
+        key(name);
+        _out += std::to_string(value);
+        return *this;
+    }
+
+    Writer& Writer::field(std::string_view name, double value) {
+        key(name);
+        _out += number(value);
+        return *this;
+    }
+
+    Writer& Writer::field(std::string_view name, bool value) {
+        key(name);
+        _out += value ? "true" : "false";
+        return *this;
+    }
+
+    Writer& Writer::raw(std::string_view name, std::string_view json) {
+        key(name);
+        _out += json;
+        return *this;
+    }
+}
@@ -16,6 +16,8 @@
 #include "../interface/fireRowModel.hpp"
 #include "../interface/fireColumnModel.hpp"
 #include "../interface/fire_service_direct.hpp"
+#include "../interface/query_server.hpp"
+#include "../interface/ingest_manifest.hpp"
 
 /**
  * @file main.cpp
@@ -33,7 +35,8 @@
  * - Configurable benchmark parameters through BenchmarkConfig
  * 
  * Usage:
- *   ./benchmark [--help] [--threads N] [--repetitions N]
+ *   ./benchmark [--help] [--threads N] [--repetitions N] [--snapshot DIR]
+ *   ./benchmark --serve [--socket PATH] [--workers N] [--query-threads N]
  */
 
 namespace {
@@ -97,6 +100,70 @@ namespace {
         return std::filesystem::path(projectRoot) / "data" / "PopulationData" / "population.csv";
     }
 
+    /**
+     * Path of a column snapshot inside the --snapshot DIR directory, or "" if the
+     * flag is absent (snapshots disabled). The directory is created if needed.
+     */
+    std::string getSnapshotPath(int argc, char* argv[], const std::string& fileName) {
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) != "--snapshot") continue;
+            const std::filesystem::path dir = argv[i + 1];
+            std::error_code ec;
+            std::filesystem::create_directories(dir, ec);
+            return (dir / fileName).string();
+        }
+        return "";
+    }
+
+    /**
+     * Load the fire column model. With a snapshot path, the snapshot and the manifest
+     * beside it are loaded and only CSV files added (or appended to) since are parsed;
+     * both files are rewritten when anything was added. Without one, or when the data
+     * directory changed beyond appends, the whole directory is parsed.
+     * Returns where the data came from, for the progress line.
+     */
+    std::string loadFireColumns(FireColumnModel& model, const std::string& snapshotPath,
+                                const std::string& fireDataPath, int loadThreads) {
+        if (snapshotPath.empty()) {
+            model.readFromDirectoryParallel(fireDataPath, loadThreads);
+            return "parsed CSV";
+        }
+        const std::string manifestPath = snapshotPath + ".manifest";
+        IngestManifest manifest;
+        bool fromSnapshot = false;
+        if (std::filesystem::exists(snapshotPath)) {
+            try {
+                model.loadSnapshot(snapshotPath, true, loadThreads);
+                manifest.load(manifestPath);
+                fromSnapshot = true;
+            } catch (const std::exception& e) {
+                std::cerr << "Rebuilding snapshot: " << e.what() << "\n";
+                model = FireColumnModel();
+                manifest.clear();
+            }
+        }
+        IngestReport report = model.readNewFiles(fireDataPath, manifest, loadThreads);
+        if (report.requiresFullReload()) {
+            std::cerr << "Rebuilding snapshot: files in " << fireDataPath << " were rewritten or removed\n";
+            model = FireColumnModel();
+            manifest.clear();
+            fromSnapshot = false;
+            report = model.readNewFiles(fireDataPath, manifest, loadThreads);
+        }
+        if (!fromSnapshot || report.measurementsAdded > 0) {
+            try {
+                model.saveSnapshot(snapshotPath);
+                manifest.save(manifestPath);
+            } catch (const std::exception& e) {
+                std::cerr << "Could not write snapshot: " << e.what() << "\n";
+            }
+        }
+        if (!fromSnapshot) return "parsed CSV";
+        if (report.plan.tasks.empty()) return "mapped " + snapshotPath;
+        return "mapped " + snapshotPath + " + " + std::to_string(report.plan.newFiles()) + " new, " +
+               std::to_string(report.plan.grownFiles()) + " grown files";
+    }
+
     /**
      * Get fire data directory path
      */
@@ -275,6 +342,33 @@ namespace {
         }
         
         std::cout << std::string(100, '-') << "\n\n";
+
+        // Streaming pipeline: one read thread and the appending caller, the rest parse
+        const int parseWorkers = std::max(1, maxThreads - 2);
+        std::cout << "=== Streaming Pipeline (" << parseWorkers << " parse workers) ===\n";
+        auto benchmarkPipeline = [&](const char* name, auto load) {
+            IngestPipeline::Report best;
+            for (int rep = 0; rep < repetitions; ++rep) {
+                try {
+                    IngestPipeline::Report report = load();
+                    if (rep == 0 || report.wallSeconds < best.wallSeconds) best = report;
+                } catch (const std::exception& e) {
+                    std::cerr << "Error in pipelined " << name << " load: " << e.what() << "\n";
+                    return;
+                }
+            }
+            std::cout << name << ": " << std::fixed << std::setprecision(3) << best.wallSeconds << " s\n";
+            best.print(std::cout);
+            std::cout << "\n";
+        };
+        benchmarkPipeline("Row-oriented", [&] {
+            FireRowModel fire_model;
+            return fire_model.readFromDirectoryPipelined(fireDataPath, parseWorkers);
+        });
+        benchmarkPipeline("Column-oriented", [&] {
+            FireColumnModel fire_model;
+            return fire_model.readFromDirectoryPipelined(fireDataPath, parseWorkers);
+        });
         
         // Explain the benchmark metrics
         std::cout << "=== Benchmark Metrics Explained ===\n";
@@ -284,7 +378,9 @@ namespace {
         std::cout << "Speedup: Performance improvement vs single-threaded baseline (higher is better)\n";
         std::cout << "Sites: Number of unique monitoring sites found in the data\n";
         std::cout << "Measurements: Total number of fire/air quality measurements processed\n";
-        std::cout << "Files/sec: Processing throughput - CSV files processed per second\n\n";
+        std::cout << "Files/sec: Processing throughput - CSV files processed per second\n";
+        std::cout << "Pipeline: MB/s is what a stage sustains with all its threads busy; the stage with the\n"
+                  << "          highest utilization is the bottleneck\n\n";
 
         // Summary comparison
         if (row_baseline_time > 0.0 && column_baseline_time > 0.0) {
@@ -306,6 +402,112 @@ namespace {
         std::cout << "\nBenchmark completed successfully.\n";
     }
 
+    /**
+     * Thread-scaling benchmark for the group-by analytics (best of `repetitions` runs)
+     */
+    void benchmarkFireGroupByScaling(const FireRowService& rowService, const FireColumnService& columnService,
+                                     int maxThreads, int repetitions) {
+        std::cout << "=== Group-By Thread Scaling (best of " << repetitions << ", ms) ===\n";
+
+        std::vector<int> threadCounts;
+        for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(std::max(1, maxThreads));
+
+        auto bestMs = [repetitions](auto&& fn) {
+            double best = 0.0;
+            for (int rep = 0; rep < std::max(1, repetitions); ++rep) {
+                auto start = std::chrono::high_resolution_clock::now();
+                auto result = fn();
+                auto end = std::chrono::high_resolution_clock::now();
+                (void)result;
+                double ms = std::chrono::duration<double, std::milli>(end - start).count();
+                if (rep == 0 || ms < best) best = ms;
+            }
+            return best;
+        };
+
+        std::cout << std::setw(10) << "Threads"
+                  << std::setw(18) << "Row TopN Site"
+                  << std::setw(18) << "Col TopN Site"
+                  << std::setw(18) << "Row By Param"
+                  << std::setw(18) << "Col By Param" << "\n";
+        std::cout << std::string(82, '-') << "\n";
+
+        for (int threads : threadCounts) {
+            double rowTopN = bestMs([&] { return rowService.topNSitesByAverageConcentration(10, threads); });
+            double colTopN = bestMs([&] { return columnService.topNSitesByAverageConcentration(10, threads); });
+            double rowByParam = bestMs([&] { return rowService.averageConcentrationByParameter(threads); });
+            double colByParam = bestMs([&] { return columnService.averageConcentrationByParameter(threads); });
+            std::cout << std::setw(10) << threads << std::fixed << std::setprecision(3)
+                      << std::setw(18) << rowTopN
+                      << std::setw(18) << colTopN
+                      << std::setw(18) << rowByParam
+                      << std::setw(18) << colByParam << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    /**
+     * Query server mode: load every model once, then answer line-delimited JSON
+     * queries from stdin (default) or a Unix socket until EOF or a shutdown request
+     */
+    int runQueryServer(int argc, char* argv[], int loadThreads) {
+        std::string socketPath;
+        QueryServer::Options options;
+        options.workers = Config::DEFAULT_PARALLEL_THREADS;
+        for (int i = 1; i + 1 < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--socket") socketPath = argv[++i];
+            else if (arg == "--workers") options.workers = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--query-threads") options.context.threads = std::max(1, std::atoi(argv[++i]));
+        }
+
+        // Status goes to stderr so stdout carries nothing but responses in stdin mode;
+        // the model loaders report progress on std::cout, so it is redirected while they run
+        std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+        auto started = std::chrono::steady_clock::now();
+        PopulationModel model;
+        PopulationModelColumn modelCol;
+        auto initResult = BenchmarkUtils::initializeModels(getCSVPath(), model, modelCol, loadThreads,
+                                                           getSnapshotPath(argc, argv, "population_columns.snap"));
+        if (!initResult.success) {
+            std::cout.rdbuf(stdoutBuffer);
+            std::cerr << "Error: " << initResult.errorMessage << "\n";
+            return 1;
+        }
+        model.buildRangeIndex();
+        modelCol.buildRangeIndex();
+
+        FireRowModel fireRowModel;
+        FireColumnModel fireColumnModel;
+        QueryServer::Models models{&model, &modelCol, nullptr, nullptr};
+        const std::string fireDataPath = getFireDataPath();
+        if (std::filesystem::is_directory(fireDataPath)) {
+            fireRowModel.readFromDirectoryParallel(fireDataPath, loadThreads);
+            loadFireColumns(fireColumnModel, getSnapshotPath(argc, argv, "fire_columns.snap"), fireDataPath, loadThreads);
+            models.fireRow = &fireRowModel;
+            models.fireColumn = &fireColumnModel;
+        } else {
+            std::cerr << "Fire data not found at " << fireDataPath << "; fire queries are disabled\n";
+        }
+        std::cout.rdbuf(stdoutBuffer);
+        double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::cerr << "Loaded " << model.rowCount() << " countries and " << fireColumnModel.measurementCount()
+                  << " fire measurements in " << std::fixed << std::setprecision(2) << loadSeconds << " s\n";
+
+        QueryServer::Server server(models, options);
+        if (socketPath.empty()) {
+            std::cerr << "Serving stdin with " << options.workers << " workers [" << options.context.describe() << "]\n";
+            server.serveStream(std::cin, std::cout);
+        } else {
+            std::cerr << "Serving " << socketPath << " with " << options.workers << " workers ["
+                      << options.context.describe() << "]\n";
+            server.serveUnixSocket(socketPath);
+        }
+        server.printStats(std::cerr);
+        return 0;
+    }
+
 }
 
 int main(int argc, char* argv[]) {
@@ -314,9 +516,14 @@ int main(int argc, char* argv[]) {
         BenchmarkUtils::Config args = BenchmarkUtils::parseCommandLine(argc, argv);
         
         // Check for fire benchmarking flag
+        bool runServer = false;
         bool runFireBenchmark = false;
         bool runFireAnalytics = false;
         for (int i = 1; i < argc; ++i) {
+            if (std::string(argv[i]) == "--serve") {
+                runServer = true;
+                break;
+            }
             if (std::string(argv[i]) == "--fire" || std::string(argv[i]) == "-f") {
                 runFireBenchmark = true;
                 break;
@@ -328,7 +535,8 @@ int main(int argc, char* argv[]) {
         }
         
         if (args.showHelp) {
-            std::cout << "Usage: " << argv[0] << " [--help] [--threads N] [--repetitions N] [--fire] [--fire-analytics]\n";
+            std::cout << "Usage: " << argv[0] << " [--help] [--threads N] [--repetitions N] [--fire] [--fire-analytics] [--snapshot DIR]\n";
+            std::cout << "       " << argv[0] << " --serve [--socket PATH] [--workers N] [--query-threads N]\n";
             std::cout << "\nDemonstrates interface-based design eliminating code duplication\n";
             std::cout << "Uses synthetic data to showcase generic benchmark framework\n\n";
             std::cout << "Options:\n";
@@ -336,10 +544,20 @@ int main(int argc, char* argv[]) {
             std::cout << "  --threads N         Number of parallel threads (default: 4)\n";
             std::cout << "  --repetitions N     Number of benchmark repetitions (default: 5)\n";
             std::cout << "  --fire, -f          Run fire data reading benchmark\n";
-            std::cout << "  --fire-analytics, -fa Run fire analytics benchmark suite\n\n";
+            std::cout << "  --fire-analytics, -fa Run fire analytics benchmark suite\n";
+            std::cout << "  --snapshot DIR      Load column models from binary snapshots in DIR\n";
+            std::cout << "                      (written there on first use or when the CSVs are newer)\n";
+            std::cout << "  --serve             Load all models once and answer JSON-line queries\n";
+            std::cout << "  --socket PATH       Serve a Unix socket instead of stdin\n";
+            std::cout << "  --workers N         Query worker threads (default: 4)\n";
+            std::cout << "  --query-threads N   OpenMP threads per query (default: 1)\n\n";
             return 0;
         }
         
+        if (runServer) {
+            return runQueryServer(argc, argv, args.parallelThreads);
+        }
+        
         std::cout << "=== Population Data Analysis: Interface Comparison ===\n";
         std::cout << "Threads: " << args.parallelThreads 
                   << ", Repetitions: " << args.repetitions << "\n\n";
@@ -367,8 +585,13 @@ int main(int argc, char* argv[]) {
                 std::cout << "Loading row model with " << loadThreads << " threads...\n";
                 fireRowModel.readFromDirectoryParallel(fireDataPath, loadThreads);
                 
+                const std::string snapshotPath = getSnapshotPath(argc, argv, "fire_columns.snap");
                 std::cout << "Loading column model with " << loadThreads << " threads...\n";
-                fireColumnModel.readFromDirectoryParallel(fireDataPath, loadThreads);
+                auto loadStart = std::chrono::steady_clock::now();
+                const std::string source = loadFireColumns(fireColumnModel, snapshotPath, fireDataPath, loadThreads);
+                auto loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+                std::cout << "Column model ready in " << std::fixed << std::setprecision(1) << loadMs << " ms ("
+                          << source << ")\n";
                 
                 // Create direct services
                 FireRowService fireRowService(&fireRowModel);
@@ -376,7 +599,8 @@ int main(int argc, char* argv[]) {
                 
                 std::cout << "\n=== Fire Analytics Benchmark Results ===\n";
                 std::cout << "Configuration: " << args.parallelThreads << " threads, " << args.repetitions << " repetitions\n";
-                std::cout << "Row Model: " << fireRowService.totalMeasurementCount() << " measurements, " << fireRowService.uniqueSiteCount() << " sites\n";
+                std::cout << "Row Model: " << fireRowService.totalMeasurementCount() << " measurements, " << fireRowService.uniqueSiteCount() << " sites, "
+                          << std::fixed << std::setprecision(1) << fireRowModel.memoryBytes() / (1024.0 * 1024.0) << " MB\n";
                 std::cout << "Column Model: " << fireColumnService.totalMeasurementCount() << " measurements, " << fireColumnService.uniqueSiteCount() << " sites\n\n";
                 
                 // Simple benchmarking for maxAQI
@@ -446,10 +670,22 @@ int main(int argc, char* argv[]) {
                 }
                 std::cout << "\n\n";
                 
+                // Per-parameter group-by (hashed engine on rows, dense engine on columns)
+                auto rowByParam = fireRowService.averageConcentrationByParameter(args.parallelThreads);
+                auto colByParam = fireColumnService.averageConcentrationByParameter(args.parallelThreads);
+                std::cout << "Average Concentration by Parameter:\n";
+                for (const auto& entry : colByParam) {
+                    std::cout << "  " << entry.first << ": " << std::fixed << std::setprecision(2) << entry.second << "\n";
+                }
+                std::cout << "\n";
+                
+                benchmarkFireGroupByScaling(fireRowService, fireColumnService, args.parallelThreads, args.repetitions);
+                
                 // Validation
                 bool resultsMatch = (rowMaxSerial == rowMaxParallel && rowMaxSerial == colMaxSerial && 
                                    rowMinSerial == rowMinParallel && rowMinSerial == colMinSerial &&
-                                   std::abs(rowAvgSerial - rowAvgParallel) < 0.1);
+                                   std::abs(rowAvgSerial - rowAvgParallel) < 0.1 &&
+                                   rowByParam.size() == colByParam.size());
                 
                 std::cout << "=== Validation ===\n";
                 std::cout << "Serial vs Parallel consistency: " << (resultsMatch ? "✓ PASS" : "⚠ WARNING") << "\n";
@@ -468,7 +704,8 @@ int main(int argc, char* argv[]) {
         // Initialize models with error handling
         std::string csvPath = getCSVPath();
         
-        auto initResult = BenchmarkUtils::initializeModels(csvPath, model, modelCol);
+        auto initResult = BenchmarkUtils::initializeModels(csvPath, model, modelCol, args.parallelThreads,
+                                                           getSnapshotPath(argc, argv, "population_columns.snap"));
         if (!initResult.success) {
             std::cerr << "Error: " << initResult.errorMessage << "\n";
             return 1;
@@ -483,6 +720,11 @@ int main(int argc, char* argv[]) {
 
         printModelInfo(model, modelCol);
 
+        // O(1) per-country year-range queries for the benchmark suite
+        model.buildRangeIndex();
+        modelCol.buildRangeIndex();
+        std::cout << "Range index: " << model.rangeIndex().memoryBytes() / 1024 << " KB per model\n";
+
         // Create services with the common interface
         PopulationModelService rowService(&model);
         PopulationModelColumnService columnService(&modelCol);
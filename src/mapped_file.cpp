@@ -0,0 +1,96 @@
+#include "../interface/mapped_file.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define MAPPED_FILE_USE_HEAP 1
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path, Access access) { open(path, access); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _open(std::exchange(other._open, false)),
+      _heap(std::exchange(other._heap, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _open = std::exchange(other._open, false);
+        _heap = std::exchange(other._heap, false);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() { close(); }
+
+#if defined(MAPPED_FILE_USE_HEAP)
+void MappedFile::open(const std::string& path, Access) {
+    close();
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if (!ifs.is_open()) throw std::runtime_error("Failed to open file for mapping: " + path);
+    std::size_t size = static_cast<std::size_t>(ifs.tellg());
+    ifs.seekg(0);
+    if (size > 0) {
+        char* buffer = new char[size];
+        ifs.read(buffer, static_cast<std::streamsize>(size));
+        _data = buffer;
+        _heap = true;
+    }
+    _size = size;
+    _open = true;
+}
+#else
+void MappedFile::open(const std::string& path, Access access) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Failed to open file for mapping: " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file for mapping: " + path);
+    }
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size > 0) {
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to mmap file: " + path);
+        }
+        // Parsers walk the file front to back; let the kernel read ahead aggressively
+        if (access == Access::Sequential) ::madvise(addr, size, MADV_SEQUENTIAL);
+        _data = static_cast<const char*>(addr);
+    }
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    _size = size;
+    _open = true;
+}
+#endif
+
+void MappedFile::close() noexcept {
+    if (_data) {
+#if defined(MAPPED_FILE_USE_HEAP)
+        delete[] _data;
+#else
+        if (_heap) delete[] _data;
+        else ::munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+    _data = nullptr;
+    _size = 0;
+    _open = false;
+    _heap = false;
+}
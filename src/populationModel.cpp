@@ -1,7 +1,9 @@
 #include "../interface/populationModel.hpp"
 
 #include "../interface/readcsv.hpp"
+#include "../interface/csv_chunked.hpp"
 #include "../interface/utils.hpp"
+#include <algorithm>
 #include <stdexcept>
 #include <sstream>
 #include <string>
@@ -9,20 +11,23 @@
 #include <iostream>
 
 // PopulationRow implementations
-PopulationRow::PopulationRow() = default;
-PopulationRow::PopulationRow(std::string country, std::vector<long long> year_population)
-    : _country(std::move(country)), _year_population(std::move(year_population)) {}
+PopulationRow::PopulationRow() : _country(nullptr) {}
+PopulationRow::PopulationRow(const std::string& country, PopulationSpan year_population)
+    : _country(&country), _year_population(year_population) {}
 
-const std::string& PopulationRow::country() const noexcept { return _country; }
-const std::vector<long long>& PopulationRow::yearPopulation() const noexcept { return _year_population; }
+const std::string& PopulationRow::country() const noexcept {
+    static const std::string empty;
+    return _country ? *_country : empty;
+}
+PopulationSpan PopulationRow::yearPopulation() const noexcept { return _year_population; }
 long long PopulationRow::getPopulationForYear(std::size_t yearIndex) const {
-    if (yearIndex >= _year_population.size()) throw std::out_of_range("Year index out of range");
+    if (yearIndex >= _year_population.size) throw std::out_of_range("Year index out of range");
     return _year_population[yearIndex];
 }
-std::size_t PopulationRow::yearCount() const noexcept { return _year_population.size(); }
+std::size_t PopulationRow::yearCount() const noexcept { return _year_population.size; }
 
 // PopulationModel implementations
-PopulationModel::PopulationModel() = default;
+PopulationModel::PopulationModel(PopulationMatrix::Layout layout) : _matrix(layout) {}
 PopulationModel::~PopulationModel() = default;
 
 const std::vector<std::string>& PopulationModel::countryNames() const noexcept { return _countryNames; }
@@ -31,34 +36,65 @@ const std::vector<std::string>& PopulationModel::indicatorNames() const noexcept
 const std::vector<std::string>& PopulationModel::indicatorCodes() const noexcept { return _indicatorCodes; }
 const std::vector<long long>& PopulationModel::years() const noexcept { return _years; }
 
-// Build a temporary per-instance map from country name to row index using the header-provided maps.
-const std::unordered_map<std::string, int>& PopulationModel::countryNameToIndex() const noexcept {
-    // cache built per-instance in a thread_local variable
-    thread_local std::unordered_map<std::string, int> cache;
-    cache.clear();
-    for (const auto& kv : _countryNameToCountryCode) {
-        const std::string& cname = kv.first;
-        const std::string& code = kv.second;
-        auto it = _countryCodeToRowIndex.find(code);
-        if (it != _countryCodeToRowIndex.end()) cache[cname] = it->second;
-    }
-    return cache;
-}
+const std::unordered_map<std::string, int>& PopulationModel::countryNameToIndex() const noexcept { return _countryNameToRowIndex; }
 
 const std::unordered_map<long long, int>& PopulationModel::yearToIndex() const noexcept { return _yearToIndex; }
 
-std::size_t PopulationModel::rowCount() const noexcept { return _rows.size(); }
-const PopulationRow& PopulationModel::rowAt(std::size_t idx) const { return _rows.at(idx); }
+std::size_t PopulationModel::rowCount() const noexcept { return _matrix.rows(); }
+
+PopulationRow PopulationModel::rowAt(std::size_t idx) const {
+    if (idx >= _matrix.rows()) throw std::out_of_range("Row index out of range");
+    return PopulationRow(_countryNames[idx], _matrix.view().row(idx));
+}
+
+std::optional<PopulationRow> PopulationModel::getByCountry(const std::string& country) const noexcept {
+    auto it = _countryNameToRowIndex.find(country);
+    if (it == _countryNameToRowIndex.end()) return std::nullopt;
+    std::size_t idx = static_cast<std::size_t>(it->second);
+    return PopulationRow(_countryNames[idx], _matrix.view().row(idx));
+}
+
+PopulationMatrixView PopulationModel::matrix() const noexcept { return _matrix.view(); }
+
+void PopulationModel::buildRangeIndex() {
+    _rangeIndex.build(_matrix.view());
+    _rangeIndexEnabled = true;
+}
 
-const PopulationRow* PopulationModel::getByCountry(const std::string& country) const noexcept {
-    const auto &map = countryNameToIndex();
-    auto it = map.find(country);
-    if (it == map.end()) return nullptr;
-    return &_rows[it->second];
+void PopulationModel::dropRangeIndex() noexcept {
+    _rangeIndex.clear();
+    _rangeIndexEnabled = false;
+}
+
+bool PopulationModel::hasRangeIndex() const noexcept { return _rangeIndexEnabled; }
+
+const PopulationRangeIndex& PopulationModel::rangeIndex() const noexcept { return _rangeIndex; }
+
+PopulationRange PopulationModel::rangeForCountry(const std::string& country, long long startYear, long long endYear) const {
+    auto itCountry = _countryNameToRowIndex.find(country);
+    auto itStart = _yearToIndex.find(startYear);
+    auto itEnd = _yearToIndex.find(endYear);
+    if (itCountry == _countryNameToRowIndex.end() || itStart == _yearToIndex.end() || itEnd == _yearToIndex.end()) return {};
+    const std::size_t r = static_cast<std::size_t>(itCountry->second);
+    const std::size_t first = static_cast<std::size_t>(itStart->second);
+    const std::size_t last = static_cast<std::size_t>(itEnd->second);
+    if (_rangeIndexEnabled) return _rangeIndex.query(r, first, last);
+
+    PopulationRange range;
+    const PopulationSpan values = _matrix.view().row(r);
+    if (first > last || last >= values.size) return range;
+    range.min = range.max = values[first];
+    for (std::size_t i = first; i <= last; ++i) {
+        range.sum += values[i];
+        range.min = std::min(range.min, values[i]);
+        range.max = std::max(range.max, values[i]);
+    }
+    range.count = last - first + 1;
+    return range;
 }
 
 bool PopulationModel::setYears(std::vector<long long> years) {
-    if (!_rows.empty()) return false; // Cannot set years if rows already exist
+    if (_matrix.rows() != 0) return false; // Cannot set years if rows already exist
     _years = std::move(years);
     _yearToIndex.clear();
     for (std::size_t i = 0; i < _years.size(); ++i) {
@@ -74,16 +110,36 @@ void PopulationModel::insertNewEntry(std::string country, std::string contry_cod
     _countriesCode.push_back(std::move(contry_code));
     _indicatorNames.push_back(std::move(indicator_name));
     _indicatorCodes.push_back(std::move(indicator_code));
-    PopulationRow newRow(std::move(country), std::move(year_population));
-    std::size_t idx = _rows.size();
-    _rows.push_back(std::move(newRow));
-    _countryNames.push_back(_rows.back().country());
+    std::size_t idx = _matrix.rows();
+    _matrix.appendRow(year_population.data(), year_population.size());
+    _countryNames.push_back(std::move(country));
     // maintain the code->row mapping and name->code mapping
     _countryCodeToRowIndex[_countriesCode.back()] = static_cast<int>(idx);
     _countryNameToCountryCode[_countryNames.back()] = _countriesCode.back();
+    _countryNameToRowIndex[_countryNames.back()] = static_cast<int>(idx);
+    if (_rangeIndexEnabled) _rangeIndex.appendRow(_matrix.view().row(idx));
 }
 
-void PopulationModel::readFromCSV(const std::string& filename) {
+void PopulationModel::readFromCSV(const std::string& filename, int numThreads) {
+    if (numThreads > 1) {
+        PopulationCSVData data;
+        if (!PopulationCSV::readParallel(filename, numThreads, data)) return;
+        setYears(std::move(data.years));
+        _matrix.reserve(data.rowCount(), _years.size());
+        for (std::size_t r = 0; r < data.rowCount(); ++r) {
+            // Rows are copied straight from the flat parse buffer into the matrix
+            _countriesCode.push_back(std::move(data.countryCodes[r]));
+            _indicatorNames.push_back(std::move(data.indicatorNames[r]));
+            _indicatorCodes.push_back(std::move(data.indicatorCodes[r]));
+            _countryNames.push_back(std::move(data.countryNames[r]));
+            _matrix.appendRow(data.values.data() + data.rowOffsets[r], data.rowOffsets[r + 1] - data.rowOffsets[r]);
+            _countryCodeToRowIndex[_countriesCode.back()] = static_cast<int>(_matrix.rows() - 1);
+            _countryNameToCountryCode[_countryNames.back()] = _countriesCode.back();
+            _countryNameToRowIndex[_countryNames.back()] = static_cast<int>(_matrix.rows() - 1);
+        }
+        if (_rangeIndexEnabled) _rangeIndex.build(_matrix.view());
+        return;
+    }
     CSVReader reader(filename);
     try { 
         reader.open();
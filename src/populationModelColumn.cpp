@@ -1,11 +1,32 @@
 #include "../interface/populationModelColumn.hpp"
 #include "../interface/readcsv.hpp"
+#include "../interface/csv_chunked.hpp"
 #include "../interface/constants.hpp"
 #include "../interface/utils.hpp"
+#include "../interface/columnar_snapshot.hpp"
+#include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <algorithm>
 #include <iostream>
 
-PopulationModelColumn::PopulationModelColumn() = default;
+namespace {
+    // Snapshot section ids (stable across versions: add new ids, never renumber)
+    enum Section : std::uint32_t {
+        SHAPE = 1,      ///< layout, rows, cols, row stride, column stride
+        YEARS,
+        VALUES,         ///< Matrix buffer as laid out in memory, padding included
+        ROW_LENGTHS,
+        COUNTRY_NAMES,
+        COUNTRY_CODES,
+        INDICATOR_NAMES,
+        INDICATOR_CODES
+    };
+}
+
+PopulationModelColumn::PopulationModelColumn(PopulationMatrix::Layout layout) : _matrix(layout) {}
 PopulationModelColumn::~PopulationModelColumn() = default;
 
 const std::vector<std::string>& PopulationModelColumn::countryNames() const noexcept { return _countryNames; }
@@ -22,16 +43,18 @@ std::size_t PopulationModelColumn::yearCount() const noexcept { return _years.si
 
 bool PopulationModelColumn::setYears(std::vector<long long> years) {
     if (! _countryNames.empty()) return false; // only allowed when empty
+    detachSnapshot();
     _years = std::move(years);
-    _columns.clear();
-    _columns.resize(_years.size());
-    for (auto &col : _columns) col.reserve(Config::DEFAULT_COLUMN_RESERVE_SIZE);
+    _matrix.clear();
+    _matrix.reserve(Config::DEFAULT_COLUMN_RESERVE_SIZE, _years.size());
+    _matrix.resize(0, _years.size());
     _yearToIndex.clear();
     for (std::size_t i = 0; i < _years.size(); ++i) _yearToIndex[_years[i]] = static_cast<int>(i);
     return true;
 }
 
 void PopulationModelColumn::insertNewEntry(std::string country, std::string country_code, std::string indicator_name, std::string indicator_code, std::vector<long long> year_population) {
+    detachSnapshot();
     // store metadata (move into containers)
     _countryNames.push_back(std::move(country));
     _countriesCode.push_back(std::move(country_code));
@@ -41,21 +64,57 @@ void PopulationModelColumn::insertNewEntry(std::string country, std::string coun
     _countryNameToIndex[_countryNames.back()] = idx;
     _countryNameToCountryCode[_countryNames.back()] = _countriesCode.back();
 
-    // ensure columns sized
+    // append one value to each year column; extra values are dropped and a shorter
+    // vector is padded with zeros
     std::size_t nYears = _years.size();
-    if (_columns.size() < nYears) _columns.resize(nYears);
-
-    // append values to each column; if the provided vector is shorter, pad with zeros
-    for (std::size_t y = 0; y < nYears; ++y) {
-        long long v = 0;
-        if (y < year_population.size()) v = year_population[y];
-        _columns[y].push_back(v);
-    }
+    _matrix.appendRow(year_population.data(), std::min(year_population.size(), nYears));
+    if (_matrix.cols() < nYears) _matrix.resize(_matrix.rows(), nYears);
+    if (_rangeIndexEnabled) _rangeIndex.appendRow(_matrix.view().row(_matrix.rows() - 1));
 }
 
 long long PopulationModelColumn::getPopulationForCountryYear(std::size_t countryIndex, std::size_t yearIndex) const {
-    if (yearIndex >= _columns.size() || countryIndex >= columnCount()) return 0;
-    return _columns[yearIndex][countryIndex];
+    const PopulationMatrixView values = matrix();
+    if (yearIndex >= values.cols() || countryIndex >= values.rows()) return 0;
+    return values.at(countryIndex, yearIndex);
+}
+
+PopulationMatrixView PopulationModelColumn::matrix() const noexcept { return _snapshot ? _mappedMatrix : _matrix.view(); }
+
+void PopulationModelColumn::buildRangeIndex() {
+    _rangeIndex.build(matrix());
+    _rangeIndexEnabled = true;
+}
+
+void PopulationModelColumn::dropRangeIndex() noexcept {
+    _rangeIndex.clear();
+    _rangeIndexEnabled = false;
+}
+
+bool PopulationModelColumn::hasRangeIndex() const noexcept { return _rangeIndexEnabled; }
+
+const PopulationRangeIndex& PopulationModelColumn::rangeIndex() const noexcept { return _rangeIndex; }
+
+PopulationRange PopulationModelColumn::rangeForCountry(const std::string& country, long long startYear, long long endYear) const {
+    auto itCountry = _countryNameToIndex.find(country);
+    auto itStart = _yearToIndex.find(startYear);
+    auto itEnd = _yearToIndex.find(endYear);
+    if (itCountry == _countryNameToIndex.end() || itStart == _yearToIndex.end() || itEnd == _yearToIndex.end()) return {};
+    const std::size_t r = static_cast<std::size_t>(itCountry->second);
+    const std::size_t first = static_cast<std::size_t>(itStart->second);
+    const std::size_t last = static_cast<std::size_t>(itEnd->second);
+    if (_rangeIndexEnabled) return _rangeIndex.query(r, first, last);
+
+    PopulationRange range;
+    const PopulationSpan values = matrix().row(r);
+    if (first > last || last >= values.size) return range;
+    range.min = range.max = values[first];
+    for (std::size_t i = first; i <= last; ++i) {
+        range.sum += values[i];
+        range.min = std::min(range.min, values[i]);
+        range.max = std::max(range.max, values[i]);
+    }
+    range.count = last - first + 1;
+    return range;
 }
 
 int PopulationModelColumn::countryNameIndex(const std::string& country) const noexcept {
@@ -64,13 +123,41 @@ int PopulationModelColumn::countryNameIndex(const std::string& country) const no
     return it->second;
 }
 
-void PopulationModelColumn::readFromCSV(const std::string& filename) {
-    CSVReader reader(filename);
+void PopulationModelColumn::readFromCSV(const std::string& filename, int numThreads) {
+    if (numThreads > 1) {
+        PopulationCSVData data;
+        if (!PopulationCSV::readParallel(filename, numThreads, data)) return;
+        if (!setYears(std::move(data.years))) return;
+        const std::size_t nRows = data.rowCount();
+        for (std::size_t r = 0; r < nRows; ++r) {
+            _countryNames.push_back(std::move(data.countryNames[r]));
+            _countriesCode.push_back(std::move(data.countryCodes[r]));
+            _indicatorNames.push_back(std::move(data.indicatorNames[r]));
+            _indicatorCodes.push_back(std::move(data.indicatorCodes[r]));
+            _countryNameToIndex[_countryNames.back()] = static_cast<int>(r);
+            _countryNameToCountryCode[_countryNames.back()] = _countriesCode.back();
+        }
+        // Each year column is independent: fill them in parallel, padding short rows with zeros
+        const int nYears = static_cast<int>(_years.size());
+        _matrix.resize(nRows, _years.size());
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int y = 0; y < nYears; ++y) {
+            for (std::size_t r = 0; r < nRows; ++r) {
+                std::size_t at = data.rowOffsets[r] + static_cast<std::size_t>(y);
+                _matrix.at(r, static_cast<std::size_t>(y)) = at < data.rowOffsets[r + 1] ? data.values[at] : 0;
+            }
+        }
+        if (_rangeIndexEnabled) _rangeIndex.build(_matrix.view());
+        return;
+    }
+    CSVReader reader(filename, Config::DEFAULT_CSV_DELIMITER, Config::DEFAULT_CSV_QUOTE,
+                     Config::DEFAULT_CSV_COMMENT, CSVReader::Mode::Mapped);
     try { reader.open(); } catch (const std::exception& e) { std::cerr << "Failed to open CSV: " << e.what() << "\n"; return; }
-    std::vector<std::string> row;
+    // Views into the mapped file: year values are parsed in place, no per-field strings
+    std::vector<std::string_view> row;
     bool headerRead = false;
     std::vector<long long> yearsLocal;
-    while (reader.readRow(row)) {
+    while (reader.readRowViews(row)) {
         if (!headerRead) {
             for (std::size_t i = 4; i < row.size(); ++i) {
                 if (row[i].empty()) continue;
@@ -81,17 +168,97 @@ void PopulationModelColumn::readFromCSV(const std::string& filename) {
             continue;
         }
         if (row.size() < 5) continue;
-        std::string country = row[0];
-        std::string code = row[1];
-        std::string iname = row[2];
-        std::string icode = row[3];
         std::vector<long long> pops;
         pops.reserve(_years.size());
         for (std::size_t i = 4; i < row.size(); ++i) {
             if (row[i].empty()) pops.push_back(0);
             else pops.push_back(Utils::parseLongOrZero(row[i]));
         }
-        insertNewEntry(country, code, iname, icode, pops);
+        insertNewEntry(std::string(row[0]), std::string(row[1]), std::string(row[2]), std::string(row[3]), std::move(pops));
     }
     reader.close();
 }
+
+void PopulationModelColumn::saveSnapshot(const std::string& path) const {
+    const PopulationMatrixView values = matrix();
+    const std::uint64_t layout = _matrix.layout() == PopulationMatrix::Layout::RowMajor ? 0 : 1;
+    const std::uint64_t shape[] = {layout, values.rows(), values.cols(), values.rowStride(), values.colStride()};
+    const std::size_t extent = values.rows() == 0 || values.cols() == 0 ? 0 :
+        (values.rows() - 1) * values.rowStride() + (values.cols() - 1) * values.colStride() + 1;
+    std::vector<std::size_t> rowLengths(values.rows());
+    for (std::size_t r = 0; r < rowLengths.size(); ++r) rowLengths[r] = values.rowLength(r);
+
+    Snapshot::Writer writer(Snapshot::Kind::PopulationColumns);
+    writer.column(SHAPE, ColumnView<std::uint64_t>(shape, 5));
+    writer.column(YEARS, ColumnView<long long>(_years));
+    writer.column(VALUES, ColumnView<long long>(values.data(), extent));
+    writer.column(ROW_LENGTHS, ColumnView<std::size_t>(rowLengths));
+    writer.strings(COUNTRY_NAMES, _countryNames);
+    writer.strings(COUNTRY_CODES, _countriesCode);
+    writer.strings(INDICATOR_NAMES, _indicatorNames);
+    writer.strings(INDICATOR_CODES, _indicatorCodes);
+    writer.write(path);
+}
+
+void PopulationModelColumn::loadSnapshot(const std::string& path, bool verifyChecksums) {
+    const Snapshot::Reader reader(path, Snapshot::Kind::PopulationColumns, verifyChecksums);
+    auto malformed = [&path] { return std::runtime_error("Population snapshot is malformed: " + path); };
+
+    const ColumnView<std::uint64_t> shape = reader.column<std::uint64_t>(SHAPE);
+    if (shape.size() != 5 || shape[0] > 1) throw malformed();
+    const auto layout = shape[0] == 0 ? PopulationMatrix::Layout::RowMajor : PopulationMatrix::Layout::ColumnMajor;
+    const std::size_t rows = shape[1], cols = shape[2], rowStride = shape[3], colStride = shape[4];
+    const ColumnView<long long> values = reader.column<long long>(VALUES);
+    const ColumnView<std::size_t> rowLengths = reader.column<std::size_t>(ROW_LENGTHS);
+    std::vector<long long> years = reader.column<long long>(YEARS).toVector();
+    std::vector<std::string> countryNames = reader.strings(COUNTRY_NAMES);
+    std::vector<std::string> countryCodes = reader.strings(COUNTRY_CODES);
+    std::vector<std::string> indicatorNames = reader.strings(INDICATOR_NAMES);
+    std::vector<std::string> indicatorCodes = reader.strings(INDICATOR_CODES);
+
+    // Every (r, c) must land inside VALUES and every row length inside the matrix
+    if (cols != years.size() || rowLengths.size() != rows || countryNames.size() != rows ||
+        countryCodes.size() != rows || indicatorNames.size() != rows || indicatorCodes.size() != rows) {
+        throw malformed();
+    }
+    if (rows > 0 && cols > 0) {
+        const std::size_t leadingStride = layout == PopulationMatrix::Layout::RowMajor ? colStride : rowStride;
+        if (values.empty() || rowStride == 0 || colStride == 0 || leadingStride != 1) throw malformed();
+        const std::size_t last = values.size() - 1;
+        if (rows - 1 > last / rowStride) throw malformed();
+        if (cols - 1 > (last - (rows - 1) * rowStride) / colStride) throw malformed();
+    }
+    for (std::size_t length : rowLengths) {
+        if (length > cols) throw malformed();
+    }
+
+    _countryNames = std::move(countryNames);
+    _countriesCode = std::move(countryCodes);
+    _indicatorNames = std::move(indicatorNames);
+    _indicatorCodes = std::move(indicatorCodes);
+    _years = std::move(years);
+    _countryNameToIndex.clear();
+    _countryNameToCountryCode.clear();
+    _yearToIndex.clear();
+    _countryNameToIndex.reserve(rows);
+    _countryNameToCountryCode.reserve(rows);
+    for (std::size_t r = 0; r < rows; ++r) {
+        _countryNameToIndex[_countryNames[r]] = static_cast<int>(r);
+        _countryNameToCountryCode[_countryNames[r]] = _countriesCode[r];
+    }
+    for (std::size_t i = 0; i < _years.size(); ++i) _yearToIndex[_years[i]] = static_cast<int>(i);
+
+    _matrix = PopulationMatrix(layout);
+    _mappedMatrix = PopulationMatrixView(values.data(), rows, cols, rowStride, colStride, rowLengths.data());
+    _snapshot = reader.file();
+    dropRangeIndex();
+}
+
+bool PopulationModelColumn::isSnapshotBacked() const noexcept { return _snapshot != nullptr; }
+
+void PopulationModelColumn::detachSnapshot() {
+    if (!_snapshot) return;
+    _matrix.assign(_mappedMatrix);
+    _mappedMatrix = PopulationMatrixView();
+    _snapshot.reset();
+}
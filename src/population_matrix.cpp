@@ -0,0 +1,106 @@
+#include "../interface/population_matrix.hpp"
+#include <algorithm>
+
+namespace {
+    std::size_t roundUpToLane(std::size_t n) {
+        return (n + PopulationMatrix::LANE - 1) / PopulationMatrix::LANE * PopulationMatrix::LANE;
+    }
+}
+
+std::vector<long long> PopulationSpan::toVector() const {
+    std::vector<long long> out(size);
+    for (std::size_t i = 0; i < size; ++i) out[i] = (*this)[i];
+    return out;
+}
+
+bool operator==(const PopulationSpan& a, const PopulationSpan& b) noexcept {
+    if (a.size != b.size) return false;
+    for (std::size_t i = 0; i < a.size; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+void PopulationMatrix::reserve(std::size_t rows, std::size_t cols) {
+    if (rows > _rowCapacity || cols > _colCapacity) {
+        grow(std::max(rows, _rowCapacity), std::max(cols, _colCapacity));
+    }
+    _rowLengths.reserve(rows);
+}
+
+void PopulationMatrix::resize(std::size_t rows, std::size_t cols) {
+    reserve(rows, cols);
+    // Cells outside the old extent may hold stale values from a shrink; zero them
+    for (std::size_t r = 0; r < rows; ++r) {
+        std::size_t firstNew = r < _rows ? std::min(_cols, cols) : 0;
+        for (std::size_t c = firstNew; c < cols; ++c) at(r, c) = 0;
+    }
+    _rowLengths.resize(rows, cols);
+    for (auto& length : _rowLengths) length = std::min(length, cols);
+    _rows = rows;
+    _cols = cols;
+}
+
+void PopulationMatrix::appendRow(const long long* values, std::size_t count) {
+    const std::size_t cols = std::max(_cols, count);
+    if (_rows + 1 > _rowCapacity || cols > _colCapacity) {
+        // Geometric growth in whichever dimension overflowed
+        std::size_t rowCapacity = _rows + 1 > _rowCapacity ? std::max<std::size_t>(_rowCapacity * 2, LANE) : _rowCapacity;
+        std::size_t colCapacity = cols > _colCapacity ? std::max(_colCapacity * 2, cols) : _colCapacity;
+        grow(rowCapacity, colCapacity);
+    }
+    if (cols > _cols) {
+        // Widening: the new columns of existing rows must read as 0
+        for (std::size_t r = 0; r < _rows; ++r) {
+            for (std::size_t c = _cols; c < cols; ++c) at(r, c) = 0;
+        }
+        _cols = cols;
+    }
+    const std::size_t r = _rows++;
+    for (std::size_t c = 0; c < count; ++c) at(r, c) = values[c];
+    for (std::size_t c = count; c < _cols; ++c) at(r, c) = 0;
+    _rowLengths.push_back(count);
+}
+
+void PopulationMatrix::assign(const PopulationMatrixView& view) {
+    clear();
+    resize(view.rows(), view.cols());
+    for (std::size_t r = 0; r < _rows; ++r) {
+        for (std::size_t c = 0; c < _cols; ++c) at(r, c) = view.at(r, c);
+        _rowLengths[r] = view.rowLength(r);
+    }
+}
+
+PopulationMatrixView PopulationMatrix::view() const noexcept {
+    const std::size_t rowStride = _layout == Layout::RowMajor ? _colCapacity : 1;
+    const std::size_t colStride = _layout == Layout::RowMajor ? 1 : _rowCapacity;
+    return PopulationMatrixView(_data.data(), _rows, _cols, rowStride, colStride, _rowLengths.data());
+}
+
+void PopulationMatrix::clear() noexcept {
+    _rows = _cols = 0;
+    _rowCapacity = _colCapacity = 0;
+    _rowLengths.clear();
+    _data.clear();
+}
+
+std::size_t PopulationMatrix::memoryBytes() const noexcept {
+    return _data.capacity() * sizeof(long long) + _rowLengths.capacity() * sizeof(std::size_t);
+}
+
+void PopulationMatrix::grow(std::size_t rowCapacity, std::size_t colCapacity) {
+    // Pad the leading (contiguous) dimension so every row/column starts on a cache line
+    if (_layout == Layout::RowMajor) colCapacity = roundUpToLane(colCapacity);
+    else rowCapacity = roundUpToLane(rowCapacity);
+
+    std::vector<long long, AlignedAllocator<long long, ALIGNMENT>> data(rowCapacity * colCapacity, 0);
+    for (std::size_t r = 0; r < _rows; ++r) {
+        for (std::size_t c = 0; c < _cols; ++c) {
+            std::size_t to = _layout == Layout::RowMajor ? r * colCapacity + c : c * rowCapacity + r;
+            data[to] = _data[offset(r, c)];
+        }
+    }
+    _data.swap(data);
+    _rowCapacity = rowCapacity;
+    _colCapacity = colCapacity;
+}
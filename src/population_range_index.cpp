@@ -0,0 +1,92 @@
+#include "../interface/population_range_index.hpp"
+#include <algorithm>
+
+void PopulationRangeIndex::build(const PopulationMatrixView& matrix) {
+    clear();
+    // Size every buffer exactly once instead of growing it row by row
+    std::size_t prefixSize = 0, tableSize = 0;
+    for (std::size_t r = 0; r < matrix.rows(); ++r) {
+        const std::size_t length = matrix.rowLength(r);
+        prefixSize += length + 1;
+        tableSize += length > 0 ? levelOffset(length, floorLog2(length) + 1) : 0;
+    }
+    _lengths.reserve(matrix.rows());
+    _prefixOffsets.reserve(matrix.rows() + 1);
+    _tableOffsets.reserve(matrix.rows() + 1);
+    _prefix.reserve(prefixSize);
+    _min.reserve(tableSize);
+    _max.reserve(tableSize);
+    for (std::size_t r = 0; r < matrix.rows(); ++r) appendRow(matrix.row(r));
+}
+
+void PopulationRangeIndex::appendRow(const PopulationSpan& values) {
+    if (_prefixOffsets.empty()) {
+        _prefixOffsets.push_back(0);
+        _tableOffsets.push_back(0);
+    }
+    const std::size_t length = values.size;
+    _lengths.push_back(length);
+
+    long long running = 0;
+    _prefix.push_back(0);
+    for (std::size_t i = 0; i < length; ++i) {
+        running += values[i];
+        _prefix.push_back(running);
+    }
+    _prefixOffsets.push_back(_prefix.size());
+
+    const std::size_t base = _min.size();
+    const unsigned levels = length > 0 ? floorLog2(length) + 1 : 0;
+    const std::size_t tableSize = levelOffset(length, levels);
+    _min.resize(base + tableSize);
+    _max.resize(base + tableSize);
+    for (std::size_t i = 0; i < length; ++i) _min[base + i] = _max[base + i] = values[i];
+    for (unsigned k = 1; k < levels; ++k) {
+        // Level k window i covers two level k-1 windows: i and i + 2^(k-1)
+        const std::size_t prev = base + levelOffset(length, k - 1);
+        const std::size_t cur = base + levelOffset(length, k);
+        const std::size_t half = std::size_t{1} << (k - 1);
+        const std::size_t windows = length - (std::size_t{1} << k) + 1;
+        for (std::size_t i = 0; i < windows; ++i) {
+            _min[cur + i] = std::min(_min[prev + i], _min[prev + i + half]);
+            _max[cur + i] = std::max(_max[prev + i], _max[prev + i + half]);
+        }
+    }
+    _tableOffsets.push_back(_min.size());
+}
+
+void PopulationRangeIndex::clear() noexcept {
+    _lengths.clear();
+    _prefixOffsets.clear();
+    _tableOffsets.clear();
+    _prefix.clear();
+    _min.clear();
+    _max.clear();
+}
+
+long long PopulationRangeIndex::min(std::size_t r, std::size_t first, std::size_t last) const noexcept {
+    const unsigned k = floorLog2(last - first + 1);
+    const long long* level = _min.data() + _tableOffsets[r] + levelOffset(_lengths[r], k);
+    return std::min(level[first], level[last + 1 - (std::size_t{1} << k)]);
+}
+
+long long PopulationRangeIndex::max(std::size_t r, std::size_t first, std::size_t last) const noexcept {
+    const unsigned k = floorLog2(last - first + 1);
+    const long long* level = _max.data() + _tableOffsets[r] + levelOffset(_lengths[r], k);
+    return std::max(level[first], level[last + 1 - (std::size_t{1} << k)]);
+}
+
+PopulationRange PopulationRangeIndex::query(std::size_t r, std::size_t first, std::size_t last) const noexcept {
+    PopulationRange range;
+    if (r >= _lengths.size() || first > last || last >= _lengths[r]) return range;
+    range.sum = sum(r, first, last);
+    range.min = min(r, first, last);
+    range.max = max(r, first, last);
+    range.count = last - first + 1;
+    return range;
+}
+
+std::size_t PopulationRangeIndex::memoryBytes() const noexcept {
+    return (_prefix.capacity() + _min.capacity() + _max.capacity()) * sizeof(long long) +
+           (_lengths.capacity() + _prefixOffsets.capacity() + _tableOffsets.capacity()) * sizeof(std::size_t);
+}
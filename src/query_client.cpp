@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../interface/json_line.hpp"
+
+/**
+ * @file query_client.cpp
+ * @brief Load generator for the application's --serve mode
+ *
+ * Opens several connections to the server's Unix socket and keeps a window of
+ * requests in flight on each, drawn from a mix of population queries (and fire
+ * queries when the server has fire data). Reports throughput, client-side
+ * round-trip percentiles and the server-side execution latency.
+ *
+ * Usage: ./OpenMP_Mini1_Project_query_client [--socket PATH] [--connections N]
+ *            [--requests N] [--window N] [--shutdown]
+ *
+ * Start the server first, e.g.
+ *   ./OpenMP_Mini1_Project_app --serve --socket /tmp/population.sock --workers 4
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    struct Options {
+        std::string socketPath = "/tmp/population.sock";
+        int connections = 4;
+        int requests = 10000;     ///< Per connection
+        int window = 16;          ///< Requests in flight per connection
+        bool shutdown = false;    ///< Send a shutdown request when done
+    };
+
+    struct Dataset {
+        long long firstYear = 0;
+        long long lastYear = 0;
+        std::string sampleCountry;
+        bool fire = false;
+    };
+
+    int connectTo(const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) return -1;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+            if (n <= 0) return false;
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    /// Buffered line reader over a socket
+    class LineReader {
+    public:
+        explicit LineReader(int fd) : _fd(fd) {}
+
+        bool next(std::string& line) {
+            for (;;) {
+                const std::size_t end = _buffer.find('\n', _start);
+                if (end != std::string::npos) {
+                    line.assign(_buffer, _start, end - _start);
+                    _start = end + 1;
+                    return true;
+                }
+                _buffer.erase(0, _start);
+                _start = 0;
+                char chunk[65536];
+                const ssize_t n = ::recv(_fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return false;
+                _buffer.append(chunk, static_cast<std::size_t>(n));
+            }
+        }
+
+    private:
+        int _fd;
+        std::string _buffer;
+        std::size_t _start = 0;
+    };
+
+    /// One request/response exchange on a fresh connection
+    std::optional<JsonLine::Object> call(const std::string& path, const std::string& request) {
+        const int fd = connectTo(path);
+        if (fd < 0) return std::nullopt;
+        std::string line;
+        LineReader reader(fd);
+        const bool ok = sendAll(fd, request + "\n") && reader.next(line);
+        ::close(fd);
+        if (!ok) return std::nullopt;
+        return JsonLine::parse(line);
+    }
+
+    std::string makeRequest(long long id, const Dataset& data, std::mt19937_64& rng) {
+        std::uniform_int_distribution<long long> year(data.firstYear, data.lastYear);
+        std::uniform_int_distribution<int> pick(0, data.fire ? 11 : 9);
+        JsonLine::Writer request;
+        request.field("id", id).field("model", rng() % 2 ? "row" : "column");
+        switch (pick(rng)) {
+            case 0: request.field("op", "sum").field("year", year(rng)); break;
+            case 1: request.field("op", "average").field("year", year(rng)); break;
+            case 2: request.field("op", "max").field("year", year(rng)); break;
+            case 3: request.field("op", "min").field("year", year(rng)); break;
+            case 4: request.field("op", "summary").field("year", year(rng)); break;
+            case 5: request.field("op", "top_n").field("year", year(rng)).field("n", 10); break;
+            case 6:
+            case 7: request.field("op", "country_year").field("country", data.sampleCountry).field("year", year(rng)); break;
+            case 8: request.field("op", "country_range").field("country", data.sampleCountry)
+                        .field("start", data.firstYear).field("end", data.lastYear); break;
+            case 9: request.field("op", "country_years").field("country", data.sampleCountry)
+                        .field("start", data.firstYear).field("end", data.lastYear); break;
+            case 10: request.field("op", "fire_average_aqi"); break;
+            default: request.field("op", "fire_top_sites").field("n", 10); break;
+        }
+        return request.str();
+    }
+
+    struct ConnectionResult {
+        std::vector<double> roundTripMicros;
+        double serverMicros = 0.0;
+        std::size_t errors = 0;
+        bool failed = false;
+    };
+
+    void runConnection(const Options& options, const Dataset& data, int index, ConnectionResult& result) {
+        const int fd = connectTo(options.socketPath);
+        if (fd < 0) { result.failed = true; return; }
+        std::mt19937_64 rng(static_cast<std::uint64_t>(index) * 7919 + 17);
+        const long long total = options.requests;
+        const long long base = static_cast<long long>(index) * total;
+        std::vector<Clock::time_point> sentAt(static_cast<std::size_t>(total));
+        result.roundTripMicros.reserve(static_cast<std::size_t>(total));
+
+        LineReader reader(fd);
+        long long sent = 0, received = 0;
+        std::string line;
+        while (received < total) {
+            // Top the window up, batching the writes into one send
+            std::string batch;
+            while (sent < total && sent - received < options.window) {
+                batch += makeRequest(base + sent, data, rng);
+                batch += '\n';
+                sentAt[static_cast<std::size_t>(sent)] = Clock::now();
+                ++sent;
+            }
+            if (!batch.empty() && !sendAll(fd, batch)) { result.failed = true; break; }
+            if (!reader.next(line)) { result.failed = true; break; }
+            const auto now = Clock::now();
+            auto response = JsonLine::parse(line);
+            const long long id = response ? response->getInt("id").value_or(-1) : -1;
+            if (id < base || id >= base + total) { ++result.errors; ++received; continue; }
+            result.roundTripMicros.push_back(
+                std::chrono::duration<double, std::micro>(now - sentAt[static_cast<std::size_t>(id - base)]).count());
+            if (response->getString("error")) ++result.errors;
+            result.serverMicros += response->getDouble("latency_us").value_or(0.0);
+            ++received;
+        }
+        ::close(fd);
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue) options.socketPath = argv[++i];
+        else if (arg == "--connections" && hasValue) options.connections = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--requests" && hasValue) options.requests = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--window" && hasValue) options.window = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--shutdown") options.shutdown = true;
+        else {
+            std::cout << "Usage: " << argv[0] << " [--socket PATH] [--connections N] [--requests N] [--window N] [--shutdown]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    auto info = call(options.socketPath, R"({"id":0,"op":"info"})");
+    auto infoResult = info ? info->getRaw("result") : std::nullopt;
+    auto dataset = infoResult ? JsonLine::parse(*infoResult) : std::nullopt;
+    if (!dataset) {
+        std::cerr << "Cannot query " << options.socketPath << " (is the server running with --serve --socket?)\n";
+        return 1;
+    }
+    Dataset data;
+    data.firstYear = dataset->getInt("first_year").value_or(2000);
+    data.lastYear = std::max(data.firstYear, dataset->getInt("last_year").value_or(2000));
+    data.sampleCountry = dataset->getString("sample_country").value_or("");
+    data.fire = dataset->getInt("fire_measurements").value_or(0) > 0;
+    std::cout << "Server: " << *infoResult << "\n";
+    std::cout << options.connections << " connections x " << options.requests << " requests, window "
+              << options.window << "\n\n";
+
+    std::vector<ConnectionResult> results(static_cast<std::size_t>(options.connections));
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for (int c = 0; c < options.connections; ++c) {
+        threads.emplace_back(runConnection, std::cref(options), std::cref(data), c, std::ref(results[static_cast<std::size_t>(c)]));
+    }
+    for (auto& thread : threads) thread.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> roundTrips;
+    double serverMicros = 0.0;
+    std::size_t errors = 0, failedConnections = 0;
+    for (const auto& result : results) {
+        roundTrips.insert(roundTrips.end(), result.roundTripMicros.begin(), result.roundTripMicros.end());
+        serverMicros += result.serverMicros;
+        errors += result.errors;
+        failedConnections += result.failed ? 1 : 0;
+    }
+    if (roundTrips.empty()) {
+        std::cerr << "No responses received\n";
+        return 1;
+    }
+    std::sort(roundTrips.begin(), roundTrips.end());
+    auto percentile = [&](double p) { return roundTrips[static_cast<std::size_t>(p * static_cast<double>(roundTrips.size() - 1))]; };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Responses:        " << roundTrips.size() << " (" << errors << " errors, "
+              << failedConnections << " failed connections)\n";
+    std::cout << "Throughput:       " << static_cast<double>(roundTrips.size()) / seconds << " queries/s\n";
+    std::cout << "Round trip (us):  p50=" << percentile(0.50) << " p90=" << percentile(0.90)
+              << " p99=" << percentile(0.99) << " max=" << roundTrips.back() << "\n";
+    std::cout << "Server exec (us): mean=" << serverMicros / static_cast<double>(roundTrips.size()) << "\n";
+
+    if (options.shutdown) call(options.socketPath, R"({"id":0,"op":"shutdown"})");
+    return failedConnections > 0 ? 1 : 0;
+}
@@ -0,0 +1,544 @@
+#include "../interface/query_server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace QueryServer {
+    namespace {
+        std::int64_t nowNanos() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /// True for a well-formed shutdown request; the stream reader stops after submitting it
+        bool isShutdownRequest(const std::string& line) {
+            if (line.find("shutdown") == std::string::npos) return false;
+            const std::optional<JsonLine::Object> request = JsonLine::parse(line);
+            return request && request->getString("op") == std::string("shutdown");
+        }
+
+        /// Every operation the server understands; "invalid" collects unparseable requests
+        const char* const OPERATIONS[] = {
+            "info", "ping", "stats", "shutdown",
+            "sum", "average", "max", "min", "summary", "top_n",
+            "country_year", "country_years", "country_range",
+            "fire_max_aqi", "fire_min_aqi", "fire_average_aqi", "fire_top_sites", "fire_by_parameter",
+            "invalid"};
+
+        long long requireInt(const JsonLine::Object& request, const char* key) {
+            auto value = request.getInt(key);
+            if (!value) throw std::invalid_argument(std::string("missing or non-integer \"") + key + "\"");
+            return *value;
+        }
+
+        std::string requireString(const JsonLine::Object& request, const char* key) {
+            auto value = request.getString(key);
+            if (!value) throw std::invalid_argument(std::string("missing or non-string \"") + key + "\"");
+            return *value;
+        }
+
+        int requireYear(const JsonLine::Object& request, const char* key) {
+            const long long year = requireInt(request, key);
+            if (year < std::numeric_limits<int>::min() || year > std::numeric_limits<int>::max()) {
+                throw std::invalid_argument(std::string("\"") + key + "\" out of range");
+            }
+            return static_cast<int>(year);
+        }
+
+        std::size_t requireCount(const JsonLine::Object& request, const char* key) {
+            const long long n = requireInt(request, key);
+            if (n < 0) throw std::invalid_argument(std::string("\"") + key + "\" must not be negative");
+            return static_cast<std::size_t>(n);
+        }
+
+        bool wantsRow(const JsonLine::Object& request) {
+            const std::string model = request.getString("model").value_or("column");
+            if (model == "row") return true;
+            if (model == "column") return false;
+            throw std::invalid_argument("\"model\" must be \"row\" or \"column\"");
+        }
+
+        int threadsOf(const JsonLine::Object& request) {
+            const long long threads = request.getInt("threads").value_or(ExecutionContext::USE_CONTEXT);
+            if (threads < 0 || threads > 1024) throw std::invalid_argument("\"threads\" out of range");
+            return static_cast<int>(threads);
+        }
+
+        template <typename Value>
+        std::string pairArray(const std::vector<std::pair<std::string, Value>>& pairs,
+                              const char* nameKey, const char* valueKey) {
+            std::string out = "[";
+            for (std::size_t i = 0; i < pairs.size(); ++i) {
+                if (i > 0) out += ',';
+                out += JsonLine::Writer().field(nameKey, pairs[i].first).field(valueKey, pairs[i].second).str();
+            }
+            return out + "]";
+        }
+
+        /**
+         * A connected client; kept alive by its reader and by every job still answering it.
+         * The fd has a send timeout, so a client that stops reading its answers cannot hold
+         * a worker: the send fails, the connection is dropped and later answers are discarded.
+         */
+        struct Connection {
+            explicit Connection(int fd) : fd(fd) {}
+            ~Connection() { ::close(fd); }
+
+            void send(const std::string& line) {
+                std::lock_guard<std::mutex> lock(writeMutex);
+                std::size_t sent = 0;
+                while (sent < line.size() && !dropped.load()) {
+#if defined(MSG_NOSIGNAL)
+                    const ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+#else
+                    const ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, 0);
+#endif
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) {
+                        drop();   // peer went away, or stopped reading until the send timed out
+                        return;
+                    }
+                    sent += static_cast<std::size_t>(n);
+                }
+            }
+
+            /// Shut both directions: the reader sees EOF and stops submitting
+            void drop() noexcept {
+                if (dropped.exchange(true)) return;
+                ::shutdown(fd, SHUT_RDWR);
+                { std::lock_guard<std::mutex> lock(slotMutex); }
+                slotFreed.notify_all();
+            }
+
+            /// Wait for one of `limit` in-flight slots; false if the connection was dropped
+            bool acquire(std::size_t limit) {
+                std::unique_lock<std::mutex> lock(slotMutex);
+                slotFreed.wait(lock, [&] { return inFlight < limit || dropped.load(); });
+                if (dropped.load()) return false;
+                ++inFlight;
+                return true;
+            }
+
+            void release() {
+                {
+                    std::lock_guard<std::mutex> lock(slotMutex);
+                    --inFlight;
+                }
+                slotFreed.notify_one();
+            }
+
+            int fd;
+            std::atomic<bool> dropped{false};
+            std::mutex writeMutex;
+            std::mutex slotMutex;
+            std::condition_variable slotFreed;
+            std::size_t inFlight{0};   ///< Requests queued or running for this connection
+        };
+
+        /// Longest request line accepted before a connection is dropped
+        constexpr std::size_t MAX_LINE_BYTES = 1 << 20;
+    }
+
+    // === LatencyHistogram ===
+
+    int LatencyHistogram::bucketOf(std::uint64_t nanos) noexcept {
+        if (nanos < SUB_BUCKETS) return static_cast<int>(nanos);
+        // Values in [2^e, 2^(e+1)) share a power and are split by their next three bits
+        const int e = 63 - __builtin_clzll(nanos);
+        const int sub = static_cast<int>(nanos >> (e - 3)) - SUB_BUCKETS;
+        return std::min((e - 2) * SUB_BUCKETS + sub, BUCKETS - 1);
+    }
+
+    std::uint64_t LatencyHistogram::upperBound(int bucket) noexcept {
+        if (bucket < SUB_BUCKETS) return static_cast<std::uint64_t>(bucket) + 1;
+        const int e = bucket / SUB_BUCKETS + 2;
+        const std::uint64_t sub = static_cast<std::uint64_t>(bucket % SUB_BUCKETS);
+        return (SUB_BUCKETS + sub + 1) << (e - 3);
+    }
+
+    void LatencyHistogram::record(double micros) noexcept {
+        const std::uint64_t nanos = micros > 0.0 ? static_cast<std::uint64_t>(micros * 1000.0) : 0;
+        _buckets[static_cast<std::size_t>(bucketOf(nanos))].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+        std::uint64_t seen = _maxNanos.load(std::memory_order_relaxed);
+        while (nanos > seen && !_maxNanos.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {}
+    }
+
+    double LatencyHistogram::percentile(double quantile) const noexcept {
+        std::uint64_t total = 0;
+        for (const auto& bucket : _buckets) total += bucket.load(std::memory_order_relaxed);
+        if (total == 0) return 0.0;
+        const double clamped = std::min(1.0, std::max(0.0, quantile));
+        const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(total))));
+        std::uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += _buckets[static_cast<std::size_t>(b)].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(static_cast<double>(upperBound(b)), static_cast<double>(_maxNanos.load())) / 1000.0;
+        }
+        return max();
+    }
+
+    double LatencyHistogram::max() const noexcept {
+        return static_cast<double>(_maxNanos.load(std::memory_order_relaxed)) / 1000.0;
+    }
+
+    double LatencyHistogram::mean() const noexcept {
+        const std::uint64_t n = count();
+        return n > 0 ? static_cast<double>(_totalNanos.load(std::memory_order_relaxed)) / 1000.0 / static_cast<double>(n) : 0.0;
+    }
+
+    // === WorkerPool ===
+
+    WorkerPool::WorkerPool(int workers, std::size_t capacity) : _capacity(std::max<std::size_t>(capacity, 1)) {
+        const int count = std::max(1, workers);
+        _threads.reserve(static_cast<std::size_t>(count));
+        for (int i = 0; i < count; ++i) _threads.emplace_back([this] { run(); });
+    }
+
+    WorkerPool::~WorkerPool() { stop(); }
+
+    bool WorkerPool::submit(std::function<void()> job) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this] { return _stopping || _jobs.size() < _capacity; });
+        if (_stopping) return false;
+        _jobs.push_back(std::move(job));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    void WorkerPool::drain() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this] { return _jobs.empty() && _active == 0; });
+    }
+
+    void WorkerPool::stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stopping && _threads.empty()) return;
+            _stopping = true;
+        }
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+        for (auto& thread : _threads) thread.join();
+        _threads.clear();
+    }
+
+    void WorkerPool::run() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _notEmpty.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+                if (_jobs.empty()) return;   // stopping and nothing left
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+                ++_active;
+            }
+            _notFull.notify_one();
+            job();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_active;
+                if (_jobs.empty() && _active == 0) _idle.notify_all();
+            }
+        }
+    }
+
+    // === Server ===
+
+    Server::Server(const Models& models, const Options& options)
+        : _models(models), _options(options), _pool(options.workers, options.queueCapacity) {
+        if (_models.populationRow) _rowService = std::make_unique<PopulationModelService>(_models.populationRow, _options.context);
+        if (_models.populationColumn) _columnService = std::make_unique<PopulationModelColumnService>(_models.populationColumn, _options.context);
+        if (_models.fireRow) _fireRowService = std::make_unique<FireRowService>(_models.fireRow, _options.context);
+        if (_models.fireColumn) _fireColumnService = std::make_unique<FireColumnService>(_models.fireColumn, _options.context);
+        for (const char* op : OPERATIONS) _stats.emplace(op, std::make_unique<OpStats>());
+    }
+
+    Server::~Server() { _pool.stop(); }
+
+    Server::OpStats& Server::statsFor(const std::string& op) {
+        auto it = _stats.find(op);
+        return it != _stats.end() ? *it->second : *_stats.at("invalid");
+    }
+
+    const IPopulationService& Server::population(const JsonLine::Object& request) const {
+        const IPopulationService* service = nullptr;
+        if (wantsRow(request)) service = _rowService.get();
+        else service = _columnService.get();
+        if (!service) throw std::invalid_argument("population data not loaded");
+        return *service;
+    }
+
+    std::string Server::handle(const std::string& line) {
+        return answer(line, nowNanos());
+    }
+
+    std::string Server::answer(const std::string& line, std::int64_t receivedAt) {
+        const std::int64_t started = nowNanos();
+        const double queueMicros = static_cast<double>(started - receivedAt) / 1000.0;
+
+        std::string parseError;
+        const std::optional<JsonLine::Object> request = JsonLine::parse(line, &parseError);
+        std::string id = "null";
+        std::string op = "invalid";
+        std::string result;
+        std::string error;
+        if (!request) {
+            error = "malformed request: " + parseError;
+        } else {
+            id = request->getRaw("id").value_or("null");
+            auto name = request->getString("op");
+            if (!name) {
+                error = "missing \"op\"";
+            } else if (_stats.count(*name) == 0 || *name == "invalid") {
+                error = "unknown op \"" + *name + "\"";
+            } else {
+                op = *name;
+                try {
+                    result = execute(*request, op);
+                } catch (const std::exception& e) {
+                    error = e.what();
+                }
+            }
+        }
+
+        const double latencyMicros = static_cast<double>(nowNanos() - started) / 1000.0;
+        OpStats& stats = statsFor(op);
+        stats.latency.record(latencyMicros);
+        if (!error.empty()) stats.errors.fetch_add(1, std::memory_order_relaxed);
+
+        JsonLine::Writer response;
+        response.raw("id", id).field("ok", error.empty());
+        if (error.empty()) response.raw("result", result);
+        else response.field("error", error);
+        // Latencies are reported to 0.1 us; finer digits are clock noise
+        response.field("latency_us", std::round(latencyMicros * 10.0) / 10.0)
+                .field("queue_us", std::round(queueMicros * 10.0) / 10.0);
+        return response.str();
+    }
+
+    std::string Server::execute(const JsonLine::Object& request, const std::string& op) {
+        if (op == "ping") return "true";
+        if (op == "stats") return statsJson();
+        if (op == "shutdown") {
+            requestShutdown();
+            return "true";
+        }
+        if (op == "info") {
+            JsonLine::Writer info;
+            const PopulationModelColumn* columns = _models.populationColumn;
+            const PopulationModel* rows = _models.populationRow;
+            const std::vector<std::string>* names = columns ? &columns->countryNames() : rows ? &rows->countryNames() : nullptr;
+            const std::vector<long long>* years = columns ? &columns->years() : rows ? &rows->years() : nullptr;
+            info.field("countries", names ? names->size() : std::size_t{0});
+            if (years && !years->empty()) {
+                info.field("first_year", years->front()).field("last_year", *std::max_element(years->begin(), years->end()));
+            }
+            if (names && !names->empty()) info.field("sample_country", names->front());
+            info.field("fire_measurements", _models.fireColumn ? _models.fireColumn->measurementCount()
+                                            : _models.fireRow ? _models.fireRow->totalMeasurements() : std::size_t{0});
+            info.field("workers", _pool.size()).field("context", _options.context.describe());
+            return info.str();
+        }
+
+        const int threads = threadsOf(request);
+        if (op.rfind("fire_", 0) == 0) {
+            const bool row = wantsRow(request);
+            if (row ? !_fireRowService : !_fireColumnService) throw std::invalid_argument("fire data not loaded");
+            if (op == "fire_max_aqi") return std::to_string(row ? _fireRowService->maxAQI(threads) : _fireColumnService->maxAQI(threads));
+            if (op == "fire_min_aqi") return std::to_string(row ? _fireRowService->minAQI(threads) : _fireColumnService->minAQI(threads));
+            if (op == "fire_average_aqi") return JsonLine::number(row ? _fireRowService->averageAQI(threads) : _fireColumnService->averageAQI(threads));
+            if (op == "fire_top_sites") {
+                const std::size_t n = requireCount(request, "n");
+                return pairArray(row ? _fireRowService->topNSitesByAverageConcentration(n, threads)
+                                     : _fireColumnService->topNSitesByAverageConcentration(n, threads), "site", "concentration");
+            }
+            return pairArray(row ? _fireRowService->averageConcentrationByParameter(threads)
+                                 : _fireColumnService->averageConcentrationByParameter(threads), "parameter", "concentration");
+        }
+
+        const IPopulationService& service = population(request);
+        if (op == "sum") return std::to_string(service.sumPopulationForYear(requireYear(request, "year"), threads));
+        if (op == "average") return JsonLine::number(service.averagePopulationForYear(requireYear(request, "year"), threads));
+        if (op == "max") return std::to_string(service.maxPopulationForYear(requireYear(request, "year"), threads));
+        if (op == "min") return std::to_string(service.minPopulationForYear(requireYear(request, "year"), threads));
+        if (op == "summary") {
+            const YearSummary summary = service.yearSummary(requireYear(request, "year"), threads);
+            return JsonLine::Writer().field("sum", summary.sum).field("count", summary.count).field("mean", summary.mean)
+                .field("min", summary.min).field("max", summary.max)
+                .field("min_country", summary.minCountry).field("max_country", summary.maxCountry).str();
+        }
+        if (op == "top_n") {
+            return pairArray(service.topNCountriesByPopulationInYear(requireYear(request, "year"), requireCount(request, "n"), threads),
+                             "country", "population");
+        }
+        const std::string country = requireString(request, "country");
+        if (op == "country_year") return std::to_string(service.populationForCountryInYear(country, requireYear(request, "year"), threads));
+        if (op == "country_years") {
+            const std::vector<long long> values = service.populationOverYearsForCountry(
+                country, requireYear(request, "start"), requireYear(request, "end"), threads);
+            std::string out = "[";
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                if (i > 0) out += ',';
+                out += std::to_string(values[i]);
+            }
+            return out + "]";
+        }
+        // country_range
+        const PopulationRange range = service.populationRangeForCountry(country, requireYear(request, "start"), requireYear(request, "end"));
+        return JsonLine::Writer().field("sum", range.sum).field("min", range.min).field("max", range.max)
+            .field("count", range.count).str();
+    }
+
+    std::string Server::statsJson() const {
+        JsonLine::Writer all;
+        for (const auto& [op, stats] : _stats) {
+            if (stats->latency.count() == 0) continue;
+            all.raw(op, JsonLine::Writer()
+                .field("count", static_cast<long long>(stats->latency.count()))
+                .field("errors", static_cast<long long>(stats->errors.load(std::memory_order_relaxed)))
+                .field("mean_us", stats->latency.mean())
+                .field("p50_us", stats->latency.percentile(0.50))
+                .field("p99_us", stats->latency.percentile(0.99))
+                .field("max_us", stats->latency.max()).str());
+        }
+        return all.str();
+    }
+
+    void Server::printStats(std::ostream& out) const {
+        for (const auto& [op, stats] : _stats) {
+            if (stats->latency.count() == 0) continue;
+            std::ostringstream line;
+            line.setf(std::ios::fixed);
+            line.precision(1);
+            line << op << ": " << stats->latency.count() << " queries, " << stats->errors.load() << " errors, p50="
+                 << stats->latency.percentile(0.50) << "us p99=" << stats->latency.percentile(0.99)
+                 << "us max=" << stats->latency.max() << "us\n";
+            out << line.str();
+        }
+    }
+
+    void Server::serveStream(std::istream& in, std::ostream& out) {
+        std::mutex outMutex;
+        std::string line;
+        while (!_shutdown.load() && std::getline(in, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            const std::int64_t received = nowNanos();
+            // Stop reading here rather than waiting in getline() for a line that may never come
+            const bool last = isShutdownRequest(line);
+            _pool.submit([this, request = std::move(line), received, &out, &outMutex] {
+                const std::string response = answer(request, received);
+                std::lock_guard<std::mutex> lock(outMutex);
+                out << response << '\n' << std::flush;
+            });
+            if (last) break;
+        }
+        _pool.drain();
+    }
+
+    void Server::serveUnixSocket(const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Invalid Unix socket path: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) throw std::runtime_error("Cannot create socket: " + std::string(std::strerror(errno)));
+        ::unlink(path.c_str());
+        if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listener, SOMAXCONN) != 0) {
+            const std::string reason = std::strerror(errno);
+            ::close(listener);
+            throw std::runtime_error("Cannot listen on " + path + ": " + reason);
+        }
+
+        struct Reader {
+            std::shared_ptr<Connection> connection;
+            std::shared_ptr<std::atomic<bool>> done;
+            std::thread thread;
+        };
+        std::vector<Reader> readers;
+
+        const std::size_t maxInFlight = std::max<std::size_t>(_options.maxInFlightPerConnection, 1);
+        auto readLoop = [this, maxInFlight](std::shared_ptr<Connection> connection, std::shared_ptr<std::atomic<bool>> done) {
+            std::string buffer;
+            char chunk[65536];
+            for (bool open = true; open;) {
+                const ssize_t n = ::recv(connection->fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) break;
+                const std::int64_t received = nowNanos();
+                buffer.append(chunk, static_cast<std::size_t>(n));
+                std::size_t start = 0;
+                for (std::size_t end; (end = buffer.find('\n', start)) != std::string::npos; start = end + 1) {
+                    std::string line = buffer.substr(start, end - start);
+                    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                    // One client may hold only a few queue slots; past that only its own reader waits
+                    if (!connection->acquire(maxInFlight)) {
+                        open = false;
+                        break;
+                    }
+                    const bool queued = _pool.submit([this, connection, request = std::move(line), received] {
+                        connection->send(answer(request, received) + '\n');
+                        connection->release();
+                    });
+                    if (!queued) connection->release();
+                }
+                buffer.erase(0, start);
+                if (buffer.size() > MAX_LINE_BYTES) break;
+            }
+            done->store(true);
+        };
+
+        while (!_shutdown.load()) {
+            // Finished readers are joined as we go so long-running servers do not accumulate threads
+            for (auto& reader : readers) {
+                if (reader.done->load() && reader.thread.joinable()) reader.thread.join();
+            }
+            readers.erase(std::remove_if(readers.begin(), readers.end(),
+                                         [](const Reader& reader) { return !reader.thread.joinable(); }), readers.end());
+
+            pollfd ready{listener, POLLIN, 0};
+            if (::poll(&ready, 1, 100) <= 0 || !(ready.revents & POLLIN)) continue;
+            const int fd = ::accept(listener, nullptr, nullptr);
+            if (fd < 0) continue;
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+            int one = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+            timeval timeout{};
+            timeout.tv_sec = _options.sendTimeoutMs / 1000;
+            timeout.tv_usec = (_options.sendTimeoutMs % 1000) * 1000;
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            Reader reader{std::make_shared<Connection>(fd), std::make_shared<std::atomic<bool>>(false), {}};
+            reader.thread = std::thread(readLoop, reader.connection, reader.done);
+            readers.push_back(std::move(reader));
+        }
+
+        ::close(listener);
+        ::unlink(path.c_str());
+        // Wake readers still blocked in recv(); queued answers are still delivered
+        for (auto& reader : readers) ::shutdown(reader.connection->fd, SHUT_RD);
+        for (auto& reader : readers) reader.thread.join();
+        _pool.drain();
+    }
+
+}
@@ -1,24 +1,116 @@
 #include "../interface/readcsv.hpp"
+#include "../interface/mapped_file.hpp"
+#include "../interface/csv_scanner.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+namespace {
+    // Walks delimiter/newline positions that lie outside quotes, 64 bytes at a time.
+    // Quote state comes from a prefix XOR of the quote mask carried across blocks,
+    // which matches the parity rule of readPhysicalRecord and the Quoted/Unquoted
+    // states of splitRecord (an escaped "" flips the state twice).
+    class StructuralCursor {
+    public:
+        void reset(std::string_view data, std::size_t pos, char delim, char quote) {
+            _data = data;
+            _delim = delim;
+            _quote = quote;
+            _base = pos;
+            _inside = 0;
+            _pendingQuote = false;
+            _valid = true;
+            load();
+        }
+
+        void invalidate() noexcept { _valid = false; }
+        bool valid() const noexcept { return _valid; }
+
+        // Advance to the next structural character. quoteBefore reports whether the
+        // bytes since the previous structural character contained a quote. Returns
+        // false at end of data (quoteBefore then covers the trailing bytes).
+        bool next(std::size_t& at, bool& isNewline, bool& quoteBefore) {
+            while (true) {
+                if (_structural) {
+                    int bit = __builtin_ctzll(_structural);
+                    std::uint64_t below = (std::uint64_t{1} << bit) - 1;
+                    quoteBefore = _pendingQuote || (_quotes & below) != 0;
+                    _pendingQuote = false;
+                    _quotes &= ~below;
+                    _structural &= _structural - 1;
+                    at = _base + static_cast<std::size_t>(bit);
+                    isNewline = ((_newlines >> bit) & 1) != 0;
+                    return true;
+                }
+                if (_quotes) _pendingQuote = true;
+                _base += CSVScan::BLOCK_SIZE;
+                if (_base >= _data.size()) {
+                    quoteBefore = _pendingQuote;
+                    _pendingQuote = false;
+                    _quotes = 0;
+                    return false;
+                }
+                load();
+            }
+        }
+
+    private:
+        void load() {
+            std::size_t len = _base < _data.size() ? std::min(CSVScan::BLOCK_SIZE, _data.size() - _base) : 0;
+            CSVScan::BlockMasks m = CSVScan::scanBlock(_data.data() + _base, len, _delim, _quote);
+            std::uint64_t quoted = CSVScan::prefixXor(m.quote) ^ _inside;
+            _structural = (m.delim | m.newline) & ~quoted;
+            _newlines = m.newline;
+            _quotes = m.quote;
+            _inside = (quoted >> 63) ? ~std::uint64_t{0} : 0;
+        }
+
+        std::string_view _data;
+        char _delim{','};
+        char _quote{'"'};
+        std::size_t _base{0};
+        std::uint64_t _structural{0};
+        std::uint64_t _newlines{0};
+        std::uint64_t _quotes{0};
+        std::uint64_t _inside{0};
+        bool _pendingQuote{false};
+        bool _valid{false};
+    };
+}
+
 struct CSVReader::Impl {
     std::ifstream ifs;
     std::string path;
     char delim;
     char quote;
     char comment;
+    Mode mode;
+
+    // Mapped mode state (data views either the mapping or an openBuffer() slice)
+    MappedFile mapped;
+    std::string_view data;
+    bool dataOpen{false};
+    std::size_t pos{0};
+    StructuralCursor cursor;
 
-    Impl(const std::string& p, char d, char q, char c)
-        : path(p), delim(d), quote(q), comment(c) {}
+    // Buffers reused across readRowViews() calls
+    std::string record;                                   ///< Stream mode: current logical record
+    std::string scratch;                                  ///< Unescaped copies of quoted fields
+    std::vector<std::pair<std::size_t, std::size_t>> fixups; ///< (field index, scratch offset)
+
+    Impl(const std::string& p, char d, char q, char c, Mode m)
+        : path(p), delim(d), quote(q), comment(c), mode(m) {}
 };
 
-CSVReader::CSVReader(const std::string& path, char delimiter, char quote, char comment)
-    : pimpl(new Impl(path, delimiter, quote, comment)) {}
+CSVReader::CSVReader(const std::string& path, char delimiter, char quote, char comment, Mode mode)
+    : pimpl(new Impl(path, delimiter, quote, comment, mode)) {}
 
 CSVReader::~CSVReader() {
     close();
@@ -26,12 +118,37 @@ CSVReader::~CSVReader() {
 }
 
 void CSVReader::open() {
+    if (pimpl->mode == Mode::Mapped) {
+        try {
+            pimpl->mapped.open(pimpl->path);
+        } catch (const std::exception&) {
+            throw std::runtime_error("Failed to open CSV file: " + pimpl->path);
+        }
+        pimpl->data = pimpl->mapped.view();
+        pimpl->dataOpen = true;
+        pimpl->pos = 0;
+        pimpl->cursor.invalidate();
+        return;
+    }
     pimpl->ifs.open(pimpl->path);
     if (!pimpl->ifs.is_open()) throw std::runtime_error("Failed to open CSV file: " + pimpl->path);
 }
 
+void CSVReader::openBuffer(std::string_view buffer) {
+    close();
+    pimpl->mode = Mode::Mapped;
+    pimpl->data = buffer;
+    pimpl->dataOpen = true;
+}
+
 void CSVReader::close() {
-    if (pimpl && pimpl->ifs.is_open()) pimpl->ifs.close();
+    if (!pimpl) return;
+    if (pimpl->ifs.is_open()) pimpl->ifs.close();
+    pimpl->mapped.close();
+    pimpl->data = std::string_view();
+    pimpl->dataOpen = false;
+    pimpl->pos = 0;
+    pimpl->cursor.invalidate();
 }
 
 // Helper to read logical record
@@ -92,11 +209,178 @@ static void splitRecord(const std::string& record, std::vector<std::string>& out
     out.push_back(cur);
 }
 
+// Run the splitRecord state machine over one field starting at i, appending the
+// unescaped bytes to scratch. Returns the index of the terminating delimiter (or size).
+static std::size_t unescapeField(std::string_view record, std::size_t i, std::string& scratch,
+                                 char delim, char quote) {
+    enum State { Unquoted, Quoted } state = Unquoted;
+    for (; i < record.size(); ++i) {
+        char c = record[i];
+        if (state == Unquoted) {
+            if (c == delim) return i;
+            if (c == quote) state = Quoted;
+            else scratch.push_back(c);
+        } else if (c == quote) {
+            if (i + 1 < record.size() && record[i+1] == quote) {
+                scratch.push_back(quote);
+                ++i;
+            } else {
+                state = Unquoted;
+            }
+        } else {
+            scratch.push_back(c);
+        }
+    }
+    return record.size();
+}
+
+// Point materialized fields at their unescaped copies once scratch stops growing
+static void applyFixups(std::vector<std::string_view>& out, const std::string& scratch,
+                        const std::vector<std::pair<std::size_t, std::size_t>>& fixups) {
+    for (std::size_t f = 0; f < fixups.size(); ++f) {
+        std::size_t offset = fixups[f].second;
+        std::size_t end = (f + 1 < fixups.size()) ? fixups[f + 1].second : scratch.size();
+        out[fixups[f].first] = std::string_view(scratch.data() + offset, end - offset);
+    }
+}
+
+// Zero-copy split: plain fields and simply quoted fields ("...") become views into
+// record; anything else goes through unescapeField into scratch. Produces exactly
+// the same fields as splitRecord.
+static void splitRecordViews(std::string_view record, std::vector<std::string_view>& out,
+                             std::string& scratch, std::vector<std::pair<std::size_t, std::size_t>>& fixups,
+                             char delim, char quote) {
+    out.clear();
+    scratch.clear();
+    fixups.clear();
+    const std::size_t n = record.size();
+    std::size_t i = 0;
+
+    while (true) {
+        const std::size_t start = i;
+        bool done = false;
+        if (i < n && record[i] == quote) {
+            std::size_t close = record.find(quote, i + 1);
+            if (close != std::string_view::npos && (close + 1 == n || record[close + 1] == delim)) {
+                out.push_back(record.substr(i + 1, close - i - 1));
+                i = close + 1;
+                done = true;
+            }
+        } else {
+            std::size_t j = i;
+            while (j < n && record[j] != delim && record[j] != quote) ++j;
+            if (j == n || record[j] == delim) {
+                out.push_back(record.substr(i, j - i));
+                i = j;
+                done = true;
+            }
+        }
+
+        if (!done) {
+            // Escaped quotes or mixed quoting: materialize, patch the view once scratch is stable
+            std::size_t offset = scratch.size();
+            i = unescapeField(record, start, scratch, delim, quote);
+            fixups.emplace_back(out.size(), offset);
+            out.emplace_back();
+        }
+
+        if (i >= n) break;
+        ++i; // skip delimiter
+        if (i == n) {
+            out.emplace_back();
+            break;
+        }
+    }
+
+    applyFixups(out, scratch, fixups);
+}
+
+// Emit one field of a structurally split record. The slice never contains a
+// delimiter outside quotes, so only quoting needs handling here.
+static void pushField(std::string_view field, bool hasQuote, std::vector<std::string_view>& out,
+                      std::string& scratch, std::vector<std::pair<std::size_t, std::size_t>>& fixups,
+                      char delim, char quote) {
+    if (!hasQuote) {
+        out.push_back(field);
+        return;
+    }
+    if (field.size() >= 2 && field.front() == quote && field.back() == quote &&
+        field.find(quote, 1) == field.size() - 1) {
+        out.push_back(field.substr(1, field.size() - 2));
+        return;
+    }
+    std::size_t offset = scratch.size();
+    unescapeField(field, 0, scratch, delim, quote);
+    fixups.emplace_back(out.size(), offset);
+    out.emplace_back();
+}
+
+// Mapped mode: find the next logical record and split it in one pass over the
+// structural index, with the same comment and multi-line quote rules as
+// readPhysicalRecord + splitRecord.
+static bool readStructuredRecord(std::string_view data, std::size_t& pos,
+                                 StructuralCursor& cursor, std::vector<std::string_view>& out,
+                                 std::string& scratch, std::vector<std::pair<std::size_t, std::size_t>>& fixups,
+                                 char delim, char quote, char comment) {
+    const std::size_t n = data.size();
+    while (pos < n) {
+        std::size_t i = pos;
+        while (i < n && (data[i] == ' ' || data[i] == '\t')) ++i;
+        if (i >= n || data[i] != comment) break;
+        // Comment lines are skipped whole, quotes included, so restart the index after them
+        const void* nl = std::memchr(data.data() + i, '\n', n - i);
+        pos = nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - data.data()) + 1 : n;
+        cursor.invalidate();
+    }
+    if (pos >= n) return false;
+    if (!cursor.valid()) cursor.reset(data, pos, delim, quote);
+
+    out.clear();
+    scratch.clear();
+    fixups.clear();
+    std::size_t fieldStart = pos;
+    std::size_t at = 0;
+    bool isNewline = false;
+    bool quoteBefore = false;
+    while (cursor.next(at, isNewline, quoteBefore)) {
+        pushField(data.substr(fieldStart, at - fieldStart), quoteBefore, out, scratch, fixups, delim, quote);
+        fieldStart = at + 1;
+        if (isNewline) {
+            pos = at + 1;
+            applyFixups(out, scratch, fixups);
+            return true;
+        }
+    }
+    pushField(data.substr(fieldStart, n - fieldStart), quoteBefore, out, scratch, fixups, delim, quote);
+    pos = n;
+    applyFixups(out, scratch, fixups);
+    return true;
+}
+
 bool CSVReader::readRow(std::vector<std::string>& out) {
     if (!pimpl) return false;
+    if (pimpl->mode == Mode::Mapped) {
+        std::vector<std::string_view> views;
+        if (!readRowViews(views)) return false;
+        out.assign(views.begin(), views.end());
+        return true;
+    }
     if (!pimpl->ifs.is_open()) return false;
     std::string raw;
     if (!readPhysicalRecord(pimpl->ifs, raw, pimpl->quote, pimpl->comment)) return false;
     splitRecord(raw, out, pimpl->delim, pimpl->quote);
     return true;
-}
\ No newline at end of file
+}
+
+bool CSVReader::readRowViews(std::vector<std::string_view>& out) {
+    if (!pimpl) return false;
+    if (pimpl->mode == Mode::Mapped) {
+        if (!pimpl->dataOpen) return false;
+        return readStructuredRecord(pimpl->data, pimpl->pos, pimpl->cursor, out,
+                                    pimpl->scratch, pimpl->fixups, pimpl->delim, pimpl->quote, pimpl->comment);
+    }
+    if (!pimpl->ifs.is_open()) return false;
+    if (!readPhysicalRecord(pimpl->ifs, pimpl->record, pimpl->quote, pimpl->comment)) return false;
+    splitRecordViews(pimpl->record, out, pimpl->scratch, pimpl->fixups, pimpl->delim, pimpl->quote);
+    return true;
+}
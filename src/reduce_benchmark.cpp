@@ -0,0 +1,97 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <cstdlib>
+#include "../interface/simd_reduce.hpp"
+#include "../interface/constants.hpp"
+
+/**
+ * @file reduce_benchmark.cpp
+ * @brief Micro-benchmark: scalar vs. AVX2 vs. AVX-512 column reductions
+ *
+ * Builds one synthetic population-like column and times the fused
+ * sum/min/max pass and the threshold count for every kernel the CPU
+ * supports, at 1..maxThreads OpenMP threads. The scalar kernel is the
+ * plain loop the column service used before vectorization.
+ *
+ * Usage: ./OpenMP_Mini1_Project_reduce_benchmark [elements] [repetitions] [maxThreads]
+ */
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+    template <typename Fn>
+    double bestOf(int repetitions, Fn&& fn) {
+        double best = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            auto t0 = Clock::now();
+            fn();
+            double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (rep == 0 || seconds < best) best = seconds;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t elements = std::size_t{1} << 24;
+    int repetitions = Config::DEFAULT_REPETITIONS;
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (argc > 1) elements = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[1])));
+    if (argc > 2) repetitions = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) maxThreads = std::max(1, std::atoi(argv[3]));
+
+    // Country-population-like magnitudes: 1e3 .. 1.5e9
+    std::vector<long long> column(elements);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long long> dist(1000, 1500000000LL);
+    for (auto& v : column) v = dist(rng);
+    const long long threshold = 100000000LL;
+    const double megabytes = static_cast<double>(elements * sizeof(long long)) / (1024.0 * 1024.0);
+
+    std::cout << "Column reduction micro-benchmark: " << elements << " values, "
+              << std::fixed << std::setprecision(1) << megabytes << " MB, best of "
+              << repetitions << " runs\n";
+    std::cout << "Detected kernel: " << SimdReduce::kernelName(SimdReduce::detectKernel()) << "\n\n";
+
+    SimdReduce::Kernel original = SimdReduce::activeKernel();
+    SimdReduce::selectKernel(SimdReduce::Kernel::Scalar);
+    const SimdReduce::Summary reference = SimdReduce::summarize(column.data(), column.size());
+    const std::size_t referenceCount = SimdReduce::countGreater(column.data(), column.size(), threshold);
+
+    std::cout << std::setw(10) << "Kernel" << std::setw(9) << "Threads"
+              << std::setw(14) << "Summary (ms)" << std::setw(10) << "GB/s"
+              << std::setw(13) << "Count (ms)" << std::setw(10) << "GB/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(77, '-') << "\n";
+
+    std::vector<double> scalarSeconds(static_cast<std::size_t>(maxThreads) + 1, 0.0);
+    const double gigabytes = megabytes / 1024.0;
+    for (SimdReduce::Kernel kernel : {SimdReduce::Kernel::Scalar, SimdReduce::Kernel::AVX2, SimdReduce::Kernel::AVX512}) {
+        if (!SimdReduce::selectKernel(kernel)) continue;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            SimdReduce::Summary s;
+            std::size_t count = 0;
+            double summarySeconds = bestOf(repetitions, [&] { s = SimdReduce::parallelSummarize(column.data(), column.size(), threads); });
+            double countSeconds = bestOf(repetitions, [&] { count = SimdReduce::parallelCountGreater(column.data(), column.size(), threshold, threads); });
+            if (kernel == SimdReduce::Kernel::Scalar) scalarSeconds[static_cast<std::size_t>(threads)] = summarySeconds;
+
+            std::cout << std::setw(10) << SimdReduce::kernelName(kernel) << std::setw(9) << threads
+                      << std::setw(14) << std::setprecision(3) << summarySeconds * 1000.0
+                      << std::setw(10) << std::setprecision(2) << gigabytes / summarySeconds
+                      << std::setw(13) << std::setprecision(3) << countSeconds * 1000.0
+                      << std::setw(10) << std::setprecision(2) << gigabytes / countSeconds
+                      << std::setw(10) << scalarSeconds[static_cast<std::size_t>(threads)] / summarySeconds << "x\n";
+            if (s.sum != reference.sum || s.min != reference.min || s.max != reference.max || count != referenceCount) {
+                std::cout << "  WARNING: result mismatch against scalar kernel!\n";
+            }
+        }
+    }
+    SimdReduce::selectKernel(original);
+    return 0;
+}
@@ -0,0 +1,318 @@
+/**
+ * @file roaring_bitmap.cpp
+ * @brief RoaringBitmap implementation
+ */
+
+#include "../interface/roaring_bitmap.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    std::uint32_t popcount(const std::uint64_t* words, std::uint32_t n) noexcept {
+        std::uint32_t bits = 0;
+        for (std::uint32_t w = 0; w < n; ++w) bits += static_cast<std::uint32_t>(__builtin_popcountll(words[w]));
+        return bits;
+    }
+
+    void setBit(std::uint64_t* words, std::uint16_t low) noexcept {
+        words[low >> 6] |= std::uint64_t{1} << (low & 63);
+    }
+
+    bool testBit(const std::uint64_t* words, std::uint16_t low) noexcept {
+        return (words[low >> 6] >> (low & 63)) & 1;
+    }
+}
+
+RoaringBitmap::RoaringBitmap(const allocator_type& alloc) : _containers(alloc), _arrays(alloc), _words(alloc) {}
+
+RoaringBitmap::RoaringBitmap(const RoaringBitmap& other, const allocator_type& alloc)
+    : _containers(other._containers, alloc), _arrays(other._arrays, alloc), _words(other._words, alloc),
+      _cardinality(other._cardinality), _last(other._last) {}
+
+RoaringBitmap::RoaringBitmap(RoaringBitmap&& other, const allocator_type& alloc)
+    : _containers(std::move(other._containers), alloc), _arrays(std::move(other._arrays), alloc),
+      _words(std::move(other._words), alloc), _cardinality(other._cardinality), _last(other._last) {
+    other.clear();
+}
+
+RoaringBitmap RoaringBitmap::range(Value begin, Value end) {
+    RoaringBitmap result;
+    std::vector<std::uint64_t> chunk(WORDS);
+    for (std::uint64_t first = begin; first < end;) {
+        const auto key = static_cast<std::uint16_t>(first >> 16);
+        const std::uint64_t chunkEnd = std::min<std::uint64_t>(end, (static_cast<std::uint64_t>(key) + 1) << 16);
+        const auto lowFirst = static_cast<std::uint32_t>(first & 0xFFFF);
+        const auto count = static_cast<std::uint32_t>(chunkEnd - first);
+        if (count <= ARRAY_LIMIT) {
+            const std::size_t offset = result._arrays.size();
+            for (std::uint32_t v = 0; v < count; ++v) result._arrays.push_back(static_cast<std::uint16_t>(lowFirst + v));
+            result.closeArray(key, offset);
+        } else {
+            std::fill(chunk.begin(), chunk.end(), 0);
+            for (std::uint32_t v = 0; v < count; ++v) setBit(chunk.data(), static_cast<std::uint16_t>(lowFirst + v));
+            result.appendWords(key, chunk.data(), count);
+        }
+        first = chunkEnd;
+    }
+    result.updateLast();
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::unionOf(const std::vector<const RoaringBitmap*>& bitmaps) {
+    // Every container of every input, grouped by key; a key covered by one input is copied as is
+    struct Ref { std::uint16_t key; const RoaringBitmap* owner; const Container* container; };
+    std::vector<Ref> refs;
+    for (const RoaringBitmap* bitmap : bitmaps) {
+        if (!bitmap) continue;
+        for (const Container& c : bitmap->_containers) refs.push_back(Ref{c.key, bitmap, &c});
+    }
+    std::stable_sort(refs.begin(), refs.end(), [](const Ref& x, const Ref& y) { return x.key < y.key; });
+
+    RoaringBitmap result;
+    std::vector<std::uint64_t> chunk(WORDS);
+    for (std::size_t i = 0; i < refs.size();) {
+        std::size_t run = i;
+        while (run < refs.size() && refs[run].key == refs[i].key) ++run;
+        if (run - i == 1) {
+            result.appendCopy(*refs[i].owner, *refs[i].container);
+        } else {
+            std::fill(chunk.begin(), chunk.end(), 0);
+            for (std::size_t r = i; r < run; ++r) {
+                const RoaringBitmap& owner = *refs[r].owner;
+                const Container& c = *refs[r].container;
+                if (isBitmap(c)) {
+                    const std::uint64_t* bits = owner.words(c);
+                    for (std::uint32_t w = 0; w < WORDS; ++w) chunk[w] |= bits[w];
+                } else {
+                    const std::uint16_t* low = owner.values(c);
+                    for (std::uint32_t v = 0; v < c.cardinality; ++v) setBit(chunk.data(), low[v]);
+                }
+            }
+            result.appendWords(refs[i].key, chunk.data(), popcount(chunk.data(), WORDS));
+        }
+        i = run;
+    }
+    result.updateLast();
+    return result;
+}
+
+void RoaringBitmap::append(Value value) {
+    if (_cardinality > 0 && value <= _last) {
+        throw std::invalid_argument("RoaringBitmap: ids must be appended in increasing order");
+    }
+    const auto key = static_cast<std::uint16_t>(value >> 16);
+    const auto low = static_cast<std::uint16_t>(value & 0xFFFF);
+    if (_containers.empty() || _containers.back().key != key) {
+        _containers.push_back(Container{key, 0, static_cast<std::uint32_t>(_arrays.size())});
+    }
+    Container& c = _containers.back();
+    if (c.cardinality < ARRAY_LIMIT) {
+        _arrays.push_back(low);
+    } else {
+        if (c.cardinality == ARRAY_LIMIT) convertLastToBitmap();
+        setBit(_words.data() + c.offset, low);
+    }
+    ++c.cardinality;
+    ++_cardinality;
+    _last = value;
+}
+
+bool RoaringBitmap::contains(Value value) const noexcept {
+    const auto key = static_cast<std::uint16_t>(value >> 16);
+    const auto low = static_cast<std::uint16_t>(value & 0xFFFF);
+    auto it = std::lower_bound(_containers.begin(), _containers.end(), key,
+                               [](const Container& c, std::uint16_t k) { return c.key < k; });
+    if (it == _containers.end() || it->key != key) return false;
+    if (isBitmap(*it)) return testBit(words(*it), low);
+    return std::binary_search(values(*it), values(*it) + it->cardinality, low);
+}
+
+std::vector<std::size_t> RoaringBitmap::toIndices() const {
+    std::vector<std::size_t> indices(_cardinality);
+    std::size_t* out = indices.data();
+    forEach([&](Value v) { *out++ = v; });
+    return indices;
+}
+
+RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) {
+    using Container = RoaringBitmap::Container;
+    RoaringBitmap result;
+    std::vector<std::uint64_t> chunk;
+    std::size_t i = 0, j = 0;
+    while (i < a._containers.size() && j < b._containers.size()) {
+        const Container& x = a._containers[i];
+        const Container& y = b._containers[j];
+        if (x.key != y.key) {
+            if (x.key < y.key) ++i; else ++j;
+            continue;
+        }
+        if (RoaringBitmap::isBitmap(x) && RoaringBitmap::isBitmap(y)) {
+            chunk.resize(RoaringBitmap::WORDS);
+            const std::uint64_t* xw = a.words(x);
+            const std::uint64_t* yw = b.words(y);
+            for (std::uint32_t w = 0; w < RoaringBitmap::WORDS; ++w) chunk[w] = xw[w] & yw[w];
+            result.appendWords(x.key, chunk.data(), popcount(chunk.data(), RoaringBitmap::WORDS));
+        } else {
+            // At least one side is an array, so the result is one too
+            const std::size_t offset = result._arrays.size();
+            if (!RoaringBitmap::isBitmap(x) && !RoaringBitmap::isBitmap(y)) {
+                std::set_intersection(a.values(x), a.values(x) + x.cardinality, b.values(y), b.values(y) + y.cardinality,
+                                      std::back_inserter(result._arrays));
+            } else {
+                const bool xIsArray = !RoaringBitmap::isBitmap(x);
+                const std::uint16_t* low = xIsArray ? a.values(x) : b.values(y);
+                const std::uint32_t count = xIsArray ? x.cardinality : y.cardinality;
+                const std::uint64_t* bits = xIsArray ? b.words(y) : a.words(x);
+                for (std::uint32_t v = 0; v < count; ++v) {
+                    if (testBit(bits, low[v])) result._arrays.push_back(low[v]);
+                }
+            }
+            result.closeArray(x.key, offset);
+        }
+        ++i;
+        ++j;
+    }
+    result.updateLast();
+    return result;
+}
+
+RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) {
+    using Container = RoaringBitmap::Container;
+    RoaringBitmap result;
+    std::vector<std::uint64_t> chunk;
+    std::size_t i = 0, j = 0;
+    while (i < a._containers.size() || j < b._containers.size()) {
+        if (j == b._containers.size() || (i < a._containers.size() && a._containers[i].key < b._containers[j].key)) {
+            result.appendCopy(a, a._containers[i++]);
+            continue;
+        }
+        if (i == a._containers.size() || b._containers[j].key < a._containers[i].key) {
+            result.appendCopy(b, b._containers[j++]);
+            continue;
+        }
+        const Container& x = a._containers[i++];
+        const Container& y = b._containers[j++];
+        if (!RoaringBitmap::isBitmap(x) && !RoaringBitmap::isBitmap(y)) {
+            const std::size_t offset = result._arrays.size();
+            std::set_union(a.values(x), a.values(x) + x.cardinality, b.values(y), b.values(y) + y.cardinality,
+                           std::back_inserter(result._arrays));
+            result.closeArray(x.key, offset);
+            continue;
+        }
+        // Start from a bitmap side and fold the other side in
+        const bool xIsBitmap = RoaringBitmap::isBitmap(x);
+        const std::uint64_t* base = xIsBitmap ? a.words(x) : b.words(y);
+        chunk.assign(base, base + RoaringBitmap::WORDS);
+        const RoaringBitmap& otherOwner = xIsBitmap ? b : a;
+        const Container& other = xIsBitmap ? y : x;
+        if (RoaringBitmap::isBitmap(other)) {
+            const std::uint64_t* bits = otherOwner.words(other);
+            for (std::uint32_t w = 0; w < RoaringBitmap::WORDS; ++w) chunk[w] |= bits[w];
+        } else {
+            const std::uint16_t* low = otherOwner.values(other);
+            for (std::uint32_t v = 0; v < other.cardinality; ++v) setBit(chunk.data(), low[v]);
+        }
+        result.appendWords(x.key, chunk.data(), popcount(chunk.data(), RoaringBitmap::WORDS));
+    }
+    result.updateLast();
+    return result;
+}
+
+bool operator==(const RoaringBitmap& a, const RoaringBitmap& b) noexcept {
+    if (a._cardinality != b._cardinality || a._containers.size() != b._containers.size()) return false;
+    for (std::size_t i = 0; i < a._containers.size(); ++i) {
+        const RoaringBitmap::Container& x = a._containers[i];
+        const RoaringBitmap::Container& y = b._containers[i];
+        if (x.key != y.key || x.cardinality != y.cardinality) return false;
+        // Equal cardinalities mean equal container kinds
+        const bool same = RoaringBitmap::isBitmap(x)
+            ? std::equal(a.words(x), a.words(x) + RoaringBitmap::WORDS, b.words(y))
+            : std::equal(a.values(x), a.values(x) + x.cardinality, b.values(y));
+        if (!same) return false;
+    }
+    return true;
+}
+
+void RoaringBitmap::clear() noexcept {
+    _containers.clear();
+    _arrays.clear();
+    _words.clear();
+    _cardinality = 0;
+    _last = 0;
+}
+
+std::size_t RoaringBitmap::arrayContainerCount() const noexcept {
+    return static_cast<std::size_t>(std::count_if(_containers.begin(), _containers.end(),
+                                                  [](const Container& c) { return !isBitmap(c); }));
+}
+
+std::size_t RoaringBitmap::memoryBytes() const noexcept {
+    return _containers.capacity() * sizeof(Container) + _arrays.capacity() * sizeof(std::uint16_t) +
+           _words.capacity() * sizeof(std::uint64_t);
+}
+
+void RoaringBitmap::appendWords(std::uint16_t key, const std::uint64_t* bits, std::uint32_t cardinality) {
+    if (cardinality == 0) return;
+    if (cardinality > ARRAY_LIMIT) {
+        _containers.push_back(Container{key, cardinality, static_cast<std::uint32_t>(_words.size())});
+        _words.insert(_words.end(), bits, bits + WORDS);
+        _cardinality += cardinality;
+        return;
+    }
+    const std::size_t offset = _arrays.size();
+    for (std::uint32_t w = 0; w < WORDS; ++w) {
+        for (std::uint64_t word = bits[w]; word != 0; word &= word - 1) {
+            _arrays.push_back(static_cast<std::uint16_t>((w << 6) | static_cast<std::uint32_t>(__builtin_ctzll(word))));
+        }
+    }
+    closeArray(key, offset);
+}
+
+void RoaringBitmap::appendCopy(const RoaringBitmap& from, const Container& c) {
+    if (isBitmap(c)) {
+        appendWords(c.key, from.words(c), c.cardinality);
+        return;
+    }
+    const std::size_t offset = _arrays.size();
+    _arrays.insert(_arrays.end(), from.values(c), from.values(c) + c.cardinality);
+    closeArray(c.key, offset);
+}
+
+void RoaringBitmap::closeArray(std::uint16_t key, std::size_t offset) {
+    const auto count = static_cast<std::uint32_t>(_arrays.size() - offset);
+    if (count == 0) return;
+    _containers.push_back(Container{key, count, static_cast<std::uint32_t>(offset)});
+    _cardinality += count;
+    if (count > ARRAY_LIMIT) convertLastToBitmap();
+}
+
+void RoaringBitmap::convertLastToBitmap() {
+    Container& c = _containers.back();
+    const std::size_t offset = _words.size();
+    _words.resize(offset + WORDS, 0);
+    for (std::size_t v = c.offset; v < _arrays.size(); ++v) setBit(_words.data() + offset, _arrays[v]);
+    _arrays.resize(c.offset);
+    c.offset = static_cast<std::uint32_t>(offset);
+}
+
+void RoaringBitmap::updateLast() noexcept {
+    if (_containers.empty()) {
+        _last = 0;
+        return;
+    }
+    const Container& c = _containers.back();
+    const Value high = static_cast<Value>(c.key) << 16;
+    if (!isBitmap(c)) {
+        _last = high | values(c)[c.cardinality - 1];
+        return;
+    }
+    const std::uint64_t* bits = words(c);
+    for (std::uint32_t w = WORDS; w-- > 0;) {
+        if (bits[w] != 0) {
+            _last = high | (w << 6) | static_cast<Value>(63 - __builtin_clzll(bits[w]));
+            return;
+        }
+    }
+}
@@ -1,14 +1,26 @@
 #include "../interface/service.hpp"
 #include "../interface/populationModel.hpp"
+#include "../interface/population_matrix.hpp"
+#include "../interface/top_n_engine.hpp"
+#include "../interface/parallel_region.hpp"
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
 #include <chrono>
-#include <queue>
 #include <functional>
 #include <omp.h>
 
-PopulationModelService::PopulationModelService(PopulationModel* m) : model_(m) {}
+namespace {
+    /// Running sum and count for averages, combined across thread partials
+    struct SumCount {
+        long long sum{0};
+        long long count{0};
+    };
+}
+
+PopulationModelService::PopulationModelService(PopulationModel* m, ExecutionContext context)
+    : model_(m), context_(context) {}
 PopulationModelService::~PopulationModelService() = default;
 
 std::string PopulationModelService::getImplementationName() const {
@@ -16,142 +28,151 @@ std::string PopulationModelService::getImplementationName() const {
 }
 
 long long PopulationModelService::sumPopulationForYear(int year, int numThreads) const {
-    // If caller requests multiple threads and OpenMP is available, delegate to parallel implementation
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        const auto& yearMap = model_->yearToIndex();
-        auto it = yearMap.find(year);
-        if (it == yearMap.end()) return 0;
-    std::size_t yearIndex = static_cast<std::size_t>(it->second);
-        long long total = 0;
-#pragma omp parallel for reduction(+:total)
-        for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-            const PopulationRow& row = model_->rowAt(i);
-            if (yearIndex < row.yearCount()) total += row.getPopulationForYear(yearIndex);
-        }
-        return total;
-    }
     const auto& yearMap = model_->yearToIndex();
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
-    long long total = 0;
-    for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-        const PopulationRow& row = model_->rowAt(i);
-        if (yearIndex < row.yearCount()) total += row.getPopulationForYear(yearIndex);
-    }
-    return total;
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+    // Small inputs run inline; larger ones open one region sized by the context
+    return Parallel::reduce(context_.withThreads(numThreads), matrix.rows(), 0LL,
+        [&](std::size_t i, long long& total) {
+            if (yearIndex < matrix.rowLength(i)) total += yearValues[i];
+        },
+        [](long long& into, long long from) { into += from; });
 }
 
 double PopulationModelService::averagePopulationForYear(int year, int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        const auto& yearMap = model_->yearToIndex();
-        auto it = yearMap.find(year);
-        if (it == yearMap.end()) return 0.0;
-    std::size_t yearIndex = static_cast<std::size_t>(it->second);
-        long long total = 0;
-        long long countLL = 0;
-#pragma omp parallel for reduction(+:total, countLL)
-        for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-            const PopulationRow& row = model_->rowAt(i);
-            if (yearIndex < row.yearCount()) { total += row.getPopulationForYear(yearIndex); ++countLL; }
-        }
-        return countLL > 0 ? static_cast<double>(total) / static_cast<double>(countLL) : 0.0;
-    }
     const auto& yearMap = model_->yearToIndex();
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0.0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
-    long long total = 0;
-    std::size_t count = 0;
-    for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-        const PopulationRow& row = model_->rowAt(i);
-        if (yearIndex < row.yearCount()) { total += row.getPopulationForYear(yearIndex); ++count; }
-    }
-    return count > 0 ? static_cast<double>(total) / count : 0.0;
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+    const SumCount totals = Parallel::reduce(context_.withThreads(numThreads), matrix.rows(), SumCount{},
+        [&](std::size_t i, SumCount& local) {
+            if (yearIndex < matrix.rowLength(i)) { local.sum += yearValues[i]; ++local.count; }
+        },
+        [](SumCount& into, const SumCount& from) { into.sum += from.sum; into.count += from.count; });
+    return totals.count > 0 ? static_cast<double>(totals.sum) / static_cast<double>(totals.count) : 0.0;
 }
 
-// Parallel helpers removed: parallel code is inlined in the numThreads>1 branches.
-
 long long PopulationModelService::maxPopulationForYear(int year, int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        const auto& yearMap = model_->yearToIndex();
-        auto it = yearMap.find(year);
-        if (it == yearMap.end()) return 0;
-    std::size_t yearIndex = static_cast<std::size_t>(it->second);
-        long long global_max = std::numeric_limits<long long>::min();
-#pragma omp parallel
-        {
-            long long local_max = std::numeric_limits<long long>::min();
-#pragma omp for nowait
-            for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-                const PopulationRow& row = model_->rowAt(i);
-                if (yearIndex < row.yearCount()) local_max = std::max(local_max, row.getPopulationForYear(yearIndex));
-            }
-#pragma omp critical
-            { global_max = std::max(global_max, local_max); }
-        }
-        return global_max == std::numeric_limits<long long>::min() ? 0 : global_max;
-    }
     const auto& yearMap = model_->yearToIndex();
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
-    long long maxPop = 0;
-    for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-        const PopulationRow& row = model_->rowAt(i);
-        if (yearIndex < row.yearCount()) maxPop = std::max(maxPop, row.getPopulationForYear(yearIndex));
-    }
-    return maxPop;
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+    // Populations are non-negative, so 0 doubles as the identity and the "no data" result
+    return Parallel::reduce(context_.withThreads(numThreads), matrix.rows(), 0LL,
+        [&](std::size_t i, long long& maxPop) {
+            if (yearIndex < matrix.rowLength(i)) maxPop = std::max(maxPop, yearValues[i]);
+        },
+        [](long long& into, long long from) { into = std::max(into, from); });
 }
 
-// Parallel helpers removed: parallel code is inlined in the numThreads>1 branches.
-
 long long PopulationModelService::minPopulationForYear(int year, int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        const auto& yearMap = model_->yearToIndex();
-        auto it = yearMap.find(year);
-        if (it == yearMap.end()) return 0;
-    std::size_t yearIndex = static_cast<std::size_t>(it->second);
-        long long global_min = std::numeric_limits<long long>::max();
-#pragma omp parallel
-        {
-            long long local_min = std::numeric_limits<long long>::max();
-#pragma omp for nowait
-            for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-                const PopulationRow& row = model_->rowAt(i);
-                if (yearIndex < row.yearCount()) local_min = std::min(local_min, row.getPopulationForYear(yearIndex));
-            }
-#pragma omp critical
-            { global_min = std::min(global_min, local_min); }
-        }
-        return global_min == std::numeric_limits<long long>::max() ? 0 : global_min;
-    }
     const auto& yearMap = model_->yearToIndex();
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
-    long long minPop = std::numeric_limits<long long>::max();
-    for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-        const PopulationRow& row = model_->rowAt(i);
-        if (yearIndex < row.yearCount()) minPop = std::min(minPop, row.getPopulationForYear(yearIndex));
-    }
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+    const long long minPop = Parallel::reduce(context_.withThreads(numThreads), matrix.rows(),
+        std::numeric_limits<long long>::max(),
+        [&](std::size_t i, long long& local) {
+            if (yearIndex < matrix.rowLength(i)) local = std::min(local, yearValues[i]);
+        },
+        [](long long& into, long long from) { into = std::min(into, from); });
     return minPop == std::numeric_limits<long long>::max() ? 0 : minPop;
 }
 
-// Parallel helpers removed: parallel code is inlined in the numThreads>1 branches.
+YearSummary PopulationModelService::yearSummary(int year, int numThreads) const {
+    YearSummary summary;
+    const auto& yearMap = model_->yearToIndex();
+    auto it = yearMap.find(year);
+    if (it == yearMap.end()) return summary;
+    std::size_t yearIndex = static_cast<std::size_t>(it->second);
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+    const std::size_t rows = matrix.rows();
+
+    // One partial per thread; merging in thread order keeps ties on the lowest row
+    summary = Parallel::reduce(context_.withThreads(numThreads), rows, summary,
+        [&](std::size_t i, YearSummary& local) {
+            if (yearIndex < matrix.rowLength(i)) local.add(yearValues[i], i);
+        },
+        [](YearSummary& into, const YearSummary& from) { into.merge(from); });
+
+    summary.finalize();
+    if (summary.count > 0) {
+        summary.minCountry = model_->countryNames()[summary.argmin];
+        summary.maxCountry = model_->countryNames()[summary.argmax];
+    }
+    return summary;
+}
+
+std::vector<YearSummary> PopulationModelService::yearSummaries(const std::vector<int>& years, int numThreads) const {
+    const std::size_t yearCount = years.size();
+    std::vector<YearSummary> summaries(yearCount);
+    // Resolve the requested years to matrix columns once; unknown years stay empty
+    constexpr std::size_t NO_YEAR = std::numeric_limits<std::size_t>::max();
+    const auto& yearMap = model_->yearToIndex();
+    std::vector<std::size_t> yearIndices(yearCount, NO_YEAR);
+    for (std::size_t j = 0; j < yearCount; ++j) {
+        auto it = yearMap.find(years[j]);
+        if (it != yearMap.end()) yearIndices[j] = static_cast<std::size_t>(it->second);
+    }
+    const PopulationMatrixView matrix = model_->matrix();
+    const std::size_t rows = matrix.rows();
+
+    // Fold every requested year of row r into out[0, yearCount); the row is read once
+    auto addRow = [&](std::size_t r, YearSummary* out) {
+        const PopulationSpan values = matrix.row(r);
+        for (std::size_t j = 0; j < yearCount; ++j) {
+            if (yearIndices[j] < values.size) out[j].add(values[yearIndices[j]], r);
+        }
+    };
+
+    const ExecutionContext context = context_.withThreads(numThreads);
+    // The team is sized by the total number of values read, not just the row count
+    const std::size_t items = rows * yearCount;
+    const int team = context.teamSize(items);
+    if (team > 1) {
+        // Countries are split across threads into per-thread partials; the same region
+        // then splits the years across threads to merge them, in thread order
+        std::vector<std::vector<YearSummary>> partials(static_cast<std::size_t>(team));
+        Parallel::region(context, items, [&]() {
+            std::vector<YearSummary>& local = partials[static_cast<std::size_t>(omp_get_thread_num())];
+            local.resize(yearCount);
+#pragma omp for schedule(runtime)
+            for (std::size_t r = 0; r < rows; ++r) addRow(r, local.data());
+
+            const std::size_t threads = static_cast<std::size_t>(omp_get_num_threads());
+#pragma omp for schedule(runtime)
+            for (std::size_t j = 0; j < yearCount; ++j) {
+                for (std::size_t t = 0; t < threads; ++t) summaries[j].merge(partials[t][j]);
+            }
+        });
+    } else {
+        for (std::size_t r = 0; r < rows; ++r) addRow(r, summaries.data());
+    }
 
-long long PopulationModelService::populationForCountryInYear(const std::string& country, int year, int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        // Per-country lookup is effectively O(1) via hash -> just perform serial lookup even when asking for multiple threads
-        (void)country; (void)year; // silence unused warnings in some builds
-        // fall through to serial implementation below
+    const auto& names = model_->countryNames();
+    for (auto& summary : summaries) {
+        summary.finalize();
+        if (summary.count == 0) continue;
+        summary.minCountry = names[summary.argmin];
+        summary.maxCountry = names[summary.argmax];
     }
-    const PopulationRow* row = model_->getByCountry(country);
+    return summaries;
+}
+
+long long PopulationModelService::populationForCountryInYear(const std::string& country, int year, int numThreads) const {
+    // Per-country lookup is O(1) via hash, so it always runs on the calling thread
+    (void)numThreads;
+    const std::optional<PopulationRow> row = model_->getByCountry(country);
     if (!row) return 0;
     const auto& yearMap = model_->yearToIndex();
     auto it = yearMap.find(year);
@@ -163,77 +184,32 @@ long long PopulationModelService::populationForCountryInYear(const std::string&
 
 std::vector<std::pair<std::string, long long>> PopulationModelService::topNCountriesByPopulationInYear(int year, std::size_t n, int numThreads) const {
     if (n == 0) return {};
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        const auto& yearMap = model_->yearToIndex();
-        auto it = yearMap.find(year);
-        if (it == yearMap.end()) return {};
-        std::size_t yearIndex = static_cast<std::size_t>(it->second);
-
-        using HeapElem = std::pair<long long, std::string>; // (population, country)
-        using MinHeap = std::priority_queue<HeapElem, std::vector<HeapElem>, std::greater<HeapElem>>;
-
-        int threads = omp_get_max_threads();
-        std::vector<MinHeap> localHeaps(static_cast<std::size_t>(threads));
-
-#pragma omp parallel
-        {
-            int tid = omp_get_thread_num();
-            MinHeap &heap = localHeaps[static_cast<std::size_t>(tid)];
-#pragma omp for nowait
-            for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-                const PopulationRow& row = model_->rowAt(i);
-                if (yearIndex >= row.yearCount()) continue;
-                HeapElem e{row.getPopulationForYear(yearIndex), row.country()};
-                if (heap.size() < n) heap.push(e);
-                else if (e > heap.top()) { heap.pop(); heap.push(e); }
-            }
-        }
-
-        // Merge per-thread heaps into a final min-heap of size up to n
-        MinHeap finalHeap;
-        for (auto &h : localHeaps) {
-            while (!h.empty()) {
-                HeapElem e = h.top(); h.pop();
-                if (finalHeap.size() < n) finalHeap.push(e);
-                else if (e > finalHeap.top()) { finalHeap.pop(); finalHeap.push(e); }
-            }
-        }
-
-        // Extract results from finalHeap into vector sorted descending
-        std::vector<std::pair<std::string,long long>> out;
-        out.reserve(finalHeap.size());
-        while (!finalHeap.empty()) {
-            auto p = finalHeap.top(); finalHeap.pop(); // smallest-first
-            out.emplace_back(p.second, p.first);
-        }
-        std::reverse(out.begin(), out.end()); // now descending
-        return out;
-    }
     const auto& yearMap = model_->yearToIndex();
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return {};
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
-    std::vector<std::pair<std::string, long long>> countryPops;
-    for (std::size_t i = 0; i < model_->rowCount(); ++i) {
-        const PopulationRow& row = model_->rowAt(i);
-        if (yearIndex < row.yearCount()) countryPops.emplace_back(row.country(), row.getPopulationForYear(yearIndex));
-    }
-    std::sort(countryPops.begin(), countryPops.end(), [](const auto& a, const auto& b){ return a.second > b.second; });
-    if (countryPops.size() > n) countryPops.resize(n);
-    return countryPops;
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+
+    // Select on (population, row) pairs; country names are copied only for the winners
+    const std::size_t rows = matrix.rows();
+    const int team = context_.withThreads(numThreads).teamSize(rows);
+    auto top = TopN::select<long long>(rows, n, team, [&](std::size_t i, long long& value) {
+        if (yearIndex >= matrix.rowLength(i)) return false;
+        value = yearValues[i];
+        return true;
+    });
+
+    std::vector<std::pair<std::string, long long>> out;
+    out.reserve(top.size());
+    for (const auto& entry : top) out.emplace_back(model_->countryNames()[entry.index], entry.value);
+    return out;
 }
 
-// Parallel helpers removed: parallel code is inlined in the numThreads>1 branches.
-
 std::vector<long long> PopulationModelService::populationOverYearsForCountry(const std::string& country, int startYear, int endYear, int numThreads) const {
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        // per-country over-years is small; run serially even when numThreads>1
-        (void)country; (void)startYear; (void)endYear;
-        // fall through to serial implementation below
-    }
-    const PopulationRow* row = model_->getByCountry(country);
+    // Per-country over-years is small; it always runs on the calling thread
+    (void)numThreads;
+    const std::optional<PopulationRow> row = model_->getByCountry(country);
     if (!row) return {};
     const auto& yearMap = model_->yearToIndex();
     auto itStart = yearMap.find(startYear);
@@ -242,8 +218,15 @@ std::vector<long long> PopulationModelService::populationOverYearsForCountry(con
     std::size_t startIndex = static_cast<std::size_t>(itStart->second);
     std::size_t endIndex = static_cast<std::size_t>(itEnd->second);
     if (startIndex >= row->yearCount() || endIndex >= row->yearCount() || startIndex > endIndex) return {};
-    std::vector<long long> populations;
-    for (std::size_t i = startIndex; i <= endIndex; ++i) populations.push_back(row->getPopulationForYear(i));
+    // Copy the year range in one go; the row is contiguous in the default row-major layout
+    const PopulationSpan values = row->yearPopulation();
+    if (values.contiguous()) return std::vector<long long>(values.data + startIndex, values.data + endIndex + 1);
+    std::vector<long long> populations(endIndex - startIndex + 1);
+    for (std::size_t i = startIndex; i <= endIndex; ++i) populations[i - startIndex] = values[i];
     return populations;
 }
 
+PopulationRange PopulationModelService::populationRangeForCountry(const std::string& country, int startYear, int endYear) const {
+    return model_->rangeForCountry(country, startYear, endYear);
+}
+
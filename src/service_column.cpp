@@ -9,22 +9,28 @@
  * 
  * Key Optimizations:
  * - Direct indexing for O(1) country-year access
+ * - Year columns read straight from the aligned PopulationMatrix buffer
  * - Contiguous memory access patterns for better cache performance
  * - OpenMP parallel reductions over cache-friendly data layout
- * - Per-thread min-heap optimization for top-N operations
+ * - Runtime-dispatched AVX2/AVX-512 kernels for unit-stride year columns
+ * - Per-thread bounded top-N buffers over (value, row) pairs
  */
 
 #include "../interface/service.hpp"
 #include "../interface/populationModelColumn.hpp"
+#include "../interface/population_matrix.hpp"
+#include "../interface/simd_reduce.hpp"
+#include "../interface/top_n_engine.hpp"
+#include "../interface/parallel_region.hpp"
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
 #include <chrono>
-#include <queue>
 #include <functional>
-#include <omp.h>
 
-PopulationModelColumnService::PopulationModelColumnService(PopulationModelColumn* m) : model_(m) {}
+PopulationModelColumnService::PopulationModelColumnService(PopulationModelColumn* m, ExecutionContext context)
+    : model_(m), context_(context) {}
 PopulationModelColumnService::~PopulationModelColumnService() = default;
 
 std::string PopulationModelColumnService::getImplementationName() const {
@@ -37,25 +43,20 @@ long long PopulationModelColumnService::sumPopulationForYear(int year, int numTh
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
+    // One year column of the matrix: unit stride in the default column-major layout
+    const PopulationSpan yearValues = model_->matrix().column(yearIndex);
     
-    long long total = 0;
     std::size_t columns = model_->columnCount(); //size_t - 0-n unsigned int meaning positive number
+    const ExecutionContext context = context_.withThreads(numThreads);
     
-    if (numThreads > 1) {
-        // Parallel reduction over contiguous memory for optimal cache usage
-        omp_set_num_threads(numThreads);
-#pragma omp parallel for reduction(+:total)
-        for (std::size_t i = 0; i < columns; ++i) {
-            total += model_->getPopulationForCountryYear(i, yearIndex);
-        }
-        return total;
+    if (yearValues.contiguous()) {
+        // Vectorized kernel, one contiguous chunk per thread
+        return SimdReduce::parallelSum(yearValues.data, columns, context.teamSize(columns));
     }
     
-    // Serial version for comparison - same access pattern
-    for (std::size_t i = 0; i < columns; ++i) {
-        total += model_->getPopulationForCountryYear(i, yearIndex);
-    }
-    return total;
+    return Parallel::reduce(context, columns, 0LL,
+        [&](std::size_t i, long long& total) { total += yearValues[i]; },
+        [](long long& into, long long from) { into += from; });
 }
 
 double PopulationModelColumnService::averagePopulationForYear(int year, int numThreads) const {
@@ -64,23 +65,19 @@ double PopulationModelColumnService::averagePopulationForYear(int year, int numT
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0.0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
+    // One year column of the matrix: unit stride in the default column-major layout
+    const PopulationSpan yearValues = model_->matrix().column(yearIndex);
     
-    long long total = 0;
     std::size_t columns = model_->columnCount();
+    const ExecutionContext context = context_.withThreads(numThreads);
     
-    if (numThreads > 1) {
-        // Parallel reduction with same pattern as sum for consistency
-        omp_set_num_threads(numThreads);
-#pragma omp parallel for reduction(+:total)
-        for (std::size_t i = 0; i < columns; ++i) {
-            total += model_->getPopulationForCountryYear(i, yearIndex);
-        }
-        return columns > 0 ? static_cast<double>(total) / static_cast<double>(columns) : 0.0;
-    }
-    
-    // Serial calculation
-    for (std::size_t i = 0; i < columns; ++i) {
-        total += model_->getPopulationForCountryYear(i, yearIndex);
+    long long total = 0;
+    if (yearValues.contiguous()) {
+        total = SimdReduce::parallelSum(yearValues.data, columns, context.teamSize(columns));
+    } else {
+        total = Parallel::reduce(context, columns, 0LL,
+            [&](std::size_t i, long long& local) { local += yearValues[i]; },
+            [](long long& into, long long from) { into += from; });
     }
     return columns > 0 ? static_cast<double>(total) / static_cast<double>(columns) : 0.0;
 }
@@ -90,21 +87,18 @@ long long PopulationModelColumnService::maxPopulationForYear(int year, int numTh
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
+    // One year column of the matrix: unit stride in the default column-major layout
+    const PopulationSpan yearValues = model_->matrix().column(yearIndex);
     std::size_t columns = model_->columnCount();
+    const ExecutionContext context = context_.withThreads(numThreads);
     long long global_max = std::numeric_limits<long long>::min();
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-#pragma omp parallel
-        {
-            long long local_max = std::numeric_limits<long long>::min();
-#pragma omp for nowait
-            for (std::size_t i = 0; i < columns; ++i) local_max = std::max(local_max, model_->getPopulationForCountryYear(i, yearIndex));
-#pragma omp critical
-            { global_max = std::max(global_max, local_max); }
-        }
-        return global_max == std::numeric_limits<long long>::min() ? 0 : global_max;
+    if (yearValues.contiguous()) {
+        global_max = SimdReduce::parallelMax(yearValues.data, columns, context.teamSize(columns));
+        return global_max == SimdReduce::MAX_IDENTITY ? 0 : global_max;
     }
-    for (std::size_t i = 0; i < columns; ++i) global_max = std::max(global_max, model_->getPopulationForCountryYear(i, yearIndex));
+    global_max = Parallel::reduce(context, columns, global_max,
+        [&](std::size_t i, long long& local) { local = std::max(local, yearValues[i]); },
+        [](long long& into, long long from) { into = std::max(into, from); });
     return global_max == std::numeric_limits<long long>::min() ? 0 : global_max;
 }
 
@@ -113,24 +107,83 @@ long long PopulationModelColumnService::minPopulationForYear(int year, int numTh
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return 0;
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
+    // One year column of the matrix: unit stride in the default column-major layout
+    const PopulationSpan yearValues = model_->matrix().column(yearIndex);
     std::size_t columns = model_->columnCount();
+    const ExecutionContext context = context_.withThreads(numThreads);
     long long global_min = std::numeric_limits<long long>::max();
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-#pragma omp parallel
-        {
-            long long local_min = std::numeric_limits<long long>::max();
-#pragma omp for nowait
-            for (std::size_t i = 0; i < columns; ++i) local_min = std::min(local_min, model_->getPopulationForCountryYear(i, yearIndex));
-#pragma omp critical
-            { global_min = std::min(global_min, local_min); }
-        }
-        return global_min == std::numeric_limits<long long>::max() ? 0 : global_min;
+    if (yearValues.contiguous()) {
+        global_min = SimdReduce::parallelMin(yearValues.data, columns, context.teamSize(columns));
+        return global_min == SimdReduce::MIN_IDENTITY ? 0 : global_min;
     }
-    for (std::size_t i = 0; i < columns; ++i) global_min = std::min(global_min, model_->getPopulationForCountryYear(i, yearIndex));
+    global_min = Parallel::reduce(context, columns, global_min,
+        [&](std::size_t i, long long& local) { local = std::min(local, yearValues[i]); },
+        [](long long& into, long long from) { into = std::min(into, from); });
     return global_min == std::numeric_limits<long long>::max() ? 0 : global_min;
 }
 
+YearSummary PopulationModelColumnService::yearSummary(int year, int numThreads) const {
+    YearSummary summary;
+    const auto& yearMap = model_->yearToIndex();
+    auto it = yearMap.find(year);
+    if (it == yearMap.end()) return summary;
+    std::size_t yearIndex = static_cast<std::size_t>(it->second);
+    const PopulationMatrixView matrix = model_->matrix();
+    const PopulationSpan yearValues = matrix.column(yearIndex);
+    const std::size_t rows = matrix.rows();
+
+    // Fused sum/min/max/argmin/argmax per thread, merged in thread order
+    summary = Parallel::reduce(context_.withThreads(numThreads), rows, summary,
+        [&](std::size_t i, YearSummary& local) { local.add(yearValues[i], i); },
+        [](YearSummary& into, const YearSummary& from) { into.merge(from); });
+
+    summary.finalize();
+    if (summary.count > 0) {
+        summary.minCountry = model_->countryNames()[summary.argmin];
+        summary.maxCountry = model_->countryNames()[summary.argmax];
+    }
+    return summary;
+}
+
+std::vector<YearSummary> PopulationModelColumnService::yearSummaries(const std::vector<int>& years, int numThreads) const {
+    const std::size_t yearCount = years.size();
+    std::vector<YearSummary> summaries(yearCount);
+    // Resolve the requested years to matrix columns once; unknown years stay empty
+    constexpr std::size_t NO_YEAR = std::numeric_limits<std::size_t>::max();
+    const auto& yearMap = model_->yearToIndex();
+    std::vector<std::size_t> yearIndices(yearCount, NO_YEAR);
+    for (std::size_t j = 0; j < yearCount; ++j) {
+        auto it = yearMap.find(years[j]);
+        if (it != yearMap.end()) yearIndices[j] = static_cast<std::size_t>(it->second);
+    }
+    const PopulationMatrixView matrix = model_->matrix();
+    const std::size_t rows = matrix.rows();
+
+    // Each requested year is one contiguous column, summarized by a single thread
+    auto summarizeYear = [&](std::size_t j) {
+        if (yearIndices[j] == NO_YEAR) return;
+        const PopulationSpan yearValues = matrix.column(yearIndices[j]);
+        YearSummary& summary = summaries[j];
+        for (std::size_t i = 0; i < rows; ++i) summary.add(yearValues[i], i);
+    };
+
+    // The team is sized by the total number of values read, at most one thread per year
+    ExecutionContext context = context_.withThreads(numThreads);
+    const int team = context.teamSize(rows * yearCount);
+    context.threads = std::min(team, static_cast<int>(std::max<std::size_t>(yearCount, 1)));
+    context.grain = 0;
+    Parallel::forEach(context, yearCount, summarizeYear);
+
+    const auto& names = model_->countryNames();
+    for (auto& summary : summaries) {
+        summary.finalize();
+        if (summary.count == 0) continue;
+        summary.minCountry = names[summary.argmin];
+        summary.maxCountry = names[summary.argmax];
+    }
+    return summaries;
+}
+
 long long PopulationModelColumnService::populationForCountryInYear(const std::string& country, int year, int numThreads) const {
     (void)numThreads;
     const auto& yearMap = model_->yearToIndex();
@@ -148,53 +201,20 @@ std::vector<std::pair<std::string, long long>> PopulationModelColumnService::top
     auto it = yearMap.find(year);
     if (it == yearMap.end()) return {};
     std::size_t yearIndex = static_cast<std::size_t>(it->second);
-    std::size_t columns = model_->columnCount();
-
-    if (numThreads > 1) {
-        omp_set_num_threads(numThreads);
-        using HeapElem = std::pair<long long, std::string>;
-        using MinHeap = std::priority_queue<HeapElem, std::vector<HeapElem>, std::greater<HeapElem>>;
-
-        int threads = omp_get_max_threads();
-        std::vector<MinHeap> localHeaps(static_cast<std::size_t>(threads));
-
-#pragma omp parallel
-        {
-            int tid = omp_get_thread_num();
-            MinHeap &heap = localHeaps[static_cast<std::size_t>(tid)];
-#pragma omp for nowait
-            for (std::size_t i = 0; i < columns; ++i) {
-                long long val = model_->getPopulationForCountryYear(i, yearIndex);
-                HeapElem e{val, model_->countryNames()[i]};
-                if (heap.size() < n) heap.push(e);
-                else if (e > heap.top()) { heap.pop(); heap.push(e); }
-            }
-        }
-
-        MinHeap finalHeap;
-        for (auto &h : localHeaps) {
-            while (!h.empty()) {
-                auto e = h.top(); h.pop();
-                if (finalHeap.size() < n) finalHeap.push(e);
-                else if (e > finalHeap.top()) { finalHeap.pop(); finalHeap.push(e); }
-            }
-        }
-
-        std::vector<std::pair<std::string,long long>> out;
-        out.reserve(finalHeap.size());
-        while (!finalHeap.empty()) {
-            auto p = finalHeap.top(); finalHeap.pop();
-            out.emplace_back(p.second, p.first);
-        }
-        std::reverse(out.begin(), out.end());
-        return out;
-    }
-
-    std::vector<std::pair<std::string,long long>> out;
-    out.reserve(columns);
-    for (std::size_t i = 0; i < columns; ++i) out.emplace_back(model_->countryNames()[i], model_->getPopulationForCountryYear(i, yearIndex));
-    std::sort(out.begin(), out.end(), [](const auto &a, const auto &b){ return a.second > b.second; });
-    if (out.size() > n) out.resize(n);
+    // One year column of the matrix: unit stride in the default column-major layout
+    const PopulationSpan yearValues = model_->matrix().column(yearIndex);
+
+    // Select on (population, row) pairs; country names are copied only for the winners
+    const std::size_t columns = model_->columnCount();
+    const int team = context_.withThreads(numThreads).teamSize(columns);
+    auto top = TopN::select<long long>(columns, n, team, [&](std::size_t i, long long& value) {
+        value = yearValues[i];
+        return true;
+    });
+
+    std::vector<std::pair<std::string, long long>> out;
+    out.reserve(top.size());
+    for (const auto& entry : top) out.emplace_back(model_->countryNames()[entry.index], entry.value);
     return out;
 }
 
@@ -208,7 +228,14 @@ std::vector<long long> PopulationModelColumnService::populationOverYearsForCount
     std::size_t endIndex = static_cast<std::size_t>(itEnd->second);
     int cidx = model_->countryNameIndex(country);
     if (cidx < 0) return {};
-    std::vector<long long> res;
-    for (std::size_t y = startIndex; y <= endIndex; ++y) res.push_back(model_->getPopulationForCountryYear(static_cast<std::size_t>(cidx), y));
+    if (startIndex > endIndex) return {};
+    // One strided walk along the country's row of the matrix into a presized result
+    const PopulationSpan values = model_->matrix().row(static_cast<std::size_t>(cidx));
+    std::vector<long long> res(endIndex - startIndex + 1);
+    for (std::size_t y = startIndex; y <= endIndex; ++y) res[y - startIndex] = y < values.size ? values[y] : 0;
     return res;
 }
+
+PopulationRange PopulationModelColumnService::populationRangeForCountry(const std::string& country, int startYear, int endYear) const {
+    return model_->rangeForCountry(country, startYear, endYear);
+}
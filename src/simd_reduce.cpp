@@ -0,0 +1,458 @@
+/**
+ * @file simd_reduce.cpp
+ * @brief Runtime-dispatched reduction kernels over long long columns
+ *
+ * The x86 kernels are compiled with function-level target attributes so the
+ * rest of the project keeps its baseline compiler flags; the dispatcher only
+ * installs them after checking the CPU at runtime. AVX2 has no 64-bit integer
+ * min/max, so those use compare + blend; AVX-512 uses native vpminsq/vpmaxsq
+ * and masked loads for the tail.
+ */
+
+#include "../interface/simd_reduce.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <omp.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_REDUCE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace SimdReduce {
+    namespace {
+        // Unsigned accumulation gives defined wrap-around on overflow
+        using Acc = unsigned long long;
+
+        struct KernelTable {
+            long long (*sum)(const long long*, std::size_t);
+            long long (*min)(const long long*, std::size_t);
+            long long (*max)(const long long*, std::size_t);
+            std::size_t (*countGreater)(const long long*, std::size_t, long long);
+            Summary (*summarize)(const long long*, std::size_t);
+        };
+
+        // === Portable fallback ===
+
+        long long sumScalar(const long long* data, std::size_t n) {
+            Acc total = 0;
+            for (std::size_t i = 0; i < n; ++i) total += static_cast<Acc>(data[i]);
+            return static_cast<long long>(total);
+        }
+
+        long long minScalar(const long long* data, std::size_t n) {
+            long long m = MIN_IDENTITY;
+            for (std::size_t i = 0; i < n; ++i) m = std::min(m, data[i]);
+            return m;
+        }
+
+        long long maxScalar(const long long* data, std::size_t n) {
+            long long m = MAX_IDENTITY;
+            for (std::size_t i = 0; i < n; ++i) m = std::max(m, data[i]);
+            return m;
+        }
+
+        std::size_t countGreaterScalar(const long long* data, std::size_t n, long long threshold) {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; ++i) count += data[i] > threshold ? 1 : 0;
+            return count;
+        }
+
+        Summary summarizeScalar(const long long* data, std::size_t n) {
+            Summary s;
+            Acc total = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                total += static_cast<Acc>(data[i]);
+                s.min = std::min(s.min, data[i]);
+                s.max = std::max(s.max, data[i]);
+            }
+            s.sum = static_cast<long long>(total);
+            s.count = n;
+            return s;
+        }
+
+        const KernelTable scalarKernels{sumScalar, minScalar, maxScalar, countGreaterScalar, summarizeScalar};
+
+#if defined(SIMD_REDUCE_X86)
+        // === AVX2: 4 x int64 lanes ===
+
+        __attribute__((target("avx2")))
+        inline __m256i load4(const long long* p) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i min4(__m256i a, __m256i b) {
+            return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i max4(__m256i a, __m256i b) {
+            return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+        }
+
+        __attribute__((target("avx2")))
+        inline void store4(__m256i v, long long out[4]) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+        }
+
+        __attribute__((target("avx2")))
+        long long sumAVX2(const long long* data, std::size_t n) {
+            // Two independent accumulators hide the add latency
+            __m256i acc0 = _mm256_setzero_si256();
+            __m256i acc1 = _mm256_setzero_si256();
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                acc0 = _mm256_add_epi64(acc0, load4(data + i));
+                acc1 = _mm256_add_epi64(acc1, load4(data + i + 4));
+            }
+            long long lanes[4];
+            store4(_mm256_add_epi64(acc0, acc1), lanes);
+            Acc total = 0;
+            for (long long v : lanes) total += static_cast<Acc>(v);
+            for (; i < n; ++i) total += static_cast<Acc>(data[i]);
+            return static_cast<long long>(total);
+        }
+
+        __attribute__((target("avx2")))
+        long long minAVX2(const long long* data, std::size_t n) {
+            __m256i m = _mm256_set1_epi64x(MIN_IDENTITY);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) m = min4(m, load4(data + i));
+            long long lanes[4];
+            store4(m, lanes);
+            long long result = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+            for (; i < n; ++i) result = std::min(result, data[i]);
+            return result;
+        }
+
+        __attribute__((target("avx2")))
+        long long maxAVX2(const long long* data, std::size_t n) {
+            __m256i m = _mm256_set1_epi64x(MAX_IDENTITY);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) m = max4(m, load4(data + i));
+            long long lanes[4];
+            store4(m, lanes);
+            long long result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+            for (; i < n; ++i) result = std::max(result, data[i]);
+            return result;
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t countGreaterAVX2(const long long* data, std::size_t n, long long threshold) {
+            // Matching lanes compare to -1, so subtracting the mask counts them
+            const __m256i t = _mm256_set1_epi64x(threshold);
+            __m256i acc = _mm256_setzero_si256();
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) acc = _mm256_sub_epi64(acc, _mm256_cmpgt_epi64(load4(data + i), t));
+            long long lanes[4];
+            store4(acc, lanes);
+            std::size_t count = static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+            for (; i < n; ++i) count += data[i] > threshold ? 1 : 0;
+            return count;
+        }
+
+        __attribute__((target("avx2")))
+        Summary summarizeAVX2(const long long* data, std::size_t n) {
+            __m256i acc = _mm256_setzero_si256();
+            __m256i mn = _mm256_set1_epi64x(MIN_IDENTITY);
+            __m256i mx = _mm256_set1_epi64x(MAX_IDENTITY);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256i v = load4(data + i);
+                acc = _mm256_add_epi64(acc, v);
+                mn = min4(mn, v);
+                mx = max4(mx, v);
+            }
+            long long sums[4], mins[4], maxs[4];
+            store4(acc, sums);
+            store4(mn, mins);
+            store4(mx, maxs);
+            Summary s;
+            Acc total = 0;
+            for (int k = 0; k < 4; ++k) {
+                total += static_cast<Acc>(sums[k]);
+                s.min = std::min(s.min, mins[k]);
+                s.max = std::max(s.max, maxs[k]);
+            }
+            for (; i < n; ++i) {
+                total += static_cast<Acc>(data[i]);
+                s.min = std::min(s.min, data[i]);
+                s.max = std::max(s.max, data[i]);
+            }
+            s.sum = static_cast<long long>(total);
+            s.count = n;
+            return s;
+        }
+
+        const KernelTable avx2Kernels{sumAVX2, minAVX2, maxAVX2, countGreaterAVX2, summarizeAVX2};
+
+        // === AVX-512: 8 x int64 lanes, masked tail loads ===
+
+        __attribute__((target("avx512f")))
+        inline __mmask8 tailMask(std::size_t remaining) {
+            return static_cast<__mmask8>((1u << remaining) - 1u);
+        }
+
+        // GCC 12's unmasked vpminsq/vpmaxsq and reduce intrinsics start from an
+        // undefined vector and trip -Wuninitialized in optimized builds, so min/max
+        // use the all-lanes masked form and horizontal reductions go through memory
+
+        __attribute__((target("avx512f")))
+        inline __m512i min8(__m512i a, __m512i b) { return _mm512_mask_min_epi64(a, 0xFF, a, b); }
+
+        __attribute__((target("avx512f")))
+        inline __m512i max8(__m512i a, __m512i b) { return _mm512_mask_max_epi64(a, 0xFF, a, b); }
+
+        __attribute__((target("avx512f")))
+        inline void store8(__m512i v, long long out[8]) { _mm512_storeu_si512(out, v); }
+
+        __attribute__((target("avx512f")))
+        inline long long hsum8(__m512i v) {
+            long long lanes[8];
+            store8(v, lanes);
+            Acc total = 0;
+            for (long long x : lanes) total += static_cast<Acc>(x);
+            return static_cast<long long>(total);
+        }
+
+        __attribute__((target("avx512f")))
+        inline long long hmin8(__m512i v) {
+            long long lanes[8];
+            store8(v, lanes);
+            return *std::min_element(lanes, lanes + 8);
+        }
+
+        __attribute__((target("avx512f")))
+        inline long long hmax8(__m512i v) {
+            long long lanes[8];
+            store8(v, lanes);
+            return *std::max_element(lanes, lanes + 8);
+        }
+
+        __attribute__((target("avx512f")))
+        long long sumAVX512(const long long* data, std::size_t n) {
+            __m512i acc0 = _mm512_setzero_si512();
+            __m512i acc1 = _mm512_setzero_si512();
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                acc0 = _mm512_add_epi64(acc0, _mm512_loadu_si512(data + i));
+                acc1 = _mm512_add_epi64(acc1, _mm512_loadu_si512(data + i + 8));
+            }
+            for (; i + 8 <= n; i += 8) acc0 = _mm512_add_epi64(acc0, _mm512_loadu_si512(data + i));
+            if (i < n) acc1 = _mm512_add_epi64(acc1, _mm512_maskz_loadu_epi64(tailMask(n - i), data + i));
+            return hsum8(_mm512_add_epi64(acc0, acc1));
+        }
+
+        __attribute__((target("avx512f")))
+        long long minAVX512(const long long* data, std::size_t n) {
+            const __m512i identity = _mm512_set1_epi64(MIN_IDENTITY);
+            __m512i m = identity;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) m = min8(m, _mm512_loadu_si512(data + i));
+            if (i < n) m = min8(m, _mm512_mask_loadu_epi64(identity, tailMask(n - i), data + i));
+            return hmin8(m);
+        }
+
+        __attribute__((target("avx512f")))
+        long long maxAVX512(const long long* data, std::size_t n) {
+            const __m512i identity = _mm512_set1_epi64(MAX_IDENTITY);
+            __m512i m = identity;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) m = max8(m, _mm512_loadu_si512(data + i));
+            if (i < n) m = max8(m, _mm512_mask_loadu_epi64(identity, tailMask(n - i), data + i));
+            return hmax8(m);
+        }
+
+        __attribute__((target("avx512f,popcnt")))
+        std::size_t countGreaterAVX512(const long long* data, std::size_t n, long long threshold) {
+            const __m512i t = _mm512_set1_epi64(threshold);
+            std::size_t count = 0;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                count += static_cast<std::size_t>(_mm_popcnt_u32(_mm512_cmpgt_epi64_mask(_mm512_loadu_si512(data + i), t)));
+            }
+            if (i < n) {
+                __mmask8 valid = tailMask(n - i);
+                __m512i v = _mm512_maskz_loadu_epi64(valid, data + i);
+                count += static_cast<std::size_t>(_mm_popcnt_u32(_mm512_mask_cmpgt_epi64_mask(valid, v, t)));
+            }
+            return count;
+        }
+
+        __attribute__((target("avx512f")))
+        Summary summarizeAVX512(const long long* data, std::size_t n) {
+            const __m512i minIdentity = _mm512_set1_epi64(MIN_IDENTITY);
+            const __m512i maxIdentity = _mm512_set1_epi64(MAX_IDENTITY);
+            __m512i acc = _mm512_setzero_si512();
+            __m512i mn = minIdentity;
+            __m512i mx = maxIdentity;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m512i v = _mm512_loadu_si512(data + i);
+                acc = _mm512_add_epi64(acc, v);
+                mn = min8(mn, v);
+                mx = max8(mx, v);
+            }
+            if (i < n) {
+                __mmask8 valid = tailMask(n - i);
+                acc = _mm512_add_epi64(acc, _mm512_maskz_loadu_epi64(valid, data + i));
+                mn = min8(mn, _mm512_mask_loadu_epi64(minIdentity, valid, data + i));
+                mx = max8(mx, _mm512_mask_loadu_epi64(maxIdentity, valid, data + i));
+            }
+            Summary s;
+            s.sum = hsum8(acc);
+            s.min = hmin8(mn);
+            s.max = hmax8(mx);
+            s.count = n;
+            return s;
+        }
+
+        const KernelTable avx512Kernels{sumAVX512, minAVX512, maxAVX512, countGreaterAVX512, summarizeAVX512};
+#endif
+
+        const KernelTable& kernelTable(Kernel kernel) {
+            switch (kernel) {
+#if defined(SIMD_REDUCE_X86)
+                case Kernel::AVX512: return avx512Kernels;
+                case Kernel::AVX2: return avx2Kernels;
+#endif
+                default: return scalarKernels;
+            }
+        }
+
+        std::atomic<Kernel>& currentKernel() {
+            static std::atomic<Kernel> kernel{detectKernel()};
+            return kernel;
+        }
+
+        const KernelTable& active() { return kernelTable(activeKernel()); }
+
+        /// This thread's contiguous share [begin, end) of n items
+        void threadChunk(std::size_t n, std::size_t& begin, std::size_t& end) {
+            const std::size_t t = static_cast<std::size_t>(omp_get_thread_num());
+            const std::size_t threads = static_cast<std::size_t>(omp_get_num_threads());
+            begin = n * t / threads;
+            end = n * (t + 1) / threads;
+        }
+    }
+
+    bool isSupported(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::Scalar: return true;
+#if defined(SIMD_REDUCE_X86)
+            case Kernel::AVX2: return __builtin_cpu_supports("avx2");
+            case Kernel::AVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+#endif
+            default: return false;
+        }
+    }
+
+    Kernel detectKernel() noexcept {
+        if (isSupported(Kernel::AVX512)) return Kernel::AVX512;
+        if (isSupported(Kernel::AVX2)) return Kernel::AVX2;
+        return Kernel::Scalar;
+    }
+
+    Kernel activeKernel() noexcept { return currentKernel().load(std::memory_order_relaxed); }
+
+    bool selectKernel(Kernel kernel) noexcept {
+        if (!isSupported(kernel)) return false;
+        currentKernel().store(kernel, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* kernelName(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::AVX512: return "AVX-512";
+            case Kernel::AVX2: return "AVX2";
+            default: return "Scalar";
+        }
+    }
+
+    long long sum(const long long* data, std::size_t n) noexcept { return active().sum(data, n); }
+    long long min(const long long* data, std::size_t n) noexcept { return active().min(data, n); }
+    long long max(const long long* data, std::size_t n) noexcept { return active().max(data, n); }
+
+    std::size_t countGreater(const long long* data, std::size_t n, long long threshold) noexcept {
+        return active().countGreater(data, n, threshold);
+    }
+
+    Summary summarize(const long long* data, std::size_t n) noexcept { return active().summarize(data, n); }
+
+    long long parallelSum(const long long* data, std::size_t n, int numThreads) {
+        if (numThreads <= 1) return sum(data, n);
+        const KernelTable& kernels = active();
+        Acc total = 0;
+#pragma omp parallel num_threads(numThreads) reduction(+:total)
+        {
+            std::size_t begin, end;
+            threadChunk(n, begin, end);
+            total += static_cast<Acc>(kernels.sum(data + begin, end - begin));
+        }
+        return static_cast<long long>(total);
+    }
+
+    long long parallelMin(const long long* data, std::size_t n, int numThreads) {
+        if (numThreads <= 1) return min(data, n);
+        const KernelTable& kernels = active();
+        long long result = MIN_IDENTITY;
+#pragma omp parallel num_threads(numThreads) reduction(min:result)
+        {
+            std::size_t begin, end;
+            threadChunk(n, begin, end);
+            result = std::min(result, kernels.min(data + begin, end - begin));
+        }
+        return result;
+    }
+
+    long long parallelMax(const long long* data, std::size_t n, int numThreads) {
+        if (numThreads <= 1) return max(data, n);
+        const KernelTable& kernels = active();
+        long long result = MAX_IDENTITY;
+#pragma omp parallel num_threads(numThreads) reduction(max:result)
+        {
+            std::size_t begin, end;
+            threadChunk(n, begin, end);
+            result = std::max(result, kernels.max(data + begin, end - begin));
+        }
+        return result;
+    }
+
+    std::size_t parallelCountGreater(const long long* data, std::size_t n, long long threshold, int numThreads) {
+        if (numThreads <= 1) return countGreater(data, n, threshold);
+        const KernelTable& kernels = active();
+        std::size_t count = 0;
+#pragma omp parallel num_threads(numThreads) reduction(+:count)
+        {
+            std::size_t begin, end;
+            threadChunk(n, begin, end);
+            count += kernels.countGreater(data + begin, end - begin, threshold);
+        }
+        return count;
+    }
+
+    Summary parallelSummarize(const long long* data, std::size_t n, int numThreads) {
+        if (numThreads <= 1) return summarize(data, n);
+        const KernelTable& kernels = active();
+        Acc total = 0;
+        long long mn = MIN_IDENTITY;
+        long long mx = MAX_IDENTITY;
+#pragma omp parallel num_threads(numThreads) reduction(+:total) reduction(min:mn) reduction(max:mx)
+        {
+            std::size_t begin, end;
+            threadChunk(n, begin, end);
+            Summary part = kernels.summarize(data + begin, end - begin);
+            total += static_cast<Acc>(part.sum);
+            mn = std::min(mn, part.min);
+            mx = std::max(mx, part.max);
+        }
+        Summary s;
+        s.sum = static_cast<long long>(total);
+        s.min = mn;
+        s.max = mx;
+        s.count = n;
+        return s;
+    }
+}
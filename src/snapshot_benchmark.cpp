@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <cstdlib>
+#include "../interface/fireColumnModel.hpp"
+#include "../interface/populationModelColumn.hpp"
+#include "../interface/constants.hpp"
+
+/**
+ * @file snapshot_benchmark.cpp
+ * @brief Micro-benchmark: CSV ingestion vs. memory-mapped binary snapshots
+ *
+ * Loads the fire data (FIRE_DATA_PATH or data/FireData) into a FireColumnModel
+ * and the population CSV (CSV_PATH or data/PopulationData/population.csv) into a
+ * PopulationModelColumn, writes a snapshot of each to the temp directory and
+ * times loading it back with and without checksum verification, plus the first
+ * full scan of a mapped column (which pays the page faults a verified load
+ * already took).
+ *
+ * Usage: ./OpenMP_Mini1_Project_snapshot_benchmark [threads] [repetitions]
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    double millisSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double bestMs(int repetitions, const std::function<void()>& fn) {
+        double best = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            auto start = Clock::now();
+            fn();
+            double ms = millisSince(start);
+            if (rep == 0 || ms < best) best = ms;
+        }
+        return best;
+    }
+
+    void report(const std::string& label, double ms, double csvMs) {
+        std::cout << std::setw(36) << label << std::setw(12) << std::fixed << std::setprecision(2) << ms
+                  << std::setw(11) << std::setprecision(1) << csvMs / ms << "x\n";
+    }
+
+    /// Save, then time snapshot loads of one model type
+    template <typename Model, typename Scan>
+    void benchmarkModel(const std::string& name, const Model& source, double csvMs, const std::string& path,
+                        int repetitions, Scan scan) {
+        auto start = Clock::now();
+        source.saveSnapshot(path);
+        double saveMs = millisSince(start);
+        double megabytes = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+        std::cout << "\n" << name << ": snapshot " << std::fixed << std::setprecision(1) << megabytes << " MB\n";
+        std::cout << std::setw(36) << "Step" << std::setw(12) << "Time (ms)" << std::setw(11) << "vs CSV" << "\n";
+        std::cout << std::string(59, '-') << "\n";
+        report("Parse CSV", csvMs, csvMs);
+        report("Write snapshot", saveMs, csvMs);
+        // Loaded models are kept until the end so their teardown is not timed
+        std::vector<Model> loaded(static_cast<std::size_t>(2 * repetitions));
+        std::size_t next = 0;
+        report("Load snapshot (verify checksums)", bestMs(repetitions, [&] { loaded[next++].loadSnapshot(path, true); }), csvMs);
+        report("Load snapshot (trust)", bestMs(repetitions, [&] { loaded[next++].loadSnapshot(path, false); }), csvMs);
+
+        Model mapped;
+        mapped.loadSnapshot(path, false);
+        long long checksum = 0;
+        report("First scan of a mapped column", bestMs(1, [&] { checksum = scan(mapped); }), csvMs);
+        if (checksum != scan(source)) std::cout << "  WARNING: mapped column differs from the CSV model!\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::max(1, std::atoi(argv[1])) : Config::DEFAULT_PARALLEL_THREADS;
+    int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : Config::DEFAULT_REPETITIONS;
+
+    const char* fireEnv = std::getenv("FIRE_DATA_PATH");
+    const char* csvEnv = std::getenv("CSV_PATH");
+    const std::string firePath = fireEnv ? fireEnv : "data/FireData";
+    const std::string csvPath = csvEnv ? csvEnv : "data/PopulationData/population.csv";
+    const auto tempDir = std::filesystem::temp_directory_path();
+
+    std::cout << "Snapshot micro-benchmark: " << threads << " load threads, best of " << repetitions << " runs\n";
+
+    try {
+        if (std::filesystem::is_directory(firePath)) {
+            FireColumnModel fire;
+            std::streambuf* stdoutBuffer = std::cout.rdbuf(nullptr);   // silence loader progress
+            auto start = Clock::now();
+            fire.readFromDirectory(firePath, threads);
+            double csvMs = millisSince(start);
+            std::cout.rdbuf(stdoutBuffer);
+            const std::string path = (tempDir / "openmp_mini1_fire_columns.snap").string();
+            benchmarkModel("Fire columns (" + std::to_string(fire.measurementCount()) + " measurements)",
+                           fire, csvMs, path, repetitions, [](const FireColumnModel& m) {
+                               long long sum = 0;
+                               for (int aqi : m.aqis()) sum += aqi;
+                               return sum;
+                           });
+            std::filesystem::remove(path);
+        } else {
+            std::cout << "\nNo fire data at " << firePath << "; skipping\n";
+        }
+
+        PopulationModelColumn population;
+        auto start = Clock::now();
+        population.readFromCSV(csvPath, threads);
+        double csvMs = millisSince(start);
+        if (population.columnCount() == 0) {
+            std::cerr << "No population data loaded from " << csvPath << "\n";
+            return 1;
+        }
+        const std::string path = (tempDir / "openmp_mini1_population_columns.snap").string();
+        benchmarkModel("Population columns (" + std::to_string(population.columnCount()) + " countries x " +
+                           std::to_string(population.yearCount()) + " years)",
+                       population, csvMs, path, repetitions, [](const PopulationModelColumn& m) {
+                           long long sum = 0;
+                           const PopulationMatrixView matrix = m.matrix();
+                           for (std::size_t c = 0; c < matrix.cols(); ++c) {
+                               const PopulationSpan column = matrix.column(c);
+                               for (std::size_t r = 0; r < column.size; ++r) sum += column[r];
+                           }
+                           return sum;
+                       });
+        std::filesystem::remove(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file spatial_index.cpp
+ * @brief GeoBox, GeoRegion and SpatialIndex implementation
+ */
+
+#include "../interface/spatial_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double RADIANS_PER_DEGREE = PI / 180.0;
+}
+
+bool GeoBox::contains(double latitude, double longitude) const noexcept {
+    if (!(latitude >= minLatitude && latitude <= maxLatitude)) return false;
+    if (wrapsAntimeridian()) return longitude >= minLongitude || longitude <= maxLongitude;
+    return longitude >= minLongitude && longitude <= maxLongitude;
+}
+
+double Geo::distanceKm(double latitude1, double longitude1, double latitude2, double longitude2) noexcept {
+    const double dLat = (latitude2 - latitude1) * RADIANS_PER_DEGREE;
+    const double dLon = (longitude2 - longitude1) * RADIANS_PER_DEGREE;
+    const double sinLat = std::sin(dLat / 2.0);
+    const double sinLon = std::sin(dLon / 2.0);
+    const double a = sinLat * sinLat +
+                     std::cos(latitude1 * RADIANS_PER_DEGREE) * std::cos(latitude2 * RADIANS_PER_DEGREE) * sinLon * sinLon;
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+GeoRegion GeoRegion::box(const GeoBox& box) noexcept {
+    GeoRegion region;
+    region._bounds = box;
+    return region;
+}
+
+GeoRegion GeoRegion::circle(double latitude, double longitude, double radiusKm) noexcept {
+    GeoRegion region;
+    region._circle = true;
+    region._latitude = latitude;
+    region._longitude = longitude;
+    region._radius_km = radiusKm;
+    if (!(radiusKm >= 0.0)) {
+        region._bounds = GeoBox{1.0, -1.0, 0.0, 0.0};   // empty
+        return region;
+    }
+
+    // Angular radius; the longitude half-width is widest at the circle's latitude
+    const double angle = radiusKm / Geo::EARTH_RADIUS_KM;
+    const double dLat = angle / RADIANS_PER_DEGREE;
+    GeoBox& bounds = region._bounds;
+    bounds.minLatitude = std::max(-90.0, latitude - dLat);
+    bounds.maxLatitude = std::min(90.0, latitude + dLat);
+    bounds.minLongitude = -180.0;
+    bounds.maxLongitude = 180.0;
+    const double cosLat = std::cos(latitude * RADIANS_PER_DEGREE);
+    if (latitude - dLat <= -90.0 || latitude + dLat >= 90.0 || angle >= PI / 2.0 || std::sin(angle) >= cosLat) {
+        return region;   // reaches a pole: every longitude
+    }
+    const double dLon = std::asin(std::sin(angle) / cosLat) / RADIANS_PER_DEGREE;
+    bounds.minLongitude = longitude - dLon;
+    bounds.maxLongitude = longitude + dLon;
+    if (bounds.minLongitude < -180.0) bounds.minLongitude += 360.0;
+    if (bounds.maxLongitude > 180.0) bounds.maxLongitude -= 360.0;
+    return region;
+}
+
+bool GeoRegion::contains(double latitude, double longitude) const noexcept {
+    if (!_bounds.contains(latitude, longitude)) return false;
+    return !_circle || Geo::distanceKm(_latitude, _longitude, latitude, longitude) <= _radius_km;
+}
+
+SpatialIndex::SpatialIndex(std::pmr::memory_resource* resource, double cellDegrees)
+    : _points(resource), _group_heads(resource), _unlocated(resource), _cells(resource),
+      _cell_degrees(cellDegrees > 0.0 ? cellDegrees : DEFAULT_CELL_DEGREES),
+      _rows(static_cast<std::int64_t>(std::ceil(180.0 / _cell_degrees))),
+      _columns(static_cast<std::int64_t>(std::ceil(360.0 / _cell_degrees))) {}
+
+std::int64_t SpatialIndex::rowOf(double latitude) const noexcept {
+    // Out-of-range coordinates land in the edge cells; queries clamp the same way
+    const double row = std::floor((latitude + 90.0) / _cell_degrees);
+    return static_cast<std::int64_t>(std::clamp(row, 0.0, static_cast<double>(_rows - 1)));
+}
+
+std::int64_t SpatialIndex::columnOf(double longitude) const noexcept {
+    const double column = std::floor((longitude + 180.0) / _cell_degrees);
+    return static_cast<std::int64_t>(std::clamp(column, 0.0, static_cast<double>(_columns - 1)));
+}
+
+void SpatialIndex::add(std::size_t group, double latitude, double longitude) {
+    if (group >= _group_heads.size()) _group_heads.resize(group + 1, NONE);
+    if (!std::isfinite(latitude) || !std::isfinite(longitude)) {
+        // No point to index, but the group can no longer be matched whole
+        if (group >= _unlocated.size()) _unlocated.resize(group + 1, false);
+        _unlocated[group] = true;
+        return;
+    }
+
+    // Known location: nearly every call ends here after one comparison
+    for (std::uint32_t p = _group_heads[group]; p != NONE; p = _points[p].nextInGroup) {
+        if (_points[p].latitude == latitude && _points[p].longitude == longitude) return;
+    }
+
+    const auto id = static_cast<std::uint32_t>(_points.size());
+    auto cell = _cells.try_emplace(rowOf(latitude) * _columns + columnOf(longitude), NONE).first;
+    _points.push_back(Point{latitude, longitude, static_cast<std::uint32_t>(group), _group_heads[group], cell->second});
+    _group_heads[group] = id;
+    cell->second = id;
+}
+
+void SpatialIndex::merge(const SpatialIndex& other, const std::vector<std::size_t>& groupMap) {
+    for (const Point& point : other._points) {
+        add(groupMap.empty() ? point.group : groupMap[point.group], point.latitude, point.longitude);
+    }
+    for (std::size_t group = 0; group < other._unlocated.size(); ++group) {
+        if (!other._unlocated[group]) continue;
+        const double nowhere = std::numeric_limits<double>::quiet_NaN();
+        add(groupMap.empty() ? group : groupMap[group], nowhere, nowhere);
+    }
+}
+
+std::vector<SpatialIndex::Match> SpatialIndex::query(const GeoRegion& region) const {
+    const GeoBox& bounds = region.bounds();
+    if (bounds.empty() || _points.empty()) return {};
+
+    // Column ranges under the box: one, or two when it crosses the antimeridian
+    const std::int64_t firstRow = rowOf(bounds.minLatitude);
+    const std::int64_t lastRow = rowOf(bounds.maxLatitude);
+    std::int64_t ranges[2][2] = {{columnOf(bounds.minLongitude), columnOf(bounds.maxLongitude)}, {0, -1}};
+    if (bounds.wrapsAntimeridian()) {
+        ranges[0][1] = _columns - 1;
+        ranges[1][1] = columnOf(bounds.maxLongitude);
+    }
+    const std::int64_t cellCount = (lastRow - firstRow + 1) *
+                                   ((ranges[0][1] - ranges[0][0] + 1) + (ranges[1][1] - ranges[1][0] + 1));
+
+    std::vector<std::uint32_t> hits;   // groups of the points inside, one entry per point
+    auto test = [&](const Point& point) {
+        if (region.contains(point.latitude, point.longitude)) hits.push_back(point.group);
+    };
+    if (static_cast<std::size_t>(cellCount) > _cells.size()) {
+        for (const Point& point : _points) test(point);
+    } else {
+        for (std::int64_t row = firstRow; row <= lastRow; ++row) {
+            for (const auto& range : ranges) {
+                for (std::int64_t column = range[0]; column <= range[1]; ++column) {
+                    auto cell = _cells.find(row * _columns + column);
+                    if (cell == _cells.end()) continue;
+                    for (std::uint32_t p = cell->second; p != NONE; p = _points[p].nextInCell) test(_points[p]);
+                }
+            }
+        }
+    }
+
+    // One match per group; whole when all of the group's points were hit
+    std::sort(hits.begin(), hits.end());
+    std::vector<Match> matches;
+    for (std::size_t i = 0; i < hits.size();) {
+        std::size_t run = i;
+        while (run < hits.size() && hits[run] == hits[i]) ++run;
+        std::size_t points = 0;
+        for (std::uint32_t p = _group_heads[hits[i]]; p != NONE; p = _points[p].nextInGroup) ++points;
+        const bool unlocated = hits[i] < _unlocated.size() && _unlocated[hits[i]];
+        matches.push_back(Match{hits[i], run - i == points && !unlocated});
+        i = run;
+    }
+    return matches;
+}
+
+void SpatialIndex::clear() noexcept {
+    _points.clear();
+    _group_heads.clear();
+    _unlocated.clear();
+    _cells.clear();
+}
+
+std::size_t SpatialIndex::memoryBytes() const noexcept {
+    // Hash nodes hold the key, the value and a next pointer (estimated, not exact)
+    return _points.capacity() * sizeof(Point) + _group_heads.capacity() * sizeof(std::uint32_t) + _unlocated.capacity() / 8 +
+           _cells.bucket_count() * sizeof(void*) +
+           _cells.size() * (sizeof(std::int64_t) + sizeof(std::uint32_t) + 2 * sizeof(void*));
+}
@@ -0,0 +1,76 @@
+/**
+ * @file string_dictionary.cpp
+ * @brief StringDictionary implementation
+ */
+
+#include "../interface/string_dictionary.hpp"
+#include <stdexcept>
+
+StringDictionary::StringDictionary(std::pmr::memory_resource* resource) : _values(resource), _index(resource) {}
+
+StringDictionary::StringDictionary(const StringDictionary& other) : _values(other._values) {
+    rebuildIndex();
+}
+
+StringDictionary& StringDictionary::operator=(const StringDictionary& other) {
+    if (this != &other) {
+        _values = other._values;
+        rebuildIndex();
+    }
+    return *this;
+}
+
+StringDictionary& StringDictionary::operator=(StringDictionary&& other) {
+    if (this == &other) return *this;
+    if (_values.get_allocator() == other._values.get_allocator()) {
+        _values = std::move(other._values);
+        _index = std::move(other._index);
+    } else {
+        // The values are moved one by one into this table's blocks, so short strings
+        // change address and the views in other's index would dangle
+        _values = std::move(other._values);
+        rebuildIndex();
+    }
+    other.clear();
+    return *this;
+}
+
+StringDictionary::Code StringDictionary::intern(std::string_view value) {
+    auto it = _index.find(value);
+    if (it != _index.end()) return it->second;
+    if (_values.size() >= NOT_FOUND) {
+        throw std::runtime_error("StringDictionary: too many distinct values");
+    }
+    Code code = static_cast<Code>(_values.size());
+    _values.emplace_back(value);
+    _index.emplace(std::string_view(_values.back()), code);
+    return code;
+}
+
+StringDictionary::Code StringDictionary::find(std::string_view value) const noexcept {
+    auto it = _index.find(value);
+    return it == _index.end() ? NOT_FOUND : it->second;
+}
+
+void StringDictionary::clear() noexcept {
+    _index.clear();
+    _values.clear();
+}
+
+std::size_t StringDictionary::memoryBytes() const noexcept {
+    std::size_t bytes = _values.size() * sizeof(std::string);
+    for (const auto& v : _values) {
+        if (v.capacity() > sizeof(std::string)) bytes += v.capacity() + 1;
+    }
+    bytes += _index.bucket_count() * sizeof(void*);
+    bytes += _index.size() * (sizeof(std::string_view) + sizeof(Code) + 2 * sizeof(void*));
+    return bytes;
+}
+
+void StringDictionary::rebuildIndex() {
+    _index.clear();
+    _index.reserve(_values.size());
+    for (std::size_t i = 0; i < _values.size(); ++i) {
+        _index.emplace(std::string_view(_values[i]), static_cast<Code>(i));
+    }
+}
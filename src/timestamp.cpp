@@ -0,0 +1,74 @@
+/**
+ * @file timestamp.cpp
+ * @brief ISO datetime <-> epoch-minute conversion
+ */
+
+#include "../interface/timestamp.hpp"
+#include <cstdio>
+
+namespace Timestamp {
+    namespace {
+        // Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+        std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) noexcept {
+            y -= m <= 2;
+            const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+            const unsigned yoe = static_cast<unsigned>(y - era * 400);
+            const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+            const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+        }
+
+        void civilFromDays(std::int64_t z, std::int64_t& y, unsigned& m, unsigned& d) noexcept {
+            z += 719468;
+            const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+            const unsigned doe = static_cast<unsigned>(z - era * 146097);
+            const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp = (5 * doy + 2) / 153;
+            d = doy - (153 * mp + 2) / 5 + 1;
+            m = mp < 10 ? mp + 3 : mp - 9;
+            y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
+        }
+
+        bool digits(std::string_view s, std::size_t pos, std::size_t n, unsigned& out) noexcept {
+            if (pos + n > s.size()) return false;
+            unsigned v = 0;
+            for (std::size_t i = pos; i < pos + n; ++i) {
+                char c = s[i];
+                if (c < '0' || c > '9') return false;
+                v = v * 10 + static_cast<unsigned>(c - '0');
+            }
+            out = v;
+            return true;
+        }
+
+        bool isLeap(unsigned y) noexcept { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+    }
+
+    bool parseIsoMinutes(std::string_view s, EpochMinutes& out) noexcept {
+        // Layout: YYYY-MM-DDTHH:MM
+        unsigned year, month, day, hour, minute;
+        if (s.size() < 16 || s[4] != '-' || s[7] != '-' || (s[10] != 'T' && s[10] != ' ') || s[13] != ':') return false;
+        if (!digits(s, 0, 4, year) || !digits(s, 5, 2, month) || !digits(s, 8, 2, day) ||
+            !digits(s, 11, 2, hour) || !digits(s, 14, 2, minute)) return false;
+        static constexpr unsigned DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        if (month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59) return false;
+        unsigned maxDay = DAYS_IN_MONTH[month - 1] + (month == 2 && isLeap(year) ? 1 : 0);
+        if (day > maxDay) return false;
+        out = daysFromCivil(year, month, day) * MINUTES_PER_DAY + hour * MINUTES_PER_HOUR + minute;
+        return true;
+    }
+
+    std::string formatIsoMinutes(EpochMinutes minutes) {
+        EpochMinutes days = minutes / MINUTES_PER_DAY;
+        EpochMinutes rem = minutes % MINUTES_PER_DAY;
+        if (rem < 0) { rem += MINUTES_PER_DAY; --days; }
+        std::int64_t y;
+        unsigned m, d;
+        civilFromDays(days, y, m, d);
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02uT%02lld:%02lld", static_cast<long long>(y), m, d,
+                      static_cast<long long>(rem / MINUTES_PER_HOUR), static_cast<long long>(rem % MINUTES_PER_HOUR));
+        return buffer;
+    }
+}
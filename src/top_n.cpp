@@ -0,0 +1,18 @@
+#include "../interface/top_n.hpp"
+#include "../interface/top_n_engine.hpp"
+
+namespace TopN {
+    std::vector<TopNEntry<long long>> largest(const long long* values, std::size_t count, std::size_t n, int numThreads) {
+        return select<long long>(count, n, numThreads, [values](std::size_t i, long long& value) {
+            value = values[i];
+            return true;
+        });
+    }
+
+    std::vector<TopNEntry<double>> largest(const double* values, std::size_t count, std::size_t n, int numThreads) {
+        return select<double>(count, n, numThreads, [values](std::size_t i, double& value) {
+            value = values[i];
+            return true;
+        });
+    }
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <queue>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <cstdlib>
+#include "../interface/top_n.hpp"
+#include "../interface/constants.hpp"
+
+/**
+ * @file topn_benchmark.cpp
+ * @brief Micro-benchmark: named-pair sort/heap top-N vs. the (value, index) engine
+ *
+ * Builds a synthetic set of named measurements and selects the top N for N from
+ * 10 to 100k with:
+ *  - the previous serial path (sort every (name, value) pair),
+ *  - the previous heap path (priority_queue of (value, name), one name copy per candidate),
+ *  - TopN::largest on (value, index) pairs, resolving names for the winners only,
+ *    serially and with maxThreads threads.
+ *
+ * Usage: ./OpenMP_Mini1_Project_topn_benchmark [items] [repetitions] [maxThreads]
+ */
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+    using Named = std::vector<std::pair<std::string, double>>;
+
+    template <typename Fn>
+    double bestOf(int repetitions, Fn&& fn) {
+        double best = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            auto t0 = Clock::now();
+            fn();
+            double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (rep == 0 || seconds < best) best = seconds;
+        }
+        return best;
+    }
+
+    Named sortAll(const std::vector<double>& values, const std::vector<std::string>& names, std::size_t n) {
+        Named all;
+        all.reserve(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) all.emplace_back(names[i], values[i]);
+        std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (all.size() > n) all.resize(n);
+        return all;
+    }
+
+    Named namedHeap(const std::vector<double>& values, const std::vector<std::string>& names, std::size_t n) {
+        using HeapElem = std::pair<double, std::string>;
+        std::priority_queue<HeapElem, std::vector<HeapElem>, std::greater<HeapElem>> heap;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            HeapElem e{values[i], names[i]};
+            if (heap.size() < n) heap.push(e);
+            else if (e > heap.top()) { heap.pop(); heap.push(e); }
+        }
+        Named out;
+        out.reserve(heap.size());
+        while (!heap.empty()) { out.emplace_back(heap.top().second, heap.top().first); heap.pop(); }
+        std::reverse(out.begin(), out.end());
+        return out;
+    }
+
+    Named engine(const std::vector<double>& values, const std::vector<std::string>& names, std::size_t n, int threads) {
+        auto top = TopN::largest(values.data(), values.size(), n, threads);
+        Named out;
+        out.reserve(top.size());
+        for (const auto& entry : top) out.emplace_back(names[entry.index], entry.value);
+        return out;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t items = 1000000;
+    int repetitions = Config::DEFAULT_REPETITIONS;
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (argc > 1) items = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[1])));
+    if (argc > 2) repetitions = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) maxThreads = std::max(1, std::atoi(argv[3]));
+
+    // Distinct values so every variant must return the same ranking
+    std::vector<double> values(items);
+    std::vector<std::string> names(items);
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist(0.0, 500.0);
+    for (std::size_t i = 0; i < items; ++i) {
+        values[i] = dist(rng) + static_cast<double>(i) * 1e-9;
+        names[i] = "Monitoring site #" + std::to_string(i);
+    }
+
+    std::cout << "Top-N micro-benchmark: " << items << " named values, best of " << repetitions << " runs\n\n";
+    const std::string parallelLabel = "Engine x" + std::to_string(maxThreads) + " (ms)";
+    std::cout << std::setw(8) << "N" << std::setw(15) << "Sort all (ms)" << std::setw(15) << "Name heap (ms)"
+              << std::setw(15) << "Engine x1 (ms)" << std::setw(18) << parallelLabel
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(82, '-') << "\n";
+
+    for (std::size_t n : {std::size_t{10}, std::size_t{100}, std::size_t{1000}, std::size_t{10000}, std::size_t{100000}}) {
+        if (n > items) break;
+        Named reference, heap, serial, parallel;
+        double sortSeconds = bestOf(repetitions, [&] { reference = sortAll(values, names, n); });
+        double heapSeconds = bestOf(repetitions, [&] { heap = namedHeap(values, names, n); });
+        double serialSeconds = bestOf(repetitions, [&] { serial = engine(values, names, n, 1); });
+        double parallelSeconds = bestOf(repetitions, [&] { parallel = engine(values, names, n, maxThreads); });
+
+        std::cout << std::setw(8) << n << std::fixed << std::setprecision(3)
+                  << std::setw(15) << sortSeconds * 1000.0 << std::setw(15) << heapSeconds * 1000.0
+                  << std::setw(15) << serialSeconds * 1000.0 << std::setw(18) << parallelSeconds * 1000.0
+                  << std::setw(10) << std::setprecision(1) << std::min(sortSeconds, heapSeconds) / serialSeconds << "x\n";
+        if (heap != reference || serial != reference || parallel != reference) {
+            std::cout << "  WARNING: result mismatch against full sort!\n";
+        }
+    }
+    return 0;
+}
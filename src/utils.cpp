@@ -9,20 +9,30 @@
  */
 
 #include "../interface/utils.hpp"
+#include "../interface/field_decoder.hpp"
 #include <stdexcept>
 #include <algorithm>
-#include <cmath>
+#include <charconv>
 
 namespace Utils {
-    long long parseLongOrZero(const std::string& s) {
-        try {
-            size_t idx = 0;
-            long long v = std::stoll(s, &idx);
-            return v;
-        } catch (...) {
-            // Return 0 for any parsing error (invalid format, overflow, etc.)
-            return 0;
-        }
+    long long parseLongOrZero(std::string_view s) noexcept {
+        long long v = 0;
+        // Return 0 for any parsing error (invalid format, overflow, etc.)
+        return parseLong(s, v) ? v : 0;
+    }
+
+    bool parseLong(std::string_view s, long long& out) noexcept {
+        const char* first = s.data();
+        const char* last = s.data() + s.size();
+        while (first != last && (*first == ' ' || *first == '\t' || *first == '\n' ||
+                                 *first == '\r' || *first == '\f' || *first == '\v')) ++first;
+        if (first != last && *first == '+') ++first;
+        auto res = std::from_chars(first, last, out);
+        return res.ec == std::errc();
+    }
+
+    bool parseDouble(std::string_view s, double& out) noexcept {
+        return FieldDecoder::toDouble(s, out) == FieldDecoder::Status::Ok;
     }
 
     double timeCall(const std::function<void()>& f) {